@@ -141,6 +141,8 @@ public:
 	virtual void			ListModels( void ) = 0;
 	// Writes a collision model file for the given map entity.
 	virtual bool			WriteCollisionModelForMapEntity( const idMapEntity *mapEnt, const char *filename, const bool testTraceModel = true ) = 0;
+	// Writes the collision models of the loaded map to a binary file that is loaded instead of the .cm.
+	virtual bool			WriteBinaryCollisionModelFile( const idMapFile *mapFile ) = 0;
 };
 
 extern idCollisionModelManager *		collisionModelManager;
@@ -43,6 +43,10 @@ If you have questions concerning this license or the applicable additional terms
 #define CM_FILEID			"CM"
 #define CM_FILEVERSION		"1.00"
 
+#define BCM_FILE_EXT		"bcm"
+#define BCM_FILEID			"BCM"
+#define BCM_FILEVERSION		1
+
 
 /*
 ===============================================================================
@@ -528,6 +532,20 @@ bool idCollisionModelManagerLocal::ParseCollisionModel( idLexer *src ) {
 
 		src->Error( "ParseCollisionModel: bad token \"%s\"", token.c_str() );
 	}
+
+	FinishParsedModel( model );
+
+	return true;
+}
+
+/*
+================
+idCollisionModelManagerLocal::FinishParsedModel
+
+Derives the data that is not stored in collision model files.
+================
+*/
+void idCollisionModelManagerLocal::FinishParsedModel( cm_model_t *model ) {
 	// calculate edge normals
 	checkCount++;
 	CalculateEdgeNormals( model, model->node );
@@ -543,8 +561,6 @@ bool idCollisionModelManagerLocal::ParseCollisionModel( idLexer *src ) {
 						model->numNodes * sizeof(cm_node_t) +
 						model->numPolygonRefs * sizeof(cm_polygonRef_t) +
 						model->numBrushRefs * sizeof(cm_brushRef_t);
-
-	return true;
 }
 
 /*
@@ -558,6 +574,11 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 	idLexer *src;
 	unsigned int crc;
 
+	// the binary version written by dmap is a lot faster to load
+	if ( LoadBinaryCollisionModelFile( name, mapFileCRC ) ) {
+		return true;
+	}
+
 	// load it
 	fileName = name;
 	fileName.SetFileExtension( CM_FILE_EXT );
@@ -614,3 +635,419 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 
 	return true;
 }
+
+
+/*
+===============================================================================
+
+Binary collision model files
+
+Written by dmap next to the .cm, holds the same data as the text version
+so the models can be restored with a single file read.
+
+===============================================================================
+*/
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryNodes
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryNodes( idFile *fp, cm_node_t *node ) {
+	fp->WriteInt( node->planeType );
+	fp->WriteFloat( node->planeDist );
+	if ( node->planeType != -1 ) {
+		WriteBinaryNodes( fp, node->children[0] );
+		WriteBinaryNodes( fp, node->children[1] );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::GetModelPrimitives
+
+Gathers the unique polygons and brushes of the tree.
+================
+*/
+void idCollisionModelManagerLocal::GetModelPrimitives( cm_node_t *node, idList<cm_polygon_t *> &polygons, idList<cm_brush_t *> &brushes ) {
+	cm_polygonRef_t *pref;
+	cm_brushRef_t *bref;
+
+	for ( pref = node->polygons; pref; pref = pref->next ) {
+		if ( pref->p->checkcount != checkCount ) {
+			pref->p->checkcount = checkCount;
+			polygons.Append( pref->p );
+		}
+	}
+	for ( bref = node->brushes; bref; bref = bref->next ) {
+		if ( bref->b->checkcount != checkCount ) {
+			bref->b->checkcount = checkCount;
+			brushes.Append( bref->b );
+		}
+	}
+	if ( node->planeType != -1 ) {
+		GetModelPrimitives( node->children[0], polygons, brushes );
+		GetModelPrimitives( node->children[1], polygons, brushes );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModel
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModel( idFile *fp, cm_model_t *model, idList<const idMaterial *> &materials ) {
+	idList<cm_polygon_t *> polygons;
+	idList<cm_brush_t *> brushes;
+	int i, j, polygonMemory, brushMemory;
+
+	checkCount++;
+	GetModelPrimitives( model->node, polygons, brushes );
+
+	polygonMemory = 0;
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		polygonMemory += sizeof( cm_polygon_t ) + ( polygons[i]->numEdges - 1 ) * sizeof( polygons[i]->edges[0] );
+	}
+	brushMemory = 0;
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		brushMemory += sizeof( cm_brush_t ) + ( brushes[i]->numPlanes - 1 ) * sizeof( brushes[i]->planes[0] );
+	}
+
+	fp->WriteString( model->name );
+	// vertices
+	fp->WriteInt( model->numVertices );
+	for ( i = 0; i < model->numVertices; i++ ) {
+		fp->WriteVec3( model->vertices[i].p );
+	}
+	// edges
+	fp->WriteInt( model->numEdges );
+	for ( i = 0; i < model->numEdges; i++ ) {
+		fp->WriteInt( model->edges[i].vertexNum[0] );
+		fp->WriteInt( model->edges[i].vertexNum[1] );
+		fp->WriteInt( model->edges[i].internal );
+		fp->WriteInt( model->edges[i].numUsers );
+	}
+	// nodes
+	WriteBinaryNodes( fp, model->node );
+	// polygons
+	fp->WriteInt( polygonMemory );
+	fp->WriteInt( polygons.Num() );
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		const cm_polygon_t *p = polygons[i];
+		fp->WriteInt( p->numEdges );
+		for ( j = 0; j < p->numEdges; j++ ) {
+			fp->WriteInt( p->edges[j] );
+		}
+		fp->WriteVec3( p->plane.Normal() );
+		fp->WriteFloat( p->plane.Dist() );
+		fp->WriteVec3( p->bounds[0] );
+		fp->WriteVec3( p->bounds[1] );
+		fp->WriteInt( materials.AddUnique( p->material ) );
+	}
+	// brushes
+	fp->WriteInt( brushMemory );
+	fp->WriteInt( brushes.Num() );
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		const cm_brush_t *b = brushes[i];
+		fp->WriteInt( b->numPlanes );
+		for ( j = 0; j < b->numPlanes; j++ ) {
+			fp->WriteVec3( b->planes[j].Normal() );
+			fp->WriteFloat( b->planes[j].Dist() );
+		}
+		fp->WriteVec3( b->bounds[0] );
+		fp->WriteVec3( b->bounds[1] );
+		fp->WriteInt( b->contents );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC ) {
+	idList<const idMaterial *> materials;
+	idFile_Memory modelData( "binaryCollisionModels" );
+	idFile *fp;
+	idStr name;
+	int i;
+
+	name = filename;
+	name.SetFileExtension( BCM_FILE_EXT );
+
+	common->Printf( "writing %s\n", name.c_str() );
+	fp = fileSystem->OpenFileWrite( name, "fs_devpath" );
+	if ( !fp ) {
+		common->Warning( "idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile: Error opening file %s\n", name.c_str() );
+		return;
+	}
+
+	// the material table goes in front of the models that reference it
+	for ( i = firstModel; i < lastModel; i++ ) {
+		WriteBinaryCollisionModel( &modelData, models[i], materials );
+	}
+
+	fp->WriteString( BCM_FILEID );
+	fp->WriteInt( BCM_FILEVERSION );
+	fp->WriteUnsignedInt( mapFileCRC );
+	fp->WriteInt( materials.Num() );
+	for ( i = 0; i < materials.Num(); i++ ) {
+		fp->WriteString( materials[i]->GetName() );
+	}
+	fp->WriteInt( lastModel - firstModel );
+	fp->Write( modelData.GetDataPtr(), modelData.Length() );
+
+	fileSystem->CloseFile( fp );
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModelFile
+================
+*/
+bool idCollisionModelManagerLocal::WriteBinaryCollisionModelFile( const idMapFile *mapFile ) {
+	if ( !loaded || mapName.Icmp( mapFile->GetName() ) != 0 ) {
+		common->Warning( "idCollisionModelManagerLocal::WriteBinaryCollisionModelFile: %s is not loaded\n", mapFile->GetName() );
+		return false;
+	}
+	WriteBinaryCollisionModelsToFile( mapFile->GetName(), 0, numModels, mapFile->GetGeometryCRC() );
+	return true;
+}
+
+/*
+================
+idCollisionModelManagerLocal::ReadBinaryNodes
+================
+*/
+cm_node_t *idCollisionModelManagerLocal::ReadBinaryNodes( idFile *fp, cm_model_t *model, cm_node_t *parent, bool &ok ) {
+	cm_node_t *node;
+	int planeType = -1;
+	float planeDist = 0.0f;
+
+	model->numNodes++;
+	node = AllocNode( model, model->numNodes < NODE_BLOCK_SIZE_SMALL ? NODE_BLOCK_SIZE_SMALL : NODE_BLOCK_SIZE_LARGE );
+	node->brushes = NULL;
+	node->polygons = NULL;
+	node->parent = parent;
+	node->planeType = -1;
+	node->planeDist = 0.0f;
+
+	ok = ok && fp->ReadInt( planeType ) == sizeof( planeType ) && planeType >= -1 && planeType <= 2;
+	ok = ok && fp->ReadFloat( planeDist ) == sizeof( planeDist );
+	if ( ok && planeType != -1 ) {
+		// only link the children once both are complete so a partial tree can still be freed
+		cm_node_t *child0 = ReadBinaryNodes( fp, model, node, ok );
+		cm_node_t *child1 = ReadBinaryNodes( fp, model, node, ok );
+		node->children[0] = child0;
+		node->children[1] = child1;
+		node->planeType = planeType;
+	}
+	node->planeDist = planeDist;
+	return node;
+}
+
+/*
+================
+idCollisionModelManagerLocal::ReadBinaryCollisionModel
+================
+*/
+bool idCollisionModelManagerLocal::ReadBinaryCollisionModel( idFile *fp, const idList<const idMaterial *> &materials ) {
+	cm_model_t *model;
+	int i, j, num;
+	idVec3 normal;
+	float dist;
+	bool ok = true;
+
+	if ( numModels >= MAX_SUBMODELS ) {
+		common->Warning( "ReadBinaryCollisionModel: no free slots" );
+		return false;
+	}
+	model = AllocModel();
+	models[numModels] = model;
+	numModels++;
+
+	fp->ReadString( model->name );
+	// vertices
+	ok = fp->ReadInt( num ) == sizeof( num ) && num >= 0 && num <= fp->Length();
+	if ( ok ) {
+		model->numVertices = model->maxVertices = num;
+		model->vertices = (cm_vertex_t *) Mem_Alloc( model->maxVertices * sizeof( cm_vertex_t ) );
+		for ( i = 0; i < model->numVertices; i++ ) {
+			fp->ReadVec3( model->vertices[i].p );
+			model->vertices[i].side = 0;
+			model->vertices[i].sideSet = 0;
+			model->vertices[i].checkcount = 0;
+		}
+	}
+	// edges
+	ok = ok && fp->ReadInt( num ) == sizeof( num ) && num >= 0 && num <= fp->Length();
+	if ( ok ) {
+		model->numEdges = model->maxEdges = num;
+		model->edges = (cm_edge_t *) Mem_Alloc( model->maxEdges * sizeof( cm_edge_t ) );
+		for ( i = 0; i < model->numEdges; i++ ) {
+			cm_edge_t *edge = &model->edges[i];
+			int internal = 0, numUsers = 0;
+			fp->ReadInt( edge->vertexNum[0] );
+			fp->ReadInt( edge->vertexNum[1] );
+			fp->ReadInt( internal );
+			fp->ReadInt( numUsers );
+			edge->side = 0;
+			edge->sideSet = 0;
+			edge->internal = internal;
+			edge->numUsers = numUsers;
+			edge->normal = vec3_origin;
+			edge->checkcount = 0;
+			model->numInternalEdges += edge->internal;
+			ok = ok && edge->vertexNum[0] >= 0 && edge->vertexNum[0] < model->numVertices &&
+					edge->vertexNum[1] >= 0 && edge->vertexNum[1] < model->numVertices;
+		}
+	}
+	// nodes
+	if ( ok ) {
+		model->node = ReadBinaryNodes( fp, model, NULL, ok );
+	}
+	// polygons, all allocated from a single block
+	ok = ok && fp->ReadInt( num ) == sizeof( num ) && num >= 0 && num <= fp->Length();
+	if ( ok && num > 0 ) {
+		model->polygonBlock = (cm_polygonBlock_t *) Mem_Alloc( sizeof( cm_polygonBlock_t ) + num );
+		model->polygonBlock->bytesRemaining = num;
+		model->polygonBlock->next = ( (byte *) model->polygonBlock ) + sizeof( cm_polygonBlock_t );
+	}
+	ok = ok && fp->ReadInt( num ) == sizeof( num ) && num >= 0;
+	for ( i = 0; ok && i < num; i++ ) {
+		int numEdges = 0, materialNum = -1;
+		ok = fp->ReadInt( numEdges ) == sizeof( numEdges ) && numEdges >= 3 && numEdges <= fp->Length() && model->polygonBlock &&
+			model->polygonBlock->bytesRemaining >= (int)( sizeof( cm_polygon_t ) + ( numEdges - 1 ) * sizeof( int ) );
+		if ( !ok ) {
+			break;
+		}
+		cm_polygon_t *p = AllocPolygon( model, numEdges );
+		p->numEdges = numEdges;
+		for ( j = 0; j < numEdges; j++ ) {
+			fp->ReadInt( p->edges[j] );
+			ok = ok && abs( p->edges[j] ) < model->numEdges;
+		}
+		fp->ReadVec3( normal );
+		fp->ReadFloat( dist );
+		p->plane.SetNormal( normal );
+		p->plane.SetDist( dist );
+		fp->ReadVec3( p->bounds[0] );
+		fp->ReadVec3( p->bounds[1] );
+		fp->ReadInt( materialNum );
+		ok = ok && materialNum >= 0 && materialNum < materials.Num();
+		if ( !ok ) {
+			break;
+		}
+		p->material = materials[materialNum];
+		p->contents = p->material->GetContentFlags();
+		p->checkcount = 0;
+		// filter polygon into tree
+		R_FilterPolygonIntoTree( model, model->node, NULL, p );
+	}
+	// brushes, all allocated from a single block
+	ok = ok && fp->ReadInt( num ) == sizeof( num ) && num >= 0 && num <= fp->Length();
+	if ( ok && num > 0 ) {
+		model->brushBlock = (cm_brushBlock_t *) Mem_Alloc( sizeof( cm_brushBlock_t ) + num );
+		model->brushBlock->bytesRemaining = num;
+		model->brushBlock->next = ( (byte *) model->brushBlock ) + sizeof( cm_brushBlock_t );
+	}
+	ok = ok && fp->ReadInt( num ) == sizeof( num ) && num >= 0;
+	for ( i = 0; ok && i < num; i++ ) {
+		int numPlanes = 0;
+		ok = fp->ReadInt( numPlanes ) == sizeof( numPlanes ) && numPlanes >= 1 && numPlanes <= fp->Length() && model->brushBlock &&
+			model->brushBlock->bytesRemaining >= (int)( sizeof( cm_brush_t ) + ( numPlanes - 1 ) * sizeof( idPlane ) );
+		if ( !ok ) {
+			break;
+		}
+		cm_brush_t *b = AllocBrush( model, numPlanes );
+		b->numPlanes = numPlanes;
+		for ( j = 0; j < numPlanes; j++ ) {
+			fp->ReadVec3( normal );
+			fp->ReadFloat( dist );
+			b->planes[j].SetNormal( normal );
+			b->planes[j].SetDist( dist );
+		}
+		fp->ReadVec3( b->bounds[0] );
+		fp->ReadVec3( b->bounds[1] );
+		fp->ReadInt( b->contents );
+		b->checkcount = 0;
+		b->primitiveNum = 0;
+		// filter brush into tree
+		R_FilterBrushIntoTree( model, model->node, NULL, b );
+	}
+
+	if ( !ok ) {
+		return false;
+	}
+
+	FinishParsedModel( model );
+
+	return true;
+}
+
+/*
+================
+idCollisionModelManagerLocal::LoadBinaryCollisionModelFile
+================
+*/
+bool idCollisionModelManagerLocal::LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC ) {
+	idList<const idMaterial *> materials;
+	idStr fileName, fileId, materialName;
+	int i, version, numMaterials, numFileModels, firstModel;
+	unsigned int crc;
+	void *buffer;
+	int length;
+
+	fileName = name;
+	fileName.SetFileExtension( BCM_FILE_EXT );
+	length = fileSystem->ReadFile( fileName, &buffer );
+	if ( length <= 0 || buffer == NULL ) {
+		return false;
+	}
+
+	idFile_Memory fp( fileName, (const char *)buffer, length );
+
+	version = numMaterials = numFileModels = 0;
+	crc = 0;
+	fp.ReadString( fileId );
+	fp.ReadInt( version );
+	fp.ReadUnsignedInt( crc );
+	if ( fileId != BCM_FILEID || version != BCM_FILEVERSION ) {
+		common->Warning( "%s has version %d instead of %d", fileName.c_str(), version, BCM_FILEVERSION );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+	if ( mapFileCRC && crc != mapFileCRC ) {
+		common->Printf( "%s is out of date\n", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	bool ok = fp.ReadInt( numMaterials ) == sizeof( numMaterials ) && numMaterials >= 0 && numMaterials <= length;
+	for ( i = 0; ok && i < numMaterials; i++ ) {
+		fp.ReadString( materialName );
+		materials.Append( declManager->FindMaterial( materialName ) );
+	}
+
+	firstModel = numModels;
+	ok = ok && fp.ReadInt( numFileModels ) == sizeof( numFileModels ) && numFileModels >= 0;
+	for ( i = 0; ok && i < numFileModels; i++ ) {
+		ok = ReadBinaryCollisionModel( &fp, materials );
+	}
+	ok = ok && fp.Tell() == fp.Length();
+
+	fileSystem->FreeFile( buffer );
+
+	if ( !ok ) {
+		// drop whatever was restored and fall back to the text file
+		common->Warning( "%s is corrupt", fileName.c_str() );
+		for ( i = firstModel; i < numModels; i++ ) {
+			FreeModel( models[i] );
+			models[i] = NULL;
+		}
+		numModels = firstModel;
+		return false;
+	}
+
+	return true;
+}
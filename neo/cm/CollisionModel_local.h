@@ -344,6 +344,8 @@ public:
 	void			ListModels( void );
 	// write a collision model file for the map entity
 	bool			WriteCollisionModelForMapEntity( const idMapEntity *mapEnt, const char *filename, const bool testTraceModel = true );
+	// write a binary collision model file for the currently loaded map
+	bool			WriteBinaryCollisionModelFile( const idMapFile *mapFile );
 
 private:			// CollisionMap_translate.cpp
 	int				TranslateEdgeThroughEdge( idVec3 &cross, idPluecker &l1, idPluecker &l2, float *fraction );
@@ -481,6 +483,10 @@ private:			// CollisionMap_files.cpp
 	void			WriteBrushes( idFile *fp, cm_node_t *node );
 	void			WriteCollisionModel( idFile *fp, cm_model_t *model );
 	void			WriteCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC );
+	void			WriteBinaryNodes( idFile *fp, cm_node_t *node );
+	void			GetModelPrimitives( cm_node_t *node, idList<cm_polygon_t *> &polygons, idList<cm_brush_t *> &brushes );
+	void			WriteBinaryCollisionModel( idFile *fp, cm_model_t *model, idList<const idMaterial *> &materials );
+	void			WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC );
 					// loading
 	cm_node_t *		ParseNodes( idLexer *src, cm_model_t *model, cm_node_t *parent );
 	void			ParseVertices( idLexer *src, cm_model_t *model );
@@ -488,7 +494,11 @@ private:			// CollisionMap_files.cpp
 	void			ParsePolygons( idLexer *src, cm_model_t *model );
 	void			ParseBrushes( idLexer *src, cm_model_t *model );
 	bool			ParseCollisionModel( idLexer *src );
+	void			FinishParsedModel( cm_model_t *model );
 	bool			LoadCollisionModelFile( const char *name, unsigned int mapFileCRC );
+	cm_node_t *		ReadBinaryNodes( idFile *fp, cm_model_t *model, cm_node_t *parent, bool &ok );
+	bool			ReadBinaryCollisionModel( idFile *fp, const idList<const idMaterial *> &materials );
+	bool			LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC );
 
 private:			// CollisionMap_debug
 	int				ContentsFromString( const char *string ) const;
@@ -1693,6 +1693,8 @@ void idAFEntity_Vehicle::Spawn( void ) {
 
 	SetPhysics( af.GetPhysics() );
 
+	af.GetPhysics()->SetContinuousCollision( spawnArgs.GetBool( "continuousCollision", "1" ) );
+
 	fl.takedamage = true;
 
 	if ( !eyesJointName[0] ) {
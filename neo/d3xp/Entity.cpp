@@ -409,6 +409,7 @@ idEntity::idEntity() {
 	snapshotNode.SetOwner( this );
 	snapshotSequence = -1;
 	snapshotBits = 0;
+	memset( snapshotAccumulator, 0, sizeof( snapshotAccumulator ) );
 
 	thinkFlags		= 0;
 	dormantStart	= 0;
@@ -1532,7 +1533,7 @@ bool idEntity::UpdateRenderEntity( renderEntity_t *renderEntity, const renderVie
 		SetTimeState ts( timeGroup );
 #endif
 
-		return animator->CreateFrame( gameLocal.time, false );
+		return animator->CreateFrame( gameLocal.time, false, true );
 	}
 
 	return false;
@@ -5186,6 +5187,8 @@ void idAnimatedEntity::UpdateAnimation( void ) {
 		animator.ServiceAnims( gameLocal.previousTime, gameLocal.time );
 	}
 
+	UpdateAnimationLOD();
+
 	// if the model is animating then we have to update it
 	if ( !animator.FrameHasChanged( gameLocal.time ) ) {
 		// still fine the way it was
@@ -5201,10 +5204,57 @@ void idAnimatedEntity::UpdateAnimation( void ) {
 	// update the renderEntity
 	UpdateVisuals();
 
+	// build the pose along with the other visible animated entities after think
+	if ( !fl.hidden && renderEntity.callback && gameLocal.GetLocalPlayer() && gameLocal.InPlayerPVS( this ) ) {
+		animator.QueueFrame();
+	}
+
 	// the animation is updated
 	animator.ClearForceUpdate();
 }
 
+// bounds radius of a human sized actor, g_animLodDistance is given for it
+static const float ANIM_LOD_REFERENCE_RADIUS = 48.0f;
+
+/*
+================
+idAnimatedEntity::UpdateAnimationLOD
+
+Picks the level of detail the render callback builds the pose with, from the
+distance to the local player's view scaled by the size of the entity and the
+zoom of the view.  An entity has to get g_animLodHysteresis past a threshold
+before it switches, so it doesn't flicker between two levels.
+================
+*/
+void idAnimatedEntity::UpdateAnimationLOD( void ) {
+	animLOD_t		newLOD = ANIMLOD_FULL;
+	idPlayer *		player = gameLocal.GetLocalPlayer();
+	renderView_t *	view = player ? player->GetRenderView() : NULL;
+
+	if ( g_animLod.GetBool() && g_animLodDistance.GetFloat() > 0.0f && view && player != this && !( gameLocal.inCinematic && cinematic ) ) {
+		if ( !gameLocal.InPlayerPVS( this ) ) {
+			newLOD = ANIMLOD_HIDDEN;
+		} else {
+			float radius = renderEntity.bounds.IsCleared() ? ANIM_LOD_REFERENCE_RADIUS : Max( renderEntity.bounds.GetRadius(), 1.0f );
+			float distance = ( renderEntity.origin - view->vieworg ).Length();
+			distance *= ( ANIM_LOD_REFERENCE_RADIUS / radius ) * idMath::Tan( DEG2RAD( view->fov_x * 0.5f ) );
+
+			float hysteresis = g_animLodHysteresis.GetFloat();
+			animLOD_t currentLOD = animator.GetLOD();
+			for ( int i = ANIMLOD_REDUCED; i <= ANIMLOD_LOW; i++ ) {
+				float threshold = g_animLodDistance.GetFloat() * i;
+				threshold *= ( i <= currentLOD ) ? 1.0f - hysteresis : 1.0f + hysteresis;
+				if ( distance > threshold ) {
+					newLOD = (animLOD_t)i;
+				}
+			}
+		}
+	}
+
+	animator.SetLOD( newLOD );
+	gameLocal.animLODStats.numEntities[ newLOD ]++;
+}
+
 /*
 ================
 idAnimatedEntity::GetAnimator
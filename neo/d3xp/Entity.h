@@ -117,6 +117,7 @@ public:
 	idLinkList<idEntity>	snapshotNode;			// for being linked into snapshotEntities list
 	int						snapshotSequence;		// last snapshot this entity was in
 	int						snapshotBits;			// number of bits this entity occupied in the last snapshot
+	float					snapshotAccumulator[ MAX_CLIENTS ];	// priority accumulated per client while the entity wasn't sent
 
 	idStr					name;					// name of entity
 	idDict					spawnArgs;				// key/value pairs used to spawn and initialize entity
@@ -511,6 +512,7 @@ public:
 	virtual void			Think( void );
 
 	void					UpdateAnimation( void );
+	void					UpdateAnimationLOD( void );
 
 	virtual idAnimator *	GetAnimator( void );
 	virtual void			SetModel( const char *modelname );
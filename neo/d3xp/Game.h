@@ -73,6 +73,15 @@ typedef enum {
 #define TIME_GROUP2		1
 #endif
 
+// a client snapshot written by idGame::ServerWriteSnapshots
+typedef struct snapshotRequest_s {
+	int							clientNum;
+	int							sequence;
+	idBitMsg *					msg;
+	byte *						clientInPVS;
+	int							maxBytes;			// snapshot size that fits the client rate, 0 for no limit
+} snapshotRequest_t;
+
 class idGame {
 public:
 	virtual						~idGame() {}
@@ -196,6 +205,9 @@ public:
 	virtual void				GetMapLoadingGUI( char gui[ MAX_STRING_CHARS ] ) = 0;
 
 	virtual int                 GetAreaLocationNames( const char** names, int namesSize ) = 0;
+
+	// Writes snapshots for several clients at once, the game may build them in parallel.
+	virtual void				ServerWriteSnapshots( snapshotRequest_t *requests, int numRequests, int numPVSClients ) = 0;
 };
 
 extern idGame *					game;
@@ -54,6 +54,11 @@ idCVar net_clientSelfSmoothing( "net_clientSelfSmoothing", "0.6", CVAR_GAME | CV
 idCVar net_clientMaxPrediction( "net_clientMaxPrediction", "1000", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "maximum number of milliseconds a client can predict ahead of server." );
 idCVar net_clientLagOMeter( "net_clientLagOMeter", "1", CVAR_GAME | CVAR_BOOL | CVAR_NOCHEAT | CVAR_ARCHIVE, "draw prediction graph" );
 
+static idParallelJobList	snapshotJobList( "snapshots" );
+
+const float SNAPSHOT_PRIORITY_DISTANCE	= 512.0f;	// distance at which the entity priority is halved
+const float SNAPSHOT_PRIORITY_SPEED		= 320.0f;	// speed at which the entity priority is doubled
+
 /*
 ================
 idGameLocal::InitAsyncNetwork
@@ -71,6 +76,8 @@ void idGameLocal::InitAsyncNetwork( void ) {
 	memset( clientEntityStates, 0, sizeof( clientEntityStates ) );
 	memset( clientPVS, 0, sizeof( clientPVS ) );
 	memset( clientSnapshots, 0, sizeof( clientSnapshots ) );
+	memset( entitySnapshots, 0, sizeof( entitySnapshots ) );
+	snapshotCacheFrame = 0;
 
 	eventQueue.Init();
 	savedEventQueue.Init();
@@ -90,11 +97,13 @@ idGameLocal::ShutdownAsyncNetwork
 void idGameLocal::ShutdownAsyncNetwork( void ) {
 	entityStateAllocator.Shutdown();
 	snapshotAllocator.Shutdown();
+	entitySnapshotAllocator.Shutdown();
 	eventQueue.Shutdown();
 	savedEventQueue.Shutdown();
 	memset( clientEntityStates, 0, sizeof( clientEntityStates ) );
 	memset( clientPVS, 0, sizeof( clientPVS ) );
 	memset( clientSnapshots, 0, sizeof( clientSnapshots ) );
+	memset( entitySnapshots, 0, sizeof( entitySnapshots ) );
 }
 
 /*
@@ -294,6 +303,7 @@ void idGameLocal::ServerClientConnect( int clientNum, const char *guid ) {
 		delete entities[ clientNum ];
 	}
 	userInfo[ clientNum ].Clear();
+	snapshotBuilds[ clientNum ].reserveBytes = 0;
 	mpGame.ServerClientConnect( clientNum );
 	Printf( "client %d connected.\n", clientNum );
 }
@@ -542,41 +552,52 @@ void idGameLocal::ReadGameStateFromSnapshot( const idBitMsgDelta &msg ) {
 
 /*
 ================
-idGameLocal::ServerWriteSnapshot
+idGameLocal::ServerPrepareSnapshot
 
-  Write a snapshot of the current game state for the given client.
+  Allocates the snapshot for the client and selects the entities written to it.
+  Touches shared game state so it always runs on the main thread. The new entity
+  states are allocated up front so writing the snapshot doesn't use the allocator.
+  Returns false if the client has no player.
 ================
 */
-void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &msg, byte *clientInPVS, int numPVSClients ) {
-	int i, msgSize, msgWriteBit;
-	idPlayer *player, *spectated = NULL;
+bool idGameLocal::ServerPrepareSnapshot( snapshotBuild_t &build, bool cacheEntities ) {
+	int i;
+	idPlayer *spectated;
 	idEntity *ent;
 	pvsHandle_t pvsHandle;
-	idBitMsgDelta deltaMsg;
 	snapshot_t *snapshot;
-	entityState_t *base, *newBase;
 	int numSourceAreas, sourceAreas[ idEntity::MAX_PVS_AREAS ];
+	const int clientNum = build.clientNum;
 
-	player = static_cast<idPlayer *>( entities[ clientNum ] );
-	if ( !player ) {
-		return;
+	build.entities.SetNum( 0, false );
+	build.newBases.SetNum( 0, false );
+	build.changed.SetNum( 0, false );
+
+	build.player = static_cast<idPlayer *>( entities[ clientNum ] );
+	if ( !build.player ) {
+		return false;
 	}
-	if ( player->spectating && player->spectator != clientNum && entities[ player->spectator ] ) {
-		spectated = static_cast< idPlayer * >( entities[ player->spectator ] );
+	if ( build.player->spectating && build.player->spectator != clientNum && entities[ build.player->spectator ] ) {
+		spectated = static_cast< idPlayer * >( entities[ build.player->spectator ] );
 	} else {
-		spectated = player;
+		spectated = build.player;
 	}
 
+	// the entity priorities are relative to the view of the player
+	build.viewOrigin = spectated->GetPhysics()->GetOrigin();
+	build.viewDir = spectated->viewAngles.ToForward();
+
 	// free too old snapshots
-	FreeSnapshotsOlderThanSequence( clientNum, sequence - 64 );
+	FreeSnapshotsOlderThanSequence( clientNum, build.sequence - 64 );
 
 	// allocate new snapshot
 	snapshot = snapshotAllocator.Alloc();
-	snapshot->sequence = sequence;
+	snapshot->sequence = build.sequence;
 	snapshot->firstEntityState = NULL;
 	snapshot->next = clientSnapshots[clientNum];
 	clientSnapshots[clientNum] = snapshot;
 	memset( snapshot->pvs, 0, sizeof( snapshot->pvs ) );
+	build.snapshot = snapshot;
 
 	// get PVS for this player
 	// don't use PVSAreas for networking - PVSAreas depends on animations (and md5 bounds), which are not synchronized
@@ -598,12 +619,10 @@ void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &ms
 #endif
 
 #if ASYNC_WRITE_TAGS
-	idRandom tagRandom;
-	tagRandom.SetSeed( random.RandomInt() );
-	msg.WriteLong( tagRandom.GetSeed() );
+	build.tagRandom.SetSeed( random.RandomInt() );
+	build.msg->WriteLong( build.tagRandom.GetSeed() );
 #endif
 
-	// create the snapshot
 	for( ent = spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
 
 		// if the entity is not in the player PVS
@@ -619,75 +638,262 @@ void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &ms
 			continue;
 		}
 
+		build.entities.Append( ent );
+	}
+
+#if ASYNC_WRITE_PVS
+	// the PVS is written after the entities
+	build.pvsHandle = pvsHandle;
+	build.numSourceAreas = numSourceAreas;
+	memcpy( build.sourceAreas, sourceAreas, sizeof( build.sourceAreas ) );
+#else
+	// free the PVS
+	pvs.FreeCurrentPVS( pvsHandle );
+#endif
+
+	// the last new state is for the game and player state
+	build.newBases.SetNum( build.entities.Num() + 1, false );
+	for ( i = 0; i < build.newBases.Num(); i++ ) {
+		build.newBases[i] = entityStateAllocator.Alloc();
+	}
+	build.changed.SetNum( build.entities.Num(), false );
+	build.priorities.SetNum( build.entities.Num(), false );
+
+	// entities seen by several clients are only written once
+	build.cached.SetNum( build.entities.Num(), false );
+	for ( i = 0; i < build.entities.Num(); i++ ) {
+		build.cached[i] = cacheEntities ? ServerCacheEntitySnapshot( build.entities[i], false ) : NULL;
+	}
+
+	return true;
+}
+
+/*
+================
+idGameLocal::ServerCacheEntitySnapshot
+
+  Records the snapshot writes of the entity the first time it is written this frame.
+  Returns NULL if the entity has to be written directly for each client.
+================
+*/
+entitySnapshot_t *idGameLocal::ServerCacheEntitySnapshot( idEntity *ent, bool coop ) {
+	idBitMsgDelta deltaMsg;
+	entitySnapshot_t *cache;
+
+	cache = entitySnapshots[ ent->entityNumber ];
+	if ( !cache ) {
+		cache = entitySnapshotAllocator.Alloc();
+		cache->cacheFrame = snapshotCacheFrame - 1;
+		entitySnapshots[ ent->entityNumber ] = cache;
+	}
+
+	if ( cache->cacheFrame != snapshotCacheFrame ) {
+		cache->cacheFrame = snapshotCacheFrame;
+
+		cache->state.Init( cache->stateBuf, sizeof( cache->stateBuf ) );
+		cache->state.SetAllowOverflow( true );
+		cache->state.BeginWriting();
+		cache->record.Init( cache->recordBuf, sizeof( cache->recordBuf ) );
+		cache->record.SetAllowOverflow( true );
+		cache->record.BeginWriting();
+
+		deltaMsg.InitRecord( &cache->state, &cache->record );
+
+		deltaMsg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
+		deltaMsg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
+		deltaMsg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
+
+		ent->WriteToSnapshot( deltaMsg );
+
+		cache->valid = !cache->state.IsOverflowed() && !cache->record.IsOverflowed();
+	}
+
+	return cache->valid ? cache : NULL;
+}
+
+/*
+================
+SnapshotPriorityCompare
+================
+*/
+static int SnapshotPriorityCompare( const snapshotPriority_t *a, const snapshotPriority_t *b ) {
+	if ( a->priority > b->priority ) {
+		return -1;
+	}
+	if ( a->priority < b->priority ) {
+		return 1;
+	}
+	return a->index - b->index;
+}
+
+/*
+================
+idGameLocal::ServerScheduleSnapshotEntities
+
+  Orders the entities by the priority they accumulated for the client since they were
+  last sent. Near entities in view that move fast gain priority the quickest.
+  Only changes the accumulators of the client so it is safe to run in a snapshot job.
+================
+*/
+void idGameLocal::ServerScheduleSnapshotEntities( snapshotBuild_t &build ) {
+	int i;
+	float priority, dist, speed;
+	idVec3 delta;
+	idEntity *ent;
+	const int clientNum = build.clientNum;
+
+	for ( i = 0; i < build.entities.Num(); i++ ) {
+		ent = build.entities[i];
+		snapshotPriority_t &entry = build.priorities[i];
+		entry.index = i;
+
+		// the own player is always sent
+		if ( ent == build.player ) {
+			entry.priority = idMath::INFINITY;
+			continue;
+		}
+
+		delta = ent->GetPhysics()->GetOrigin() - build.viewOrigin;
+		dist = delta.Normalize();
+
+		priority = SNAPSHOT_PRIORITY_DISTANCE / ( SNAPSHOT_PRIORITY_DISTANCE + dist );
+
+		// entities behind the player matter less
+		priority *= 0.625f + 0.375f * ( delta * build.viewDir );
+
+		// fast entities get out of date sooner
+		speed = ent->GetPhysics()->GetLinearVelocity().LengthFast();
+		priority *= 1.0f + Min( speed / SNAPSHOT_PRIORITY_SPEED, 3.0f );
+
+		if ( ent->IsType( idPlayer::Type ) ) {
+			priority *= 2.0f;
+		}
+
+		ent->snapshotAccumulator[clientNum] += priority;
+		entry.priority = ent->snapshotAccumulator[clientNum];
+	}
+
+	build.priorities.Sort( SnapshotPriorityCompare );
+}
+
+/*
+================
+idGameLocal::ServerWriteSnapshotEntities
+
+  Writes the prepared entities and the game and player state to the snapshot message.
+  Only reads game state and only writes to the build and the client's own entity
+  states, so the snapshots of different clients can be written in parallel.
+================
+*/
+void idGameLocal::ServerWriteSnapshotEntities( snapshotBuild_t &build ) {
+	int i, n, msgSize, msgWriteBit, entityBytes, entitiesSize;
+	bool scheduled;
+	idEntity *ent;
+	idBitMsgDelta deltaMsg;
+	entityState_t *base, *newBase;
+	entitySnapshot_t *cache;
+	idBitMsg &msg = *build.msg;
+	const int clientNum = build.clientNum;
+
+	// with a byte budget the entities with the highest priority are written first and the rest is postponed
+	scheduled = build.maxBytes > 0 && net_snapshotPriority.GetBool();
+	if ( scheduled ) {
+		ServerScheduleSnapshotEntities( build );
+	}
+	entityBytes = build.maxBytes - build.reserveBytes;
+
+	// create the snapshot
+	for ( n = 0; n < build.entities.Num(); n++ ) {
+		i = scheduled ? build.priorities[n].index : n;
+		ent = build.entities[i];
+		newBase = build.newBases[i];
+		cache = build.cached[i];
+
+		// the delta is empty when the shared state is identical to the base
+		base = clientEntityStates[clientNum][ent->entityNumber];
+		if ( cache && base && base->state.GetNumBitsWritten() == cache->state.GetNumBitsWritten() &&
+				memcmp( base->state.GetData(), cache->state.GetData(), cache->state.GetSize() ) == 0 ) {
+			build.changed[i] = false;
+			ent->snapshotAccumulator[clientNum] = 0.0f;
+			continue;
+		}
+
 		// save the write state to which we can revert when the entity didn't change at all
 		msg.SaveWriteState( msgSize, msgWriteBit );
 
 		// write the entity to the snapshot
 		msg.WriteBits( ent->entityNumber, GENTITYNUM_BITS );
 
-		base = clientEntityStates[clientNum][ent->entityNumber];
 		if ( base ) {
 			base->state.BeginReading();
 		}
-		newBase = entityStateAllocator.Alloc();
 		newBase->entityNumber = ent->entityNumber;
 		newBase->state.Init( newBase->stateBuf, sizeof( newBase->stateBuf ) );
 		newBase->state.BeginWriting();
 
 		deltaMsg.Init( base ? &base->state : NULL, &newBase->state, &msg );
 
-		deltaMsg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
-		deltaMsg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
-		deltaMsg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
+		if ( cache ) {
+			deltaMsg.Replay( cache->record );
+		} else {
+			deltaMsg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
+			deltaMsg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
+			deltaMsg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
 
-		// write the class specific data to the snapshot
-		ent->WriteToSnapshot( deltaMsg );
+			// write the class specific data to the snapshot
+			ent->WriteToSnapshot( deltaMsg );
+		}
+
+		build.changed[i] = deltaMsg.HasChanged();
 
-		if ( !deltaMsg.HasChanged() ) {
+		// the client keeps the old state of entities that don't fit, the own player is always sent
+		if ( build.changed[i] && scheduled && msg.GetSize() > entityBytes && ent != build.player ) {
+			build.changed[i] = false;
 			msg.RestoreWriteState( msgSize, msgWriteBit );
-			entityStateAllocator.Free( newBase );
-		} else {
-			newBase->next = snapshot->firstEntityState;
-			snapshot->firstEntityState = newBase;
+			continue;
+		}
+		ent->snapshotAccumulator[clientNum] = 0.0f;
 
+		if ( !build.changed[i] ) {
+			msg.RestoreWriteState( msgSize, msgWriteBit );
+		}
 #if ASYNC_WRITE_TAGS
-			msg.WriteLong( tagRandom.RandomInt() );
-#endif
+		else {
+			msg.WriteLong( build.tagRandom.RandomInt() );
 		}
+#endif
 	}
 
+	entitiesSize = msg.GetSize();
 	msg.WriteBits( ENTITYNUM_NONE, GENTITYNUM_BITS );
 
 	// write the PVS to the snapshot
 #if ASYNC_WRITE_PVS
 	for ( i = 0; i < idEntity::MAX_PVS_AREAS; i++ ) {
-		if ( i < numSourceAreas ) {
-			msg.WriteLong( sourceAreas[ i ] );
+		if ( i < build.numSourceAreas ) {
+			msg.WriteLong( build.sourceAreas[ i ] );
 		} else {
 			msg.WriteLong( 0 );
 		}
 	}
-	gameLocal.pvs.WritePVS( pvsHandle, msg );
+	gameLocal.pvs.WritePVS( build.pvsHandle, msg );
 #endif
 	for ( i = 0; i < ENTITY_PVS_SIZE; i++ ) {
-		msg.WriteDeltaLong( clientPVS[clientNum][i], snapshot->pvs[i] );
+		msg.WriteDeltaLong( clientPVS[clientNum][i], build.snapshot->pvs[i] );
 	}
 
-	// free the PVS
-	pvs.FreeCurrentPVS( pvsHandle );
-
 	// write the game and player state to the snapshot
 	base = clientEntityStates[clientNum][ENTITYNUM_NONE];	// ENTITYNUM_NONE is used for the game and player state
 	if ( base ) {
 		base->state.BeginReading();
 	}
-	newBase = entityStateAllocator.Alloc();
+	newBase = build.newBases[ build.entities.Num() ];
 	newBase->entityNumber = ENTITYNUM_NONE;
-	newBase->next = snapshot->firstEntityState;
-	snapshot->firstEntityState = newBase;
 	newBase->state.Init( newBase->stateBuf, sizeof( newBase->stateBuf ) );
 	newBase->state.BeginWriting();
 	deltaMsg.Init( base ? &base->state : NULL, &newBase->state, &msg );
+
+	idPlayer *player = build.player;
 	if ( player->spectating && player->spectator != player->entityNumber && gameLocal.entities[ player->spectator ] && gameLocal.entities[ player->spectator ]->IsType( idPlayer::Type ) ) {
 		static_cast< idPlayer * >( gameLocal.entities[ player->spectator ] )->WritePlayerStateToSnapshot( deltaMsg );
 	} else {
@@ -695,9 +901,125 @@ void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &ms
 	}
 	WriteGameStateToSnapshot( deltaMsg );
 
+	// keep room for the end of the next snapshot
+	build.reserveBytes = msg.GetSize() - entitiesSize;
+}
+
+/*
+================
+idGameLocal::ServerFinishSnapshot
+
+  Links the changed entity states to the snapshot and frees the others.
+================
+*/
+void idGameLocal::ServerFinishSnapshot( snapshotBuild_t &build, int numPVSClients ) {
+	int i;
+	entityState_t *newBase;
+
+	for ( i = 0; i < build.newBases.Num(); i++ ) {
+		newBase = build.newBases[i];
+
+		// the game and player state is always kept
+		if ( i < build.entities.Num() && !build.changed[i] ) {
+			entityStateAllocator.Free( newBase );
+			continue;
+		}
+
+		newBase->next = build.snapshot->firstEntityState;
+		build.snapshot->firstEntityState = newBase;
+	}
+
+#if ASYNC_WRITE_PVS
+	// free the PVS
+	pvs.FreeCurrentPVS( build.pvsHandle );
+#endif
+
 	// copy the client PVS string
-	memcpy( clientInPVS, snapshot->pvs, ( numPVSClients + 7 ) >> 3 );
-	LittleRevBytes( clientInPVS, sizeof( int ), sizeof( clientInPVS ) / sizeof ( int ) );
+	memcpy( build.clientInPVS, build.snapshot->pvs, ( numPVSClients + 7 ) >> 3 );
+	LittleRevBytes( build.clientInPVS, sizeof( int ), sizeof( build.clientInPVS ) / sizeof ( int ) );
+}
+
+/*
+================
+idGameLocal::ServerWriteSnapshotJob
+================
+*/
+void idGameLocal::ServerWriteSnapshotJob( void *data ) {
+	gameLocal.ServerWriteSnapshotEntities( *reinterpret_cast< snapshotBuild_t * >( data ) );
+}
+
+/*
+================
+idGameLocal::ServerWriteSnapshot
+
+  Write a snapshot of the current game state for the given client.
+================
+*/
+void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &msg, byte *clientInPVS, int numPVSClients ) {
+	snapshotRequest_t request;
+
+	request.clientNum = clientNum;
+	request.sequence = sequence;
+	request.msg = &msg;
+	request.clientInPVS = clientInPVS;
+	request.maxBytes = 0;
+
+	ServerWriteSnapshots( &request, 1, numPVSClients );
+}
+
+/*
+================
+idGameLocal::ServerWriteSnapshots
+
+  Write the snapshots for several clients. Everything that touches shared game state
+  runs on the main thread before and after the entity states are written in parallel.
+  The entity states are written once and shared by all the snapshots.
+================
+*/
+void idGameLocal::ServerWriteSnapshots( snapshotRequest_t *requests, int numRequests, int numPVSClients ) {
+	int i, numBuilds;
+	bool parallel, cacheEntities;
+	snapshotBuild_t *builds[ MAX_CLIENTS ];
+
+	// the PVS handles are kept until the snapshot is finished when the PVS is written
+	parallel = net_parallelSnapshots.GetBool() && numRequests > 1 && !ASYNC_WRITE_PVS;
+	cacheEntities = net_snapshotCache.GetBool() && numRequests > 1;
+
+	// the entity states written for the previous snapshots are outdated
+	snapshotCacheFrame++;
+
+	numBuilds = 0;
+	for ( i = 0; i < numRequests; i++ ) {
+		snapshotBuild_t &build = snapshotBuilds[ requests[i].clientNum ];
+
+		build.clientNum = requests[i].clientNum;
+		build.sequence = requests[i].sequence;
+		build.msg = requests[i].msg;
+		build.clientInPVS = requests[i].clientInPVS;
+		build.maxBytes = requests[i].maxBytes;
+
+		if ( !ServerPrepareSnapshot( build, cacheEntities ) ) {
+			continue;
+		}
+		if ( parallel ) {
+			builds[ numBuilds++ ] = &build;
+			snapshotJobList.AddJob( ServerWriteSnapshotJob, &build );
+		} else {
+			ServerWriteSnapshotEntities( build );
+			ServerFinishSnapshot( build, numPVSClients );
+		}
+	}
+
+	if ( !parallel ) {
+		return;
+	}
+
+	snapshotJobList.Submit();
+	snapshotJobList.Wait();
+
+	for ( i = 0; i < numBuilds; i++ ) {
+		ServerFinishSnapshot( *builds[i], numPVSClients );
+	}
 }
 
 /*
@@ -64,8 +64,8 @@ class idPVS {
 public:
 						idPVS( void );
 						~idPVS( void );
-						// setup for the current map
-	void				Init( void );
+						// setup for the current map, the PVS is cached in generated/pvs/ when the map name is given
+	void				Init( const char *mapName = NULL );
 	void				Shutdown( void );
 						// get the area(s) the source is in
 	int					GetPVSArea( const idVec3 &point ) const;		// returns the area number
@@ -121,11 +121,17 @@ private:
 	void				FloodFrontPortalPVS_r( struct pvsPortal_s *portal, int areaNum ) const;
 	void				FrontPortalPVS( void ) const;
 	struct pvsStack_s *	FloodPassagePVS_r( struct pvsPortal_s *source, const struct pvsPortal_s *portal, struct pvsStack_s *prevStack ) const;
+	void				FloodPassagePVS( int firstPortal, int numFloodPortals, bool markDone ) const;
+	static void			FloodPassagePVSJob( void *data );
 	void				PassagePVS( void ) const;
 	void				AddPassageBoundaries( const idWinding &source, const idWinding &pass, bool flipClip, idPlane *bounds, int &numBounds, int maxBounds ) const;
 	void				CreatePassages( void ) const;
 	void				DestroyPassages( void ) const;
 	int					AreaPVSFromPortalPVS( void ) const;
+	int					CountVisibleAreas( void ) const;
+	void				PVSCacheFileName( const char *mapName, idStr &fileName, idStr &procName ) const;
+	bool				LoadPVSCache( const char *fileName, unsigned long procChecksum );
+	void				WritePVSCache( const char *fileName, unsigned long procChecksum ) const;
 	void				GetConnectedAreas( int srcArea, bool *connectedAreas ) const;
 	pvsHandle_t			AllocCurrentPVS( unsigned int h ) const;
 };
@@ -50,6 +50,9 @@ idMD5Anim::idMD5Anim() {
 	numJoints	= 0;
 	frameRate	= 24;
 	animLength	= 0;
+	numAnimatedComponents = 0;
+	numTracks	= 0;
+	uncompressedSize = 0;
 	totaldelta.Zero();
 }
 
@@ -78,7 +81,16 @@ void idMD5Anim::Free( void ) {
 
 	jointInfo.Clear();
 	bounds.Clear();
-	componentFrames.Clear();
+
+	numTracks	= 0;
+	constantComponents.Clear();
+	trackComponents.Clear();
+	trackScale.Clear();
+	trackBias.Clear();
+	trackFrames.Clear();
+	keyFrames.Clear();
+	frameKeys.Clear();
+	uncompressedSize = 0;
 }
 
 /*
@@ -146,10 +158,23 @@ idMD5Anim::Allocated
 ====================
 */
 size_t idMD5Anim::Allocated( void ) const {
-	size_t	size = bounds.Allocated() + jointInfo.Allocated() + componentFrames.Allocated() + name.Allocated();
+	size_t	size = bounds.Allocated() + jointInfo.Allocated() + baseFrame.Allocated() + name.Allocated();
+	size += constantComponents.Allocated() + trackComponents.Allocated() + trackScale.Allocated() + trackBias.Allocated();
+	size += trackFrames.Allocated() + keyFrames.Allocated() + frameKeys.Allocated();
 	return size;
 }
 
+/*
+====================
+idMD5Anim::UncompressedSize
+
+Size the anim would have with the float frames of the .md5anim
+====================
+*/
+size_t idMD5Anim::UncompressedSize( void ) const {
+	return sizeof( *this ) + bounds.Allocated() + jointInfo.Allocated() + baseFrame.Allocated() + name.Allocated() + uncompressedSize;
+}
+
 /*
 ====================
 idMD5Anim::LoadAnim
@@ -161,6 +186,7 @@ bool idMD5Anim::LoadAnim( const char *filename ) {
 	idToken	token;
 	int		i, j;
 	int		num;
+	idList<float> componentFrames;
 
 	if ( !parser.LoadFile( filename ) ) {
 		return false;
@@ -323,10 +349,253 @@ bool idMD5Anim::LoadAnim( const char *filename ) {
 	// we don't count last frame because it would cause a 1 frame pause at the end
 	animLength = ( ( numFrames - 1 ) * 1000 + frameRate - 1 ) / frameRate;
 
+	Compress( componentFrames );
+
 	// done
 	return true;
 }
 
+/*
+====================
+CanInterpolateFrames
+
+Returns true if every frame between firstFrame and lastFrame can be linearly
+interpolated from those two within the error bounds of the tracks
+====================
+*/
+static bool CanInterpolateFrames( const float *componentFrames, int numAnimatedComponents, const int *trackComponents, const float *trackError, int numTracks, int firstFrame, int lastFrame ) {
+	const float *first = componentFrames + firstFrame * numAnimatedComponents;
+	const float *last = componentFrames + lastFrame * numAnimatedComponents;
+	float scale = 1.0f / ( lastFrame - firstFrame );
+
+	for ( int i = firstFrame + 1; i < lastFrame; i++ ) {
+		const float *frame = componentFrames + i * numAnimatedComponents;
+		float lerp = ( i - firstFrame ) * scale;
+		for ( int j = 0; j < numTracks; j++ ) {
+			int c = trackComponents[ j ];
+			float value = first[ c ] + ( last[ c ] - first[ c ] ) * lerp;
+			if ( idMath::Fabs( value - frame[ c ] ) > trackError[ j ] ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+====================
+idMD5Anim::Compress
+
+Components that stay the same over the whole anim are stored once in
+constantComponents.  The others become tracks quantized to 16 bits over
+their own range.  If g_animMaxTranslationError or g_animMaxRotationError are
+set, frames that can be interpolated from their neighbours within those
+bounds are dropped, the remaining key frames are interpolated on decode.
+====================
+*/
+void idMD5Anim::Compress( const idList<float> &componentFrames ) {
+	int i, j;
+
+	uncompressedSize = componentFrames.Num() * sizeof( float );
+
+	constantComponents.SetGranularity( 1 );
+	constantComponents.SetNum( numAnimatedComponents );
+	trackComponents.SetGranularity( 1 );
+	trackScale.SetGranularity( 1 );
+	trackBias.SetGranularity( 1 );
+	trackFrames.SetGranularity( 1 );
+	keyFrames.SetGranularity( 1 );
+	frameKeys.SetGranularity( 1 );
+
+	// find the components that change
+	idList<float> trackMin;
+	numTracks = 0;
+	for ( i = 0; i < numAnimatedComponents; i++ ) {
+		float min = componentFrames[ i ];
+		float max = componentFrames[ i ];
+		for ( j = 1; j < numFrames; j++ ) {
+			float value = componentFrames[ j * numAnimatedComponents + i ];
+			if ( value < min ) {
+				min = value;
+			} else if ( value > max ) {
+				max = value;
+			}
+		}
+
+		constantComponents[ i ] = ( min + max ) * 0.5f;
+		if ( max - min <= 1e-6f ) {
+			continue;
+		}
+
+		float scale = ( max - min ) / 65535.0f;
+		trackComponents.Append( i );
+		trackScale.Append( scale );
+		trackBias.Append( min + 32768.0f * scale );
+		trackMin.Append( min );
+		numTracks++;
+	}
+
+	// pick the key frames
+	idList<int> keys;
+	keys.SetGranularity( 64 );
+	keys.Append( 0 );
+
+	float maxTranslationError = g_animMaxTranslationError.GetFloat();
+	float maxRotationError = g_animMaxRotationError.GetFloat();
+	if ( numTracks && numFrames > 2 && ( maxTranslationError > 0.0f || maxRotationError > 0.0f ) ) {
+		// the error bound of each track depends on what it animates
+		idList<bool> isTranslation;
+		isTranslation.SetNum( numAnimatedComponents );
+		for ( i = 0; i < jointInfo.Num(); i++ ) {
+			int c = jointInfo[ i ].firstComponent;
+			for ( j = 0; j < 6; j++ ) {
+				if ( jointInfo[ i ].animBits & ( 1 << j ) ) {
+					isTranslation[ c++ ] = ( j < 3 );
+				}
+			}
+		}
+
+		// the tracks lose up to half a quantization step on top of the interpolation
+		float *trackError = (float *)_alloca16( numTracks * sizeof( float ) );
+		for ( i = 0; i < numTracks; i++ ) {
+			trackError[ i ] = isTranslation[ trackComponents[ i ] ] ? maxTranslationError : maxRotationError;
+			trackError[ i ] = Max( trackError[ i ] - trackScale[ i ] * 0.5f, 0.0f );
+		}
+
+		int first = 0;
+		while ( first < numFrames - 1 ) {
+			int last = first + 1;
+			while ( last + 1 < numFrames && CanInterpolateFrames( componentFrames.Ptr(), numAnimatedComponents, trackComponents.Ptr(), trackError, numTracks, first, last + 1 ) ) {
+				last++;
+			}
+			keys.Append( last );
+			first = last;
+		}
+	} else {
+		for ( i = 1; i < numFrames; i++ ) {
+			keys.Append( i );
+		}
+	}
+
+	if ( keys.Num() < numFrames ) {
+		keyFrames = keys;
+		frameKeys.SetNum( numFrames );
+		for ( i = 0; i < keyFrames.Num(); i++ ) {
+			int end = ( i + 1 < keyFrames.Num() ) ? keyFrames[ i + 1 ] : numFrames;
+			for ( j = keyFrames[ i ]; j < end; j++ ) {
+				frameKeys[ j ] = i;
+			}
+		}
+	}
+
+	// quantize the key frames
+	trackFrames.SetNum( keys.Num() * numTracks );
+	for ( i = 0; i < keys.Num(); i++ ) {
+		const float *frame = &componentFrames[ keys[ i ] * numAnimatedComponents ];
+		short *quantized = trackFrames.Ptr() + i * numTracks;
+		for ( j = 0; j < numTracks; j++ ) {
+			int value = (int)( ( frame[ trackComponents[ j ] ] - trackMin[ j ] ) / trackScale[ j ] + 0.5f );
+			quantized[ j ] = idMath::ClampInt( 0, 65535, value ) - 32768;
+		}
+	}
+}
+
+/*
+====================
+idMD5Anim::FindKeyFrame
+
+Returns the key frame at or before framenum, and how far framenum is towards the next key frame
+====================
+*/
+int idMD5Anim::FindKeyFrame( int framenum, float &lerp ) const {
+	lerp = 0.0f;
+
+	if ( !frameKeys.Num() ) {
+		return framenum;
+	}
+
+	int key = frameKeys[ framenum ];
+	if ( keyFrames[ key ] != framenum ) {
+		lerp = ( framenum - keyFrames[ key ] ) / (float)( keyFrames[ key + 1 ] - keyFrames[ key ] );
+	}
+	return key;
+}
+
+/*
+====================
+idMD5Anim::DecodeFrame
+
+Decodes all the animated components of a frame
+====================
+*/
+void idMD5Anim::DecodeFrame( int framenum, float *components ) const {
+	int		i;
+	float	lerp;
+
+	SIMDProcessor->Memcpy( components, constantComponents.Ptr(), numAnimatedComponents * sizeof( float ) );
+
+	if ( !numTracks ) {
+		return;
+	}
+
+	int key = FindKeyFrame( framenum, lerp );
+
+	float *tracks = (float *)_alloca16( numTracks * sizeof( float ) );
+	SIMDProcessor->Dequantize( tracks, trackFrames.Ptr() + key * numTracks, trackScale.Ptr(), trackBias.Ptr(), numTracks );
+
+	if ( lerp > 0.0f ) {
+		float *nextTracks = (float *)_alloca16( numTracks * sizeof( float ) );
+		SIMDProcessor->Dequantize( nextTracks, trackFrames.Ptr() + ( key + 1 ) * numTracks, trackScale.Ptr(), trackBias.Ptr(), numTracks );
+		for ( i = 0; i < numTracks; i++ ) {
+			tracks[ i ] += ( nextTracks[ i ] - tracks[ i ] ) * lerp;
+		}
+	}
+
+	for ( i = 0; i < numTracks; i++ ) {
+		components[ trackComponents[ i ] ] = tracks[ i ];
+	}
+}
+
+/*
+====================
+idMD5Anim::DecodeJoint
+
+Decodes the animated components of a single joint, components must hold 6 floats
+====================
+*/
+void idMD5Anim::DecodeJoint( int framenum, int jointNum, float *components ) const {
+	const jointAnimInfo_t *infoPtr = &jointInfo[ jointNum ];
+	int		numComponents;
+	float	lerp;
+
+	numComponents = 0;
+	for ( int i = 0; i < 6; i++ ) {
+		if ( infoPtr->animBits & ( 1 << i ) ) {
+			numComponents++;
+		}
+	}
+
+	int key = FindKeyFrame( framenum, lerp );
+	const short *frame1 = trackFrames.Ptr() + key * numTracks;
+	const short *frame2 = ( lerp > 0.0f ) ? frame1 + numTracks : frame1;
+
+	// the tracks are in component order, so the tracks of the joint follow each other
+	for ( int i = 0; i < numComponents; i++ ) {
+		int c = infoPtr->firstComponent + i;
+		int t = 0;
+		while ( t < numTracks && trackComponents[ t ] < c ) {
+			t++;
+		}
+		if ( t >= numTracks || trackComponents[ t ] != c ) {
+			components[ i ] = constantComponents[ c ];
+			continue;
+		}
+		float value1 = trackBias[ t ] + trackScale[ t ] * frame1[ t ];
+		float value2 = trackBias[ t ] + trackScale[ t ] * frame2[ t ];
+		components[ i ] = value1 + ( value2 - value1 ) * lerp;
+	}
+}
+
 /*
 ====================
 idMD5Anim::IncreaseRefs
@@ -442,8 +711,12 @@ void idMD5Anim::GetOrigin( idVec3 &offset, int time, int cyclecount ) const {
 
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float *componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float *componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	float components1[ 6 ], components2[ 6 ];
+	DecodeJoint( frame.frame1, 0, components1 );
+	DecodeJoint( frame.frame2, 0, components2 );
+
+	const float *componentPtr1 = components1;
+	const float *componentPtr2 = components2;
 
 	if ( jointInfo[ 0 ].animBits & ANIM_TX ) {
 		offset.x = *componentPtr1 * frame.frontlerp + *componentPtr2 * frame.backlerp;
@@ -484,8 +757,12 @@ void idMD5Anim::GetOriginRotation( idQuat &rotation, int time, int cyclecount )
 
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float	*jointframe1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float	*jointframe2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	float components1[ 6 ], components2[ 6 ];
+	DecodeJoint( frame.frame1, 0, components1 );
+	DecodeJoint( frame.frame2, 0, components2 );
+
+	const float	*jointframe1 = components1;
+	const float	*jointframe2 = components2;
 
 	if ( animBits & ANIM_TX ) {
 		jointframe1++;
@@ -598,8 +875,12 @@ void idMD5Anim::GetBounds( idBounds &bnds, int time, int cyclecount ) const {
 	// origin position
 	offset = baseFrame[ 0 ].t;
 	if ( jointInfo[ 0 ].animBits & ( ANIM_TX | ANIM_TY | ANIM_TZ ) ) {
-		const float *componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-		const float *componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+		float components1[ 6 ], components2[ 6 ];
+		DecodeJoint( frame.frame1, 0, components1 );
+		DecodeJoint( frame.frame2, 0, components2 );
+
+		const float *componentPtr1 = components1;
+		const float *componentPtr2 = components2;
 
 		if ( jointInfo[ 0 ].animBits & ANIM_TX ) {
 			offset.x = *componentPtr1 * frame.frontlerp + *componentPtr2 * frame.backlerp;
@@ -652,8 +933,17 @@ void idMD5Anim::GetInterpolatedFrame( frameBlend_t &frame, idJointQuat *joints,
 	lerpIndex = (int *)_alloca16( baseFrame.Num() * sizeof( lerpIndex[ 0 ] ) );
 	numLerpJoints = 0;
 
-	frame1 = &componentFrames[ frame.frame1 * numAnimatedComponents ];
-	frame2 = &componentFrames[ frame.frame2 * numAnimatedComponents ];
+	float *components1 = (float *)_alloca16( numAnimatedComponents * sizeof( float ) );
+	DecodeFrame( frame.frame1, components1 );
+	frame1 = components1;
+
+	if ( frame.frame2 != frame.frame1 ) {
+		float *components2 = (float *)_alloca16( numAnimatedComponents * sizeof( float ) );
+		DecodeFrame( frame.frame2, components2 );
+		frame2 = components2;
+	} else {
+		frame2 = frame1;
+	}
 
 	for ( i = 0; i < numIndexes; i++ ) {
 		int j = index[i];
@@ -833,7 +1123,9 @@ void idMD5Anim::GetSingleFrame( int framenum, idJointQuat *joints, const int *in
 		return;
 	}
 
-	frame = &componentFrames[ framenum * numAnimatedComponents ];
+	float *components = (float *)_alloca16( numAnimatedComponents * sizeof( float ) );
+	DecodeFrame( framenum, components );
+	frame = components;
 
 	for ( i = 0; i < numIndexes; i++ ) {
 		int j = index[i];
@@ -1036,18 +1328,23 @@ void idAnimManager::ListAnims( void ) const {
 	idMD5Anim	*anim;
 	size_t		size;
 	size_t		s;
+	size_t		u;
+	size_t		uncompressed;
 	size_t		namesize;
 	int			num;
 
 	num = 0;
 	size = 0;
+	uncompressed = 0;
 	for( i = 0; i < animations.Num(); i++ ) {
 		animptr = animations.GetIndex( i );
 		if ( animptr && *animptr ) {
 			anim = *animptr;
 			s = anim->Size();
-			gameLocal.Printf( "%8d bytes : %2d refs : %s\n", s, anim->NumRefs(), anim->Name() );
+			u = anim->UncompressedSize();
+			gameLocal.Printf( "%8d bytes (%3d%%) : %2d refs : %s\n", (int)s, u ? (int)( s * 100 / u ) : 100, anim->NumRefs(), anim->Name() );
 			size += s;
+			uncompressed += u;
 			num++;
 		}
 	}
@@ -1058,6 +1355,7 @@ void idAnimManager::ListAnims( void ) const {
 	}
 
 	gameLocal.Printf( "\n%d memory used in %d anims\n", size, num );
+	gameLocal.Printf( "%d memory saved by compression\n", (int)( uncompressed - size ) );
 	gameLocal.Printf( "%d memory used in %d joint names\n", namesize, jointnames.Num() );
 }
 
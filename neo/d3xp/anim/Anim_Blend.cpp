@@ -3079,6 +3079,10 @@ const idVec3 &idDeclModelDef::GetVisualOffset( void ) const {
 
 ***********************************************************************/
 
+// animators waiting for CreateQueuedFrames
+static idList<idAnimator *>		queuedFrames;
+static idParallelJobList		frameJobList( "animFrames" );
+
 /*
 =====================
 idAnimator::idAnimator
@@ -3095,6 +3099,10 @@ idAnimator::idAnimator() {
 	stoppedAnimatingUpdate	= false;
 	removeOriginOffset		= false;
 	forceUpdate				= false;
+	lod						= ANIMLOD_FULL;
+	frameLOD				= ANIMLOD_FULL;
+	frameQueued				= false;
+	pendingFrame			= false;
 
 	frameBounds.Clear();
 
@@ -3117,6 +3125,9 @@ idAnimator::~idAnimator
 =====================
 */
 idAnimator::~idAnimator() {
+	if ( frameQueued ) {
+		queuedFrames.Remove( this );
+	}
 	FreeData();
 }
 
@@ -4150,6 +4161,9 @@ void idAnimator::ClearAFPose( void ) {
 	AFPoseTime = 0;
 }
 
+// faded out anims below this weight are skipped at ANIMLOD_LOW
+static const float ANIM_LOD_MIN_BLEND_WEIGHT = 0.1f;
+
 /*
 =====================
 idAnimator::ServiceAnims
@@ -4247,24 +4261,118 @@ bool idAnimator::FrameHasChanged( int currentTime ) const {
 	return false;
 }
 
+/*
+=====================
+idAnimator::SetLOD
+=====================
+*/
+void idAnimator::SetLOD( animLOD_t newLOD ) {
+	if ( newLOD < lod ) {
+		// show the extra detail right away
+		lastTransformTime = -1;
+	}
+	lod = newLOD;
+}
+
+/*
+=====================
+idAnimator::GetLOD
+=====================
+*/
+animLOD_t idAnimator::GetLOD( void ) const {
+	return lod;
+}
+
+/*
+=====================
+idAnimator::QueueFrame
+=====================
+*/
+void idAnimator::QueueFrame( void ) {
+	if ( !frameQueued ) {
+		frameQueued = true;
+		queuedFrames.Append( this );
+	}
+}
+
+/*
+=====================
+idAnimator::BuildFrameJob
+=====================
+*/
+void idAnimator::BuildFrameJob( void *data ) {
+	idAnimator *animator = static_cast<idAnimator *>( data );
+	animator->pendingFrame = animator->BuildFrame( animator->lastTransformTime, false );
+}
+
+/*
+=====================
+idAnimator::CreateQueuedFrames
+
+Builds the poses of all queued animators after the entities have thought.
+Each animator only writes its own joints, so the blending and the joint
+transforms run as parallel jobs.  The render callback picks up the pose
+through pendingFrame.
+=====================
+*/
+void idAnimator::CreateQueuedFrames( int currentTime ) {
+	int i;
+	bool debugInfo;
+
+	for ( i = 0; i < queuedFrames.Num(); i++ ) {
+		idAnimator *animator = queuedFrames[i];
+		animator->frameQueued = false;
+
+		if ( !animator->SetupFrame( currentTime, false, true, debugInfo ) ) {
+			continue;
+		}
+
+		// the debug output has to stay in order
+		if ( debugInfo || !g_parallelAnimation.GetBool() ) {
+			animator->pendingFrame = animator->BuildFrame( currentTime, debugInfo );
+			continue;
+		}
+
+		animator->pendingFrame = false;
+		frameJobList.AddJob( BuildFrameJob, animator );
+	}
+	queuedFrames.SetNum( 0, false );
+
+	frameJobList.Submit();
+	frameJobList.Wait();
+}
+
 /*
 =====================
 idAnimator::CreateFrame
 =====================
 */
-bool idAnimator::CreateFrame( int currentTime, bool force ) {
-	int					i, j;
-	int					numJoints;
-	int					parentNum;
-	bool				hasAnim;
-	bool				debugInfo;
-	float				baseBlend;
-	float				blendWeight;
-	const idAnimBlend *	blend;
-	const int *			jointParent;
-	const jointMod_t *	jointMod;
-	const idJointQuat *	defaultPose;
+bool idAnimator::CreateFrame( int currentTime, bool force, bool useLOD ) {
+	bool debugInfo;
 
+	if ( pendingFrame && useLOD ) {
+		pendingFrame = false;
+		if ( !force && lastTransformTime == currentTime ) {
+			// CreateQueuedFrames already built it
+			return true;
+		}
+	}
+
+	if ( !SetupFrame( currentTime, force, useLOD, debugInfo ) ) {
+		return false;
+	}
+
+	return BuildFrame( currentTime, debugInfo );
+}
+
+/*
+=====================
+idAnimator::SetupFrame
+
+Decides if the pose has to be built, returns false if it can stay as it is.
+=====================
+*/
+bool idAnimator::SetupFrame( int currentTime, bool force, bool useLOD, bool &debugInfo ) {
 	static idCVar		r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 
 	if ( gameLocal.inCinematic && gameLocal.skipCinematic ) {
@@ -4276,16 +4384,28 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 	}
 
 	if ( !force && !r_showSkel.GetInteger() ) {
-		if ( lastTransformTime == currentTime ) {
+		// joint queries need every channel, even if the last frame was built with less detail
+		bool detailed = ( useLOD || frameLOD == ANIMLOD_FULL );
+
+		if ( lastTransformTime == currentTime && detailed ) {
 			return false;
 		}
-		if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) ) {
+		if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) && detailed ) {
+			return false;
+		}
+
+		// distant actors keep their pose for a few frames
+		if ( useLOD && lod != ANIMLOD_FULL && lastTransformTime != -1 && !stoppedAnimatingUpdate &&
+			currentTime > lastTransformTime && currentTime - lastTransformTime < ( gameLocal.msec << lod ) ) {
+			gameLocal.animLODStats.numFramesSkipped++;
 			return false;
 		}
 	}
 
 	lastTransformTime = currentTime;
 	stoppedAnimatingUpdate = false;
+	frameLOD = useLOD ? lod : ANIMLOD_FULL;
+	gameLocal.animLODStats.numFramesCreated++;
 
 	if ( entity && ( ( g_debugAnim.GetInteger() == entity->entityNumber ) || ( g_debugAnim.GetInteger() == -2 ) ) ) {
 		debugInfo = true;
@@ -4295,6 +4415,29 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 		debugInfo = false;
 	}
 
+	return true;
+}
+
+/*
+=====================
+idAnimator::BuildFrame
+
+Blends the anims and transforms the joints.  Only touches the animator
+itself, so it can run as a job unless debugInfo is set.
+=====================
+*/
+bool idAnimator::BuildFrame( int currentTime, bool debugInfo ) {
+	int					i, j;
+	int					numJoints;
+	int					parentNum;
+	bool				hasAnim;
+	float				baseBlend;
+	float				blendWeight;
+	const idAnimBlend *	blend;
+	const int *			jointParent;
+	const jointMod_t *	jointMod;
+	const idJointQuat *	defaultPose;
+
 	// init the joint buffer
 	if ( AFPoseJoints.Num() ) {
 		// initialize with AF pose anim for the case where there are no other animations and no AF pose joint modifications
@@ -4318,6 +4461,10 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 	baseBlend = 0.0f;
 	blend = channels[ ANIMCHANNEL_ALL ];
 	for( j = 0; j < ANIM_MaxAnimsPerChannel; j++, blend++ ) {
+		if ( frameLOD >= ANIMLOD_LOW && j > 0 && blend->GetWeight( currentTime ) < ANIM_LOD_MIN_BLEND_WEIGHT ) {
+			// skip the anims that have almost faded out
+			continue;
+		}
 		if ( blend->BlendAnim( currentTime, ANIMCHANNEL_ALL, numJoints, jointFrame, baseBlend, removeOriginOffset, false, debugInfo ) ) {
 			hasAnim = true;
 			if ( baseBlend >= 1.0f ) {
@@ -4336,9 +4483,16 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 				// eyelids blend over any previous anims, so skip it and blend it later
 				continue;
 			}
+			if ( i == ANIMCHANNEL_HEAD && frameLOD >= ANIMLOD_LOW ) {
+				// the face is too small to see
+				continue;
+			}
 			blendWeight = baseBlend;
 			blend = channels[ i ];
 			for( j = 0; j < ANIM_MaxAnimsPerChannel; j++, blend++ ) {
+				if ( frameLOD >= ANIMLOD_LOW && j > 0 && blend->GetWeight( currentTime ) < ANIM_LOD_MIN_BLEND_WEIGHT ) {
+					continue;
+				}
 				if ( blend->BlendAnim( currentTime, i, numJoints, jointFrame, blendWeight, removeOriginOffset, false, debugInfo ) ) {
 					hasAnim = true;
 					if ( blendWeight >= 1.0f ) {
@@ -4355,7 +4509,7 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 	}
 
 	// blend in the eyelids
-	if ( modelDef->NumJointsOnChannel( ANIMCHANNEL_EYELIDS ) ) {
+	if ( modelDef->NumJointsOnChannel( ANIMCHANNEL_EYELIDS ) && frameLOD == ANIMLOD_FULL ) {
 		blend = channels[ ANIMCHANNEL_EYELIDS ];
 		blendWeight = baseBlend;
 		for( j = 0; j < ANIM_MaxAnimsPerChannel; j++, blend++ ) {
@@ -136,6 +136,13 @@ idCVar g_muzzleFlashLightLodBias(   "g_muzzleFlashLightLodBias", "2",
 idCVar g_disasm(					"g_disasm",					"0",			CVAR_GAME | CVAR_BOOL, "disassemble script into base/script/disasm.txt on the local drive when script is compiled" );
 idCVar g_debugBounds(				"g_debugBounds",			"0",			CVAR_GAME | CVAR_BOOL, "checks for models with bounds > 2048" );
 idCVar g_debugAnim(					"g_debugAnim",				"-1",			CVAR_GAME | CVAR_INTEGER, "displays information on which animations are playing on the specified entity number.  set to -1 to disable." );
+idCVar g_animMaxTranslationError(	"g_animMaxTranslationError", "0",			CVAR_GAME | CVAR_FLOAT, "animation frames are dropped when interpolating their neighbours moves no joint further than this, 0 keeps every frame.  applies to anims loaded afterwards" );
+idCVar g_animLod(					"g_animLod",				"1",			CVAR_GAME | CVAR_BOOL, "distant, small and hidden actors update their pose less often and with fewer channels" );
+idCVar g_animLodDistance(			"g_animLodDistance",		"768",			CVAR_GAME | CVAR_FLOAT, "distance at which a human sized actor in a 90 degree view drops to the reduced animation level of detail, the low level starts at twice the distance" );
+idCVar g_animLodHysteresis(			"g_animLodHysteresis",		"0.1",			CVAR_GAME | CVAR_FLOAT, "fraction of the distance an actor has to move past an animation level of detail threshold before it switches", 0.0f, 0.5f );
+idCVar g_parallelAnimation(		"g_parallelAnimation",		"1",			CVAR_GAME | CVAR_BOOL, "builds the poses of the visible animated entities as parallel jobs after think" );
+idCVar g_animLodStats(				"g_animLodStats",			"0",			CVAR_GAME | CVAR_BOOL, "prints the animation level of detail counts for each game frame" );
+idCVar g_animMaxRotationError(		"g_animMaxRotationError",	"0",			CVAR_GAME | CVAR_FLOAT, "animation frames are dropped when interpolating their neighbours changes no joint quaternion component more than this, 0 keeps every frame.  applies to anims loaded afterwards" );
 idCVar g_debugMove(					"g_debugMove",				"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugDamage(				"g_debugDamage",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugWeapon(				"g_debugWeapon",			"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -154,6 +161,8 @@ idCVar g_healthTakeLimit(			"g_healthTakeLimit",		"25",			CVAR_GAME | CVAR_INTEG
 
 
 
+idCVar g_pvsCache(					"g_pvsCache",				"1",			CVAR_GAME | CVAR_BOOL, "cache the PVS in generated/pvs and load it instead of calculating it when the .proc file didn't change" );
+idCVar g_parallelPVS(				"g_parallelPVS",			"1",			CVAR_GAME | CVAR_BOOL, "flood the portal passages for the PVS in parallel jobs" );
 idCVar g_showPVS(					"g_showPVS",				"0",			CVAR_GAME | CVAR_INTEGER, "", 0, 2 );
 idCVar g_showTargets(				"g_showTargets",			"0",			CVAR_GAME | CVAR_BOOL, "draws entities and thier targets.  hidden entities are drawn grey." );
 idCVar g_showTriggers(				"g_showTriggers",			"0",			CVAR_GAME | CVAR_BOOL, "draws trigger entities (orange) and thier targets (green).  disabled triggers are drawn grey." );
@@ -267,6 +276,7 @@ idCVar af_jointFrictionScale(		"af_jointFrictionScale",	"0",			CVAR_GAME | CVAR_
 idCVar af_contactFrictionScale(		"af_contactFrictionScale",	"0",			CVAR_GAME | CVAR_FLOAT, "scales the contact friction" );
 idCVar af_highlightBody(			"af_highlightBody",			"",				CVAR_GAME, "name of the body to highlight" );
 idCVar af_highlightConstraint(		"af_highlightConstraint",	"",				CVAR_GAME, "name of the constraint to highlight" );
+idCVar af_parallelStage(			"af_parallelStage",			"1",			CVAR_GAME | CVAR_BOOL, "simulate the moving articulated figures before the entities think, with the constraints solved as parallel jobs" );
 idCVar af_showTimings(				"af_showTimings",			"0",			CVAR_GAME | CVAR_BOOL, "show articulated figure cpu usage" );
 idCVar af_showConstraints(			"af_showConstraints",		"0",			CVAR_GAME | CVAR_BOOL, "show constraints" );
 idCVar af_showConstraintNames(		"af_showConstraintNames",	"0",			CVAR_GAME | CVAR_BOOL, "show constraint names" );
@@ -289,6 +299,9 @@ idCVar rb_showMass(					"rb_showMass",				"0",			CVAR_GAME | CVAR_BOOL, "show th
 idCVar rb_showInertia(				"rb_showInertia",			"0",			CVAR_GAME | CVAR_BOOL, "show the inertia tensor of each rigid body" );
 idCVar rb_showVelocity(				"rb_showVelocity",			"0",			CVAR_GAME | CVAR_BOOL, "show the velocity of each rigid body" );
 idCVar rb_showActive(				"rb_showActive",			"0",			CVAR_GAME | CVAR_BOOL, "show rigid bodies that are not at rest" );
+idCVar rb_sleepIslands(				"rb_sleepIslands",			"1",			CVAR_GAME | CVAR_BOOL, "put touching rigid bodies to rest together and wake them up together" );
+idCVar g_continuousCollision(		"g_continuousCollision",	"1",			CVAR_GAME | CVAR_BOOL, "use continuous collision detection for bodies and articulated figures flagged with continuousCollision" );
+idCVar rb_showIslands(				"rb_showIslands",			"0",			CVAR_GAME | CVAR_BOOL, "show sleeping islands in green, resting bodies in awake islands in yellow and moving bodies in red" );
 
 // The default values for player movement cvars are set in def/player.def
 idCVar pm_jumpheight(				"pm_jumpheight",			"48",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_FLOAT, "approximate hieght the player can jump" );
@@ -380,6 +393,9 @@ idCVar g_balanceTDM(				"g_balanceTDM",				"1",			CVAR_GAME | CVAR_BOOL, "mainta
 idCVar g_CTFArrows(					"g_CTFArrows",				"1",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_BOOL, "draw arrows over teammates in CTF" );
 #endif
 
+idCVar net_parallelSnapshots(		"net_parallelSnapshots",	"1",			CVAR_GAME | CVAR_BOOL, "write the snapshots for all clients in parallel jobs" );
+idCVar net_snapshotCache(			"net_snapshotCache",		"1",			CVAR_GAME | CVAR_BOOL, "write the entity states once per frame and share them between the client snapshots" );
+idCVar net_snapshotPriority(		"net_snapshotPriority",		"1",			CVAR_GAME | CVAR_BOOL, "send the entities with the highest priority that fit the client rate and postpone the others" );
 idCVar net_clientPredictGUI(		"net_clientPredictGUI",		"1",			CVAR_GAME | CVAR_BOOL, "test guis in networking without prediction" );
 
 idCVar g_voteFlags(					"g_voteFlags",				"0",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_INTEGER | CVAR_ARCHIVE, "vote flags. bit mask of votes not allowed on this server\n"
@@ -54,6 +54,13 @@ extern idCVar   g_muzzleFlashLightLodBias;
 extern idCVar	g_disasm;
 extern idCVar	g_debugBounds;
 extern idCVar	g_debugAnim;
+extern idCVar	g_animMaxTranslationError;
+extern idCVar	g_animMaxRotationError;
+extern idCVar	g_animLod;
+extern idCVar	g_animLodDistance;
+extern idCVar	g_animLodHysteresis;
+extern idCVar	g_animLodStats;
+extern idCVar	g_parallelAnimation;
 extern idCVar	g_debugMove;
 extern idCVar	g_debugDamage;
 extern idCVar	g_debugWeapon;
@@ -71,6 +78,11 @@ extern idCVar	g_healthTakeAmt;
 extern idCVar	g_healthTakeLimit;
 
 extern idCVar	g_showPVS;
+extern idCVar	g_pvsCache;
+extern idCVar	g_parallelPVS;
+extern idCVar	net_parallelSnapshots;
+extern idCVar	net_snapshotCache;
+extern idCVar	net_snapshotPriority;
 extern idCVar	g_showTargets;
 extern idCVar	g_showTriggers;
 extern idCVar	g_showCollisionWorld;
@@ -146,6 +158,7 @@ extern idCVar	af_jointFrictionScale;
 extern idCVar	af_contactFrictionScale;
 extern idCVar	af_highlightBody;
 extern idCVar	af_highlightConstraint;
+extern idCVar	af_parallelStage;
 extern idCVar	af_showTimings;
 extern idCVar	af_showConstraints;
 extern idCVar	af_showConstraintNames;
@@ -168,6 +181,9 @@ extern idCVar	rb_showMass;
 extern idCVar	rb_showInertia;
 extern idCVar	rb_showVelocity;
 extern idCVar	rb_showActive;
+extern idCVar	rb_sleepIslands;
+extern idCVar	rb_showIslands;
+extern idCVar	g_continuousCollision;
 
 extern idCVar	pm_jumpheight;
 extern idCVar	pm_stepsize;
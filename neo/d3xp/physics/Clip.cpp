@@ -31,6 +31,9 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "../Game_local.h"
 
+#define CONTINUOUS_MOTION_MAX_STEPS		16
+#define CONTINUOUS_MOTION_MIN_STEP		1.0f
+
 #define	MAX_SECTOR_DEPTH				12
 #define MAX_SECTORS						((1<<(MAX_SECTOR_DEPTH+1))-1)
 
@@ -1350,6 +1353,63 @@ bool idClip::Motion( trace_t &results, const idVec3 &start, const idVec3 &end, c
 	return ( translationalTrace.fraction < 1.0f || rotationalTrace.fraction < 1.0f );
 }
 
+/*
+============
+idClip::ContinuousMotion
+
+  Motion only sweeps the rotation at the end of the translation, so a body that
+  spins fast while moving can pass through thin geometry. This splits the motion
+  into steps small enough that no point of the model travels further than half
+  the thinnest extent of its bounds per step due to rotation.
+============
+*/
+bool idClip::ContinuousMotion( trace_t &results, const idVec3 &start, const idVec3 &end, const idRotation &rotation,
+								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity ) {
+	int i, numSteps;
+	float maxStep, arc;
+	idVec3 position, delta, stepEnd;
+	idMat3 axis;
+	idRotation stepRotation;
+
+	if ( mdl == NULL || rotation.GetAngle() == 0.0f || rotation.GetVec() == vec3_origin ) {
+		// the swept translation is exact
+		return Motion( results, start, end, rotation, mdl, trmAxis, contentMask, passEntity );
+	}
+
+	const idBounds &bounds = mdl->GetBounds();
+	maxStep = ( bounds[1] - bounds[0] ).x;
+	maxStep = Min( maxStep, ( bounds[1] - bounds[0] ).y );
+	maxStep = Min( maxStep, ( bounds[1] - bounds[0] ).z );
+	maxStep = Max( maxStep * 0.5f, CONTINUOUS_MOTION_MIN_STEP );
+
+	arc = DEG2RAD( idMath::Fabs( rotation.GetAngle() ) ) * bounds.GetRadius();
+	numSteps = idMath::Ftoi( idMath::Ceil( arc / maxStep ) );
+	if ( numSteps <= 1 ) {
+		return Motion( results, start, end, rotation, mdl, trmAxis, contentMask, passEntity );
+	}
+	numSteps = Min( numSteps, CONTINUOUS_MOTION_MAX_STEPS );
+
+	position = start;
+	axis = trmAxis;
+	delta = ( end - start ) * ( 1.0f / numSteps );
+	stepRotation = idRotation( start, rotation.GetVec(), rotation.GetAngle() / numSteps );
+
+	for ( i = 0; i < numSteps; i++ ) {
+		stepEnd = ( i == numSteps - 1 ) ? end : position + delta;
+		stepRotation.SetOrigin( position );
+
+		if ( Motion( results, position, stepEnd, stepRotation, mdl, axis, contentMask, passEntity ) ) {
+			results.fraction = ( i + results.fraction ) / numSteps;
+			return true;
+		}
+
+		position = results.endpos;
+		axis = results.endAxis;
+	}
+
+	return false;
+}
+
 /*
 ============
 idClip::Contacts
@@ -60,6 +60,9 @@ const idVec6 vec6_lcp_epsilon				= idVec6( LCP_EPSILON, LCP_EPSILON, LCP_EPSILON
 static int lastTimerReset = 0;
 static int numArticulatedFigures = 0;
 static idTimer timer_total, timer_pc, timer_ac, timer_collision, timer_lcp;
+// the timers are shared by all figures, they only run with af_showTimings when the figures are evaluated one at a time
+#define AF_TIMER_START( timer )		if ( af_showTimings.GetBool() ) { timer.Start(); }
+#define AF_TIMER_STOP( timer )		if ( af_showTimings.GetBool() ) { timer.Stop(); }
 #endif
 
 
@@ -5220,7 +5223,7 @@ void idPhysics_AF::AuxiliaryForces( float timeStep ) {
 	}
 
 #ifdef AF_TIMINGS
-	timer_lcp.Start();
+	AF_TIMER_START( timer_lcp );
 #endif
 
 	// calculate lagrange multipliers for auxiliary constraints
@@ -5229,7 +5232,7 @@ void idPhysics_AF::AuxiliaryForces( float timeStep ) {
 	}
 
 #ifdef AF_TIMINGS
-	timer_lcp.Stop();
+	AF_TIMER_STOP( timer_lcp );
 #endif
 
 	// calculate auxiliary constraint forces
@@ -5543,6 +5546,7 @@ void idPhysics_AF::CheckForCollisions( float timeStep ) {
 	idRotation rotation;
 	trace_t collision;
 	idEntity *passEntity;
+	bool hit;
 
 	// clear list with collisions
 	collisions.SetNum( 0, false );
@@ -5570,9 +5574,16 @@ void idPhysics_AF::CheckForCollisions( float timeStep ) {
 			rotation = axis.ToRotation();
 			rotation.SetOrigin( body->current->worldOrigin );
 
+			if ( continuousCollision && g_continuousCollision.GetBool() ) {
+				hit = gameLocal.clip.ContinuousMotion( collision, body->current->worldOrigin, body->next->worldOrigin, rotation,
+											body->clipModel, body->current->worldAxis, body->clipMask, passEntity );
+			} else {
+				hit = gameLocal.clip.Motion( collision, body->current->worldOrigin, body->next->worldOrigin, rotation,
+											body->clipModel, body->current->worldAxis, body->clipMask, passEntity );
+			}
+
 			// if there was a collision
-			if ( gameLocal.clip.Motion( collision, body->current->worldOrigin, body->next->worldOrigin, rotation,
-										body->clipModel, body->current->worldAxis, body->clipMask, passEntity ) ) {
+			if ( hit ) {
 
 				// set the next state to the state at the moment of impact
 				body->next->worldOrigin = collision.endpos;
@@ -6215,6 +6226,75 @@ idPhysics_AF::Evaluate
 ================
 */
 bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
+
+	// the articulated figure stage already evaluated the figure for this frame
+	if ( stageTime == endTimeMSec ) {
+		stageTime = -1;
+		return stageMoved;
+	}
+	stageTime = -1;
+	evaluateTime = endTimeMSec;
+
+	if ( !EvaluateSetup( timeStepMSec, endTimeMSec ) ) {
+		return false;
+	}
+
+	EvaluateSolve();
+
+	EvaluateFinish( endTimeMSec );
+
+	return true;
+}
+
+/*
+================
+idPhysics_AF::CanEvaluateInStage
+
+Only figures that were simulated by their entity on the previous frame are
+evaluated ahead, the others may not be run at all this frame.  Figures bound
+to a master and vehicles with suspension traces stay in think.
+================
+*/
+bool idPhysics_AF::CanEvaluateInStage( int previousTimeMSec ) const {
+	int i;
+
+	if ( evaluateTime != previousTimeMSec || current.atRest >= 0 || masterBody ) {
+		return false;
+	}
+	if ( changedAF || ( linearTime != af_useLinearTime.GetBool() ) ) {
+		return false;
+	}
+	for ( i = 0; i < constraints.Num(); i++ ) {
+		if ( constraints[i]->GetType() == CONSTRAINT_SUSPENSION ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+================
+idPhysics_AF::SetStageResult
+
+Evaluate returns moved instead of simulating the figure again for endTimeMSec.
+================
+*/
+void idPhysics_AF::SetStageResult( int endTimeMSec, bool moved ) {
+	evaluateTime = endTimeMSec;
+	stageTime = endTimeMSec;
+	stageMoved = moved;
+}
+
+/*
+================
+idPhysics_AF::EvaluateSetup
+
+Finds the contacts and sets up the constraint equations, returns false if the
+figure doesn't have to be solved.
+================
+*/
+bool idPhysics_AF::EvaluateSetup( int timeStepMSec, int endTimeMSec ) {
+	int i;
 	float timeStep;
 
 	if ( timeScaleRampStart < MS2SEC( endTimeMSec ) && timeScaleRampEnd > MS2SEC( endTimeMSec ) ) {
@@ -6256,11 +6336,11 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	AddPushVelocity( -current.pushVelocity );
 
 #ifdef AF_TIMINGS
-	timer_total.Start();
+	AF_TIMER_START( timer_total );
 #endif
 
 #ifdef AF_TIMINGS
-	timer_collision.Start();
+	AF_TIMER_START( timer_collision );
 #endif
 
 	// evaluate contacts
@@ -6270,7 +6350,7 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	SetupContactConstraints();
 
 #ifdef AF_TIMINGS
-	timer_collision.Stop();
+	AF_TIMER_STOP( timer_collision );
 #endif
 
 	// evaluate constraint equations
@@ -6282,15 +6362,31 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	// add frame constraints
 	AddFrameConstraints();
 
-#ifdef AF_TIMINGS
-	int i, numPrimary = 0, numAuxiliary = 0;
+	numPrimaryRows = 0;
 	for ( i = 0; i < primaryConstraints.Num(); i++ ) {
-		numPrimary += primaryConstraints[i]->J1.GetNumRows();
+		numPrimaryRows += primaryConstraints[i]->J1.GetNumRows();
 	}
+	numAuxiliaryRows = 0;
 	for ( i = 0; i < auxiliaryConstraints.Num(); i++ ) {
-		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
+		numAuxiliaryRows += auxiliaryConstraints[i]->J1.GetNumRows();
 	}
-	timer_pc.Start();
+
+	return true;
+}
+
+/*
+================
+idPhysics_AF::EvaluateSolve
+
+Calculates the constraint forces and the next state of the bodies.  This
+only touches the figure itself so it can run as a parallel job.
+================
+*/
+void idPhysics_AF::EvaluateSolve( void ) {
+	float timeStep = current.lastTimeStep;
+
+#ifdef AF_TIMINGS
+	AF_TIMER_START( timer_pc );
 #endif
 
 	// factor matrices for primary constraints
@@ -6300,19 +6396,30 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	PrimaryForces( timeStep );
 
 #ifdef AF_TIMINGS
-	timer_pc.Stop();
-	timer_ac.Start();
+	AF_TIMER_STOP( timer_pc );
+	AF_TIMER_START( timer_ac );
 #endif
 
 	// calculate and apply auxiliary constraint forces
 	AuxiliaryForces( timeStep );
 
 #ifdef AF_TIMINGS
-	timer_ac.Stop();
+	AF_TIMER_STOP( timer_ac );
 #endif
 
 	// evolve current state to next state
 	Evolve( timeStep );
+}
+
+/*
+================
+idPhysics_AF::EvaluateFinish
+
+Handles the collisions with the next state and checks if the figure comes to rest.
+================
+*/
+void idPhysics_AF::EvaluateFinish( int endTimeMSec ) {
+	float timeStep = current.lastTimeStep;
 
 	// debug graphics
 	DebugDraw();
@@ -6327,14 +6434,14 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	RemoveFrameConstraints();
 
 #ifdef AF_TIMINGS
-	timer_collision.Start();
+	AF_TIMER_START( timer_collision );
 #endif
 
 	// check for collisions between current and next state
 	CheckForCollisions( timeStep );
 
 #ifdef AF_TIMINGS
-	timer_collision.Stop();
+	AF_TIMER_STOP( timer_collision );
 #endif
 
 	// swap the current and next state
@@ -6372,14 +6479,14 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	}
 
 #ifdef AF_TIMINGS
-	timer_total.Stop();
+	AF_TIMER_STOP( timer_total );
 
 	if ( af_showTimings.GetInteger() == 1 ) {
 		gameLocal.Printf( "%12s: t %1.4f pc %2d, %1.4f ac %2d %1.4f lcp %1.4f cd %1.4f\n",
 						self->name.c_str(),
 						timer_total.Milliseconds(),
-						numPrimary, timer_pc.Milliseconds(),
-						numAuxiliary, timer_ac.Milliseconds() - timer_lcp.Milliseconds(),
+						numPrimaryRows, timer_pc.Milliseconds(),
+						numAuxiliaryRows, timer_ac.Milliseconds() - timer_lcp.Milliseconds(),
 						timer_lcp.Milliseconds(), timer_collision.Milliseconds() );
 	}
 	else if ( af_showTimings.GetInteger() == 2 ) {
@@ -6388,8 +6495,8 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 			gameLocal.Printf( "af %d: t %1.4f pc %2d, %1.4f ac %2d %1.4f lcp %1.4f cd %1.4f\n",
 							numArticulatedFigures,
 							timer_total.Milliseconds(),
-							numPrimary, timer_pc.Milliseconds(),
-							numAuxiliary, timer_ac.Milliseconds() - timer_lcp.Milliseconds(),
+							numPrimaryRows, timer_pc.Milliseconds(),
+							numAuxiliaryRows, timer_ac.Milliseconds() - timer_lcp.Milliseconds(),
 							timer_lcp.Milliseconds(), timer_collision.Milliseconds() );
 		}
 	}
@@ -6404,8 +6511,6 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 		timer_lcp.Clear();
 	}
 #endif
-
-	return true;
 }
 
 /*
@@ -6599,6 +6704,12 @@ idPhysics_AF::idPhysics_AF( void ) {
 
 	lcp = idLCP::AllocSymmetric();
 
+	evaluateTime = 0;
+	stageTime = -1;
+	stageMoved = false;
+	numPrimaryRows = 0;
+	numAuxiliaryRows = 0;
+
 	memset( &current, 0, sizeof( current ) );
 	current.atRest = -1;
 	current.lastTimeStep = USERCMD_MSEC;
@@ -6638,6 +6749,7 @@ idPhysics_AF::idPhysics_AF( void ) {
 
 	enableCollision = true;
 	selfCollision = true;
+	continuousCollision = false;
 	comeToRest = true;
 	linearTime = true;
 	noImpact = false;
@@ -6770,6 +6882,7 @@ void idPhysics_AF::Save( idSaveGame *saveFile ) const {
 
 	saveFile->WriteBool( enableCollision );
 	saveFile->WriteBool( selfCollision );
+	saveFile->WriteBool( continuousCollision );
 	saveFile->WriteBool( comeToRest );
 	saveFile->WriteBool( linearTime );
 	saveFile->WriteBool( noImpact );
@@ -6844,6 +6957,7 @@ void idPhysics_AF::Restore( idRestoreGame *saveFile ) {
 
 	saveFile->ReadBool( enableCollision );
 	saveFile->ReadBool( selfCollision );
+	saveFile->ReadBool( continuousCollision );
 	saveFile->ReadBool( comeToRest );
 	saveFile->ReadBool( linearTime );
 	saveFile->ReadBool( noImpact );
@@ -875,6 +875,8 @@ public:
 	void					SetCollision( const bool enable ) { enableCollision = enable; }
 							// enable or disable self collision
 	void					SetSelfCollision( const bool enable ) { selfCollision = enable; }
+							// enable or disable continuous collision detection for fast spinning bodies
+	void					SetContinuousCollision( const bool enable ) { continuousCollision = enable; }
 							// enable or disable coming to a dead stop
 	void					SetComeToRest( bool enable ) { comeToRest = enable; }
 							// call when structure of articulated figure changes
@@ -946,6 +948,15 @@ public:	// common physics interface
 
 	bool					EvaluateContacts( void );
 
+							// the articulated figure stage evaluates the moving figures before the entities think,
+							// Evaluate then returns the stage result, see idGameLocal::RunArticulatedFigures
+	bool					CanEvaluateInStage( int previousTimeMSec ) const;
+	void					SetStageResult( int endTimeMSec, bool moved );
+							// Evaluate split up, the setup and finish use the clip world, the solve can run as a parallel job
+	bool					EvaluateSetup( int timeStepMSec, int endTimeMSec );
+	void					EvaluateSolve( void );
+	void					EvaluateFinish( int endTimeMSec );
+
 	void					SetPushed( int deltaTime );
 	const idVec3 &			GetPushedLinearVelocity( const int id = 0 ) const;
 	const idVec3 &			GetPushedAngularVelocity( const int id = 0 ) const;
@@ -1003,6 +1014,7 @@ private:
 
 	bool					enableCollision;				// if true collision detection is enabled
 	bool					selfCollision;					// if true the self collision is allowed
+	bool					continuousCollision;			// if true use continuous collision detection
 	bool					comeToRest;						// if true the figure can come to rest
 	bool					linearTime;						// if true use the linear time algorithm
 	bool					noImpact;						// if true do not activate when another object collides
@@ -1016,6 +1028,12 @@ private:
 	idAFBody *				masterBody;						// master body
 	idLCP *					lcp;							// linear complementarity problem solver
 
+	int						evaluateTime;					// end time of the last evaluation
+	int						stageTime;						// end time the articulated figure stage evaluated the figure for
+	bool					stageMoved;						// result of the stage evaluation
+	int						numPrimaryRows;					// for af_showTimings
+	int						numAuxiliaryRows;
+
 private:
 	void					BuildTrees( void );
 	bool					IsClosedLoop( const idAFBody *body1, const idAFBody *body2 ) const;
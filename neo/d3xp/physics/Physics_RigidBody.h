@@ -78,6 +78,12 @@ public:
 							// initialisation
 	void					SetFriction( const float linear, const float angular, const float contact );
 	void					SetBouncyness( const float b );
+							// sweep the rotation in steps to keep fast spinning bodies from passing through geometry
+	void					SetContinuousCollision( bool enable ) { continuousCollision = enable; }
+							// sleeping island the body belongs to, see idSleepIslands
+	void					Sleep( int island );
+	int						GetSleepIsland( void ) const { return sleepIsland; }
+	void					SetSleepIsland( int island ) { sleepIsland = island; }
 							// same as above but drop to the floor first
 	void					DropToFloor( void );
 							// no contact determination and contact friction
@@ -176,6 +182,8 @@ private:
 	bool					testSolid;					// true if testing for solid when dropping to the floor
 	bool					noImpact;					// if true do not activate when another object collides
 	bool					noContact;					// if true do not determine contacts and no contact friction
+	int						sleepIsland;				// sleeping island or -1
+	bool					continuousCollision;		// if true use continuous collision detection
 
 	// master
 	bool					hasMaster;
@@ -0,0 +1,293 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code (?Doom 3 Source Code?).
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "../../idlib/precompiled.h"
+#pragma hdrstop
+
+#include "../Game_local.h"
+
+/*
+================
+idSleepIslands::idSleepIslands
+================
+*/
+idSleepIslands::idSleepIslands( void ) {
+	for ( int i = 0; i < MAX_GENTITIES; i++ ) {
+		bodyForEntity[i] = -1;
+	}
+}
+
+/*
+================
+idSleepIslands::Clear
+================
+*/
+void idSleepIslands::Clear( void ) {
+	for ( int i = 0; i < bodies.Num(); i++ ) {
+		bodyForEntity[ bodies[i].entityNum ] = -1;
+	}
+	bodies.Clear();
+	contactEntities.Clear();
+	sleeping.Clear();
+	freeIslands.Clear();
+}
+
+/*
+================
+idSleepIslands::IsEnabled
+
+  Clients do not run Update so their rigid bodies rest on their own.
+================
+*/
+bool idSleepIslands::IsEnabled( void ) const {
+	return rb_sleepIslands.GetBool() && !gameLocal.isClient;
+}
+
+/*
+================
+idSleepIslands::AddBody
+================
+*/
+void idSleepIslands::AddBody( idEntity *ent, bool atRest, const contactInfo_t *contacts, int numContacts ) {
+	islandBody_t body;
+
+	body.entityNum = ent->entityNumber;
+	body.spawnId = gameLocal.GetSpawnId( ent );
+	body.atRest = atRest;
+	body.blocked = false;
+	body.parent = bodies.Num();
+	body.firstContact = contactEntities.Num();
+	body.numContacts = 0;
+
+	for ( int i = 0; i < numContacts; i++ ) {
+		if ( contacts[i].entityNum == ENTITYNUM_WORLD || contacts[i].entityNum == ent->entityNumber ) {
+			continue;
+		}
+		contactEntities.Append( contacts[i].entityNum );
+		body.numContacts++;
+	}
+
+	bodyForEntity[ body.entityNum ] = bodies.Append( body );
+}
+
+/*
+================
+idSleepIslands::FindRoot
+================
+*/
+int idSleepIslands::FindRoot( int i ) {
+	while ( bodies[i].parent != i ) {
+		bodies[i].parent = bodies[ bodies[i].parent ].parent;
+		i = bodies[i].parent;
+	}
+	return i;
+}
+
+/*
+================
+idSleepIslands::AllocIsland
+================
+*/
+int idSleepIslands::AllocIsland( void ) {
+	if ( freeIslands.Num() ) {
+		int island = freeIslands[ freeIslands.Num() - 1 ];
+		freeIslands.RemoveIndex( freeIslands.Num() - 1 );
+		return island;
+	}
+	sleeping.Append( idList<int>() );
+	return sleeping.Num() - 1;
+}
+
+/*
+================
+idSleepIslands::FreeIsland
+================
+*/
+void idSleepIslands::FreeIsland( int island ) {
+	sleeping[island].Clear();
+	freeIslands.Append( island );
+}
+
+/*
+================
+idSleepIslands::Update
+================
+*/
+void idSleepIslands::Update( void ) {
+	int i, j, root;
+	idList<int> islandForRoot;
+	idList<int> touchedIslands;
+
+	// link the bodies that touch each other
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		for ( j = 0; j < bodies[i].numContacts; j++ ) {
+			int entityNum = contactEntities[ bodies[i].firstContact + j ];
+			int other = bodyForEntity[ entityNum ];
+
+			if ( other >= 0 ) {
+				int a = FindRoot( i );
+				int b = FindRoot( other );
+				if ( a != b ) {
+					bodies[b].parent = a;
+				}
+				continue;
+			}
+
+			idEntity *ent = gameLocal.entities[ entityNum ];
+			if ( !ent || !ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) ) {
+				continue;
+			}
+			idPhysics_RigidBody *rb = static_cast<idPhysics_RigidBody *>( ent->GetPhysics() );
+			if ( rb->GetSleepIsland() >= 0 ) {
+				// merged into the island if it goes to sleep
+				touchedIslands.Append( i );
+				touchedIslands.Append( rb->GetSleepIsland() );
+			} else if ( !rb->IsAtRest() ) {
+				bodies[i].blocked = true;
+			}
+		}
+	}
+
+	// an island stays awake if any of its bodies is not at rest
+	islandForRoot.SetNum( bodies.Num() );
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		islandForRoot[i] = -1;
+	}
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		if ( !bodies[i].atRest || bodies[i].blocked ) {
+			islandForRoot[ FindRoot( i ) ] = -2;
+		}
+	}
+
+	// put the remaining islands to sleep
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		root = FindRoot( i );
+		if ( islandForRoot[root] == -2 ) {
+			continue;
+		}
+		idEntity *ent = gameLocal.entities[ bodies[i].entityNum ];
+		if ( !ent || gameLocal.GetSpawnId( ent ) != bodies[i].spawnId || !ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) ) {
+			continue;
+		}
+		if ( islandForRoot[root] == -1 ) {
+			islandForRoot[root] = AllocIsland();
+		}
+		sleeping[ islandForRoot[root] ].Append( bodies[i].spawnId );
+		static_cast<idPhysics_RigidBody *>( ent->GetPhysics() )->Sleep( islandForRoot[root] );
+	}
+
+	// sleeping islands touched by a new sleeping island become part of it
+	for ( i = 0; i < touchedIslands.Num(); i += 2 ) {
+		int island = islandForRoot[ FindRoot( touchedIslands[i] ) ];
+		int merged = touchedIslands[i + 1];
+		if ( island < 0 || merged == island || !sleeping[merged].Num() ) {
+			continue;
+		}
+		for ( j = 0; j < sleeping[merged].Num(); j++ ) {
+			idEntity *ent = gameLocal.entities[ sleeping[merged][j] & ( ( 1 << GENTITYNUM_BITS ) - 1 ) ];
+			if ( !ent || gameLocal.GetSpawnId( ent ) != sleeping[merged][j] ) {
+				continue;
+			}
+			static_cast<idPhysics_RigidBody *>( ent->GetPhysics() )->SetSleepIsland( island );
+			sleeping[island].Append( sleeping[merged][j] );
+		}
+		FreeIsland( merged );
+	}
+
+	if ( rb_showIslands.GetBool() ) {
+		DebugDraw( islandForRoot );
+	}
+
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		bodyForEntity[ bodies[i].entityNum ] = -1;
+	}
+	bodies.SetNum( 0, false );
+	contactEntities.SetNum( 0, false );
+}
+
+/*
+================
+idSleepIslands::Wake
+================
+*/
+void idSleepIslands::Wake( int island ) {
+	idList<int> spawnIds;
+
+	if ( island < 0 || island >= sleeping.Num() || !sleeping[island].Num() ) {
+		return;
+	}
+
+	spawnIds = sleeping[island];
+	FreeIsland( island );
+
+	for ( int i = 0; i < spawnIds.Num(); i++ ) {
+		idEntity *ent = gameLocal.entities[ spawnIds[i] & ( ( 1 << GENTITYNUM_BITS ) - 1 ) ];
+		if ( !ent || gameLocal.GetSpawnId( ent ) != spawnIds[i] || !ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) ) {
+			continue;
+		}
+		idPhysics_RigidBody *rb = static_cast<idPhysics_RigidBody *>( ent->GetPhysics() );
+		if ( rb->GetSleepIsland() == island ) {
+			rb->SetSleepIsland( -1 );
+			rb->Activate();
+		}
+	}
+}
+
+/*
+================
+idSleepIslands::DebugDraw
+
+  green: sleeping, yellow: at rest but the island is awake, red: moving
+================
+*/
+void idSleepIslands::DebugDraw( const idList<int> &islandForRoot ) {
+	int i, j;
+
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		idEntity *ent = gameLocal.entities[ bodies[i].entityNum ];
+		if ( !ent || islandForRoot[ FindRoot( i ) ] >= 0 ) {
+			continue;
+		}
+		const idClipModel *clip = ent->GetPhysics()->GetClipModel();
+		gameRenderWorld->DebugBounds( bodies[i].atRest ? colorYellow : colorRed, clip->GetBounds(), clip->GetOrigin() );
+	}
+
+	for ( i = 0; i < sleeping.Num(); i++ ) {
+		for ( j = 0; j < sleeping[i].Num(); j++ ) {
+			idEntity *ent = gameLocal.entities[ sleeping[i][j] & ( ( 1 << GENTITYNUM_BITS ) - 1 ) ];
+			if ( !ent || gameLocal.GetSpawnId( ent ) != sleeping[i][j] ) {
+				continue;
+			}
+			const idClipModel *clip = ent->GetPhysics()->GetClipModel();
+			gameRenderWorld->DebugBounds( colorGreen, clip->GetBounds(), clip->GetOrigin() );
+			if ( j == 0 ) {
+				gameRenderWorld->DrawText( va( "%d", i ), clip->GetOrigin(), 0.25f, colorGreen, gameLocal.GetLocalPlayer() ? gameLocal.GetLocalPlayer()->viewAngles.ToMat3() : mat3_identity );
+			}
+		}
+	}
+}
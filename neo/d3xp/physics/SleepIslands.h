@@ -0,0 +1,82 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code (?Doom 3 Source Code?).
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __SLEEPISLANDS_H__
+#define __SLEEPISLANDS_H__
+
+/*
+===============================================================================
+
+  Sleeping islands of rigid bodies.
+
+  Rigid bodies that touch each other form an island. A body that passes its
+  rest test is only put to rest once every body in its island passed the test
+  as well, and then the whole island goes to sleep at once. Activating any
+  body of a sleeping island wakes up all the bodies in that island.
+
+===============================================================================
+*/
+
+class idSleepIslands {
+public:
+							idSleepIslands( void );
+
+	void					Clear( void );
+	bool					IsEnabled( void ) const;
+
+							// called by a rigid body after evaluating its contacts
+	void					AddBody( idEntity *ent, bool atRest, const contactInfo_t *contacts, int numContacts );
+							// puts islands to sleep where all bodies are at rest, called once per frame after think
+	void					Update( void );
+							// wakes up all the bodies in a sleeping island
+	void					Wake( int island );
+
+private:
+	typedef struct islandBody_s {
+		int					entityNum;
+		int					spawnId;
+		bool				atRest;				// passed the rest test this frame
+		bool				blocked;			// touches an awake body that was not evaluated this frame
+		int					parent;				// union-find parent
+		int					firstContact;
+		int					numContacts;
+	} islandBody_t;
+
+	idList<islandBody_t>	bodies;				// bodies evaluated this frame
+	idList<int>				contactEntities;	// entity numbers touched by the bodies
+	idList<idList<int> >	sleeping;			// spawn ids of the bodies in each sleeping island
+	idList<int>				freeIslands;		// unused entries in sleeping
+	int						bodyForEntity[MAX_GENTITIES];
+
+	int						FindRoot( int i );
+	int						AllocIsland( void );
+	void					FreeIsland( int island );
+	void					DebugDraw( const idList<int> &islandForRoot );
+};
+
+#endif /* !__SLEEPISLANDS_H__ */
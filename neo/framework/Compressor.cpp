@@ -1355,6 +1355,207 @@ float idCompressor_Huffman::GetCompressionRatio( void ) const {
 }
 
 
+/*
+=================================================================================
+
+	idCompressor_StaticHuffman
+
+	The following algorithm implements Huffman coding with a fixed canonical code
+	built from symbol counts. No model is built up while compressing, which suits
+	many small messages with similar statistics. The compressor and decompressor
+	must be allocated with the same symbol counts.
+
+=================================================================================
+*/
+
+const int SH_MAX_SYMBOLS		= 256;
+const int SH_MAX_CODE_LENGTH	= 16;
+
+class idCompressor_StaticHuffman : public idCompressor_BitStream {
+public:
+					idCompressor_StaticHuffman( const int symbolCounts[SH_MAX_SYMBOLS] );
+
+	int				Write( const void *inData, int inLength );
+	int				Read( void *outData, int outLength );
+
+private:
+	int				codeLength[SH_MAX_SYMBOLS];
+	int				code[SH_MAX_SYMBOLS];						// bit reversed so it can be written with WriteBits
+	int				numCodes[SH_MAX_CODE_LENGTH+1];				// number of codes with each length
+	int				firstCode[SH_MAX_CODE_LENGTH+1];			// first canonical code with each length
+	int				firstSymbol[SH_MAX_CODE_LENGTH+1];			// index of the first symbol with each length
+	byte			sortedSymbols[SH_MAX_SYMBOLS];				// symbols sorted on code length
+
+private:
+	bool			BuildCodeLengths( const int counts[SH_MAX_SYMBOLS] );
+	void			BuildCodes( void );
+};
+
+/*
+================
+idCompressor_StaticHuffman::idCompressor_StaticHuffman
+================
+*/
+idCompressor_StaticHuffman::idCompressor_StaticHuffman( const int symbolCounts[SH_MAX_SYMBOLS] ) {
+	int i, counts[SH_MAX_SYMBOLS];
+
+	// every symbol needs a code
+	for ( i = 0; i < SH_MAX_SYMBOLS; i++ ) {
+		counts[i] = Max( symbolCounts[i], 0 ) + 1;
+	}
+
+	// flatten the distribution until the codes are short enough
+	while( !BuildCodeLengths( counts ) ) {
+		for ( i = 0; i < SH_MAX_SYMBOLS; i++ ) {
+			counts[i] = ( counts[i] >> 1 ) + 1;
+		}
+	}
+
+	BuildCodes();
+}
+
+/*
+================
+idCompressor_StaticHuffman::BuildCodeLengths
+
+  Returns false if a code is longer than SH_MAX_CODE_LENGTH.
+================
+*/
+bool idCompressor_StaticHuffman::BuildCodeLengths( const int counts[SH_MAX_SYMBOLS] ) {
+	int i, j, numNodes, first, second, length;
+	int weight[SH_MAX_SYMBOLS * 2], parent[SH_MAX_SYMBOLS * 2];
+	bool active[SH_MAX_SYMBOLS * 2];
+
+	for ( i = 0; i < SH_MAX_SYMBOLS; i++ ) {
+		weight[i] = counts[i];
+		parent[i] = -1;
+		active[i] = true;
+	}
+
+	// repeatedly join the two lightest nodes, this only runs once per table so the simple search is fine
+	for ( numNodes = SH_MAX_SYMBOLS; numNodes < SH_MAX_SYMBOLS * 2 - 1; numNodes++ ) {
+		first = second = -1;
+		for ( j = 0; j < numNodes; j++ ) {
+			if ( !active[j] ) {
+				continue;
+			}
+			if ( first == -1 || weight[j] < weight[first] ) {
+				second = first;
+				first = j;
+			} else if ( second == -1 || weight[j] < weight[second] ) {
+				second = j;
+			}
+		}
+		weight[numNodes] = weight[first] + weight[second];
+		parent[numNodes] = -1;
+		active[numNodes] = true;
+		parent[first] = parent[second] = numNodes;
+		active[first] = active[second] = false;
+	}
+
+	for ( i = 0; i < SH_MAX_SYMBOLS; i++ ) {
+		length = 0;
+		for ( j = i; parent[j] != -1; j = parent[j] ) {
+			length++;
+		}
+		if ( length > SH_MAX_CODE_LENGTH ) {
+			return false;
+		}
+		codeLength[i] = length;
+	}
+	return true;
+}
+
+/*
+================
+idCompressor_StaticHuffman::BuildCodes
+================
+*/
+void idCompressor_StaticHuffman::BuildCodes( void ) {
+	int i, j, length, nextCode[SH_MAX_CODE_LENGTH+1], bits;
+
+	memset( numCodes, 0, sizeof( numCodes ) );
+	for ( i = 0; i < SH_MAX_SYMBOLS; i++ ) {
+		numCodes[codeLength[i]]++;
+	}
+
+	// canonical codes are consecutive within a length
+	bits = 0;
+	j = 0;
+	for ( length = 1; length <= SH_MAX_CODE_LENGTH; length++ ) {
+		firstCode[length] = bits;
+		firstSymbol[length] = j;
+		nextCode[length] = bits;
+		bits = ( bits + numCodes[length] ) << 1;
+		j += numCodes[length];
+	}
+
+	for ( i = 0; i < SH_MAX_SYMBOLS; i++ ) {
+		length = codeLength[i];
+		sortedSymbols[firstSymbol[length] + nextCode[length] - firstCode[length]] = i;
+
+		// the decoder reads the most significant bit first
+		code[i] = 0;
+		for ( j = 0; j < length; j++ ) {
+			code[i] |= ( ( nextCode[length] >> j ) & 1 ) << ( length - 1 - j );
+		}
+		nextCode[length]++;
+	}
+}
+
+/*
+================
+idCompressor_StaticHuffman::Write
+================
+*/
+int idCompressor_StaticHuffman::Write( const void *inData, int inLength ) {
+	int i, symbol;
+
+	if ( compress == false || inLength <= 0 ) {
+		return 0;
+	}
+
+	InitCompress( inData, inLength );
+
+	for ( i = 0; i < inLength; i++ ) {
+		symbol = ReadBits( 8 );
+		WriteBits( code[symbol], codeLength[symbol] );
+	}
+	return i;
+}
+
+/*
+================
+idCompressor_StaticHuffman::Read
+================
+*/
+int idCompressor_StaticHuffman::Read( void *outData, int outLength ) {
+	int i, bits, length;
+
+	if ( compress == true || outLength <= 0 ) {
+		return 0;
+	}
+
+	InitDecompress( outData, outLength );
+
+	for ( i = 0; i < outLength && readLength >= 0; i++ ) {
+		bits = 0;
+		for ( length = 1; length <= SH_MAX_CODE_LENGTH; length++ ) {
+			bits |= ReadBits( 1 );
+			if ( bits - firstCode[length] < numCodes[length] ) {
+				break;
+			}
+			bits <<= 1;
+		}
+		if ( length > SH_MAX_CODE_LENGTH ) {
+			break;
+		}
+		WriteBits( sortedSymbols[firstSymbol[length] + bits - firstCode[length]], 8 );
+	}
+	return i;
+}
+
+
 /*
 =================================================================================
 
@@ -2539,6 +2740,15 @@ idCompressor * idCompressor::AllocHuffman( void ) {
 	return new idCompressor_Huffman();
 }
 
+/*
+================
+idCompressor::AllocStaticHuffman
+================
+*/
+idCompressor * idCompressor::AllocStaticHuffman( const int symbolCounts[256] ) {
+	return new idCompressor_StaticHuffman( symbolCounts );
+}
+
 /*
 ================
 idCompressor::AllocArithmetic
@@ -47,6 +47,7 @@ public:
 	static idCompressor *	AllocRunLength( void );
 	static idCompressor *	AllocRunLength_ZeroBased( void );
 	static idCompressor *	AllocHuffman( void );
+	static idCompressor *	AllocStaticHuffman( const int symbolCounts[256] );
 	static idCompressor *	AllocArithmetic( void );
 	static idCompressor *	AllocLZSS( void );
 	static idCompressor *	AllocLZSS_WordAligned( void );
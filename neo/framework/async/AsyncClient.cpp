@@ -79,6 +79,11 @@ void idAsyncClient::Clear( void ) {
 	gameTimeResidual = 0;
 	gameTime = 0;
 	memset( userCmds, 0, sizeof( userCmds ) );
+	usercmdAckFrame = -1;
+	usercmdStatsTime = 0;
+	usercmdStatsPackets = 0;
+	usercmdStatsCmds = 0;
+	usercmdStatsBytes = 0;
 	backgroundDownload.completed = true;
 	lastRconTime = 0;
 	showUpdateMessage = false;
@@ -664,10 +669,14 @@ void idAsyncClient::SendPingResponseToServer( int time ) {
 /*
 ==================
 idAsyncClient::SendUsercmdsToServer
+
+  Sends the usercmds the server has not acknowledged yet, up to net_clientUsercmdBackup
+  previous ones, so a lost packet is covered by the next one. The usercmds are packed
+  relative to each other, starting from the newest one the server acknowledged.
 ==================
 */
 void idAsyncClient::SendUsercmdsToServer( void ) {
-	int			i, numUsercmds, index;
+	int			i, numUsercmds, index, baseOffset, usercmdStart;
 	idBitMsg	msg;
 	byte		msgBuf[MAX_MESSAGE_SIZE];
 	usercmd_t *	last;
@@ -690,17 +699,49 @@ void idAsyncClient::SendUsercmdsToServer( void ) {
 	msg.WriteByte( CLIENT_UNRELIABLE_MESSAGE_USERCMD );
 	msg.WriteShort( clientPrediction );
 
-	numUsercmds = idMath::ClampInt( 0, 10, idAsyncNetwork::clientUsercmdBackup.GetInteger() ) + 1;
+	numUsercmds = idMath::ClampInt( 0, MAX_USERCMD_REDUNDANCY, idAsyncNetwork::clientUsercmdBackup.GetInteger() ) + 1;
+
+	// pack against the acknowledged usercmd while the server still has it
+	last = NULL;
+	baseOffset = 0;
+	if ( usercmdAckFrame >= 0 && usercmdAckFrame < gameFrame && gameFrame - usercmdAckFrame <= MAX_USERCMD_BASELINE_AGE ) {
+		index = usercmdAckFrame & ( MAX_USERCMD_BACKUP - 1 );
+		if ( userCmds[index][clientNum].gameFrame == usercmdAckFrame ) {
+			last = &userCmds[index][clientNum];
+			baseOffset = gameFrame - usercmdAckFrame;
+			// no need to send again what the server already has
+			numUsercmds = Min( numUsercmds, baseOffset );
+		}
+	}
 
 	// write the user commands
+	usercmdStart = msg.GetSize();
 	msg.WriteLong( gameFrame );
 	msg.WriteByte( numUsercmds );
-	for ( last = NULL, i = gameFrame - numUsercmds + 1; i <= gameFrame; i++ ) {
+	msg.WriteByte( baseOffset );
+	for ( i = gameFrame - numUsercmds + 1; i <= gameFrame; i++ ) {
 		index = i & ( MAX_USERCMD_BACKUP - 1 );
 		idAsyncNetwork::WriteUserCmdDelta( msg, userCmds[index][clientNum], last );
 		last = &userCmds[index][clientNum];
 	}
 
+	if ( idAsyncNetwork::clientUsercmdStats.GetBool() ) {
+		usercmdStatsPackets++;
+		usercmdStatsCmds += numUsercmds;
+		usercmdStatsBytes += msg.GetSize() - usercmdStart;
+		if ( clientTime - usercmdStatsTime >= 1000 ) {
+			common->Printf( "usercmds: %.1f bytes/cmd, %.1f cmds/packet, %.1f bytes/packed cmd, %d bytes/sec\n",
+							(float) usercmdStatsBytes / Max( usercmdStatsPackets, 1 ),
+							(float) usercmdStatsCmds / Max( usercmdStatsPackets, 1 ),
+							(float) usercmdStatsBytes / Max( usercmdStatsCmds, 1 ),
+							usercmdStatsBytes * 1000 / Max( clientTime - usercmdStatsTime, 1 ) );
+			usercmdStatsTime = clientTime;
+			usercmdStatsPackets = 0;
+			usercmdStatsCmds = 0;
+			usercmdStatsBytes = 0;
+		}
+	}
+
 	channel.SendMessage( clientPort, clientTime, msg );
 	while( channel.UnsentFragmentsLeft() ) {
 		channel.SendNextFragment( clientPort, clientTime );
@@ -718,6 +759,7 @@ void idAsyncClient::InitGame( int serverGameInitId, int serverGameFrame, int ser
 	gameTime = snapshotGameTime = serverGameTime;
 	gameTimeResidual = 0;
 	memset( userCmds, 0, sizeof( userCmds ) );
+	usercmdAckFrame = -1;
 
 	for ( int i = 0; i < MAX_ASYNC_CLIENTS; i++ ) {
 		sessLocal.mapSpawnData.userInfo[ i ].Clear();
@@ -801,6 +843,7 @@ void idAsyncClient::ProcessUnreliableServerMessage( const idBitMsg &msg ) {
 			snapshotGameTime = msg.ReadLong();
 			numDuplicatedUsercmds = msg.ReadByte();
 			aheadOfServer = msg.ReadShort();
+			usercmdAckFrame = msg.ReadLong();
 
 			// read the game snapshot
 			game->ClientReadSnapshot( clientNum, snapshotSequence, snapshotGameFrame, snapshotGameTime, numDuplicatedUsercmds, aheadOfServer, msg );
@@ -1132,6 +1175,11 @@ void idAsyncClient::ProcessConnectResponseMessage( const netadr_t from, const id
 	serverGameTime = msg.ReadLong();
 	msg.ReadDeltaDict( serverSI, NULL );
 
+	// older servers don't send a codec
+	if ( msg.GetRemaingData() > 0 ) {
+		channel.SetCodec( (channelCodec_t)msg.ReadByte() );
+	}
+
 	InitGame( serverGameInitId, serverGameFrame, serverGameTime, serverSI );
 
 	// load map
@@ -1684,6 +1732,8 @@ void idAsyncClient::SetupConnection( void ) {
 		msg.WriteString( cvarSystem->GetCVarString( "password" ), -1, false );
 		// do not make the protocol depend on PB
 		msg.WriteShort( 0 );
+		msg.WriteLong( idMsgChannel::GetSupportedCodecs() );
+		msg.WriteLong( idMsgChannel::GetCodecTableChecksum() );
 		clientPort.SendPacket( serverAddress, msg.GetData(), msg.GetSize() );
 
 		if ( idAsyncNetwork::LANServer.GetBool() ) {
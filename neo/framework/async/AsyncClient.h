@@ -153,6 +153,12 @@ private:
 	int					gameTimeResidual;			// left over time from previous frame
 
 	usercmd_t			userCmds[MAX_USERCMD_BACKUP][MAX_ASYNC_CLIENTS];
+	int					usercmdAckFrame;			// newest usercmd the server has received, -1 if none
+
+	int					usercmdStatsTime;			// start of the usercmd stats interval
+	int					usercmdStatsPackets;
+	int					usercmdStatsCmds;
+	int					usercmdStatsBytes;
 
 	idUserInterface *	guiNetMenu;
 
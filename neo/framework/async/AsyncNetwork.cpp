@@ -33,6 +33,7 @@ If you have questions concerning this license or the applicable additional terms
 
 idAsyncServer		idAsyncNetwork::server;
 idAsyncClient		idAsyncNetwork::client;
+idNetSimulator		idAsyncNetwork::simulator;
 
 idCVar				idAsyncNetwork::verbose( "net_verbose", "0", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "1 = verbose output, 2 = even more verbose output", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar				idAsyncNetwork::allowCheats( "net_allowCheats", "0", CVAR_SYSTEM | CVAR_BOOL | CVAR_NETWORKSYNC, "Allow cheats in network game" );
@@ -53,7 +54,8 @@ idCVar				idAsyncNetwork::serverDrawClient( "net_serverDrawClient", "-1", CVAR_S
 idCVar				idAsyncNetwork::serverRemoteConsolePassword( "net_serverRemoteConsolePassword", "", CVAR_SYSTEM | CVAR_NOCHEAT, "remote console password" );
 idCVar				idAsyncNetwork::clientPrediction( "net_clientPrediction", "16", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "additional client side prediction in milliseconds" );
 idCVar				idAsyncNetwork::clientMaxPrediction( "net_clientMaxPrediction", "1000", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "maximum number of milliseconds a client can predict ahead of server." );
-idCVar				idAsyncNetwork::clientUsercmdBackup( "net_clientUsercmdBackup", "5", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "number of usercmds to resend" );
+idCVar				idAsyncNetwork::clientUsercmdBackup( "net_clientUsercmdBackup", "5", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "number of previous usercmds resent with every packet until the server acknowledges them", 0, MAX_USERCMD_REDUNDANCY, idCmdSystem::ArgCompletion_Integer<0,MAX_USERCMD_REDUNDANCY> );
+idCVar				idAsyncNetwork::clientUsercmdStats( "net_clientUsercmdStats", "0", CVAR_SYSTEM | CVAR_BOOL | CVAR_NOCHEAT, "print the bytes per usercmd sent to the server every second" );
 idCVar				idAsyncNetwork::clientRemoteConsoleAddress( "net_clientRemoteConsoleAddress", "localhost", CVAR_SYSTEM | CVAR_NOCHEAT, "remote console address" );
 idCVar				idAsyncNetwork::clientRemoteConsolePassword( "net_clientRemoteConsolePassword", "", CVAR_SYSTEM | CVAR_NOCHEAT, "remote console password" );
 idCVar				idAsyncNetwork::master0( "net_master0", IDNET_HOST ":" IDNET_MASTER_PORT, CVAR_SYSTEM | CVAR_ROM, "idnet master server address" );
@@ -107,6 +109,11 @@ void idAsyncNetwork::Init( void ) {
 	cmdSystem->AddCommand( "kick", Kick_f, CMD_FL_SYSTEM, "kick a client by connection number" );
 	cmdSystem->AddCommand( "checkNewVersion", CheckNewVersion_f, CMD_FL_SYSTEM, "check if a new version of the game is available" );
 	cmdSystem->AddCommand( "updateUI", UpdateUI_f, CMD_FL_SYSTEM, "internal - cause a sync down of game-modified userinfo" );
+	cmdSystem->AddCommand( "netCodecStats", CodecStats_f, CMD_FL_SYSTEM, "shows the bytes and time spent per message codec, 'clear' resets the stats" );
+	cmdSystem->AddCommand( "netCodecTrain", CodecTrain_f, CMD_FL_SYSTEM, "writes the Huffman table trained with net_channelCodecTrain" );
+	cmdSystem->AddCommand( "netSimStart", NetSimStart_f, CMD_FL_SYSTEM, "connects fake clients to the local server to benchmark the network, usage: netSimStart [clients] [seconds]" );
+	cmdSystem->AddCommand( "netSimStop", NetSimStop_f, CMD_FL_SYSTEM, "prints the network simulation stats and disconnects the fake clients" );
+	cmdSystem->AddCommand( "netSimStats", NetSimStats_f, CMD_FL_SYSTEM, "shows the network simulation stats, 'clear' resets the stats" );
 #endif
 }
 
@@ -156,6 +163,7 @@ idAsyncNetwork::Shutdown
 ==================
 */
 void idAsyncNetwork::Shutdown( void ) {
+	simulator.Stop();
 	client.serverList.Shutdown();
 	client.DisconnectFromServer();
 	client.ClearServers();
@@ -179,25 +187,78 @@ void idAsyncNetwork::RunFrame( void ) {
 	}
 	client.RunFrame();
 	server.RunFrame();
+	simulator.RunFrame();
+}
+
+/*
+==================
+WriteUserCmdDeltaShort
+
+  Mouse movement and view angles change by small steps from one usercmd to the next.
+==================
+*/
+static void WriteUserCmdDeltaShort( idBitMsg &msg, int oldValue, int newValue ) {
+	int delta = (short)( newValue - oldValue );
+
+	if ( delta == 0 ) {
+		msg.WriteBits( 0, 1 );
+		return;
+	}
+	msg.WriteBits( 1, 1 );
+	if ( delta >= -128 && delta <= 127 ) {
+		msg.WriteBits( 1, 1 );
+		msg.WriteBits( delta, -8 );
+	} else {
+		msg.WriteBits( 0, 1 );
+		msg.WriteShort( newValue );
+	}
+}
+
+/*
+==================
+ReadUserCmdDeltaShort
+==================
+*/
+static int ReadUserCmdDeltaShort( const idBitMsg &msg, int oldValue ) {
+	if ( !msg.ReadBits( 1 ) ) {
+		return oldValue;
+	}
+	if ( msg.ReadBits( 1 ) ) {
+		return (short)( oldValue + msg.ReadBits( -8 ) );
+	}
+	return msg.ReadShort();
 }
 
 /*
 ==================
 idAsyncNetwork::WriteUserCmdDelta
+
+  With a base the usercmd is bit packed relative to it. A usercmd one frame after
+  its base with the same input takes two bits.
 ==================
 */
 void idAsyncNetwork::WriteUserCmdDelta( idBitMsg &msg, const usercmd_t &cmd, const usercmd_t *base ) {
 	if ( base ) {
-		msg.WriteDeltaLongCounter( base->gameTime, cmd.gameTime );
+		if ( cmd.gameTime - base->gameTime == USERCMD_MSEC ) {
+			msg.WriteBits( 1, 1 );
+		} else {
+			msg.WriteBits( 0, 1 );
+			msg.WriteDeltaLongCounter( base->gameTime, cmd.gameTime );
+		}
+		if ( !UsercmdInputChanged( *base, cmd ) && base->mx == cmd.mx && base->my == cmd.my ) {
+			msg.WriteBits( 0, 1 );
+			return;
+		}
+		msg.WriteBits( 1, 1 );
 		msg.WriteDeltaByte( base->buttons, cmd.buttons );
-		msg.WriteDeltaShort( base->mx, cmd.mx );
-		msg.WriteDeltaShort( base->my, cmd.my );
+		WriteUserCmdDeltaShort( msg, base->mx, cmd.mx );
+		WriteUserCmdDeltaShort( msg, base->my, cmd.my );
 		msg.WriteDeltaChar( base->forwardmove, cmd.forwardmove );
 		msg.WriteDeltaChar( base->rightmove, cmd.rightmove );
 		msg.WriteDeltaChar( base->upmove, cmd.upmove );
-		msg.WriteDeltaShort( base->angles[0], cmd.angles[0] );
-		msg.WriteDeltaShort( base->angles[1], cmd.angles[1] );
-		msg.WriteDeltaShort( base->angles[2], cmd.angles[2] );
+		WriteUserCmdDeltaShort( msg, base->angles[0], cmd.angles[0] );
+		WriteUserCmdDeltaShort( msg, base->angles[1], cmd.angles[1] );
+		WriteUserCmdDeltaShort( msg, base->angles[2], cmd.angles[2] );
 		return;
 	}
 
@@ -222,16 +283,32 @@ void idAsyncNetwork::ReadUserCmdDelta( const idBitMsg &msg, usercmd_t &cmd, cons
 	memset( &cmd, 0, sizeof( cmd ) );
 
 	if ( base ) {
-		cmd.gameTime = msg.ReadDeltaLongCounter( base->gameTime );
+		if ( msg.ReadBits( 1 ) ) {
+			cmd.gameTime = base->gameTime + USERCMD_MSEC;
+		} else {
+			cmd.gameTime = msg.ReadDeltaLongCounter( base->gameTime );
+		}
+		if ( !msg.ReadBits( 1 ) ) {
+			cmd.buttons = base->buttons;
+			cmd.mx = base->mx;
+			cmd.my = base->my;
+			cmd.forwardmove = base->forwardmove;
+			cmd.rightmove = base->rightmove;
+			cmd.upmove = base->upmove;
+			cmd.angles[0] = base->angles[0];
+			cmd.angles[1] = base->angles[1];
+			cmd.angles[2] = base->angles[2];
+			return;
+		}
 		cmd.buttons = msg.ReadDeltaByte( base->buttons );
-		cmd.mx = msg.ReadDeltaShort( base->mx );
-		cmd.my = msg.ReadDeltaShort( base->my );
+		cmd.mx = ReadUserCmdDeltaShort( msg, base->mx );
+		cmd.my = ReadUserCmdDeltaShort( msg, base->my );
 		cmd.forwardmove = msg.ReadDeltaChar( base->forwardmove );
 		cmd.rightmove = msg.ReadDeltaChar( base->rightmove );
 		cmd.upmove = msg.ReadDeltaChar( base->upmove );
-		cmd.angles[0] = msg.ReadDeltaShort( base->angles[0] );
-		cmd.angles[1] = msg.ReadDeltaShort( base->angles[1] );
-		cmd.angles[2] = msg.ReadDeltaShort( base->angles[2] );
+		cmd.angles[0] = ReadUserCmdDeltaShort( msg, base->angles[0] );
+		cmd.angles[1] = ReadUserCmdDeltaShort( msg, base->angles[1] );
+		cmd.angles[2] = ReadUserCmdDeltaShort( msg, base->angles[2] );
 		return;
 	}
 
@@ -492,6 +569,62 @@ void idAsyncNetwork::UpdateUI_f( const idCmdArgs &args ) {
 	server.UpdateUI( clientNum );
 }
 
+/*
+==================
+idAsyncNetwork::CodecStats_f
+==================
+*/
+void idAsyncNetwork::CodecStats_f( const idCmdArgs &args ) {
+	if ( args.Argc() > 1 && idStr::Icmp( args.Argv( 1 ), "clear" ) == 0 ) {
+		idMsgChannel::ClearCodecStats();
+		return;
+	}
+	idMsgChannel::PrintCodecStats();
+}
+
+/*
+==================
+idAsyncNetwork::CodecTrain_f
+==================
+*/
+void idAsyncNetwork::CodecTrain_f( const idCmdArgs &args ) {
+	idMsgChannel::WriteCodecTable();
+}
+
+/*
+==================
+idAsyncNetwork::NetSimStart_f
+==================
+*/
+void idAsyncNetwork::NetSimStart_f( const idCmdArgs &args ) {
+	int numClients = args.Argc() > 1 ? atoi( args.Argv( 1 ) ) : 8;
+	int seconds = args.Argc() > 2 ? atoi( args.Argv( 2 ) ) : 0;
+	simulator.Start( numClients, seconds );
+}
+
+/*
+==================
+idAsyncNetwork::NetSimStop_f
+==================
+*/
+void idAsyncNetwork::NetSimStop_f( const idCmdArgs &args ) {
+	simulator.PrintStats();
+	simulator.Stop();
+}
+
+/*
+==================
+idAsyncNetwork::NetSimStats_f
+==================
+*/
+void idAsyncNetwork::NetSimStats_f( const idCmdArgs &args ) {
+	if ( args.Argc() > 1 && idStr::Icmp( args.Argv( 1 ), "clear" ) == 0 ) {
+		simulator.ClearStats();
+		return;
+	}
+	simulator.PrintStats();
+}
+
 /*
 ===============
 idAsyncNetwork::BuildInvalidKeyMsg
@@ -36,8 +36,9 @@ DOOM III gold:	33
 1.2 XP:			36-39
 1.3 patch:		40
 1.3.1:			41
+packed usercmds:	42
 */
-const int ASYNC_PROTOCOL_MINOR		= 41;
+const int ASYNC_PROTOCOL_MINOR		= 42;
 const int ASYNC_PROTOCOL_VERSION	= ( ASYNC_PROTOCOL_MAJOR << 16 ) + ASYNC_PROTOCOL_MINOR;
 #define MAJOR_VERSION(v) ( v >> 16 )
 
@@ -46,6 +47,8 @@ const int MAX_ASYNC_CLIENTS			= 32;
 const int MAX_USERCMD_BACKUP		= 256;
 const int MAX_USERCMD_DUPLICATION	= 25;
 const int MAX_USERCMD_RELAY			= 10;
+const int MAX_USERCMD_REDUNDANCY	= 10;		// previous usercmds resent with every packet
+const int MAX_USERCMD_BASELINE_AGE	= 64;		// oldest acknowledged usercmd the client packs against
 
 // index 0 is hardcoded to be the idnet master
 // which leaves 4 to user customization
@@ -65,6 +68,7 @@ const int GAME_INIT_ID_MAP_LOAD		= -2;
 #include "AsyncServer.h"
 #include "ServerScan.h"
 #include "AsyncClient.h"
+#include "NetSimulator.h"
 
 /*
 ===============================================================================
@@ -166,6 +170,7 @@ public:
 
 	static idAsyncServer	server;
 	static idAsyncClient	client;
+	static idNetSimulator	simulator;
 
 	static idCVar			verbose;						// verbose output
 	static idCVar			allowCheats;					// allow cheats
@@ -182,6 +187,7 @@ public:
 	static idCVar			clientPrediction;				// how many additional milliseconds the clients runs ahead
 	static idCVar			clientMaxPrediction;			// max milliseconds into the future a client can run prediction
 	static idCVar			clientUsercmdBackup;			// how many usercmds the client sends from previous frames
+	static idCVar			clientUsercmdStats;				// print the usercmd bytes sent to the server
 	static idCVar			clientRemoteConsoleAddress;		// remote console address
 	static idCVar			clientRemoteConsolePassword;	// remote console password
 	static idCVar			master0;						// idnet master server
@@ -214,6 +220,11 @@ private:
 	static void				Kick_f( const idCmdArgs &args );
 	static void				CheckNewVersion_f( const idCmdArgs &args );
 	static void				UpdateUI_f( const idCmdArgs &args );
+	static void				CodecStats_f( const idCmdArgs &args );
+	static void				CodecTrain_f( const idCmdArgs &args );
+	static void				NetSimStart_f( const idCmdArgs &args );
+	static void				NetSimStop_f( const idCmdArgs &args );
+	static void				NetSimStats_f( const idCmdArgs &args );
 };
 
 #endif /* !__ASYNCNETWORK_H__ */
@@ -79,6 +79,7 @@ idAsyncServer::idAsyncServer( void ) {
 	gameFrame = 0;
 	gameTime = 0;
 	gameTimeResidual = 0;
+	frameTime = 0;
 	memset( challenges, 0, sizeof( challenges ) );
 	memset( userCmds, 0, sizeof( userCmds ) );
 	for ( i = 0; i < MAX_ASYNC_CLIENTS; i++ ) {
@@ -654,6 +655,8 @@ void idAsyncServer::ClearClient( int clientNum ) {
 	client.snapshotSequence = 0;
 	client.acknowledgeSnapshotSequence = 0;
 	client.numDuplicatedUsercmds = 0;
+	client.snapshotUsercmdBytes = 0;
+	client.usercmdAckFrame = -1;
 }
 
 /*
@@ -688,6 +691,8 @@ void idAsyncServer::InitClient( int clientNum, int clientId, int clientRate ) {
 	client.lastInputTime = serverTime;
 	client.acknowledgeSnapshotSequence = 0;
 	client.numDuplicatedUsercmds = 0;
+	client.snapshotUsercmdBytes = 0;
+	client.usercmdAckFrame = -1;
 
 	// clear the user commands
 	for ( i = 0; i < MAX_USERCMD_BACKUP; i++ ) {
@@ -1144,15 +1149,15 @@ void idAsyncServer::SendGameInitToClient( int clientNum ) {
 
 /*
 ==================
-idAsyncServer::SendSnapshotToClient
+idAsyncServer::BeginSnapshotToClient
+
+  Writes the snapshot header, the game snapshot is written for all clients at once
+  before the snapshots are sent with FinishSnapshotToClient.
 ==================
 */
-bool idAsyncServer::SendSnapshotToClient( int clientNum ) {
-	int			i, j, index, numUsercmds;
-	idBitMsg	msg;
-	byte		msgBuf[MAX_MESSAGE_SIZE];
-	usercmd_t *	last;
-	byte		clientInPVS[MAX_ASYNC_CLIENTS >> 3];
+bool idAsyncServer::BeginSnapshotToClient( int clientNum, snapshotRequest_t &request ) {
+	int		rate;
+	float	compression;
 
 	serverClient_t &client = clients[clientNum];
 
@@ -1168,7 +1173,8 @@ bool idAsyncServer::SendSnapshotToClient( int clientNum ) {
 	client.clientAheadTime = client.gameTime - ( gameTime + gameTimeResidual );
 
 	// write the snapshot
-	msg.Init( msgBuf, sizeof( msgBuf ) );
+	idBitMsg &msg = snapshotMsgs[clientNum];
+	msg.Init( snapshotMsgBufs[clientNum], sizeof( snapshotMsgBufs[clientNum] ) );
 	msg.WriteLong( gameInitId );
 	msg.WriteByte( SERVER_UNRELIABLE_MESSAGE_SNAPSHOT );
 	msg.WriteLong( client.snapshotSequence );
@@ -1176,9 +1182,45 @@ bool idAsyncServer::SendSnapshotToClient( int clientNum ) {
 	msg.WriteLong( gameTime );
 	msg.WriteByte( idMath::ClampChar( client.numDuplicatedUsercmds ) );
 	msg.WriteShort( idMath::ClampShort( client.clientAheadTime ) );
+	msg.WriteLong( client.usercmdAckFrame );
+
+	request.clientNum = clientNum;
+	request.sequence = client.snapshotSequence;
+	request.msg = &msg;
+	request.clientInPVS = snapshotClientInPVS[clientNum];
+	memset( request.clientInPVS, 0, sizeof( snapshotClientInPVS[clientNum] ) );
+
+	// the game postpones the entities that don't fit in what the rate allows until the next snapshot
+	rate = client.channel.GetMaxOutgoingRate();
+	if ( rate > 0 ) {
+		// the game writes uncompressed data, assume the compression of the last message
+		compression = idMath::ClampFloat( 0.0f, 75.0f, client.channel.GetOutgoingCompression() );
+		request.maxBytes = rate * Max( idAsyncNetwork::serverSnapshotDelay.GetInteger(), USERCMD_MSEC ) / 1000;
+		request.maxBytes = idMath::FtoiFast( request.maxBytes * 100.0f / ( 100.0f - compression ) ) - client.snapshotUsercmdBytes;
+		request.maxBytes = Max( request.maxBytes, 1 );
+	} else {
+		request.maxBytes = 0;
+	}
+
+	return true;
+}
+
+/*
+==================
+idAsyncServer::FinishSnapshotToClient
+
+  Appends the user commands of the other clients to the snapshot and sends it.
+==================
+*/
+void idAsyncServer::FinishSnapshotToClient( const snapshotRequest_t &request ) {
+	int			i, j, index, numUsercmds;
+	usercmd_t *	last;
+	const int	clientNum = request.clientNum;
+	idBitMsg &	msg = *request.msg;
+	const byte *clientInPVS = request.clientInPVS;
+	const int	usercmdStart = msg.GetSize();
 
-	// write the game snapshot
-	game->ServerWriteSnapshot( clientNum, client.snapshotSequence, msg, clientInPVS, MAX_ASYNC_CLIENTS );
+	serverClient_t &client = clients[clientNum];
 
 	// write the latest user commands from the other clients in the PVS to the snapshot
 	for ( last = NULL, i = 0; i < MAX_ASYNC_CLIENTS; i++ ) {
@@ -1207,13 +1249,13 @@ bool idAsyncServer::SendSnapshotToClient( int clientNum ) {
 	}
 	msg.WriteByte( MAX_ASYNC_CLIENTS );
 
+	client.snapshotUsercmdBytes = msg.GetSize() - usercmdStart;
+
 	client.channel.SendMessage( serverPort, serverTime, msg );
 
 	client.lastSnapshotTime = serverTime;
 	client.snapshotSequence++;
 	client.numDuplicatedUsercmds = 0;
-
-	return true;
 }
 
 /*
@@ -1222,7 +1264,7 @@ idAsyncServer::ProcessUnreliableClientMessage
 ==================
 */
 void idAsyncServer::ProcessUnreliableClientMessage( int clientNum, const idBitMsg &msg ) {
-	int i, id, acknowledgeSequence, clientGameInitId, clientGameFrame, numUsercmds, index;
+	int i, id, acknowledgeSequence, clientGameInitId, clientGameFrame, numUsercmds, baseOffset, index;
 	usercmd_t *last;
 
 	serverClient_t &client = clients[clientNum];
@@ -1315,7 +1357,21 @@ void idAsyncServer::ProcessUnreliableClientMessage( int clientNum, const idBitMs
 			// read user commands
 			clientGameFrame = msg.ReadLong();
 			numUsercmds = msg.ReadByte();
-			for ( last = NULL, i = clientGameFrame - numUsercmds + 1; i <= clientGameFrame; i++ ) {
+			baseOffset = msg.ReadByte();
+
+			// the user commands are packed against one the client knows we have
+			last = NULL;
+			if ( baseOffset ) {
+				last = &userCmds[( clientGameFrame - baseOffset ) & ( MAX_USERCMD_BACKUP - 1 )][clientNum];
+				if ( baseOffset > MAX_USERCMD_BASELINE_AGE || last->gameFrame != clientGameFrame - baseOffset ) {
+					if ( idAsyncNetwork::verbose.GetInteger() ) {
+						common->Printf( "ignore user commands from client %d, missing base frame %d\n", clientNum, clientGameFrame - baseOffset );
+					}
+					break;
+				}
+			}
+
+			for ( i = clientGameFrame - numUsercmds + 1; i <= clientGameFrame; i++ ) {
 				index = i & ( MAX_USERCMD_BACKUP - 1 );
 				idAsyncNetwork::ReadUserCmdDelta( msg, userCmds[index][clientNum], last );
 				userCmds[index][clientNum].gameFrame = i;
@@ -1326,9 +1382,10 @@ void idAsyncServer::ProcessUnreliableClientMessage( int clientNum, const idBitMs
 				last = &userCmds[index][clientNum];
 			}
 
-			if ( last ) {
+			if ( numUsercmds ) {
 				client.gameFrame = last->gameFrame;
 				client.gameTime = last->gameTime;
+				client.usercmdAckFrame = Max( client.usercmdAckFrame, client.gameFrame );
 			}
 
 			if ( idAsyncNetwork::verbose.GetInteger() == 2 ) {
@@ -1672,6 +1729,8 @@ idAsyncServer::ProcessConnectMessage
 */
 void idAsyncServer::ProcessConnectMessage( const netadr_t from, const idBitMsg &msg ) {
 	int			clientNum, protocol, clientDataChecksum, challenge, clientId, ping, clientRate;
+	int			clientCodecs, clientCodecTable;
+	channelCodec_t codec;
 	idBitMsg	outMsg;
 	byte		msgBuf[ MAX_MESSAGE_SIZE ];
 	char		guid[ 12 ];
@@ -1776,6 +1835,17 @@ void idAsyncServer::ProcessConnectMessage( const netadr_t from, const idBitMsg &
 	// if authState == CDK_PUREOK, the check was already performed once before entering pure checks
 	// but meanwhile, the max players may have been reached
 	msg.ReadString( password, sizeof( password ) );
+
+	// the supported codecs follow the unused PB short, older clients don't send them
+	msg.ReadShort();
+	if ( msg.GetRemaingData() >= 8 ) {
+		clientCodecs = msg.ReadLong();
+		clientCodecTable = msg.ReadLong();
+	} else {
+		clientCodecs = 1 << CHANNEL_CODEC_RUNLENGTH;
+		clientCodecTable = 0;
+	}
+
 	char reason[MAX_STRING_CHARS];
 	allowReply_t reply = game->ServerAllowClient( numClients, Sys_NetAdrToString( from ), guid, password, reason );
 	if ( reply != ALLOW_YES ) {
@@ -1866,6 +1936,11 @@ void idAsyncServer::ProcessConnectMessage( const netadr_t from, const idBitMsg &
 	outMsg.WriteLong( gameTime );
 	outMsg.WriteDeltaDict( sessLocal.mapSpawnData.serverInfo, NULL );
 
+	// the codec is switched on both sides before the first channel message
+	codec = idMsgChannel::NegotiateCodec( clientCodecs, clientCodecTable );
+	clients[ clientNum ].channel.SetCodec( codec );
+	outMsg.WriteByte( codec );
+
 	serverPort.SendPacket( from, outMsg.GetData(), outMsg.GetSize() );
 
 	InitClient( clientNum, clientId, clientRate );
@@ -2371,13 +2446,14 @@ idAsyncServer::RunFrame
 ==================
 */
 void idAsyncServer::RunFrame( void ) {
-	int			i, msec, size;
+	int			i, msec, size, numSnapshots;
 	bool		newPacket;
 	idBitMsg	msg;
 	byte		msgBuf[MAX_MESSAGE_SIZE];
 	netadr_t	from;
 	int			outgoingRate, incomingRate;
 	float		outgoingCompression, incomingCompression;
+	double		startTicks;
 
 	msec = UpdateTime( 100 );
 
@@ -2415,6 +2491,8 @@ void idAsyncServer::RunFrame( void ) {
 
 	} while( gameTimeResidual < USERCMD_MSEC );
 
+	startTicks = Sys_GetClockTicks();
+
 	// send heart beat to master servers
 	MasterHeartbeat();
 
@@ -2477,6 +2555,7 @@ void idAsyncServer::RunFrame( void ) {
 	DuplicateUsercmds( gameFrame, gameTime );
 
 	// send snapshots to connected clients
+	numSnapshots = 0;
 	for ( i = 0; i < MAX_ASYNC_CLIENTS; i++ ) {
 		serverClient_t &client = clients[i];
 
@@ -2501,7 +2580,9 @@ void idAsyncServer::RunFrame( void ) {
 		}
 
 		if ( client.clientState == SCS_INGAME ) {
-			if ( !SendSnapshotToClient( i ) ) {
+			if ( BeginSnapshotToClient( i, snapshotRequests[numSnapshots] ) ) {
+				numSnapshots++;
+			} else {
 				SendPingToClient( i );
 			}
 		} else {
@@ -2509,6 +2590,16 @@ void idAsyncServer::RunFrame( void ) {
 		}
 	}
 
+	// the game writes the snapshots for all clients together so it can build them in parallel
+	if ( numSnapshots ) {
+		game->ServerWriteSnapshots( snapshotRequests, numSnapshots, MAX_ASYNC_CLIENTS );
+		for ( i = 0; i < numSnapshots; i++ ) {
+			FinishSnapshotToClient( snapshotRequests[i] );
+		}
+	}
+
+	frameTime = idMath::FtoiFast( ( Sys_GetClockTicks() - startTicks ) * 1000000.0 / Sys_ClockTicksPerSecond() );
+
 	if ( com_showAsyncStats.GetBool() ) {
 
 		UpdateAsyncStatsAvg();
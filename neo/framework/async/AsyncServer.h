@@ -122,6 +122,8 @@ typedef struct serverClient_s {
 	int					snapshotSequence;
 	int					acknowledgeSnapshotSequence;
 	int					numDuplicatedUsercmds;
+	int					snapshotUsercmdBytes;		// bytes of the relayed user commands in the last snapshot
+	int					usercmdAckFrame;			// newest user command received, -1 if none
 
 	char				guid[12];  // Even Balance - M. Quinn
 
@@ -142,6 +144,8 @@ public:
 	netadr_t			GetBoundAdr( void ) const;
 	bool				IsActive( void ) const { return active; }
 	int					GetDelay( void ) const { return gameTimeResidual; }
+	int					GetGameFrame( void ) const { return gameFrame; }
+	int					GetFrameTime( void ) const { return frameTime; }
 	int					GetOutgoingRate( void ) const;
 	int					GetIncomingRate( void ) const;
 	bool				IsClientInGame( int clientNum ) const;
@@ -195,6 +199,7 @@ private:
 	int					gameFrame;					// local game frame
 	int					gameTime;					// local game time
 	int					gameTimeResidual;			// left over time from previous frame
+	int					frameTime;					// microseconds the last frame spent running the game and sending snapshots
 
 	netadr_t			rconAddress;
 
@@ -207,6 +212,12 @@ private:
 
 	int					lastAuthTime;				// global for auth server timeout
 
+	// snapshots for all clients are written by the game at once
+	snapshotRequest_t	snapshotRequests[MAX_ASYNC_CLIENTS];
+	idBitMsg			snapshotMsgs[MAX_ASYNC_CLIENTS];
+	byte				snapshotMsgBufs[MAX_ASYNC_CLIENTS][MAX_MESSAGE_SIZE];
+	byte				snapshotClientInPVS[MAX_ASYNC_CLIENTS][MAX_ASYNC_CLIENTS >> 3];
+
 	// track the max outgoing rate over the last few secs to watch for spikes
 	// dependent on net_serverSnapshotDelay. 50ms, for a 3 seconds backlog -> 60 samples
 	static const int	stats_numsamples = 60;
@@ -234,7 +245,8 @@ private:
 	bool				SendEmptyToClient( int clientNum, bool force = false );
 	bool				SendPingToClient( int clientNum );
 	void				SendGameInitToClient( int clientNum );
-	bool				SendSnapshotToClient( int clientNum );
+	bool				BeginSnapshotToClient( int clientNum, snapshotRequest_t &request );
+	void				FinishSnapshotToClient( const snapshotRequest_t &request );
 	void				ProcessUnreliableClientMessage( int clientNum, const idBitMsg &msg );
 	void				ProcessReliableClientMessages( int clientNum );
 	void				ProcessChallengeMessage( const netadr_t from, const idBitMsg &msg );
@@ -54,6 +54,138 @@ All fragments will have the same sequence numbers.
 
 idCVar net_channelShowPackets( "net_channelShowPackets", "0", CVAR_SYSTEM | CVAR_BOOL, "show all packets" );
 idCVar net_channelShowDrop( "net_channelShowDrop", "0", CVAR_SYSTEM | CVAR_BOOL, "show dropped packets" );
+idCVar net_channelCodec( "net_channelCodec", "0", CVAR_SYSTEM | CVAR_INTEGER | CVAR_ARCHIVE, "codec the server prefers for new connections: 0 = run length, 1 = Huffman, 2 = trained Huffman, 3 = arithmetic, 4 = LZSS, 5 = LZW", 0, CHANNEL_CODEC_MAX - 1, idCmdSystem::ArgCompletion_Integer<0,CHANNEL_CODEC_MAX - 1> );
+idCVar net_channelCodecStats( "net_channelCodecStats", "0", CVAR_SYSTEM | CVAR_BOOL, "compress the outgoing messages with all codecs to compare them, see netCodecStats" );
+idCVar net_channelCodecTrain( "net_channelCodecTrain", "0", CVAR_SYSTEM | CVAR_BOOL, "count the bytes of the outgoing messages to train the Huffman table, see netCodecTrain" );
+idCVar net_channelCodecTable( "net_channelCodecTable", "netcodec.dat", CVAR_SYSTEM | CVAR_INIT, "file with the trained Huffman table" );
+
+typedef struct channelCodecStats_s {
+	int					numCompressed;
+	int64				rawBytes;
+	int64				packedBytes;
+	double				compressTicks;
+	int					numDecompressed;
+	double				decompressTicks;
+} channelCodecStats_t;
+
+static const char *			channelCodecNames[CHANNEL_CODEC_MAX] = { "run length", "Huffman", "trained Huffman", "arithmetic", "LZSS", "LZW" };
+static const int			channelCodecWordLength[CHANNEL_CODEC_MAX] = { 3, 8, 8, 8, 8, 8 };
+static channelCodecStats_t	channelCodecStats[CHANNEL_CODEC_MAX];
+static idCompressor *		channelCodecCompressors[CHANNEL_CODEC_MAX];		// used to compare the codecs
+
+static bool					codecTableLoaded = false;
+static int					codecTableCounts[256];
+static int					codecTableChecksum;
+static int					codecTrainCounts[256];
+
+/*
+===============
+LoadCodecTable
+
+  Loads the symbol counts of the trained Huffman codec. Without a trained
+  table the counts favor zero bytes, like the run length codec.
+===============
+*/
+static void LoadCodecTable( void ) {
+	int i, littleCounts[256];
+	idFile *f;
+
+	if ( codecTableLoaded ) {
+		return;
+	}
+	codecTableLoaded = true;
+
+	f = fileSystem->OpenFileRead( net_channelCodecTable.GetString() );
+	if ( f ) {
+		for ( i = 0; i < 256; i++ ) {
+			f->ReadInt( codecTableCounts[i] );
+		}
+		fileSystem->CloseFile( f );
+	} else {
+		for ( i = 0; i < 256; i++ ) {
+			codecTableCounts[i] = 1 + ( 256 >> idMath::BitCount( i ) );
+		}
+		codecTableCounts[0] = 4096;
+	}
+
+	for ( i = 0; i < 256; i++ ) {
+		littleCounts[i] = LittleLong( codecTableCounts[i] );
+	}
+	codecTableChecksum = CRC32_BlockChecksum( littleCounts, sizeof( littleCounts ) );
+}
+
+/*
+===============
+AllocCodec
+===============
+*/
+static idCompressor *AllocCodec( channelCodec_t codec ) {
+	switch( codec ) {
+		case CHANNEL_CODEC_HUFFMAN:
+			return idCompressor::AllocHuffman();
+		case CHANNEL_CODEC_TRAINED_HUFFMAN:
+			LoadCodecTable();
+			return idCompressor::AllocStaticHuffman( codecTableCounts );
+		case CHANNEL_CODEC_ARITHMETIC:
+			return idCompressor::AllocArithmetic();
+		case CHANNEL_CODEC_LZSS:
+			return idCompressor::AllocLZSS();
+		case CHANNEL_CODEC_LZW:
+			return idCompressor::AllocLZW();
+		default:
+			return idCompressor::AllocRunLength_ZeroBased();
+	}
+}
+
+/*
+===============
+CompareCodecs
+
+  Compresses and decompresses the message with all codecs other than the one
+  used by the channel so they can be compared on the same traffic.
+===============
+*/
+static void CompareCodecs( channelCodec_t used, const idBitMsg &msg ) {
+	int i;
+	double startTicks;
+	idBitMsg packed, unpacked;
+	byte packedBuf[MAX_MESSAGE_SIZE * 2], unpackedBuf[MAX_MESSAGE_SIZE];
+
+	for ( i = 0; i < CHANNEL_CODEC_MAX; i++ ) {
+		if ( i == used ) {
+			continue;
+		}
+		if ( !channelCodecCompressors[i] ) {
+			channelCodecCompressors[i] = AllocCodec( (channelCodec_t)i );
+		}
+		idCompressor *compressor = channelCodecCompressors[i];
+		channelCodecStats_t &stats = channelCodecStats[i];
+
+		packed.Init( packedBuf, sizeof( packedBuf ) );
+		packed.SetAllowOverflow( true );
+		packed.BeginWriting();
+
+		startTicks = Sys_GetClockTicks();
+		idFile_BitMsg packFile( packed );
+		compressor->Init( &packFile, true, channelCodecWordLength[i] );
+		compressor->Write( msg.GetData(), msg.GetSize() );
+		compressor->FinishCompress();
+		stats.compressTicks += Sys_GetClockTicks() - startTicks;
+		stats.numCompressed++;
+		stats.rawBytes += msg.GetSize();
+		stats.packedBytes += packed.GetSize();
+
+		unpacked.Init( unpackedBuf, sizeof( unpackedBuf ) );
+		packed.BeginReading();
+
+		startTicks = Sys_GetClockTicks();
+		idFile_BitMsg unpackFile( static_cast<const idBitMsg &>( packed ) );
+		compressor->Init( &unpackFile, false, channelCodecWordLength[i] );
+		compressor->Read( unpacked.GetData(), msg.GetSize() );
+		stats.decompressTicks += Sys_GetClockTicks() - startTicks;
+		stats.numDecompressed++;
+	}
+}
 
 /*
 ===============
@@ -247,6 +379,13 @@ idMsgChannel::idMsgChannel
 */
 idMsgChannel::idMsgChannel() {
 	id = -1;
+	compressor = NULL;
+	codec = CHANNEL_CODEC_RUNLENGTH;
+	outgoingFragments = 0;
+	incomingFragments = 0;
+	incomingFragmentedMessages = 0;
+	incomingDroppedFragmentedMessages = 0;
+	droppedFragmentSequence = 0;
 }
 
 /*
@@ -261,6 +400,7 @@ void idMsgChannel::Init( const netadr_t adr, const int id ) {
 	this->id = id;
 	this->maxRate = 50000;
 	this->compressor = idCompressor::AllocRunLength_ZeroBased();
+	this->codec = CHANNEL_CODEC_RUNLENGTH;
 
 	lastSendTime = 0;
 	lastDataBytes = 0;
@@ -279,6 +419,11 @@ void idMsgChannel::Init( const netadr_t adr, const int id ) {
 	unsentFragmentStart = 0;
 	fragmentSequence = 0;
 	fragmentLength = 0;
+	outgoingFragments = 0;
+	incomingFragments = 0;
+	incomingFragmentedMessages = 0;
+	incomingDroppedFragmentedMessages = 0;
+	droppedFragmentSequence = 0;
 	reliableSend.Init( 1 );
 	reliableReceive.Init( 0 );
 }
@@ -293,6 +438,129 @@ void idMsgChannel::Shutdown( void ) {
 	compressor = NULL;
 }
 
+/*
+===============
+idMsgChannel::SetCodec
+================
+*/
+void idMsgChannel::SetCodec( channelCodec_t codec ) {
+	if ( codec < 0 || codec >= CHANNEL_CODEC_MAX ) {
+		codec = CHANNEL_CODEC_RUNLENGTH;
+	}
+	if ( codec == this->codec && compressor ) {
+		return;
+	}
+	delete compressor;
+	compressor = AllocCodec( codec );
+	this->codec = codec;
+}
+
+/*
+===============
+idMsgChannel::GetSupportedCodecs
+================
+*/
+int idMsgChannel::GetSupportedCodecs( void ) {
+	return ( 1 << CHANNEL_CODEC_MAX ) - 1;
+}
+
+/*
+===============
+idMsgChannel::GetCodecTableChecksum
+================
+*/
+int idMsgChannel::GetCodecTableChecksum( void ) {
+	LoadCodecTable();
+	return codecTableChecksum;
+}
+
+/*
+===============
+idMsgChannel::NegotiateCodec
+
+  Falls back to run length compression which every client supports.
+================
+*/
+channelCodec_t idMsgChannel::NegotiateCodec( int remoteCodecs, int remoteTableChecksum ) {
+	int preferred = net_channelCodec.GetInteger();
+
+	if ( preferred <= CHANNEL_CODEC_RUNLENGTH || preferred >= CHANNEL_CODEC_MAX ) {
+		return CHANNEL_CODEC_RUNLENGTH;
+	}
+	if ( !( remoteCodecs & ( 1 << preferred ) ) ) {
+		return CHANNEL_CODEC_RUNLENGTH;
+	}
+	if ( preferred == CHANNEL_CODEC_TRAINED_HUFFMAN && remoteTableChecksum != GetCodecTableChecksum() ) {
+		common->Printf( "remote side uses a different Huffman table, falling back to run length compression\n" );
+		return CHANNEL_CODEC_RUNLENGTH;
+	}
+	return (channelCodec_t)preferred;
+}
+
+/*
+===============
+idMsgChannel::PrintCodecStats
+================
+*/
+void idMsgChannel::PrintCodecStats( void ) {
+	int i;
+	double toMicroseconds = 1000000.0 / Sys_ClockTicksPerSecond();
+
+	common->Printf( "codec             msgs    raw KB packed KB  ratio  comp us  decomp us\n" );
+	for ( i = 0; i < CHANNEL_CODEC_MAX; i++ ) {
+		const channelCodecStats_t &stats = channelCodecStats[i];
+		common->Printf( "%-15s %6d %9.1f %9.1f %5.1f%% %8.2f %10.2f\n", channelCodecNames[i], stats.numCompressed,
+						stats.rawBytes / 1024.0f, stats.packedBytes / 1024.0f,
+						stats.rawBytes ? stats.packedBytes * 100.0f / stats.rawBytes : 0.0f,
+						stats.numCompressed ? stats.compressTicks * toMicroseconds / stats.numCompressed : 0.0,
+						stats.numDecompressed ? stats.decompressTicks * toMicroseconds / stats.numDecompressed : 0.0 );
+	}
+	if ( !net_channelCodecStats.GetBool() ) {
+		common->Printf( "only the codecs in use are measured, set net_channelCodecStats 1 to compare all codecs\n" );
+	}
+}
+
+/*
+===============
+idMsgChannel::ClearCodecStats
+================
+*/
+void idMsgChannel::ClearCodecStats( void ) {
+	memset( channelCodecStats, 0, sizeof( channelCodecStats ) );
+}
+
+/*
+===============
+idMsgChannel::WriteCodecTable
+================
+*/
+void idMsgChannel::WriteCodecTable( void ) {
+	int i;
+	int64 total;
+	idFile *f;
+
+	total = 0;
+	for ( i = 0; i < 256; i++ ) {
+		total += codecTrainCounts[i];
+	}
+	if ( !total ) {
+		common->Printf( "no traffic was counted, set net_channelCodecTrain 1 while a server is running\n" );
+		return;
+	}
+
+	f = fileSystem->OpenFileWrite( net_channelCodecTable.GetString() );
+	if ( !f ) {
+		common->Warning( "couldn't write %s", net_channelCodecTable.GetString() );
+		return;
+	}
+	for ( i = 0; i < 256; i++ ) {
+		f->WriteInt( codecTrainCounts[i] );
+	}
+	fileSystem->CloseFile( f );
+
+	common->Printf( "wrote %s, the server and clients use it after a restart\n", net_channelCodecTable.GetString() );
+}
+
 /*
 =================
 idMsgChannel::ResetRate
@@ -333,6 +601,8 @@ idMsgChannel::WriteMessageData
 void idMsgChannel::WriteMessageData( idBitMsg &out, const idBitMsg &msg ) {
 	idBitMsg tmp;
 	byte tmpBuf[MAX_MESSAGE_SIZE];
+	int i, packedStart;
+	double startTicks;
 
 	tmp.Init( tmpBuf, sizeof( tmpBuf ) );
 
@@ -351,11 +621,37 @@ void idMsgChannel::WriteMessageData( idBitMsg &out, const idBitMsg &msg ) {
 	out.WriteShort( tmp.GetSize() );
 
 	// compress message
+	packedStart = out.GetSize();
+	startTicks = Sys_GetClockTicks();
 	idFile_BitMsg file( out );
-	compressor->Init( &file, true, 3 );
+	compressor->Init( &file, true, channelCodecWordLength[codec] );
 	compressor->Write( tmp.GetData(), tmp.GetSize() );
 	compressor->FinishCompress();
 	outgoingCompression = compressor->GetCompressionRatio();
+
+	channelCodecStats[codec].compressTicks += Sys_GetClockTicks() - startTicks;
+	channelCodecStats[codec].numCompressed++;
+	channelCodecStats[codec].rawBytes += tmp.GetSize();
+	channelCodecStats[codec].packedBytes += out.GetSize() - packedStart;
+
+	if ( net_channelCodecStats.GetBool() ) {
+		CompareCodecs( codec, tmp );
+	}
+
+	if ( net_channelCodecTrain.GetBool() ) {
+		bool overflow = false;
+		for ( i = 0; i < tmp.GetSize(); i++ ) {
+			if ( ++codecTrainCounts[tmp.GetData()[i]] > ( 1 << 30 ) ) {
+				overflow = true;
+			}
+		}
+		// keep the counts from overflowing
+		if ( overflow ) {
+			for ( i = 0; i < 256; i++ ) {
+				codecTrainCounts[i] >>= 1;
+			}
+		}
+	}
 }
 
 /*
@@ -365,15 +661,19 @@ idMsgChannel::ReadMessageData
 */
 bool idMsgChannel::ReadMessageData( idBitMsg &out, const idBitMsg &msg ) {
 	int reliableAcknowledge, reliableMessageSize, reliableSequence;
+	double startTicks;
 
 	// read message size
 	out.SetSize( msg.ReadShort() );
 
 	// decompress message
+	startTicks = Sys_GetClockTicks();
 	idFile_BitMsg file( msg );
-	compressor->Init( &file, false, 3 );
+	compressor->Init( &file, false, channelCodecWordLength[codec] );
 	compressor->Read( out.GetData(), out.GetSize() );
 	incomingCompression = compressor->GetCompressionRatio();
+	channelCodecStats[codec].decompressTicks += Sys_GetClockTicks() - startTicks;
+	channelCodecStats[codec].numDecompressed++;
 	out.BeginReading();
 
 	// read acknowledgement of sent reliable messages
@@ -444,6 +744,8 @@ void idMsgChannel::SendNextFragment( idPort &port, const int time ) {
 	// update rate control variables
 	UpdateOutgoingRate( time, msg.GetSize() );
 
+	outgoingFragments++;
+
 	if ( net_channelShowPackets.GetBool() ) {
 		common->Printf( "%d send %4i : s = %i fragment = %i,%i\n", id, msg.GetSize(), outgoingSequence - 1, unsentFragmentStart, fragLength );
 	}
@@ -605,6 +907,8 @@ bool idMsgChannel::Process( const netadr_t from, int time, idBitMsg &msg, int &s
 	// if the message is fragmented
 	//
 	if ( fragmented ) {
+		incomingFragments++;
+
 		// make sure we have the correct sequence number
 		if ( sequence != fragmentSequence ) {
 			fragmentSequence = sequence;
@@ -616,6 +920,11 @@ bool idMsgChannel::Process( const netadr_t from, int time, idBitMsg &msg, int &s
 			if ( net_channelShowDrop.GetBool() || net_channelShowPackets.GetBool() ) {
 				common->Printf( "%s: dropped a message fragment at seq %d\n", Sys_NetAdrToString( remoteAddress ), sequence );
 			}
+			// only count the message once, the remaining fragments are dropped as well
+			if ( droppedFragmentSequence != sequence ) {
+				droppedFragmentSequence = sequence;
+				incomingDroppedFragmentedMessages++;
+			}
 			// we can still keep the part that we have so far,
 			// so we don't need to clear fragmentLength
 			UpdatePacketLoss( time, 0, 1 );
@@ -642,6 +951,8 @@ bool idMsgChannel::Process( const netadr_t from, int time, idBitMsg &msg, int &s
 			return false;
 		}
 
+		incomingFragmentedMessages++;
+
 	} else {
 		memcpy( fragmentBuffer, msg.GetData() + msg.GetReadCount(), msg.GetRemaingData() );
 		fragmentLength = msg.GetRemaingData();
@@ -85,6 +85,17 @@ private:
 };
 
 
+// codecs used to compress the channel messages
+typedef enum {
+	CHANNEL_CODEC_RUNLENGTH,			// zero based run length
+	CHANNEL_CODEC_HUFFMAN,				// adaptive Huffman
+	CHANNEL_CODEC_TRAINED_HUFFMAN,		// static Huffman with a table trained on the channel traffic
+	CHANNEL_CODEC_ARITHMETIC,			// adaptive arithmetic coding
+	CHANNEL_CODEC_LZSS,					// LZSS
+	CHANNEL_CODEC_LZW,					// LZW
+	CHANNEL_CODEC_MAX
+} channelCodec_t;
+
 class idMsgChannel {
 public:
 					idMsgChannel();
@@ -93,6 +104,28 @@ public:
 	void			Shutdown( void );
 	void			ResetRate( void );
 
+					// Sets the codec used to compress the messages. Both sides of the channel must use the same codec.
+	void			SetCodec( channelCodec_t codec );
+
+					// Returns the codec used to compress the messages.
+	channelCodec_t	GetCodec( void ) const { return codec; }
+
+					// Returns a bit mask with the codecs this side of the channel can use.
+	static int		GetSupportedCodecs( void );
+
+					// Returns the checksum of the trained Huffman table, both sides need the same table.
+	static int		GetCodecTableChecksum( void );
+
+					// Picks the preferred codec that is also supported by the remote side.
+	static channelCodec_t NegotiateCodec( int remoteCodecs, int remoteTableChecksum );
+
+					// Prints the bytes and time spent per codec.
+	static void		PrintCodecStats( void );
+	static void		ClearCodecStats( void );
+
+					// Writes the symbol counts collected while net_channelCodecTrain is set.
+	static void		WriteCodecTable( void );
+
 					// Sets the maximum outgoing rate.
 	void			SetMaxOutgoingRate( int rate ) { maxRate = rate; }
 
@@ -117,6 +150,14 @@ public:
 					// Returns the average incoming packet loss over the last 5 seconds.
 	float			GetIncomingPacketLoss( void ) const;
 
+					// Returns the number of fragments sent and received since the channel was opened.
+	int				GetOutgoingFragments( void ) const { return outgoingFragments; }
+	int				GetIncomingFragments( void ) const { return incomingFragments; }
+
+					// Returns the number of fragmented messages completely received and the number dropped because a fragment was lost.
+	int				GetIncomingFragmentedMessages( void ) const { return incomingFragmentedMessages; }
+	int				GetIncomingDroppedFragmentedMessages( void ) const { return incomingDroppedFragmentedMessages; }
+
 					// Returns true if the channel is ready to send new data based on the maximum rate.
 	bool			ReadyToSend( const int time ) const;
 
@@ -149,6 +190,7 @@ private:
 	int				id;				// our identification used instead of port number
 	int				maxRate;		// maximum number of bytes that may go out per second
 	idCompressor *	compressor;		// compressor used for data compression
+	channelCodec_t	codec;			// codec of the compressor
 
 	// variables to control the outgoing rate
 	int				lastSendTime;	// last time data was sent out
@@ -184,6 +226,13 @@ private:
 	int				fragmentLength;
 	byte			fragmentBuffer[MAX_MESSAGE_SIZE];
 
+	// variables to keep track of the fragmentation
+	int				outgoingFragments;
+	int				incomingFragments;
+	int				incomingFragmentedMessages;
+	int				incomingDroppedFragmentedMessages;
+	int				droppedFragmentSequence;
+
 	// reliable messages
 	idMsgQueue		reliableSend;
 	idMsgQueue		reliableReceive;
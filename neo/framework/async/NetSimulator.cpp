@@ -0,0 +1,834 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code (?Doom 3 Source Code?).
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "../../idlib/precompiled.h"
+#pragma hdrstop
+
+#include "AsyncNetwork.h"
+
+#include "../Session_local.h"
+
+const int SIM_CONNECT_RESEND_TIME		= 1000;
+
+idCVar net_simLatency( "net_simLatency", "0", CVAR_SYSTEM | CVAR_INTEGER, "one way latency in milliseconds of the simulated client links", 0, 1000 );
+idCVar net_simJitter( "net_simJitter", "0", CVAR_SYSTEM | CVAR_INTEGER, "maximum random latency in milliseconds added to each packet on the simulated client links", 0, 1000 );
+idCVar net_simLoss( "net_simLoss", "0", CVAR_SYSTEM | CVAR_FLOAT, "percentage of packets dropped on the simulated client links", 0, 100 );
+idCVar net_simReport( "net_simReport", "0", CVAR_SYSTEM | CVAR_INTEGER, "print the network simulation stats every this many seconds, 0 = off", 0, 3600 );
+idCVar net_simQuit( "net_simQuit", "0", CVAR_SYSTEM | CVAR_BOOL, "quit after a timed network simulation printed its stats" );
+
+static const char *simClientStateNames[] = {
+	"challenging",
+	"connecting",
+	"ingame"
+};
+
+/*
+==================
+SimLoopbackAdr
+
+  Ports bound to any interface are reached through the loopback interface.
+==================
+*/
+static netadr_t SimLoopbackAdr( netadr_t adr ) {
+	if ( adr.type == NA_LOOPBACK || ( adr.ip[0] | adr.ip[1] | adr.ip[2] | adr.ip[3] ) == 0 ) {
+		adr.type = NA_LOOPBACK;
+		adr.ip[0] = 127;
+		adr.ip[1] = 0;
+		adr.ip[2] = 0;
+		adr.ip[3] = 1;
+	}
+	return adr;
+}
+
+/*
+==================
+idNetSimulator::idNetSimulator
+==================
+*/
+idNetSimulator::idNetSimulator( void ) {
+	memset( &serverAdr, 0, sizeof( serverAdr ) );
+	realTime = 0;
+	startTime = 0;
+	stopTime = 0;
+	lastServerFrame = 0;
+	nextReportTime = 0;
+	memset( &stats, 0, sizeof( stats ) );
+}
+
+/*
+==================
+idNetSimulator::Start
+==================
+*/
+void idNetSimulator::Start( int numClients, int seconds ) {
+	int i;
+
+	if ( !idAsyncNetwork::server.IsActive() ) {
+		common->Printf( "network simulation needs a running server\n" );
+		return;
+	}
+
+	// the fake clients don't have pak checksums to send
+	if ( sessLocal.mapSpawnData.serverInfo.GetBool( "si_pure" ) ) {
+		common->Printf( "network simulation needs a server with si_pure 0\n" );
+		return;
+	}
+
+	Stop();
+
+	numClients = idMath::ClampInt( 1, MAX_ASYNC_CLIENTS, numClients );
+	serverAdr = SimLoopbackAdr( idAsyncNetwork::server.GetBoundAdr() );
+
+	// the same seed for every run so runs with the same settings can be compared
+	random.SetSeed( 0 );
+
+	realTime = Sys_Milliseconds();
+	stopTime = seconds > 0 ? realTime + seconds * 1000 : 0;
+	nextReportTime = realTime + net_simReport.GetInteger() * 1000;
+
+	for ( i = 0; i < numClients; i++ ) {
+		simClient_t *client = new simClient_t;
+		if ( !InitClient( *client, i ) ) {
+			common->Printf( "network simulation couldn't open the ports for client %d\n", i );
+			ShutdownClient( *client );
+			delete client;
+			break;
+		}
+		clients.Append( client );
+	}
+
+	ClearStats();
+
+	common->Printf( "network simulation started with %d clients on %s\n", clients.Num(), Sys_NetAdrToString( serverAdr ) );
+}
+
+/*
+==================
+idNetSimulator::Stop
+==================
+*/
+void idNetSimulator::Stop( void ) {
+	int i;
+
+	if ( !clients.Num() ) {
+		return;
+	}
+
+	for ( i = 0; i < clients.Num(); i++ ) {
+		ShutdownClient( *clients[i] );
+		delete clients[i];
+	}
+	clients.Clear();
+
+	common->Printf( "network simulation stopped\n" );
+}
+
+/*
+==================
+idNetSimulator::InitClient
+==================
+*/
+bool idNetSimulator::InitClient( simClient_t &client, int index ) {
+	int i;
+
+	client.state = SIM_CHALLENGING;
+	client.clientId = ( Sys_Milliseconds() + index ) & CONNECTIONLESS_MESSAGE_ID_MASK;
+	client.clientNum = -1;
+	client.challenge = 0;
+	client.lastConnectTime = -9999;
+	client.gameInitId = GAME_INIT_ID_INVALID;
+	client.gameFrame = 0;
+	client.gameTime = 0;
+	client.serverMessageSequence = 0;
+	client.snapshotSequence = 0;
+	for ( i = 0; i < MAX_SIM_USERCMDS; i++ ) {
+		client.userCmds[i] = usercmd_t();
+	}
+
+	client.bytesToServer = 0;
+	client.bytesToClient = 0;
+	client.packetsDropped = 0;
+	client.packetsOverflowed = 0;
+	client.numSnapshots = 0;
+	client.fragmentsBase = 0;
+	client.fragmentedMessagesBase = 0;
+	client.droppedFragmentedMessagesBase = 0;
+
+	memset( &client.adr, 0, sizeof( client.adr ) );
+	memset( &client.linkAdr, 0, sizeof( client.linkAdr ) );
+
+	if ( !client.port.InitForPort( PORT_ANY ) || !client.linkPort.InitForPort( PORT_ANY ) ) {
+		return false;
+	}
+	client.adr = SimLoopbackAdr( client.port.GetAdr() );
+	client.linkAdr = SimLoopbackAdr( client.linkPort.GetAdr() );
+
+	client.toServer.first = client.toServer.count = client.toServer.lastTime = 0;
+	client.toServer.to = serverAdr;
+	client.toClient.first = client.toClient.count = client.toClient.lastTime = 0;
+	client.toClient.to = client.adr;
+
+	return true;
+}
+
+/*
+==================
+idNetSimulator::ShutdownClient
+==================
+*/
+void idNetSimulator::ShutdownClient( simClient_t &client ) {
+	if ( client.state == SIM_INGAME ) {
+		SendDisconnect( client );
+	}
+	client.channel.Shutdown();
+	client.port.Close();
+	client.linkPort.Close();
+}
+
+/*
+==================
+idNetSimulator::RunFrame
+==================
+*/
+void idNetSimulator::RunFrame( void ) {
+	int i;
+
+	if ( !clients.Num() ) {
+		return;
+	}
+
+	if ( !idAsyncNetwork::server.IsActive() ) {
+		common->Printf( "server is no longer running\n" );
+		Stop();
+		return;
+	}
+
+	realTime = Sys_Milliseconds();
+
+	UpdateFrameStats();
+
+	for ( i = 0; i < clients.Num(); i++ ) {
+		simClient_t &client = *clients[i];
+
+		// let the packets from the server through the link and process them
+		ReadLink( client );
+		DeliverLink( client, client.toClient, false );
+		ReadPackets( client );
+
+		if ( client.state == SIM_INGAME ) {
+			SendUsercmds( client );
+		} else {
+			SetupConnection( client );
+		}
+
+		// packets without latency go out right away
+		ReadLink( client );
+		DeliverLink( client, client.toServer, false );
+	}
+
+	if ( net_simReport.GetInteger() && realTime >= nextReportTime ) {
+		PrintStats();
+		nextReportTime = realTime + net_simReport.GetInteger() * 1000;
+	}
+
+	if ( stopTime && realTime >= stopTime ) {
+		PrintStats();
+		Stop();
+		if ( net_simQuit.GetBool() ) {
+			cmdSystem->BufferCommandText( CMD_EXEC_APPEND, "quit\n" );
+		}
+	}
+}
+
+/*
+==================
+idNetSimulator::ReadLink
+
+  Queues the packets that arrived at the link port in the direction they travel.
+==================
+*/
+void idNetSimulator::ReadLink( simClient_t &client ) {
+	netadr_t	from;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+	int			size;
+
+	while ( client.linkPort.GetPacket( from, msgBuf, size, sizeof( msgBuf ) ) ) {
+		if ( Sys_CompareNetAdrBase( from, serverAdr ) && from.port == serverAdr.port ) {
+			client.bytesToClient += size;
+			QueuePacket( client, client.toClient, msgBuf, size );
+		} else if ( Sys_CompareNetAdrBase( from, client.adr ) && from.port == client.adr.port ) {
+			client.bytesToServer += size;
+			QueuePacket( client, client.toServer, msgBuf, size );
+		}
+	}
+}
+
+/*
+==================
+idNetSimulator::QueuePacket
+==================
+*/
+void idNetSimulator::QueuePacket( simClient_t &client, simLinkQueue_t &queue, const byte *data, int size ) {
+	int time;
+
+	if ( net_simLoss.GetFloat() > 0.0f && random.RandomFloat() * 100.0f < net_simLoss.GetFloat() ) {
+		client.packetsDropped++;
+		return;
+	}
+
+	// only the connectionless handshake messages can be this large
+	if ( size > MAX_SIM_PACKETLEN ) {
+		client.linkPort.SendPacket( queue.to, data, size );
+		return;
+	}
+
+	// the link is saturated
+	if ( queue.count >= MAX_SIM_LINK_PACKETS ) {
+		client.packetsOverflowed++;
+		return;
+	}
+
+	time = realTime + net_simLatency.GetInteger();
+	if ( net_simJitter.GetInteger() > 0 ) {
+		time += random.RandomInt( net_simJitter.GetInteger() + 1 );
+	}
+	if ( time < queue.lastTime ) {
+		time = queue.lastTime;
+	}
+	queue.lastTime = time;
+
+	simPacket_t &packet = queue.packets[( queue.first + queue.count ) % MAX_SIM_LINK_PACKETS];
+	packet.time = time;
+	packet.size = size;
+	memcpy( packet.data, data, size );
+	queue.count++;
+}
+
+/*
+==================
+idNetSimulator::DeliverLink
+
+  Sends the packets that spent enough time on the link, or all of them when flushing.
+==================
+*/
+void idNetSimulator::DeliverLink( simClient_t &client, simLinkQueue_t &queue, bool flush ) {
+	while ( queue.count ) {
+		simPacket_t &packet = queue.packets[queue.first];
+		if ( !flush && packet.time > realTime ) {
+			break;
+		}
+		client.linkPort.SendPacket( queue.to, packet.data, packet.size );
+		queue.first = ( queue.first + 1 ) % MAX_SIM_LINK_PACKETS;
+		queue.count--;
+	}
+}
+
+/*
+==================
+idNetSimulator::ReadPackets
+==================
+*/
+void idNetSimulator::ReadPackets( simClient_t &client ) {
+	netadr_t	from;
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+	int			size, id;
+
+	while ( client.port.GetPacket( from, msgBuf, size, sizeof( msgBuf ) ) ) {
+		msg.Init( msgBuf, sizeof( msgBuf ) );
+		msg.SetSize( size );
+		msg.BeginReading();
+
+		id = msg.ReadShort();
+		if ( id == CONNECTIONLESS_MESSAGE_ID ) {
+			ConnectionlessMessage( client, from, msg );
+			continue;
+		}
+
+		if ( client.state != SIM_INGAME || msg.GetRemaingData() < 4 ) {
+			continue;
+		}
+
+		if ( !client.channel.Process( from, realTime, msg, client.serverMessageSequence ) ) {
+			continue;	// out of order, duplicated, fragment, etc.
+		}
+
+		ProcessReliableMessages( client );
+		ProcessUnreliableMessage( client, msg );
+	}
+}
+
+/*
+==================
+idNetSimulator::ConnectionlessMessage
+==================
+*/
+void idNetSimulator::ConnectionlessMessage( simClient_t &client, const netadr_t from, const idBitMsg &msg ) {
+	char		string[MAX_STRING_CHARS];
+	int			opcode;
+	idDict		serverSI;
+
+	msg.ReadString( string, sizeof( string ) );
+
+	if ( idStr::Icmp( string, "challengeResponse" ) == 0 ) {
+		if ( client.state != SIM_CHALLENGING ) {
+			return;
+		}
+		client.challenge = msg.ReadLong();
+		client.state = SIM_CONNECTING;
+		client.lastConnectTime = -9999;
+	} else if ( idStr::Icmp( string, "connectResponse" ) == 0 ) {
+		if ( client.state != SIM_CONNECTING ) {
+			return;
+		}
+		client.channel.Shutdown();
+		client.channel.Init( from, client.clientId );
+		client.clientNum = msg.ReadLong();
+		client.gameInitId = msg.ReadLong();
+		client.gameFrame = msg.ReadLong();
+		client.gameTime = msg.ReadLong();
+		msg.ReadDeltaDict( serverSI, NULL );
+		if ( msg.GetRemaingData() > 0 ) {
+			client.channel.SetCodec( (channelCodec_t)msg.ReadByte() );
+		}
+		client.serverMessageSequence = 0;
+		client.snapshotSequence = 0;
+		client.fragmentsBase = 0;
+		client.fragmentedMessagesBase = 0;
+		client.droppedFragmentedMessagesBase = 0;
+		client.state = SIM_INGAME;
+
+		SendUserInfo( client );
+	} else if ( idStr::Icmp( string, "print" ) == 0 ) {
+		opcode = msg.ReadLong();
+		if ( opcode == SERVER_PRINT_GAMEDENY ) {
+			msg.ReadLong();
+		}
+		msg.ReadString( string, sizeof( string ) );
+		common->Printf( "network simulation client %d: %s\n", client.clientId, common->GetLanguageDict()->GetString( string ) );
+	}
+}
+
+/*
+==================
+idNetSimulator::ProcessReliableMessages
+
+  The reliable messages only need to be acknowledged.
+==================
+*/
+void idNetSimulator::ProcessReliableMessages( simClient_t &client ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+
+	while ( client.channel.GetReliableMessage( msg ) ) {
+		if ( msg.ReadByte() == SERVER_RELIABLE_MESSAGE_DISCONNECT ) {
+			common->Printf( "network simulation client %d was disconnected, reconnecting\n", client.clientNum );
+			client.state = SIM_CHALLENGING;
+			client.lastConnectTime = -9999;
+			return;
+		}
+	}
+}
+
+/*
+==================
+idNetSimulator::ProcessUnreliableMessage
+==================
+*/
+void idNetSimulator::ProcessUnreliableMessage( simClient_t &client, const idBitMsg &msg ) {
+	int serverGameInitId, id, snapshotGameFrame, snapshotGameTime, size, bucket;
+
+	if ( client.state != SIM_INGAME ) {
+		return;
+	}
+
+	serverGameInitId = msg.ReadLong();
+
+	id = msg.ReadByte();
+	switch( id ) {
+		case SERVER_UNRELIABLE_MESSAGE_PING: {
+			SendPingResponse( client, msg.ReadLong() );
+			break;
+		}
+		case SERVER_UNRELIABLE_MESSAGE_GAMEINIT: {
+			// the server changed map, continue in the new game right away
+			client.gameInitId = serverGameInitId;
+			client.gameFrame = msg.ReadLong();
+			client.gameTime = msg.ReadLong();
+			client.snapshotSequence = 0;
+			break;
+		}
+		case SERVER_UNRELIABLE_MESSAGE_SNAPSHOT: {
+			if ( serverGameInitId != client.gameInitId ) {
+				break;
+			}
+
+			client.snapshotSequence = msg.ReadLong();
+			snapshotGameFrame = msg.ReadLong();
+			snapshotGameTime = msg.ReadLong();
+
+			// stay in sync with the server game
+			if ( client.gameFrame < snapshotGameFrame ) {
+				client.gameFrame = snapshotGameFrame;
+				client.gameTime = snapshotGameTime;
+			}
+
+			// uncompressed size of the whole message
+			size = msg.GetSize();
+
+			for ( bucket = 0; bucket < NUM_SIM_SNAPSHOT_BUCKETS - 1 && size >= ( 64 << bucket ); bucket++ ) {
+			}
+			stats.snapshotSizes[bucket]++;
+			stats.snapshotBytes += size;
+			stats.snapshotMin = Min( stats.snapshotMin, size );
+			stats.snapshotMax = Max( stats.snapshotMax, size );
+			stats.numSnapshots++;
+			client.numSnapshots++;
+			break;
+		}
+		default: {
+			break;
+		}
+	}
+}
+
+/*
+==================
+idNetSimulator::SetupConnection
+==================
+*/
+void idNetSimulator::SetupConnection( simClient_t &client ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+
+	if ( realTime - client.lastConnectTime < SIM_CONNECT_RESEND_TIME ) {
+		return;
+	}
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteShort( CONNECTIONLESS_MESSAGE_ID );
+
+	if ( client.state == SIM_CHALLENGING ) {
+		msg.WriteString( "challenge" );
+		msg.WriteLong( client.clientId );
+	} else {
+		msg.WriteString( "connect" );
+		msg.WriteLong( ASYNC_PROTOCOL_VERSION );
+		msg.WriteShort( BUILD_OS_ID );
+		msg.WriteLong( declManager->GetChecksum() );
+		msg.WriteLong( client.challenge );
+		msg.WriteShort( client.clientId );
+		msg.WriteLong( cvarSystem->GetCVarInteger( "net_clientMaxRate" ) );
+		msg.WriteString( "" );
+		msg.WriteString( cvarSystem->GetCVarString( "password" ), -1, false );
+		msg.WriteShort( 0 );
+		msg.WriteLong( idMsgChannel::GetSupportedCodecs() );
+		msg.WriteLong( idMsgChannel::GetCodecTableChecksum() );
+	}
+
+	client.port.SendPacket( client.linkAdr, msg.GetData(), msg.GetSize() );
+
+	client.lastConnectTime = realTime;
+}
+
+/*
+==================
+idNetSimulator::SendMessage
+==================
+*/
+void idNetSimulator::SendMessage( simClient_t &client, const idBitMsg &msg ) {
+	client.channel.SendMessage( client.port, realTime, msg );
+	while( client.channel.UnsentFragmentsLeft() ) {
+		client.channel.SendNextFragment( client.port, realTime );
+	}
+}
+
+/*
+==================
+idNetSimulator::GenerateUsercmd
+
+  Wanders around, keeps turning and fires every now and then.
+==================
+*/
+void idNetSimulator::GenerateUsercmd( simClient_t &client, usercmd_t &cmd ) {
+	cmd = client.userCmds[( client.gameFrame - 1 ) & ( MAX_SIM_USERCMDS - 1 )];
+
+	if ( random.RandomInt( 30 ) == 0 ) {
+		cmd.forwardmove = ( random.RandomInt( 3 ) - 1 ) * 127;
+		cmd.rightmove = ( random.RandomInt( 3 ) - 1 ) * 127;
+		cmd.upmove = random.RandomInt( 10 ) == 0 ? 127 : 0;
+		cmd.buttons = random.RandomInt( 4 ) == 0 ? BUTTON_ATTACK : 0;
+	}
+
+	cmd.angles[YAW] += ANGLE2SHORT( random.CRandomFloat() * 5.0f );
+	cmd.angles[PITCH] = ANGLE2SHORT( idMath::ClampFloat( -30.0f, 30.0f, SHORT2ANGLE( cmd.angles[PITCH] ) + random.CRandomFloat() ) );
+	cmd.mx = 0;
+	cmd.my = 0;
+	cmd.impulse = 0;
+	cmd.duplicateCount = 0;
+}
+
+/*
+==================
+idNetSimulator::SendUsercmds
+==================
+*/
+void idNetSimulator::SendUsercmds( simClient_t &client ) {
+	int			i, numUsercmds;
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+	usercmd_t *	last;
+
+	client.gameFrame++;
+	client.gameTime += USERCMD_MSEC;
+
+	usercmd_t &current = client.userCmds[client.gameFrame & ( MAX_SIM_USERCMDS - 1 )];
+	GenerateUsercmd( client, current );
+	current.gameFrame = client.gameFrame;
+	current.gameTime = client.gameTime;
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteLong( client.serverMessageSequence );
+	msg.WriteLong( client.gameInitId );
+	msg.WriteLong( client.snapshotSequence );
+	msg.WriteByte( CLIENT_UNRELIABLE_MESSAGE_USERCMD );
+	msg.WriteShort( 0 );
+
+	numUsercmds = idMath::ClampInt( 0, MAX_USERCMD_REDUNDANCY, idAsyncNetwork::clientUsercmdBackup.GetInteger() ) + 1;
+
+	// the fake clients send the whole window without a base
+	msg.WriteLong( client.gameFrame );
+	msg.WriteByte( numUsercmds );
+	msg.WriteByte( 0 );
+	for ( last = NULL, i = client.gameFrame - numUsercmds + 1; i <= client.gameFrame; i++ ) {
+		usercmd_t &cmd = client.userCmds[i & ( MAX_SIM_USERCMDS - 1 )];
+		idAsyncNetwork::WriteUserCmdDelta( msg, cmd, last );
+		last = &cmd;
+	}
+
+	SendMessage( client, msg );
+}
+
+/*
+==================
+idNetSimulator::SendEmpty
+==================
+*/
+void idNetSimulator::SendEmpty( simClient_t &client ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteLong( client.serverMessageSequence );
+	msg.WriteLong( client.gameInitId );
+	msg.WriteLong( client.snapshotSequence );
+	msg.WriteByte( CLIENT_UNRELIABLE_MESSAGE_EMPTY );
+
+	SendMessage( client, msg );
+}
+
+/*
+==================
+idNetSimulator::SendPingResponse
+==================
+*/
+void idNetSimulator::SendPingResponse( simClient_t &client, int time ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteLong( client.serverMessageSequence );
+	msg.WriteLong( client.gameInitId );
+	msg.WriteLong( client.snapshotSequence );
+	msg.WriteByte( CLIENT_UNRELIABLE_MESSAGE_PINGRESPONSE );
+	msg.WriteLong( time );
+
+	SendMessage( client, msg );
+}
+
+/*
+==================
+idNetSimulator::SendUserInfo
+==================
+*/
+void idNetSimulator::SendUserInfo( simClient_t &client ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+	idDict		info;
+
+	info = *cvarSystem->MoveCVarsToDict( CVAR_USERINFO );
+	info.Set( "ui_name", va( "simclient%d", client.clientNum ) );
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteByte( CLIENT_RELIABLE_MESSAGE_CLIENTINFO );
+	msg.WriteDeltaDict( info, NULL );
+
+	client.channel.SendReliableMessage( msg );
+}
+
+/*
+==================
+idNetSimulator::SendDisconnect
+
+  The disconnect skips the link latency because the ports are closed right after.
+==================
+*/
+void idNetSimulator::SendDisconnect( simClient_t &client ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteByte( CLIENT_RELIABLE_MESSAGE_DISCONNECT );
+	client.channel.SendReliableMessage( msg );
+
+	SendEmpty( client );
+
+	ReadLink( client );
+	DeliverLink( client, client.toServer, true );
+}
+
+/*
+==================
+idNetSimulator::UpdateFrameStats
+==================
+*/
+void idNetSimulator::UpdateFrameStats( void ) {
+	int gameFrame, frameTime;
+
+	gameFrame = idAsyncNetwork::server.GetGameFrame();
+	if ( gameFrame == lastServerFrame ) {
+		return;
+	}
+	lastServerFrame = gameFrame;
+
+	frameTime = idAsyncNetwork::server.GetFrameTime();
+	stats.numFrames++;
+	stats.frameTimeTotal += frameTime;
+	stats.frameTimeMax = Max( stats.frameTimeMax, frameTime );
+	if ( frameTime > USERCMD_MSEC * 1000 ) {
+		stats.numSlowFrames++;
+	}
+}
+
+/*
+==================
+idNetSimulator::ClearStats
+==================
+*/
+void idNetSimulator::ClearStats( void ) {
+	int i;
+
+	realTime = Sys_Milliseconds();
+	startTime = realTime;
+	lastServerFrame = idAsyncNetwork::server.GetGameFrame();
+
+	memset( &stats, 0, sizeof( stats ) );
+	stats.snapshotMin = MAX_MESSAGE_SIZE;
+
+	for ( i = 0; i < clients.Num(); i++ ) {
+		simClient_t &client = *clients[i];
+		client.bytesToServer = 0;
+		client.bytesToClient = 0;
+		client.packetsDropped = 0;
+		client.packetsOverflowed = 0;
+		client.numSnapshots = 0;
+		client.fragmentsBase = client.channel.GetIncomingFragments();
+		client.fragmentedMessagesBase = client.channel.GetIncomingFragmentedMessages();
+		client.droppedFragmentedMessagesBase = client.channel.GetIncomingDroppedFragmentedMessages();
+	}
+}
+
+/*
+==================
+idNetSimulator::PrintStats
+==================
+*/
+void idNetSimulator::PrintStats( void ) const {
+	int i, bytesToServer, bytesToClient, numFragments, numFragmentedMessages, numDroppedFragmentedMessages;
+	float seconds;
+
+	if ( !clients.Num() ) {
+		common->Printf( "no network simulation running\n" );
+		return;
+	}
+
+	seconds = Max( Sys_Milliseconds() - startTime, 1 ) * 0.001f;
+
+	common->Printf( "%d simulated clients, %1.1f seconds, latency %d msec, jitter %d msec, loss %1.1f%%\n",
+					clients.Num(), seconds, net_simLatency.GetInteger(), net_simJitter.GetInteger(), net_simLoss.GetFloat() );
+
+	if ( stats.numFrames ) {
+		common->Printf( "server frame: avg %1.2f msec, max %1.2f msec, %d of %d frames over %d msec\n",
+						stats.frameTimeTotal / ( stats.numFrames * 1000.0f ), stats.frameTimeMax / 1000.0f,
+						stats.numSlowFrames, stats.numFrames, USERCMD_MSEC );
+	}
+
+	common->Printf( "client        state  out B/s   in B/s  snapshots  dropped  overflow  fragments  frag msgs  lost msgs\n" );
+
+	bytesToServer = bytesToClient = 0;
+	numFragments = numFragmentedMessages = numDroppedFragmentedMessages = 0;
+	for ( i = 0; i < clients.Num(); i++ ) {
+		const simClient_t &client = *clients[i];
+		int fragments = client.channel.GetIncomingFragments() - client.fragmentsBase;
+		int fragmentedMessages = client.channel.GetIncomingFragmentedMessages() - client.fragmentedMessagesBase;
+		int droppedFragmentedMessages = client.channel.GetIncomingDroppedFragmentedMessages() - client.droppedFragmentedMessagesBase;
+
+		common->Printf( "%6d  %11s  %7d  %7d  %9d  %7d  %8d  %9d  %9d  %9d\n", client.clientNum, simClientStateNames[client.state],
+						idMath::FtoiFast( client.bytesToClient / seconds ), idMath::FtoiFast( client.bytesToServer / seconds ),
+						client.numSnapshots, client.packetsDropped, client.packetsOverflowed,
+						fragments, fragmentedMessages, droppedFragmentedMessages );
+
+		bytesToServer += client.bytesToServer;
+		bytesToClient += client.bytesToClient;
+		numFragments += fragments;
+		numFragmentedMessages += fragmentedMessages;
+		numDroppedFragmentedMessages += droppedFragmentedMessages;
+	}
+
+	common->Printf( "average per client: out %d B/s, in %d B/s\n",
+					idMath::FtoiFast( bytesToClient / ( seconds * clients.Num() ) ), idMath::FtoiFast( bytesToServer / ( seconds * clients.Num() ) ) );
+	common->Printf( "fragmentation: %d messages in %d fragments, %d messages lost a fragment\n",
+					numFragmentedMessages, numFragments, numDroppedFragmentedMessages );
+
+	if ( stats.numSnapshots ) {
+		common->Printf( "snapshot sizes: %d snapshots, avg %d bytes, min %d bytes, max %d bytes\n", stats.numSnapshots,
+						(int)( stats.snapshotBytes / stats.numSnapshots ), stats.snapshotMin, stats.snapshotMax );
+		for ( i = 0; i < NUM_SIM_SNAPSHOT_BUCKETS; i++ ) {
+			if ( !stats.snapshotSizes[i] ) {
+				continue;
+			}
+			if ( i < NUM_SIM_SNAPSHOT_BUCKETS - 1 ) {
+				common->Printf( "  <  %5d bytes: %6d (%5.1f%%)\n", 64 << i, stats.snapshotSizes[i], stats.snapshotSizes[i] * 100.0f / stats.numSnapshots );
+			} else {
+				common->Printf( "  >= %5d bytes: %6d (%5.1f%%)\n", 64 << ( i - 1 ), stats.snapshotSizes[i], stats.snapshotSizes[i] * 100.0f / stats.numSnapshots );
+			}
+		}
+	}
+}
@@ -0,0 +1,162 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code (?Doom 3 Source Code?).
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __NETSIMULATOR_H__
+#define __NETSIMULATOR_H__
+
+/*
+===============================================================================
+
+	Network simulation to benchmark the server without real clients.
+
+	Fake clients connect to the local server over the loopback interface and
+	send synthetic user commands. Each client talks to the server through its
+	own link port which delays, drops and jitters the packets in both directions.
+	The bandwidth, snapshot sizes, message fragmentation and the server frame
+	time are collected and reported with netSimStats.
+
+===============================================================================
+*/
+
+const int MAX_SIM_LINK_PACKETS			= 128;		// packets in flight per link direction
+const int MAX_SIM_PACKETLEN				= 1400;		// larger packets are not delayed
+const int MAX_SIM_USERCMDS				= 16;		// user commands kept for duplication
+const int NUM_SIM_SNAPSHOT_BUCKETS		= 9;		// snapshot size histogram, 64 bytes up to MAX_MESSAGE_SIZE
+
+typedef enum {
+	SIM_CHALLENGING,
+	SIM_CONNECTING,
+	SIM_INGAME
+} simClientState_t;
+
+// packet on its way through a simulated link
+typedef struct {
+	int					time;						// time the packet leaves the link
+	int					size;
+	byte				data[MAX_SIM_PACKETLEN];
+} simPacket_t;
+
+// queue of packets in one direction of a simulated link
+typedef struct {
+	simPacket_t			packets[MAX_SIM_LINK_PACKETS];
+	int					first;
+	int					count;
+	int					lastTime;					// packets never overtake each other
+	netadr_t			to;
+} simLinkQueue_t;
+
+typedef struct {
+	simClientState_t	state;
+	int					clientId;
+	int					clientNum;
+	idPort				port;						// port of the fake client
+	idPort				linkPort;					// port the server talks to
+	netadr_t			adr;
+	netadr_t			linkAdr;
+	idMsgChannel		channel;
+	simLinkQueue_t		toServer;
+	simLinkQueue_t		toClient;
+
+	int					challenge;
+	int					lastConnectTime;
+	int					gameInitId;
+	int					gameFrame;
+	int					gameTime;
+	int					serverMessageSequence;
+	int					snapshotSequence;
+	usercmd_t			userCmds[MAX_SIM_USERCMDS];
+
+	// statistics
+	int					bytesToServer;
+	int					bytesToClient;
+	int					packetsDropped;
+	int					packetsOverflowed;
+	int					numSnapshots;
+	int					fragmentsBase;				// channel fragment counters when the stats were cleared
+	int					fragmentedMessagesBase;
+	int					droppedFragmentedMessagesBase;
+} simClient_t;
+
+typedef struct {
+	int					numFrames;
+	int					numSlowFrames;				// frames taking longer than USERCMD_MSEC
+	int64				frameTimeTotal;				// microseconds
+	int					frameTimeMax;
+	int					numSnapshots;
+	int64				snapshotBytes;
+	int					snapshotMin;
+	int					snapshotMax;
+	int					snapshotSizes[NUM_SIM_SNAPSHOT_BUCKETS];
+} simStats_t;
+
+class idNetSimulator {
+public:
+						idNetSimulator( void );
+
+	bool				IsActive( void ) const { return clients.Num() != 0; }
+
+						// Connects numClients fake clients to the local server, stops after the given number of seconds if not zero.
+	void				Start( int numClients, int seconds );
+	void				Stop( void );
+	void				RunFrame( void );
+
+	void				PrintStats( void ) const;
+	void				ClearStats( void );
+
+private:
+	idList<simClient_t *> clients;
+	netadr_t			serverAdr;
+	idRandom			random;
+	int					realTime;
+	int					startTime;
+	int					stopTime;
+	int					lastServerFrame;
+	int					nextReportTime;
+	simStats_t			stats;
+
+	bool				InitClient( simClient_t &client, int index );
+	void				ShutdownClient( simClient_t &client );
+	void				ReadLink( simClient_t &client );
+	void				DeliverLink( simClient_t &client, simLinkQueue_t &queue, bool flush );
+	void				QueuePacket( simClient_t &client, simLinkQueue_t &queue, const byte *data, int size );
+	void				ReadPackets( simClient_t &client );
+	void				ConnectionlessMessage( simClient_t &client, const netadr_t from, const idBitMsg &msg );
+	void				ProcessReliableMessages( simClient_t &client );
+	void				ProcessUnreliableMessage( simClient_t &client, const idBitMsg &msg );
+	void				SetupConnection( simClient_t &client );
+	void				SendUsercmds( simClient_t &client );
+	void				SendEmpty( simClient_t &client );
+	void				SendPingResponse( simClient_t &client, int time );
+	void				SendUserInfo( simClient_t &client );
+	void				SendDisconnect( simClient_t &client );
+	void				SendMessage( simClient_t &client, const idBitMsg &msg );
+	void				GenerateUsercmd( simClient_t &client, usercmd_t &cmd );
+	void				UpdateFrameStats( void );
+};
+
+#endif /* !__NETSIMULATOR_H__ */
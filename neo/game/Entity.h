@@ -142,6 +142,7 @@ public:
 	bool					readByServer;			//if the entity was already tried to be sent in the snapshot
 	int						snapshotPriority;		//The priority of this entity (useful when snapshot overflow
 	int						snapshotMissingCount[ MAX_CLIENTS ];	//Missing snapshots count for coop
+	float					snapshotAccumulator[ MAX_CLIENTS ];		// priority accumulated per client while the entity wasn't sent
 
 	int						health;					// FIXME: do all objects really need health?
 	bool					spawnedByServer;		// When the ent gets spawned by the server; COOP
@@ -519,6 +520,7 @@ public:
 	virtual void			Think( void );
 
 	void					UpdateAnimation( void );
+	void					UpdateAnimationLOD( void );
 
 	virtual idAnimator *	GetAnimator( void );
 	virtual void			SetModel( const char *modelname );
@@ -74,6 +74,15 @@ typedef enum {
 #define TIME_GROUP1		0
 #define TIME_GROUP2		1
 
+// a client snapshot written by idGame::ServerWriteSnapshots
+typedef struct snapshotRequest_s {
+	int							clientNum;
+	int							sequence;
+	idBitMsg *					msg;
+	byte *						clientInPVS;
+	int							maxBytes;			// snapshot size that fits the client rate, 0 for no limit
+} snapshotRequest_t;
+
 class idGame {
 public:
 	virtual						~idGame() {}
@@ -206,6 +215,8 @@ public:
 
 	virtual void				ClientReadSnapshotCoop( int clientNum, int sequence, const int gameFrame, const int gameTime, const int dupeUsercmds, const int aheadOfServer, const idBitMsg &msg ) = 0;
 
+	// Writes snapshots for several clients at once, the game may build them in parallel.
+	virtual void				ServerWriteSnapshots( snapshotRequest_t *requests, int numRequests, int numPVSClients ) = 0;
 };
 
 extern idGame *					game;
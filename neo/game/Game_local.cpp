@@ -206,6 +206,7 @@ void idGameLocal::Clear( void ) {
 	previousTime = 0;
 	time = 0;
 	vacuumAreaNum = 0;
+	memset( &animLODStats, 0, sizeof( animLODStats ) );
 	mapFileName.Clear();
 	mapFile = NULL;
 	spawnCount = INITIAL_SPAWN_COUNT;
@@ -944,7 +945,7 @@ void idGameLocal::LoadMap( const char *mapName, int randseed ) {
 	cinematicMaxSkipTime = 0;
 
 	clip.Init();
-	pvs.Init();
+	pvs.Init( mapFileName );
 	playerPVS.i = -1;
 	playerConnectedAreas.i = -1;
 
@@ -1505,6 +1506,9 @@ idGameLocal::MapClear
 void idGameLocal::MapClear( bool clearClients ) {
 	int i;
 
+	// the electrical entities are going away, don't let them trigger anything on the way out
+	electroCircuit.Clear();
+
 	for( i = ( clearClients ? 0 : MAX_CLIENTS ); i < MAX_GENTITIES; i++ ) {
 
 		if ( entities[ i ] )
@@ -1521,6 +1525,9 @@ void idGameLocal::MapClear( bool clearClients ) {
 
 	entityHash.Clear( 1024, MAX_GENTITIES );
 
+	sleepIslands.Clear();
+	vehicleSystem.Clear();
+
 	if ( !clearClients ) {
 		// add back the hashes of the clients
 		for ( i = 0; i < MAX_CLIENTS; i++ ) {
@@ -2271,6 +2278,107 @@ const idVec3 &idGameLocal::GetGravity( void ) const {
 	return gravity;
 }
 
+static idParallelJobList	afJobList( "articulatedFigures" );
+
+/*
+================
+SetTeamClip
+
+Same as idEntity::RunPhysics, team members that aren't solid for the team
+are left out of the collision detection.
+================
+*/
+static void SetTeamClip( idEntity *master, bool enable ) {
+	for ( idEntity *part = master; part != NULL; part = part->GetNextTeamEntity() ) {
+		if ( part->GetPhysics() && !part->fl.solidForTeam ) {
+			if ( enable ) {
+				part->GetPhysics()->EnableClip();
+			} else {
+				part->GetPhysics()->DisableClip();
+			}
+		}
+	}
+}
+
+/*
+================
+SolveArticulatedFigure
+================
+*/
+static void SolveArticulatedFigure( void *data ) {
+	static_cast<idPhysics_AF *>( data )->EvaluateSolve();
+}
+
+/*
+================
+idGameLocal::RunArticulatedFigures
+
+Simulates the moving articulated figures before the entities think, so the
+constraint solves can run in parallel.  Contacts and collisions use the clip
+world and are done one figure at a time in the order of the active entities,
+the solve of a figure only depends on the figure itself.  This way the
+results are the same for any number of threads.  The entities pick up the
+results when they run physics.
+================
+*/
+void idGameLocal::RunArticulatedFigures( void ) {
+	int i;
+	idEntity *ent;
+	idStaticList<idEntity *, MAX_GENTITIES> figures;
+	bool solve[MAX_GENTITIES];
+
+	if ( !af_parallelStage.GetBool() || af_showTimings.GetBool() || isClient ) {
+		return;
+	}
+	if ( isMultiplayer && mpGame.IsGametypeCoopBased() && localClientNum < 0 && !gameLocal.firstClientToSpawn && g_freezeUntilClientJoins.GetBool() ) {
+		return;
+	}
+
+	for ( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( !( ent->thinkFlags & TH_PHYSICS ) || ent->fl.isDormant ) {
+			continue;
+		}
+		if ( ent->GetTeamMaster() && ent->GetTeamMaster() != ent ) {
+			continue;
+		}
+		if ( g_cinematic.GetBool() && inCinematic && !ent->cinematic ) {
+			continue;
+		}
+		idPhysics *physics = ent->GetPhysics();
+		if ( physics && physics->IsType( idPhysics_AF::Type ) && static_cast<idPhysics_AF *>( physics )->CanEvaluateInStage( previousTime ) ) {
+			figures.Append( ent );
+		}
+	}
+
+	// a single figure is simulated in think as usual
+	if ( figures.Num() < 2 ) {
+		return;
+	}
+
+	for ( i = 0; i < figures.Num(); i++ ) {
+		idPhysics_AF *physics = static_cast<idPhysics_AF *>( figures[i]->GetPhysics() );
+		SetTeamClip( figures[i], false );
+		solve[i] = physics->EvaluateSetup( time - previousTime, time );
+		SetTeamClip( figures[i], true );
+		if ( solve[i] ) {
+			afJobList.AddJob( SolveArticulatedFigure, physics );
+		}
+	}
+
+	afJobList.Submit();
+	afJobList.Wait();
+
+	for ( i = 0; i < figures.Num(); i++ ) {
+		idPhysics_AF *physics = static_cast<idPhysics_AF *>( figures[i]->GetPhysics() );
+		if ( solve[i] ) {
+			SetTeamClip( figures[i], false );
+			physics->EvaluateFinish( time );
+			SetTeamClip( figures[i], true );
+		}
+		physics->SetStageResult( time, solve[i] );
+	}
+}
+
 /*
 ================
 idGameLocal::SortActiveEntityList
@@ -2428,9 +2536,24 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds ) {
 		// sort the active entity list
 		SortActiveEntityList();
 
+		// simulate the moving articulated figures
+		RunArticulatedFigures();
+
+		// show how the animations were updated since the last game frame, including rendering
+		if ( g_animLodStats.GetBool() ) {
+			Printf( "anim %d: full:%d reduced:%d low:%d hidden:%d created:%d skipped:%d\n", time,
+				animLODStats.numEntities[ ANIMLOD_FULL ], animLODStats.numEntities[ ANIMLOD_REDUCED ],
+				animLODStats.numEntities[ ANIMLOD_LOW ], animLODStats.numEntities[ ANIMLOD_HIDDEN ],
+				animLODStats.numFramesCreated, animLODStats.numFramesSkipped );
+		}
+		memset( &animLODStats, 0, sizeof( animLODStats ) );
+
 		timer_think.Clear();
 		timer_think.Start();
 
+		// query the wheels of all the raycast vehicles at once
+		vehicleSystem.RunFrame();
+
 		// let entities think
 		if ( g_timeentities.GetFloat() ) {
 			num = 0;
@@ -2483,6 +2606,9 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds ) {
 			}
 		}
 
+		// put islands of resting rigid bodies to sleep
+		sleepIslands.Update();
+
 		// remove any entities that have stopped thinking
 		if ( numEntitiesToDeactivate ) {
 			idEntity *next_ent;
@@ -2498,6 +2624,9 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds ) {
 			numEntitiesToDeactivate = 0;
 		}
 
+		// build the poses of the visible animated entities
+		idAnimator::CreateQueuedFrames( time );
+
 		timer_think.Stop();
 		timer_events.Clear();
 		timer_events.Start();
@@ -3578,6 +3707,8 @@ void idGameLocal::SpawnMapEntities( void ) {
 	}
 
 	Printf( "...%i entities spawned, %i inhibited\n\n", num, inhibit );
+
+	electroCircuit.Build();
 }
 
 /*
@@ -113,6 +113,9 @@ void gameError( const char *fmt, ... );
 
 #include "physics/Clip.h"
 #include "physics/Push.h"
+#include "physics/SleepIslands.h"
+#include "engineering/Electro_Circuit.h"
+#include "vehicles/VehicleSystem.h"
 
 #include "Pvs.h"
 #include "MultiplayerGame.h"
@@ -141,6 +144,52 @@ typedef struct snapshot_s {
 	struct snapshot_s *		next;
 } snapshot_t;
 
+const int MAX_ENTITY_RECORD_SIZE	= 4 * MAX_ENTITY_STATE_SIZE;
+
+// entity state written once per snapshot frame and replayed against the base of each client
+typedef struct entitySnapshot_s {
+	int						cacheFrame;		// snapshotCacheFrame the state was written in
+	bool					valid;			// false if the state didn't fit and is written per client
+	idBitMsg				state;			// state as stored in a new base
+	byte					stateBuf[MAX_ENTITY_STATE_SIZE];
+	idBitMsg				record;			// writes to replay as a delta, see idBitMsgDelta::Replay
+	byte					recordBuf[MAX_ENTITY_RECORD_SIZE];
+} entitySnapshot_t;
+
+// entity order in a snapshot with a byte budget, see idGameLocal::ServerScheduleSnapshotEntities
+typedef struct snapshotPriority_s {
+	float					priority;
+	int						index;			// index in snapshotBuild_t::entities
+} snapshotPriority_t;
+
+// per client state while writing a snapshot, see idGameLocal::ServerWriteSnapshots
+typedef struct snapshotBuild_s {
+	int						clientNum;
+	int						sequence;
+	idBitMsg *				msg;
+	byte *					clientInPVS;
+	idPlayer *				player;
+	snapshot_t *			snapshot;
+	bool					coop;			// entities are identified by their coop number
+	idList<idEntity *>		entities;		// entities to write in order
+	idList<entityState_t *>	newBases;		// new state per entity, the last one is for the game and player state
+	idList<bool>			changed;		// true if the entity state differs from the base
+	idList<entitySnapshot_t *> cached;		// shared entity state per entity, NULL to write the entity directly
+	int						maxBytes;		// snapshot size that fits the client rate, 0 for no limit
+	int						reserveBytes;	// bytes written after the entities in the last snapshot
+	idVec3					viewOrigin;
+	idVec3					viewDir;
+	idList<snapshotPriority_t> priorities;	// entities ordered by priority when the snapshot has a byte budget
+#if ASYNC_WRITE_PVS
+	pvsHandle_t				pvsHandle;
+	int						numSourceAreas;
+	int						sourceAreas[4];			// idEntity::MAX_PVS_AREAS
+#endif
+#if ASYNC_WRITE_TAGS
+	idRandom				tagRandom;
+#endif
+} snapshotBuild_t;
+
 const int MAX_EVENT_PARAM_SIZE		= 128;
 
 typedef struct entityNetEvent_s {
@@ -336,6 +385,9 @@ public:
 
 	idClip					clip;					// collision detection
 	idPush					push;					// geometric pushing
+	idSleepIslands			sleepIslands;			// rigid bodies resting against each other
+	admElectroCircuit		electroCircuit;			// electrical entities and the circuits they form
+	admVehicleSystem		vehicleSystem;			// wheel queries of the raycast vehicles
 	idPVS					pvs;					// potential visible set
 
 	idTestModel *			testmodel;				// for development testing of models
@@ -362,6 +414,8 @@ public:
 
 	int						vacuumAreaNum;			// -1 if level doesn't have any outside areas
 
+	animLODStats_t			animLODStats;			// counted from the start of the last game frame
+
 	gameType_t				gameType;
 	bool					isMultiplayer;			// set if the game is run in multiplayer mode
 	bool					isServer;				// set if the game is run for a dedicated or listen server
@@ -412,6 +466,7 @@ public:
 	virtual void			ServerClientDisconnect( int clientNum );
 	virtual void			ServerWriteInitialReliableMessages( int clientNum );
 	virtual void			ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &msg, byte *clientInPVS, int numPVSClients );
+	virtual void			ServerWriteSnapshots( snapshotRequest_t *requests, int numRequests, int numPVSClients );
 	virtual bool			ServerApplySnapshot( int clientNum, int sequence );
 	virtual void			ServerProcessReliableMessage( int clientNum, const idBitMsg &msg );
 	virtual void			ClientReadSnapshot( int clientNum, int sequence, const int gameFrame, const int gameTime, const int dupeUsercmds, const int aheadOfServer, const idBitMsg &msg );
@@ -599,6 +654,10 @@ private:
 	snapshot_t *			clientSnapshots[MAX_CLIENTS];
 	idBlockAlloc<entityState_t,256>entityStateAllocator;
 	idBlockAlloc<snapshot_t,64>snapshotAllocator;
+	snapshotBuild_t			snapshotBuilds[MAX_CLIENTS];
+	idBlockAlloc<entitySnapshot_t,64>entitySnapshotAllocator;
+	entitySnapshot_t *		entitySnapshots[MAX_GENTITIES];
+	int						snapshotCacheFrame;
 
 	idEventQueue			eventQueue;
 	idEventQueue			savedEventQueue;
@@ -627,6 +686,7 @@ private:
 	void					FreePlayerPVS( void );
 	void					UpdateGravity( void );
 	void					SortActiveEntityList( void );
+	void					RunArticulatedFigures( void );
 	void					ShowTargets( void );
 	void					RunDebugInfo( void );
 
@@ -641,6 +701,12 @@ private:
 	void					InitClientDeclRemap( int clientNum );
 	void					ServerSendDeclRemapToClient( int clientNum, declType_t type, int index );
 	void					FreeSnapshotsOlderThanSequence( int clientNum, int sequence );
+	bool					ServerPrepareSnapshot( snapshotBuild_t &build, bool cacheEntities );
+	entitySnapshot_t *		ServerCacheEntitySnapshot( idEntity *ent, bool coop );
+	void					ServerScheduleSnapshotEntities( snapshotBuild_t &build );
+	void					ServerWriteSnapshotEntities( snapshotBuild_t &build );
+	void					ServerFinishSnapshot( snapshotBuild_t &build, int numPVSClients );
+	static void				ServerWriteSnapshotJob( void *data );
 	bool					ApplySnapshot( int clientNum, int sequence );
 	void					WriteGameStateToSnapshot( idBitMsgDelta &msg ) const;
 	void					ReadGameStateFromSnapshot( const idBitMsgDelta &msg );
@@ -897,6 +963,7 @@ const int	CINEMATIC_SKIP_DELAY	= SEC2MS( 2.0f );
 #include "anim/Anim_Testmodel.h"
 
 #include "vehicles/VehicleBase.h"
+#include "vehicles/VehiclePhysics.h"
 
 #include "script/Script_Compiler.h"
 #include "script/Script_Interpreter.h"
@@ -51,10 +51,16 @@ idCVar net_clientShowSnapshot( "net_clientShowSnapshot", "0", CVAR_GAME | CVAR_I
 idCVar net_clientShowSnapshotRadius( "net_clientShowSnapshotRadius", "128", CVAR_GAME | CVAR_FLOAT, "" );
 idCVar net_clientSmoothing( "net_clientSmoothing", "0.8", CVAR_GAME | CVAR_FLOAT, "smooth other clients angles and position.", 0.0f, 0.95f );
 idCVar net_clientSelfSmoothing( "net_clientSelfSmoothing", "0.6", CVAR_GAME | CVAR_FLOAT, "smooth self position if network causes prediction error.", 0.0f, 0.95f );
+idCVar net_clientVehicleSmoothing( "net_clientVehicleSmoothing", "0.8", CVAR_GAME | CVAR_FLOAT, "part of a vehicle prediction error kept from one frame to the next.", 0.0f, 0.95f );
 idCVar net_clientMaxPrediction( "net_clientMaxPrediction", "1000", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "maximum number of milliseconds a client can predict ahead of server." );
 idCVar net_clientLagOMeter( "net_clientLagOMeter", "1", CVAR_GAME | CVAR_BOOL | CVAR_NOCHEAT | CVAR_ARCHIVE, "draw prediction graph" );
 idCVar net_clientCoopDebug( "net_clientCoopDebug", "0", CVAR_GAME | CVAR_BOOL | CVAR_NOCHEAT | CVAR_ARCHIVE, "TMP CVar for debugging" );
 
+static idParallelJobList	snapshotJobList( "snapshots" );
+
+const float SNAPSHOT_PRIORITY_DISTANCE	= 512.0f;	// distance at which the entity priority is halved
+const float SNAPSHOT_PRIORITY_SPEED		= 320.0f;	// speed at which the entity priority is doubled
+
 /*
 ================
 idGameLocal::InitAsyncNetwork
@@ -72,6 +78,8 @@ void idGameLocal::InitAsyncNetwork( void ) {
 	memset( clientEntityStates, 0, sizeof( clientEntityStates ) );
 	memset( clientPVS, 0, sizeof( clientPVS ) );
 	memset( clientSnapshots, 0, sizeof( clientSnapshots ) );
+	memset( entitySnapshots, 0, sizeof( entitySnapshots ) );
+	snapshotCacheFrame = 0;
 
 	eventQueue.Init();
 	savedEventQueue.Init();
@@ -91,11 +99,13 @@ idGameLocal::ShutdownAsyncNetwork
 void idGameLocal::ShutdownAsyncNetwork( void ) {
 	entityStateAllocator.Shutdown();
 	snapshotAllocator.Shutdown();
+	entitySnapshotAllocator.Shutdown();
 	eventQueue.Shutdown();
 	savedEventQueue.Shutdown();
 	memset( clientEntityStates, 0, sizeof( clientEntityStates ) );
 	memset( clientPVS, 0, sizeof( clientPVS ) );
 	memset( clientSnapshots, 0, sizeof( clientSnapshots ) );
+	memset( entitySnapshots, 0, sizeof( entitySnapshots ) );
 }
 
 /*
@@ -333,6 +343,7 @@ void idGameLocal::ServerClientConnect( int clientNum, const char *guid )
 	}
 
 	userInfo[ clientNum ].Clear();
+	snapshotBuilds[ clientNum ].reserveBytes = 0;
 	mpGame.ServerClientConnect( clientNum );
 	//sync cvars here
 
@@ -719,204 +730,608 @@ void idGameLocal::ReadGameStateFromSnapshot( const idBitMsgDelta &msg ) {
 
 /*
 ================
-idGameLocal::ServerWriteSnapshot
+idGameLocal::ServerPrepareSnapshot
 
-  Write a snapshot of the current game state for the given client.
+  Allocates the snapshot for the client and selects the entities written to it.
+  Touches shared game state so it always runs on the main thread. The new entity
+  states are allocated up front so writing the snapshot doesn't use the allocator.
+  Returns false if the client has no player.
 ================
 */
-void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &msg, byte *clientInPVS, int numPVSClients )
+bool idGameLocal::ServerPrepareSnapshot( snapshotBuild_t &build, bool cacheEntities )
 {
-	if ( mpGame.IsGametypeCoopBased() )
-	{ //added for COOP
-		return ServerWriteSnapshotCoop( clientNum, sequence, msg, clientInPVS, numPVSClients );
+	int i, j;
+	idPlayer *spectated;
+	idEntity *ent;
+	pvsHandle_t pvsHandle;
+	snapshot_t *snapshot;
+	int numSourceAreas, sourceAreas[ idEntity::MAX_PVS_AREAS ];
+	const int clientNum = build.clientNum;
+
+	build.coop = mpGame.IsGametypeCoopBased();
+	build.entities.SetNum( 0, false );
+	build.newBases.SetNum( 0, false );
+	build.changed.SetNum( 0, false );
+
+	if ( build.coop )
+	{
+		build.player = static_cast<idPlayer *>(coopentities[ clientNum ]);
+	}
+	else
+	{
+		build.player = static_cast<idPlayer *>(entities[ clientNum ]);
+	}
+	if ( !build.player )
+	{
+		return false;
+	}
+	if ( build.player->spectating && build.player->spectator != clientNum && entities[ build.player->spectator ] )
+	{
+		spectated = static_cast<idPlayer *>(entities[ build.player->spectator ]);
+	}
+	else
+	{
+		spectated = build.player;
 	}
-
-	int i, msgSize, msgWriteBit;
-	idPlayer *player, *spectated = NULL;
-	idEntity *ent;
-	pvsHandle_t pvsHandle;
-	idBitMsgDelta deltaMsg;
-	snapshot_t *snapshot;
-	entityState_t *base, *newBase;
-	int numSourceAreas, sourceAreas[ idEntity::MAX_PVS_AREAS ];
-
-	player = static_cast<idPlayer *>(entities[ clientNum ]);
-	if ( !player )
-	{
-		return;
-	}
-	if ( player->spectating && player->spectator != clientNum && entities[ player->spectator ] )
-	{
-		spectated = static_cast<idPlayer *>(entities[ player->spectator ]);
-	}
-	else
-	{
-		spectated = player;
-	}
-
-	// free too old snapshots
-	FreeSnapshotsOlderThanSequence( clientNum, sequence - 64 );
-
-	// allocate new snapshot
-	snapshot = snapshotAllocator.Alloc();
-	snapshot->sequence = sequence;
-	snapshot->firstEntityState = NULL;
-	snapshot->next = clientSnapshots[ clientNum ];
-	clientSnapshots[ clientNum ] = snapshot;
-	memset( snapshot->pvs, 0, sizeof( snapshot->pvs ) );
-
-	// get PVS for this player
-	// don't use PVSAreas for networking - PVSAreas depends on animations (and md5 bounds), which are not synchronized
-	numSourceAreas = gameRenderWorld->BoundsInAreas( spectated->GetPlayerPhysics()->GetAbsBounds(), sourceAreas, idEntity::MAX_PVS_AREAS );
-	pvsHandle = gameLocal.pvs.SetupCurrentPVS( sourceAreas, numSourceAreas, PVS_NORMAL );
-
-#if ASYNC_WRITE_TAGS
-	idRandom tagRandom;
-	tagRandom.SetSeed( random.RandomInt() );
-	msg.WriteLong( tagRandom.GetSeed() );
-#endif
-
-	// create the snapshot
-	for ( ent = spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() )
-	{
-
-// if the entity is not in the player PVS
-		if ( !ent->PhysicsTeamInPVS( pvsHandle ) && ent->entityNumber != clientNum )
-		{
-			continue;
-		}
-		//In coop let's ignore static snapshots and ton of other shitty stuff
-		//TryingSomething
-
-		if ( !mpGame.IsGametypeCoopBased() )
-		{
-// add the entity to the snapshot pvs
-			snapshot->pvs[ ent->entityNumber >> 5 ] |= 1 << (ent->entityNumber & 31); //NON-Coop keeps the original order
-		}
-
-
-		//snapshot->pvs[ ent->entityNumber >> 5 ] |= 1 << ( ent->entityNumber & 31 ); 
-
-		// if that entity is not marked for network synchronization
-		if ( !ent->fl.networkSync )
-		{
-			continue;
-		}
 
-		if ( mpGame.IsGametypeCoopBased() && ent->IsType( idItem::Type ) )
-		{
-			continue; //lot of items in SP maps, let these be client-side
+	// the entity priorities are relative to the view of the player
+	build.viewOrigin = spectated->GetPhysics()->GetOrigin();
+	build.viewDir = spectated->viewAngles.ToForward();
+
+	// free too old snapshots
+	FreeSnapshotsOlderThanSequence( clientNum, build.sequence - 64 );
+
+	// allocate new snapshot
+	snapshot = snapshotAllocator.Alloc();
+	snapshot->sequence = build.sequence;
+	snapshot->firstEntityState = NULL;
+	snapshot->next = clientSnapshots[ clientNum ];
+	clientSnapshots[ clientNum ] = snapshot;
+	memset( snapshot->pvs, 0, sizeof( snapshot->pvs ) );
+	build.snapshot = snapshot;
+
+	// get PVS for this player
+	// don't use PVSAreas for networking - PVSAreas depends on animations (and md5 bounds), which are not synchronized
+	numSourceAreas = gameRenderWorld->BoundsInAreas( spectated->GetPlayerPhysics()->GetAbsBounds(), sourceAreas, idEntity::MAX_PVS_AREAS );
+	pvsHandle = gameLocal.pvs.SetupCurrentPVS( sourceAreas, numSourceAreas, PVS_NORMAL );
+
+#if ASYNC_WRITE_TAGS
+	build.tagRandom.SetSeed( random.RandomInt() );
+	build.msg->WriteLong( build.tagRandom.GetSeed() );
+#endif
+
+	if ( build.coop )
+	{
+		//Added by Stradex for netcode optimization (SORT LIST)
+		int serverSendEntitiesCount = 0;
+		int serverEntitiesLimit = net_serverSnapshotLimit.GetInteger();
+
+		//Clear the list first
+		for ( j = 0; j < MAX_GENTITIES; j++ )
+		{
+			sortsnapshotentities[ j ] = NULL;
 		}
-
-		/*
-		if (mpGame.IsGametypeCoopBased() &&
-			(ent->IsType(idStaticEntity::Type) || ent->IsType(idFuncSmoke::Type) || ent->IsType(idTextEntity::Type) ||
-			ent->IsType(idLocationSeparatorEntity::Type) || ent->IsType(idVacuumSeparatorEntity::Type) ||
-			ent->IsType(idBeam::Type) || ent->IsType(idShaking::Type) || ent->IsType(idEarthQuake::Type) ||
-			ent->IsType(idFuncAASObstacle::Type) || ent->IsType(idTrigger::Type) || ent->IsType(idSound::Type))) {
-			common->Printf("Not sending entity %s to client\n", ent->GetName());
-				continue; //ignore these entities, let the client deal with these client-side
-		}
-		*/
-
-		if ( mpGame.IsGametypeCoopBased() )
-		{
-			// add the entity to the snapshot pvs
-			snapshot->pvs[ ent->entityNumber >> 5 ] |= 1 << (ent->entityNumber & 31); //COOP add entities to the snapshot pvs only to netsync entities STRADEX
-		}
-
-		// save the write state to which we can revert when the entity didn't change at all
-		msg.SaveWriteState( msgSize, msgWriteBit );
-
-		// write the entity to the snapshot
-		msg.WriteBits( ent->entityNumber, GENTITYNUM_BITS );
-
-		base = clientEntityStates[ clientNum ][ ent->entityNumber ];
-		if ( base )
-		{
-			base->state.BeginReading();
-		}
-		newBase = entityStateAllocator.Alloc();
-		newBase->entityNumber = ent->entityNumber;
-		newBase->state.Init( newBase->stateBuf, sizeof( newBase->stateBuf ) );
-		newBase->state.BeginWriting();
-
-		deltaMsg.Init( base ? &base->state : NULL, &newBase->state, &msg );
-
-		deltaMsg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
-		deltaMsg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
-		deltaMsg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
-
-		// write the class specific data to the snapshot
-		ent->WriteToSnapshot( deltaMsg );
-
-		if ( !deltaMsg.HasChanged() )
-		{
-			msg.RestoreWriteState( msgSize, msgWriteBit );
-			entityStateAllocator.Free( newBase );
-		}
-		else
-		{
-			newBase->next = snapshot->firstEntityState;
-			snapshot->firstEntityState = newBase;
-
-		#if ASYNC_WRITE_TAGS
-			msg.WriteLong( tagRandom.RandomInt() );
-		#endif
-		}
-	}
-
-	msg.WriteBits( ENTITYNUM_NONE, GENTITYNUM_BITS );
-
-	// write the PVS to the snapshot
-#if ASYNC_WRITE_PVS
-	for ( i = 0; i < idEntity::MAX_PVS_AREAS; i++ )
-	{
-		if ( i < numSourceAreas )
-		{
-			msg.WriteLong( sourceAreas[ i ] );
-		}
-		else
-		{
-			msg.WriteLong( 0 );
-		}
-	}
-	gameLocal.pvs.WritePVS( pvsHandle, msg );
-#endif
-	for ( i = 0; i < ENTITY_PVS_SIZE; i++ )
-	{
-		msg.WriteDeltaLong( clientPVS[ clientNum ][ i ], snapshot->pvs[ i ] );
-	}
-
-	// free the PVS
-	pvs.FreeCurrentPVS( pvsHandle );
-
-	// write the game and player state to the snapshot
-	base = clientEntityStates[ clientNum ][ ENTITYNUM_NONE ];	// ENTITYNUM_NONE is used for the game and player state
-	if ( base )
-	{
-		base->state.BeginReading();
-	}
-	newBase = entityStateAllocator.Alloc();
-	newBase->entityNumber = ENTITYNUM_NONE;
-	newBase->next = snapshot->firstEntityState;
-	snapshot->firstEntityState = newBase;
-	newBase->state.Init( newBase->stateBuf, sizeof( newBase->stateBuf ) );
-	newBase->state.BeginWriting();
-	deltaMsg.Init( base ? &base->state : NULL, &newBase->state, &msg );
-	if ( player->spectating && player->spectator != player->entityNumber && gameLocal.entities[ player->spectator ] && gameLocal.entities[ player->spectator ]->IsType( idPlayer::Type ) )
-	{
-		static_cast<idPlayer *>(gameLocal.entities[ player->spectator ])->WritePlayerStateToSnapshot( deltaMsg );
-	}
-	else
-	{
-		player->WritePlayerStateToSnapshot( deltaMsg );
-	}
-	WriteGameStateToSnapshot( deltaMsg );
-
-	// copy the client PVS string
-	memcpy( clientInPVS, snapshot->pvs, (numPVSClients + 7) >> 3 );
-	LittleRevBytes( clientInPVS, sizeof( int ), sizeof( clientInPVS ) / sizeof( int ) );
+
+		int sortSnapCount = 1;
+		sortsnapshotentities[ 0 ] = coopentities[ clientNum ]; //ensure to always send info about our own player
+
+		for ( ent = coopSyncEntities.Next(); ent != NULL; ent = ent->coopNode.Next() )
+		{
+			ent->readByServer = false;
+
+			if ( !ent->PhysicsTeamInPVS( pvsHandle ) && ent->entityCoopNumber != clientNum )
+			{
+				continue;
+			}
+			if ( !ent->IsActive() && !ent->IsMasterActive() && !ent->firstTimeInClientPVS[ clientNum ] && !ent->forceNetworkSync && !ent->inSnapshotQueue[ clientNum ] )
+			{ //ignore inactive entities that the player already saw before
+				continue;
+			}
+			// if that entity is not marked for network synchronization
+			if ( !ent->fl.coopNetworkSync )
+			{
+				continue;
+			}
+			//Since sorting it's a pretty expensive stuff, let's try to have this list the less filled with entities possible
+			sortsnapshotentities[ sortSnapCount++ ] = ent;
+		}
+
+		snapshotsort_context_s context; // this is to keep sorting signatures clean if isInOrder requires more game state information
+		context.clientNum = clientNum;
+		snapshotsort( context, sortsnapshotentities, 1, sortSnapCount - 1 );
+
+		for ( j = 0, ent = sortsnapshotentities[ j ]; ent != NULL; ent = sortsnapshotentities[ ++j ] )
+		{
+			if ( serverSendEntitiesCount >= serverEntitiesLimit )
+			{
+				ent->inSnapshotQueue[ clientNum ] = true;
+				continue;
+			}
+
+			serverSendEntitiesCount++;
+
+			// add the entity to the snapshot pvs
+			snapshot->pvs[ ent->entityNumber >> 5 ] |= 1 << (ent->entityNumber & 31); //COOP add entities to the snapshot pvs only to netsync entities STRADEX
+
+			// the queue and first time flags are cleared once the entity is written, see ServerWriteSnapshotEntities
+			build.entities.Append( ent );
+		}
+	}
+	else
+	{
+		for ( ent = spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() )
+		{
+			// if the entity is not in the player PVS
+			if ( !ent->PhysicsTeamInPVS( pvsHandle ) && ent->entityNumber != clientNum )
+			{
+				continue;
+			}
+
+			// add the entity to the snapshot pvs
+			snapshot->pvs[ ent->entityNumber >> 5 ] |= 1 << (ent->entityNumber & 31);
+
+			// if that entity is not marked for network synchronization
+			if ( !ent->fl.networkSync )
+			{
+				continue;
+			}
+
+			build.entities.Append( ent );
+		}
+	}
+
+#if ASYNC_WRITE_PVS
+	// the PVS is written after the entities
+	build.pvsHandle = pvsHandle;
+	build.numSourceAreas = numSourceAreas;
+	memcpy( build.sourceAreas, sourceAreas, sizeof( build.sourceAreas ) );
+#else
+	// free the PVS
+	pvs.FreeCurrentPVS( pvsHandle );
+#endif
+
+	// the last new state is for the game and player state
+	build.newBases.SetNum( build.entities.Num() + 1, false );
+	for ( i = 0; i < build.newBases.Num(); i++ )
+	{
+		build.newBases[ i ] = entityStateAllocator.Alloc();
+	}
+	build.changed.SetNum( build.entities.Num(), false );
+	build.priorities.SetNum( build.entities.Num(), false );
+
+	// entities seen by several clients are only written once
+	build.cached.SetNum( build.entities.Num(), false );
+	for ( i = 0; i < build.entities.Num(); i++ )
+	{
+		build.cached[ i ] = cacheEntities ? ServerCacheEntitySnapshot( build.entities[ i ], build.coop ) : NULL;
+	}
+
+	return true;
+}
+
+/*
+================
+idGameLocal::ServerCacheEntitySnapshot
+
+  Records the snapshot writes of the entity the first time it is written this frame.
+  Returns NULL if the entity has to be written directly for each client.
+================
+*/
+entitySnapshot_t *idGameLocal::ServerCacheEntitySnapshot( idEntity *ent, bool coop )
+{
+	idBitMsgDelta deltaMsg;
+	entitySnapshot_t *cache;
+
+	cache = entitySnapshots[ ent->entityNumber ];
+	if ( !cache )
+	{
+		cache = entitySnapshotAllocator.Alloc();
+		cache->cacheFrame = snapshotCacheFrame - 1;
+		entitySnapshots[ ent->entityNumber ] = cache;
+	}
+
+	if ( cache->cacheFrame != snapshotCacheFrame )
+	{
+		cache->cacheFrame = snapshotCacheFrame;
+
+		cache->state.Init( cache->stateBuf, sizeof( cache->stateBuf ) );
+		cache->state.SetAllowOverflow( true );
+		cache->state.BeginWriting();
+		cache->record.Init( cache->recordBuf, sizeof( cache->recordBuf ) );
+		cache->record.SetAllowOverflow( true );
+		cache->record.BeginWriting();
+
+		deltaMsg.InitRecord( &cache->state, &cache->record );
+
+		deltaMsg.WriteBits( coop ? coopIds[ ent->entityCoopNumber ] : spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
+		deltaMsg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
+		deltaMsg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
+
+		ent->WriteToSnapshot( deltaMsg );
+
+		cache->valid = !cache->state.IsOverflowed() && !cache->record.IsOverflowed();
+	}
+
+	return cache->valid ? cache : NULL;
+}
+
+/*
+================
+SnapshotPriorityCompare
+================
+*/
+static int SnapshotPriorityCompare( const snapshotPriority_t *a, const snapshotPriority_t *b )
+{
+	if ( a->priority > b->priority )
+	{
+		return -1;
+	}
+	if ( a->priority < b->priority )
+	{
+		return 1;
+	}
+	return a->index - b->index;
+}
+
+/*
+================
+idGameLocal::ServerScheduleSnapshotEntities
+
+  Orders the entities by the priority they accumulated for the client since they were
+  last sent. Near entities in view that move fast gain priority the quickest.
+  Only changes the accumulators of the client so it is safe to run in a snapshot job.
+================
+*/
+void idGameLocal::ServerScheduleSnapshotEntities( snapshotBuild_t &build )
+{
+	int i;
+	float priority, dist, speed;
+	idVec3 delta;
+	idEntity *ent;
+	const int clientNum = build.clientNum;
+
+	for ( i = 0; i < build.entities.Num(); i++ )
+	{
+		ent = build.entities[ i ];
+		snapshotPriority_t &entry = build.priorities[ i ];
+		entry.index = i;
+
+		// the own player is always sent
+		if ( ent == build.player )
+		{
+			entry.priority = idMath::INFINITY;
+			continue;
+		}
+
+		delta = ent->GetPhysics()->GetOrigin() - build.viewOrigin;
+		dist = delta.Normalize();
+
+		priority = SNAPSHOT_PRIORITY_DISTANCE / ( SNAPSHOT_PRIORITY_DISTANCE + dist );
+
+		// entities behind the player matter less
+		priority *= 0.625f + 0.375f * ( delta * build.viewDir );
+
+		// fast entities get out of date sooner
+		speed = ent->GetPhysics()->GetLinearVelocity().LengthFast();
+		priority *= 1.0f + Min( speed / SNAPSHOT_PRIORITY_SPEED, 3.0f );
+
+		if ( ent->IsType( idPlayer::Type ) )
+		{
+			priority *= 2.0f;
+		}
+
+		ent->snapshotAccumulator[ clientNum ] += priority;
+		entry.priority = ent->snapshotAccumulator[ clientNum ];
+	}
+
+	build.priorities.Sort( SnapshotPriorityCompare );
+}
+
+/*
+================
+idGameLocal::ServerWriteSnapshotEntities
+
+  Writes the prepared entities and the game and player state to the snapshot message.
+  Only reads game state and only writes to the build and the client's own entity
+  states, so the snapshots of different clients can be written in parallel.
+================
+*/
+void idGameLocal::ServerWriteSnapshotEntities( snapshotBuild_t &build )
+{
+	int i, n, msgSize, msgWriteBit, entityNum, entityBytes, entitiesSize;
+	bool scheduled;
+	idEntity *ent;
+	idBitMsgDelta deltaMsg;
+	entityState_t *base, *newBase;
+	entitySnapshot_t *cache;
+	idBitMsg &msg = *build.msg;
+	const int clientNum = build.clientNum;
+
+	// with a byte budget the entities with the highest priority are written first and the rest is postponed
+	scheduled = build.maxBytes > 0 && net_snapshotPriority.GetBool();
+	if ( scheduled )
+	{
+		ServerScheduleSnapshotEntities( build );
+	}
+	entityBytes = build.maxBytes - build.reserveBytes;
+
+	// create the snapshot
+	for ( n = 0; n < build.entities.Num(); n++ )
+	{
+		i = scheduled ? build.priorities[ n ].index : n;
+		ent = build.entities[ i ];
+		newBase = build.newBases[ i ];
+		cache = build.cached[ i ];
+
+		// coop identifies the entities by their coop number
+		entityNum = build.coop ? ent->entityCoopNumber : ent->entityNumber;
+
+		// the delta is empty when the shared state is identical to the base
+		base = clientEntityStates[ clientNum ][ entityNum ];
+		if ( cache && base && base->state.GetNumBitsWritten() == cache->state.GetNumBitsWritten() &&
+				memcmp( base->state.GetData(), cache->state.GetData(), cache->state.GetSize() ) == 0 )
+		{
+			build.changed[ i ] = false;
+			ent->snapshotAccumulator[ clientNum ] = 0.0f;
+			if ( build.coop )
+			{
+				ent->inSnapshotQueue[ clientNum ] = false;
+				ent->firstTimeInClientPVS[ clientNum ] = false;
+			}
+			continue;
+		}
+
+		// save the write state to which we can revert when the entity didn't change at all
+		msg.SaveWriteState( msgSize, msgWriteBit );
+
+		// write the entity to the snapshot
+		msg.WriteBits( entityNum, GENTITYNUM_BITS );
+
+		if ( base )
+		{
+			base->state.BeginReading();
+		}
+		if ( build.coop )
+		{
+			newBase->entityCoopNumber = entityNum;
+		}
+		else
+		{
+			newBase->entityNumber = entityNum;
+		}
+		newBase->state.Init( newBase->stateBuf, sizeof( newBase->stateBuf ) );
+		newBase->state.BeginWriting();
+
+		deltaMsg.Init( base ? &base->state : NULL, &newBase->state, &msg );
+
+		if ( cache )
+		{
+			deltaMsg.Replay( cache->record );
+		}
+		else
+		{
+			deltaMsg.WriteBits( build.coop ? coopIds[ entityNum ] : spawnIds[ entityNum ], 32 - GENTITYNUM_BITS );
+			deltaMsg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
+			deltaMsg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
+
+			// write the class specific data to the snapshot
+			ent->WriteToSnapshot( deltaMsg );
+		}
+
+		build.changed[ i ] = deltaMsg.HasChanged();
+
+		// the client keeps the old state of entities that don't fit, the own player is always sent
+		if ( build.changed[ i ] && scheduled && msg.GetSize() > entityBytes && ent != build.player )
+		{
+			build.changed[ i ] = false;
+			msg.RestoreWriteState( msgSize, msgWriteBit );
+			if ( build.coop )
+			{
+				// keep inactive entities selected until they fit into a snapshot
+				ent->inSnapshotQueue[ clientNum ] = true;
+			}
+			continue;
+		}
+		ent->snapshotAccumulator[ clientNum ] = 0.0f;
+
+		if ( build.coop )
+		{
+			ent->inSnapshotQueue[ clientNum ] = false;
+			ent->firstTimeInClientPVS[ clientNum ] = false; //Let the server know that this client already saw this entity for atleast one time
+		}
+
+		if ( !build.changed[ i ] )
+		{
+			msg.RestoreWriteState( msgSize, msgWriteBit );
+		}
+	#if ASYNC_WRITE_TAGS
+		else
+		{
+			msg.WriteLong( build.tagRandom.RandomInt() );
+		}
+	#endif
+	}
+
+	entitiesSize = msg.GetSize();
+	msg.WriteBits( ENTITYNUM_NONE, GENTITYNUM_BITS );
+
+	// write the PVS to the snapshot
+#if ASYNC_WRITE_PVS
+	for ( i = 0; i < idEntity::MAX_PVS_AREAS; i++ )
+	{
+		if ( i < build.numSourceAreas )
+		{
+			msg.WriteLong( build.sourceAreas[ i ] );
+		}
+		else
+		{
+			msg.WriteLong( 0 );
+		}
+	}
+	gameLocal.pvs.WritePVS( build.pvsHandle, msg );
+#endif
+	for ( i = 0; i < ENTITY_PVS_SIZE; i++ )
+	{
+		msg.WriteDeltaLong( clientPVS[ clientNum ][ i ], build.snapshot->pvs[ i ] );
+	}
+
+	// write the game and player state to the snapshot
+	base = clientEntityStates[ clientNum ][ ENTITYNUM_NONE ];	// ENTITYNUM_NONE is used for the game and player state
+	if ( base )
+	{
+		base->state.BeginReading();
+	}
+	newBase = build.newBases[ build.entities.Num() ];
+	newBase->entityNumber = ENTITYNUM_NONE;
+	newBase->entityCoopNumber = ENTITYNUM_NONE; //added for coop
+	newBase->state.Init( newBase->stateBuf, sizeof( newBase->stateBuf ) );
+	newBase->state.BeginWriting();
+	deltaMsg.Init( base ? &base->state : NULL, &newBase->state, &msg );
+
+	idPlayer *player = build.player;
+	if ( player->spectating && player->spectator != player->entityNumber && gameLocal.entities[ player->spectator ] && gameLocal.entities[ player->spectator ]->IsType( idPlayer::Type ) )
+	{
+		static_cast<idPlayer *>(gameLocal.entities[ player->spectator ])->WritePlayerStateToSnapshot( deltaMsg );
+	}
+	else
+	{
+		player->WritePlayerStateToSnapshot( deltaMsg );
+	}
+
+	WriteGameStateToSnapshot( deltaMsg );
+
+	// keep room for the end of the next snapshot
+	build.reserveBytes = msg.GetSize() - entitiesSize;
+}
+
+/*
+================
+idGameLocal::ServerFinishSnapshot
+
+  Links the changed entity states to the snapshot and frees the others.
+================
+*/
+void idGameLocal::ServerFinishSnapshot( snapshotBuild_t &build, int numPVSClients )
+{
+	int i;
+	entityState_t *newBase;
+
+	for ( i = 0; i < build.newBases.Num(); i++ )
+	{
+		newBase = build.newBases[ i ];
+
+		// the game and player state is always kept
+		if ( i < build.entities.Num() && !build.changed[ i ] )
+		{
+			entityStateAllocator.Free( newBase );
+			continue;
+		}
+
+		newBase->next = build.snapshot->firstEntityState;
+		build.snapshot->firstEntityState = newBase;
+	}
+
+#if ASYNC_WRITE_PVS
+	// free the PVS
+	pvs.FreeCurrentPVS( build.pvsHandle );
+#endif
+
+	// copy the client PVS string
+	memcpy( build.clientInPVS, build.snapshot->pvs, (numPVSClients + 7) >> 3 );
+	LittleRevBytes( build.clientInPVS, sizeof( int ), sizeof( build.clientInPVS ) / sizeof( int ) );
+}
+
+/*
+================
+idGameLocal::ServerWriteSnapshotJob
+================
+*/
+void idGameLocal::ServerWriteSnapshotJob( void *data )
+{
+	gameLocal.ServerWriteSnapshotEntities( *reinterpret_cast<snapshotBuild_t *>(data) );
+}
+
+/*
+================
+idGameLocal::ServerWriteSnapshot
+
+  Write a snapshot of the current game state for the given client.
+================
+*/
+void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &msg, byte *clientInPVS, int numPVSClients )
+{
+	snapshotRequest_t request;
+
+	request.clientNum = clientNum;
+	request.sequence = sequence;
+	request.msg = &msg;
+	request.clientInPVS = clientInPVS;
+	request.maxBytes = 0;
+
+	ServerWriteSnapshots( &request, 1, numPVSClients );
+}
+
+/*
+================
+idGameLocal::ServerWriteSnapshots
+
+  Write the snapshots for several clients. Everything that touches shared game state
+  runs on the main thread before and after the entity states are written in parallel.
+  The entity states are written once and shared by all the snapshots.
+================
+*/
+void idGameLocal::ServerWriteSnapshots( snapshotRequest_t *requests, int numRequests, int numPVSClients )
+{
+	int i, numBuilds;
+	bool parallel, cacheEntities;
+	snapshotBuild_t *builds[ MAX_CLIENTS ];
+
+	// the PVS handles are kept until the snapshot is finished when the PVS is written
+	parallel = net_parallelSnapshots.GetBool() && numRequests > 1 && !ASYNC_WRITE_PVS;
+	cacheEntities = net_snapshotCache.GetBool() && numRequests > 1;
+
+	// the entity states written for the previous snapshots are outdated
+	snapshotCacheFrame++;
+
+	numBuilds = 0;
+	for ( i = 0; i < numRequests; i++ )
+	{
+		snapshotBuild_t &build = snapshotBuilds[ requests[ i ].clientNum ];
+
+		build.clientNum = requests[ i ].clientNum;
+		build.sequence = requests[ i ].sequence;
+		build.msg = requests[ i ].msg;
+		build.clientInPVS = requests[ i ].clientInPVS;
+		build.maxBytes = requests[ i ].maxBytes;
+
+		if ( !ServerPrepareSnapshot( build, cacheEntities ) )
+		{
+			continue;
+		}
+		if ( parallel )
+		{
+			builds[ numBuilds++ ] = &build;
+			snapshotJobList.AddJob( ServerWriteSnapshotJob, &build );
+		}
+		else
+		{
+			ServerWriteSnapshotEntities( build );
+			ServerFinishSnapshot( build, numPVSClients );
+		}
+	}
+
+	if ( !parallel )
+	{
+		return;
+	}
+
+	snapshotJobList.Submit();
+	snapshotJobList.Wait();
+
+	for ( i = 0; i < numBuilds; i++ )
+	{
+		ServerFinishSnapshot( *builds[ i ], numPVSClients );
+	}
 }
 
 /*
@@ -2136,6 +2551,9 @@ gameReturn_t idGameLocal::ClientPrediction( int clientNum, const usercmd_t *clie
 	// set the user commands for this frame
 	memcpy( usercmds, clientCmds, numClients * sizeof( usercmds[ 0 ] ) );
 
+	// the predicted vehicles need their wheel contacts
+	vehicleSystem.RunFrame();
+
 		// run prediction on all entities from the last snapshot
 	// run prediction on all entities from the last snapshot
 	if ( !mpGame.IsGametypeCoopBased() )
@@ -3132,314 +3550,12 @@ void idGameLocal::snapshotsort( const snapshotsort_context_s &context, idEntity*
 idGameLocal::ServerWriteSnapshotCoop
 
   Write a snapshot of the current game state for the given client.
+  The coop entity selection is done by ServerPrepareSnapshot.
 ================
 */
 void idGameLocal::ServerWriteSnapshotCoop( int clientNum, int sequence, idBitMsg &msg, byte *clientInPVS, int numPVSClients )
 {
-	int i, j, msgSize, msgWriteBit;
-	idPlayer *player, *spectated = NULL;
-	idEntity *ent;
-	pvsHandle_t pvsHandle;
-	idBitMsgDelta deltaMsg;
-	snapshot_t *snapshot;
-	entityState_t *base, *newBase;
-	int numSourceAreas, sourceAreas[ idEntity::MAX_PVS_AREAS ];
-
-	//REMINDER TO STRADEX: DELETE EVERYTHING RELATED TO serverPriorityNode. IT'S NOT USED FOR ANYTHING
-	//Used by stradex for netcode optimization
-	int serverSendEntitiesCount = 0;
-	int serverEntitiesLimit = net_serverSnapshotLimit.GetInteger();
-
-	if ( mpGame.IsGametypeCoopBased() )
-	{
-		player = static_cast<idPlayer *>(coopentities[ clientNum ]);
-	}
-	else
-	{
-		player = static_cast<idPlayer *>(entities[ clientNum ]);
-	}
-
-	if ( !player )
-	{
-		return;
-	}
-
-	if ( player->spectating && player->spectator != clientNum && entities[ player->spectator ] )
-	{
-		spectated = static_cast<idPlayer *>(entities[ player->spectator ]);
-	}
-	else
-	{
-		spectated = player;
-	}
-
-	// free too old snapshots
-	FreeSnapshotsOlderThanSequence( clientNum, sequence - 64 );
-
-	// allocate new snapshot
-	snapshot = snapshotAllocator.Alloc();
-	snapshot->sequence = sequence;
-	snapshot->firstEntityState = NULL;
-	snapshot->next = clientSnapshots[ clientNum ];
-	clientSnapshots[ clientNum ] = snapshot;
-	memset( snapshot->pvs, 0, sizeof( snapshot->pvs ) );
-
-	// get PVS for this player
-	// don't use PVSAreas for networking - PVSAreas depends on animations (and md5 bounds), which are not synchronized
-	numSourceAreas = gameRenderWorld->BoundsInAreas( spectated->GetPlayerPhysics()->GetAbsBounds(), sourceAreas, idEntity::MAX_PVS_AREAS );
-	pvsHandle = gameLocal.pvs.SetupCurrentPVS( sourceAreas, numSourceAreas, PVS_NORMAL );
-
-#if ASYNC_WRITE_TAGS
-	idRandom tagRandom;
-	tagRandom.SetSeed( random.RandomInt() );
-	msg.WriteLong( tagRandom.GetSeed() );
-#endif
-
-
-	//Added by Stradex for netcode optimization (SORT LIST)
-
-	//Clear the list first
-	for ( j = 0; j < MAX_GENTITIES; j++ )
-	{
-		sortsnapshotentities[ j ] = NULL;
-	}
-
-	int sortSnapCount = 1;
-	sortsnapshotentities[ 0 ] = coopentities[ clientNum ]; //ensure to always send info about our own player
-
-	for ( ent = coopSyncEntities.Next(); ent != NULL; ent = ent->coopNode.Next() )
-	{
-		ent->readByServer = false;
-
-		if ( !ent->PhysicsTeamInPVS( pvsHandle ) && (((ent->entityNumber != clientNum) && !mpGame.IsGametypeCoopBased()) || ((ent->entityCoopNumber != clientNum) && mpGame.IsGametypeCoopBased())) )
-		{
-			continue;
-		}
-		if ( !ent->IsActive() && !ent->IsMasterActive() && !ent->firstTimeInClientPVS[ clientNum ] && !ent->forceNetworkSync && !ent->inSnapshotQueue[ clientNum ] )
-		{ //ignore inactive entities that the player already saw before
-			continue;
-		}
-		// if that entity is not marked for network synchronization
-		if ( !ent->fl.coopNetworkSync )
-		{
-			continue;
-		}
-		//Since sorting it's a pretty expensive stuff, let's try to have this list the less filled with entities possible
-		sortsnapshotentities[ sortSnapCount++ ] = ent;
-	}
-
-	snapshotsort_context_s context; // this is to keep sorting signatures clean if isInOrder requires more game state information
-	context.clientNum = clientNum;
-	snapshotsort( context, sortsnapshotentities, 1, sortSnapCount - 1 );
-
-	//bool readingQueue = true; 
-
-	// create the snapshot
-	//for( ent = spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
-	//for (int j=0; j < 2; j++) {
-	//for( ent = coopSyncEntities.Next(); ent != NULL; ent = ent->coopNode.Next() ) { //Test for coop
-	for ( j = 0, ent = sortsnapshotentities[ j ]; ent != NULL; ent = sortsnapshotentities[ ++j ] )
-	{
-// if the entity is not in the player PVS
-/*
-if ( !ent->PhysicsTeamInPVS( pvsHandle ) && (((ent->entityNumber != clientNum) && !mpGame.IsGametypeCoopBased()) || ((ent->entityCoopNumber != clientNum) && mpGame.IsGametypeCoopBased()))  ) {
-	continue;
-}
-
-//Coop stuff
-if (!ent->IsActive() && !ent->IsMasterActive() && !ent->firstTimeInClientPVS[clientNum] && !ent->forceNetworkSync) { //ignore inactive entities that the player already saw before
-	continue;
-}
-*/
-//In coop let's ignore static snapshots and ton of other shitty stuff
-//TryingSomething
-
-		if ( !mpGame.IsGametypeCoopBased() )
-		{
-// add the entity to the snapshot pvs
-			snapshot->pvs[ ent->entityNumber >> 5 ] |= 1 << (ent->entityNumber & 31); //NON-Coop keeps the original order
-		}
-
-
-		//snapshot->pvs[ ent->entityNumber >> 5 ] |= 1 << ( ent->entityNumber & 31 ); 
-
-		/*
-		// if that entity is not marked for network synchronization
-		if ( !ent->fl.networkSync ) {
-			continue;
-		}
-		*/
-
-		if ( serverSendEntitiesCount >= serverEntitiesLimit )
-		{
-			ent->inSnapshotQueue[ clientNum ] = true;
-			continue;
-		}
-
-		ent->inSnapshotQueue[ clientNum ] = false;
-		serverSendEntitiesCount++;
-		/*
-		if (mpGame.IsGametypeCoopBased() &&
-			(ent->IsType(idStaticEntity::Type) || ent->IsType(idFuncSmoke::Type) || ent->IsType(idTextEntity::Type) ||
-			ent->IsType(idLocationSeparatorEntity::Type) || ent->IsType(idVacuumSeparatorEntity::Type) ||
-			ent->IsType(idBeam::Type) || ent->IsType(idShaking::Type) || ent->IsType(idEarthQuake::Type) ||
-			ent->IsType(idFuncAASObstacle::Type) || ent->IsType(idTrigger::Type) || ent->IsType(idSound::Type))) {
-			common->Printf("Not sending entity %s to client\n", ent->GetName());
-				continue; //ignore these entities, let the client deal with these client-side
-		}
-		*/
-
-		if ( mpGame.IsGametypeCoopBased() )
-		{
-// add the entity to the snapshot pvs
-			snapshot->pvs[ ent->entityNumber >> 5 ] |= 1 << (ent->entityNumber & 31); //COOP add entities to the snapshot pvs only to netsync entities STRADEX
-		}
-
-		ent->firstTimeInClientPVS[ clientNum ] = false; //Let the server know that this client already saw this entity for atleast one time
-
-		// save the write state to which we can revert when the entity didn't change at all
-		msg.SaveWriteState( msgSize, msgWriteBit );
-
-		if ( mpGame.IsGametypeCoopBased() )
-		{
-// write the entity coop number to the snapshot
-			msg.WriteBits( ent->entityCoopNumber, GENTITYNUM_BITS ); //test new netcode coop sync
-		}
-		else
-		{
-			 // write the entity number to the snapshot	
-			msg.WriteBits( ent->entityNumber, GENTITYNUM_BITS );
-		}
-
-
-
-		if ( mpGame.IsGametypeCoopBased() )
-		{
-			base = clientEntityStates[ clientNum ][ ent->entityCoopNumber ];
-		}
-		else
-		{
-			base = clientEntityStates[ clientNum ][ ent->entityNumber ];
-		}
-
-		if ( base )
-		{
-			base->state.BeginReading();
-		}
-		newBase = entityStateAllocator.Alloc();
-		if ( mpGame.IsGametypeCoopBased() )
-		{
-			newBase->entityCoopNumber = ent->entityCoopNumber;
-		}
-		else
-		{
-			newBase->entityNumber = ent->entityNumber;
-		}
-		newBase->state.Init( newBase->stateBuf, sizeof( newBase->stateBuf ) );
-		newBase->state.BeginWriting();
-
-		deltaMsg.Init( base ? &base->state : NULL, &newBase->state, &msg );
-
-		if ( mpGame.IsGametypeCoopBased() )
-		{
-			deltaMsg.WriteBits( coopIds[ ent->entityCoopNumber ], 32 - GENTITYNUM_BITS ); //testing netsync coop
-		}
-		else
-		{
-			deltaMsg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
-		}
-
-		deltaMsg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
-		deltaMsg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
-
-		// write the class specific data to the snapshot
-		ent->WriteToSnapshot( deltaMsg );
-
-		if ( !deltaMsg.HasChanged() )
-		{
-			msg.RestoreWriteState( msgSize, msgWriteBit );
-			entityStateAllocator.Free( newBase );
-		}
-		else
-		{
-			newBase->next = snapshot->firstEntityState;
-			snapshot->firstEntityState = newBase;
-
-		#if ASYNC_WRITE_TAGS
-			msg.WriteLong( tagRandom.RandomInt() );
-		#endif
-		}
-	}
-
-	msg.WriteBits( ENTITYNUM_NONE, GENTITYNUM_BITS );
-
-	// write the PVS to the snapshot
-#if ASYNC_WRITE_PVS
-	for ( i = 0; i < idEntity::MAX_PVS_AREAS; i++ )
-	{
-		if ( i < numSourceAreas )
-		{
-			msg.WriteLong( sourceAreas[ i ] );
-		}
-		else
-		{
-			msg.WriteLong( 0 );
-		}
-	}
-	gameLocal.pvs.WritePVS( pvsHandle, msg );
-#endif
-	for ( i = 0; i < ENTITY_PVS_SIZE; i++ )
-	{
-		msg.WriteDeltaLong( clientPVS[ clientNum ][ i ], snapshot->pvs[ i ] );
-	}
-
-	// free the PVS
-	pvs.FreeCurrentPVS( pvsHandle );
-
-	// write the game and player state to the snapshot
-	base = clientEntityStates[ clientNum ][ ENTITYNUM_NONE ];	// ENTITYNUM_NONE is used for the game and player state
-	if ( base )
-	{
-		base->state.BeginReading();
-	}
-	newBase = entityStateAllocator.Alloc();
-	newBase->entityNumber = ENTITYNUM_NONE;
-	newBase->entityCoopNumber = ENTITYNUM_NONE; //added for coop
-	newBase->next = snapshot->firstEntityState;
-	snapshot->firstEntityState = newBase;
-	newBase->state.Init( newBase->stateBuf, sizeof( newBase->stateBuf ) );
-	newBase->state.BeginWriting();
-	deltaMsg.Init( base ? &base->state : NULL, &newBase->state, &msg );
-
-	if ( player->spectating && player->spectator != player->entityNumber && gameLocal.entities[ player->spectator ] && gameLocal.entities[ player->spectator ]->IsType( idPlayer::Type ) )
-	{
-		static_cast<idPlayer *>(gameLocal.entities[ player->spectator ])->WritePlayerStateToSnapshot( deltaMsg );
-	}
-	else
-	{
-		player->WritePlayerStateToSnapshot( deltaMsg );
-	}
-
-	WriteGameStateToSnapshot( deltaMsg );
-
-	// copy the client PVS string
-	memcpy( clientInPVS, snapshot->pvs, (numPVSClients + 7) >> 3 );
-	LittleRevBytes( clientInPVS, sizeof( int ), sizeof( clientInPVS ) / sizeof( int ) );
-
-	//just for coop debug (May a cvar for test would be cool)
-	//common->Printf("Sending %d entities to client number: %d\n", serverSendEntitiesCount, clientNum);
-
-	/*
-	//It was just for DEBUG, it's common and nothing bad with it
-	if (serverSendEntitiesCount >= serverEntitiesLimit) {
-		common->Warning("[COOP] Snapshot overflow... using snapshot queue\n");
-	}
-	*/
-	/*
-	if (iterationsDebug >= MAX_SORT_ITERATIONS) {
-		common->Warning("[COOP] iterations overflow while sorting list!: %d\n", iterationsDebug);
-	}
-	*/
+	ServerWriteSnapshot( clientNum, sequence, msg, clientInPVS, numPVSClients );
 }
 
 /*
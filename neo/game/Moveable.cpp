@@ -157,6 +157,7 @@ void idMoveable::Spawn( void ) {
 	physicsObj.SetGravity( gameLocal.GetGravity() );
 	physicsObj.SetContents( CONTENTS_SOLID );
 	physicsObj.SetClipMask( MASK_SOLID | CONTENTS_BODY | CONTENTS_CORPSE | CONTENTS_MOVEABLECLIP );
+	physicsObj.SetContinuousCollision( spawnArgs.GetBool( "continuousCollision" ) );
 	SetPhysics( &physicsObj );
 
 	if ( spawnArgs.GetFloat( "mass", "10", mass ) ) {
@@ -375,6 +375,7 @@ void idProjectile::Launch( const idVec3 &start, const idVec3 &dir, const idVec3
 	physicsObj.SetGravity( gravVec * gravity );
 	physicsObj.SetContents( contents );
 	physicsObj.SetClipMask( clipMask );
+	physicsObj.SetContinuousCollision( spawnArgs.GetBool( "continuousCollision" ) );
 	physicsObj.SetLinearVelocity( axis[ 2 ] * speed + pushVelocity );
 	physicsObj.SetAngularVelocity( angular_velocity.ToAngularVelocity() * axis );
 	physicsObj.SetOrigin( start );
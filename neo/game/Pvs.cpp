@@ -33,6 +33,16 @@ If you have questions concerning this license or the applicable additional terms
 
 #define MAX_BOUNDS_AREAS	16
 
+// the passage flood is split into jobs when there are enough portals to make it worthwhile
+#define PVS_PARALLEL_MIN_PORTALS	64
+#define MAX_PVS_PASSAGE_JOBS		64
+
+static const char *	PVS_CACHE_DIR		= "generated/pvs/";
+static const int	PVS_CACHE_MAGIC		= ( 'P' << 24 ) | ( 'V' << 16 ) | ( 'S' << 8 ) | 'C';
+static const int	PVS_CACHE_VERSION	= 1;
+
+static idParallelJobList	passagePVSJobList( "passagePVS" );
+
 
 typedef struct pvsPassage_s {
 	byte *				canSee;		// bit set for all portals that can be seen through this passage
@@ -64,6 +74,13 @@ typedef struct pvsStack_s {
 } pvsStack_t;
 
 
+typedef struct pvsPassageJob_s {
+	const idPVS *		pvs;
+	int					firstPortal;
+	int					numPortals;
+} pvsPassageJob_t;
+
+
 /*
 ================
 idPVS::idPVS
@@ -408,29 +425,29 @@ pvsStack_t *idPVS::FloodPassagePVS_r( pvsPortal_t *source, const pvsPortal_t *po
 
 /*
 ===============
-idPVS::PassagePVS
+idPVS::FloodPassagePVS
+
+  Calculates the portal PVS for a range of source portals. If markDone is set the
+  finished portals are used to narrow the flood of the following ones.
 ===============
 */
-void idPVS::PassagePVS( void ) const {
+void idPVS::FloodPassagePVS( int firstPortal, int numFloodPortals, bool markDone ) const {
 	int i;
 	pvsPortal_t *source;
 	pvsStack_t *stack, *s;
 
-	// create the passages
-	CreatePassages();
-
 	// allocate first stack entry
 	stack = reinterpret_cast<pvsStack_t*>(new byte[sizeof(pvsStack_t) + portalVisBytes]);
 	stack->mightSee = (reinterpret_cast<byte *>(stack)) + sizeof(pvsStack_t);
 	stack->next = NULL;
 
 	// calculate portal PVS by flooding through the passages
-	for ( i = 0; i < numPortals; i++ ) {
+	for ( i = firstPortal; i < firstPortal + numFloodPortals; i++ ) {
 		source = &pvsPortals[i];
 		memset( source->vis, 0, portalVisBytes );
 		memcpy( stack->mightSee, source->mightSee, portalVisBytes );
 		FloodPassagePVS_r( source, source, stack );
-		source->done = true;
+		source->done = markDone;
 	}
 
 	// free the allocated stack
@@ -438,6 +455,55 @@ void idPVS::PassagePVS( void ) const {
 		stack = stack->next;
 		delete[] s;
 	}
+}
+
+/*
+===============
+idPVS::FloodPassagePVSJob
+===============
+*/
+void idPVS::FloodPassagePVSJob( void *data ) {
+	pvsPassageJob_t *job = reinterpret_cast<pvsPassageJob_t *>( data );
+
+	job->pvs->FloodPassagePVS( job->firstPortal, job->numPortals, false );
+}
+
+/*
+===============
+idPVS::PassagePVS
+===============
+*/
+void idPVS::PassagePVS( void ) const {
+	int i, numJobs, portalsPerJob;
+	pvsPassageJob_t jobs[MAX_PVS_PASSAGE_JOBS];
+
+	// create the passages
+	CreatePassages();
+
+	if ( g_parallelPVS.GetBool() && numPortals >= PVS_PARALLEL_MIN_PORTALS ) {
+		// the jobs only write the vis of their own portals and never read the vis of other
+		// portals, the flood is less narrowed than in the serial case but doesn't depend on job order
+		numJobs = Min( Max( idParallelJobManager::GetNumThreads(), 1 ) * 4, MAX_PVS_PASSAGE_JOBS );
+		portalsPerJob = ( numPortals + numJobs - 1 ) / numJobs;
+
+		for ( i = 0; i < numJobs; i++ ) {
+			jobs[i].pvs = this;
+			jobs[i].firstPortal = i * portalsPerJob;
+			jobs[i].numPortals = Min( portalsPerJob, numPortals - jobs[i].firstPortal );
+			if ( jobs[i].numPortals <= 0 ) {
+				break;
+			}
+			passagePVSJobList.AddJob( FloodPassagePVSJob, &jobs[i] );
+		}
+		passagePVSJobList.Submit();
+		passagePVSJobList.Wait();
+
+		for ( i = 0; i < numPortals; i++ ) {
+			pvsPortals[i].done = true;
+		}
+	} else {
+		FloodPassagePVS( 0, numPortals, true );
+	}
 
 	// destroy the passages
 	DestroyPassages();
@@ -788,13 +854,113 @@ int idPVS::AreaPVSFromPortalPVS( void ) const {
 	return totalVisibleAreas;
 }
 
+/*
+================
+idPVS::CountVisibleAreas
+================
+*/
+int idPVS::CountVisibleAreas( void ) const {
+	int i, j, totalVisibleAreas;
+	const byte *pvs;
+
+	totalVisibleAreas = 0;
+	for ( i = 0; i < numAreas; i++ ) {
+		pvs = areaPVS + i * areaVisBytes;
+		for ( j = 0; j < numAreas; j++ ) {
+			if ( pvs[j>>3] & (1 << (j&7)) ) {
+				totalVisibleAreas++;
+			}
+		}
+	}
+	return totalVisibleAreas;
+}
+
+/*
+================
+idPVS::PVSCacheFileName
+================
+*/
+void idPVS::PVSCacheFileName( const char *mapName, idStr &fileName, idStr &procName ) const {
+	procName = mapName;
+	procName.SetFileExtension( "proc" );
+
+	fileName = PVS_CACHE_DIR;
+	fileName += mapName;
+	fileName.SetFileExtension( "pvs" );
+}
+
+/*
+================
+idPVS::LoadPVSCache
+
+  Loads the area PVS written for a .proc file with the same checksum.
+================
+*/
+bool idPVS::LoadPVSCache( const char *fileName, unsigned long procChecksum ) {
+	int magic = 0, version = 0, cachedAreas = 0, cachedPortals = 0, cachedVisBytes = 0;
+	unsigned int cachedChecksum = 0;
+
+	idFile *file = fileSystem->OpenFileRead( fileName );
+	if ( !file ) {
+		return false;
+	}
+
+	file->ReadInt( magic );
+	file->ReadInt( version );
+	file->ReadUnsignedInt( cachedChecksum );
+	file->ReadInt( cachedAreas );
+	file->ReadInt( cachedPortals );
+	file->ReadInt( cachedVisBytes );
+
+	bool valid = magic == PVS_CACHE_MAGIC && version == PVS_CACHE_VERSION &&
+				cachedChecksum == (unsigned int)procChecksum && cachedAreas == numAreas &&
+				cachedPortals == numPortals && cachedVisBytes == areaVisBytes;
+
+	if ( valid ) {
+		valid = file->Read( areaPVS, numAreas * areaVisBytes ) == numAreas * areaVisBytes;
+	}
+
+	fileSystem->CloseFile( file );
+
+	if ( !valid ) {
+		// anything partially read is overwritten when the PVS is calculated
+		gameLocal.DPrintf( "discarding out of date PVS cache '%s'\n", fileName );
+	}
+	return valid;
+}
+
+/*
+================
+idPVS::WritePVSCache
+================
+*/
+void idPVS::WritePVSCache( const char *fileName, unsigned long procChecksum ) const {
+	idFile *file = fileSystem->OpenFileWrite( fileName );
+	if ( !file ) {
+		return;
+	}
+
+	file->WriteInt( PVS_CACHE_MAGIC );
+	file->WriteInt( PVS_CACHE_VERSION );
+	file->WriteUnsignedInt( (unsigned int)procChecksum );
+	file->WriteInt( numAreas );
+	file->WriteInt( numPortals );
+	file->WriteInt( areaVisBytes );
+	file->Write( areaPVS, numAreas * areaVisBytes );
+
+	fileSystem->CloseFile( file );
+}
+
 /*
 ================
 idPVS::Init
 ================
 */
-void idPVS::Init( void ) {
+void idPVS::Init( const char *mapName ) {
 	int totalVisibleAreas;
+	idStr cacheName, procName;
+	unsigned long procChecksum = 0;
+	bool useCache = false, cached = false;
 
 	Shutdown();
 
@@ -827,21 +993,45 @@ void idPVS::Init( void ) {
 	idTimer timer;
 	timer.Start();
 
-	CreatePVSData();
+	if ( g_pvsCache.GetBool() && mapName && mapName[0] && numPortals ) {
+		// the cache is keyed by the checksum of the .proc file the portals come from
+		void *buffer = NULL;
+		PVSCacheFileName( mapName, cacheName, procName );
+		int length = fileSystem->ReadFile( procName, &buffer );
+		if ( length > 0 && buffer ) {
+			procChecksum = CRC32_BlockChecksum( buffer, length );
+			useCache = true;
+		}
+		fileSystem->FreeFile( buffer );
+
+		if ( useCache ) {
+			cached = LoadPVSCache( cacheName, procChecksum );
+		}
+	}
+
+	if ( cached ) {
+		totalVisibleAreas = CountVisibleAreas();
+	} else {
+		CreatePVSData();
+
+		FrontPortalPVS();
 
-	FrontPortalPVS();
+		CopyPortalPVSToMightSee();
 
-	CopyPortalPVSToMightSee();
+		PassagePVS();
 
-	PassagePVS();
+		totalVisibleAreas = AreaPVSFromPortalPVS();
 
-	totalVisibleAreas = AreaPVSFromPortalPVS();
+		DestroyPVSData();
 
-	DestroyPVSData();
+		if ( useCache ) {
+			WritePVSCache( cacheName, procChecksum );
+		}
+	}
 
 	timer.Stop();
 
-	gameLocal.Printf( "%5.0f msec to calculate PVS\n", timer.Milliseconds() );
+	gameLocal.Printf( "%5.0f msec to %s PVS\n", timer.Milliseconds(), cached ? "load cached" : "calculate" );
 	gameLocal.Printf( "%5d areas\n", numAreas );
 	gameLocal.Printf( "%5d portals\n", numPortals );
 	gameLocal.Printf( "%5d areas visible on average\n", totalVisibleAreas / numAreas );
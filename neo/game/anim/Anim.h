@@ -44,6 +44,21 @@ const int ANIMCHANNEL_LEGS			= 2;
 const int ANIMCHANNEL_HEAD			= 3;
 const int ANIMCHANNEL_EYELIDS		= 4;
 
+// animation level of detail, distant actors update their pose less often and with fewer channels
+typedef enum {
+	ANIMLOD_FULL,							// every channel, every frame
+	ANIMLOD_REDUCED,						// no eyelids, every second frame
+	ANIMLOD_LOW,							// no head, eyelids or faded out anims, every fourth frame
+	ANIMLOD_HIDDEN,							// outside the player pvs, every eighth frame
+	ANIM_NumLODs
+} animLOD_t;
+
+typedef struct {
+	int						numEntities[ ANIM_NumLODs ];	// animating entities at each level of detail
+	int						numFramesCreated;
+	int						numFramesSkipped;				// pose updates put off by the level of detail
+} animLODStats_t;
+
 // for converting from 24 frames per second to milliseconds
 ID_INLINE int FRAME2MS( int framenum ) {
 	return ( framenum * 1000 ) / 24;
@@ -230,11 +245,27 @@ private:
 	idList<idBounds>		bounds;
 	idList<jointAnimInfo_t>	jointInfo;
 	idList<idJointQuat>		baseFrame;
-	idList<float>			componentFrames;
 	idStr					name;
 	idVec3					totaldelta;
 	mutable int				ref_count;
 
+	// compressed frames, the components that change are quantized to 16 bits
+	// per track, the others are stored once, see idMD5Anim::Compress
+	int						numTracks;
+	idList<float>			constantComponents;			// value of every component that never changes
+	idList<int>				trackComponents;			// component of each track
+	idList<float>			trackScale;
+	idList<float>			trackBias;
+	idList<short>			trackFrames;				// numTracks values per key frame
+	idList<int>				keyFrames;					// frame number of each key frame, empty when no frames were dropped
+	idList<int>				frameKeys;					// key frame at or before each frame
+	size_t					uncompressedSize;			// of the float frames in the .md5anim
+
+	void					Compress( const idList<float> &componentFrames );
+	int						FindKeyFrame( int framenum, float &lerp ) const;
+	void					DecodeFrame( int framenum, float *components ) const;
+	void					DecodeJoint( int framenum, int jointNum, float *components ) const;
+
 public:
 							idMD5Anim();
 							~idMD5Anim();
@@ -243,6 +274,7 @@ public:
 	bool					Reload( void );
 	size_t					Allocated( void ) const;
 	size_t					Size( void ) const { return sizeof( *this ) + Allocated(); };
+	size_t					UncompressedSize( void ) const;
 	bool					LoadAnim( const char *filename );
 
 	void					IncreaseRefs( void ) const;
@@ -517,7 +549,15 @@ public:
 
 	void						ForceUpdate( void );
 	void						ClearForceUpdate( void );
-	bool						CreateFrame( int animtime, bool force );
+								// useLOD is for the render callback, the pose may then be left as it was
+								// or be built with fewer channels, see SetLOD
+	bool						CreateFrame( int animtime, bool force, bool useLOD = false );
+	void						SetLOD( animLOD_t lod );
+	animLOD_t					GetLOD( void ) const;
+								// queues the pose the render callback will ask for, so it can be
+								// built together with the others by CreateQueuedFrames
+	void						QueueFrame( void );
+	static void					CreateQueuedFrames( int currentTime );
 	bool						FrameHasChanged( int animtime ) const;
 	void						GetDelta( int fromtime, int totime, idVec3 &delta ) const;
 	bool						GetDeltaRotation( int fromtime, int totime, idMat3 &delta ) const;
@@ -565,6 +605,9 @@ public:
 private:
 	void						FreeData( void );
 	void						PushAnims( int channel, int currentTime, int blendTime );
+	bool						SetupFrame( int currentTime, bool force, bool useLOD, bool &debugInfo );
+	bool						BuildFrame( int currentTime, bool debugInfo );
+	static void					BuildFrameJob( void *data );
 
 private:
 	const idDeclModelDef *		modelDef;
@@ -580,6 +623,12 @@ private:
 	bool						removeOriginOffset;
 	bool						forceUpdate;
 
+	animLOD_t					lod;
+	animLOD_t					frameLOD;				// level of detail the joints were built with
+
+	bool						frameQueued;			// waiting for CreateQueuedFrames
+	bool						pendingFrame;			// built by CreateQueuedFrames, the render callback hasn't picked it up yet
+
 	idBounds					frameBounds;
 
 	float						AFPoseBlendWeight;
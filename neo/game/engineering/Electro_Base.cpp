@@ -13,10 +13,14 @@ admElectroBase::admElectroBase()
 	off_targets.Clear();
 	short_targets.Clear();
 	electroState = EL_ON;
+	circuitNode = -1;
+	circuitSource = true;
 }
 
 admElectroBase::~admElectroBase()
 {
+	gameLocal.electroCircuit.RemoveNode( this );
+
 	on_targets.Clear();
 	off_targets.Clear();
 	short_targets.Clear();
@@ -30,10 +34,14 @@ void admElectroBase::Spawn()
 	FindCustomTargets( "target_short", short_targets );
 
 	GetPhysics()->SetContents( CONTENTS_SOLID );
-	BecomeActive( TH_THINK );
 	BecomeActive( TH_UPDATEVISUALS );
 
+	circuitSource = spawnArgs.GetBool( "source", "1" );
+
 	SpawnCustom();
+
+	// the circuit changes the state on events, so there's nothing to think about
+	gameLocal.electroCircuit.AddNode( this, circuitSource );
 }
 
 void admElectroBase::SpawnCustom()
@@ -46,6 +54,43 @@ void admElectroBase::Think()
 	idEntity::Think(); // display model and run physics
 }
 
+void admElectroBase::LinkCircuit()
+{
+	idList<idEntityPtr<idEntity>> connections;
+
+	FindCustomTargets( "target_connect", connections );
+
+	for ( int i = 0; i < connections.Num(); i++ )
+	{
+		idEntity *ent = connections[ i ].GetEntity();
+		if ( ent && ent->IsType( admElectroBase::Type ) )
+		{
+			gameLocal.electroCircuit.Link( this, static_cast<admElectroBase*>(ent) );
+		}
+	}
+}
+
+void admElectroBase::SetCircuitState( int state, bool notify )
+{
+	if ( state == electroState )
+	{
+		return;
+	}
+
+	if ( !notify )
+	{
+		electroState = state;
+		return;
+	}
+
+	if ( state == EL_SHORTED )
+		OnShorted();
+	else if ( state == EL_ON )
+		TurnOn();
+	else
+		TurnOff();
+}
+
 // override these methods in your classes
 void admElectroBase::OnMultimeter( idWeapon *weap )
 {
@@ -55,7 +100,7 @@ void admElectroBase::OnMultimeter( idWeapon *weap )
 
 void admElectroBase::OnScrewdriver( idWeapon *weap )
 {
-	OnShorted();
+	gameLocal.electroCircuit.SetShorted( this );
 	weap->GetOwner()->AddForce( this, 0, 
 								idVec3( 0, 0, 0 ), 
 								idVec3( 0, 0, 64 ) );
@@ -63,10 +108,10 @@ void admElectroBase::OnScrewdriver( idWeapon *weap )
 
 void admElectroBase::OnCutter( idWeapon *weap )
 {
-	if ( electroState == EL_ON )
-		TurnOff();
-	else if ( electroState == EL_OFF )
-		TurnOn();
+	if ( electroState == EL_SHORTED )
+		return;
+
+	gameLocal.electroCircuit.SetConducting( this, !gameLocal.electroCircuit.IsConducting( this ) );
 }
 
 void admElectroBase::OnShorted()
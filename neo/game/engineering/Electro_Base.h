@@ -12,6 +12,10 @@
 	On multimeter - measures 220V
 	On screwdriver - short, force the player to jump a bit
 	On cutter - toggle between on and off
+
+	The state comes from the circuit the entity is in, see Electro_Circuit.h.
+	"target_connect" links the entity to other electrical entities, and
+	"source" sets whether it feeds its circuit.
 ===============================================================================
 */
 
@@ -30,6 +34,8 @@ enum ElectroState
 
 class admElectroBase : public idEntity
 {
+	friend class admElectroCircuit;
+
 public:
 	CLASS_PROTOTYPE( admElectroBase );
 
@@ -49,9 +55,16 @@ public:
 	virtual void		TurnOff( void );
 	virtual void		TurnOn( void );
 
+	int					GetElectroState( void ) const { return electroState; }
 
 protected:
+						// links the entity to its neighbours once all the map entities have spawned
+	virtual void		LinkCircuit( void );
+	virtual void		SetCircuitState( int state, bool notify );
+
 	int electroState; // 0 = off; 1 = on, nominal; 2 = shorted;
+	int circuitNode; // node in gameLocal.electroCircuit, -1 if none
+	bool circuitSource; // feeds the circuit, from the "source" key
 
 	idList<idEntityPtr<idEntity>> on_targets;
 	idList<idEntityPtr<idEntity>> off_targets;
@@ -0,0 +1,305 @@
+#include "../idlib/precompiled.h"
+#pragma hdrstop
+
+#include "Game_local.h"
+#include "Electro_Base.h"
+
+admElectroCircuit::admElectroCircuit()
+{
+	floodCount = 0;
+	built = false;
+}
+
+void admElectroCircuit::Clear()
+{
+	for ( int i = 0; i < nodes.Num(); i++ )
+	{
+		if ( nodes[ i ].entity )
+		{
+			nodes[ i ].entity->circuitNode = -1;
+		}
+	}
+
+	nodes.Clear();
+	freeNodes.Clear();
+	stack.Clear();
+	component.Clear();
+	floodCount = 0;
+	built = false;
+}
+
+void admElectroCircuit::Build()
+{
+	int i;
+
+	for ( i = 0; i < nodes.Num(); i++ )
+	{
+		if ( nodes[ i ].entity )
+		{
+			nodes[ i ].entity->LinkCircuit();
+		}
+	}
+
+	built = true;
+
+	// the entities start in the state of their component without triggering anything
+	floodCount++;
+	for ( i = 0; i < nodes.Num(); i++ )
+	{
+		if ( nodes[ i ].entity )
+		{
+			Evaluate( i, false );
+		}
+	}
+}
+
+void admElectroCircuit::AddNode( admElectroBase *ent, bool source )
+{
+	int nodeNum;
+
+	if ( freeNodes.Num() )
+	{
+		nodeNum = freeNodes[ freeNodes.Num() - 1 ];
+		freeNodes.SetNum( freeNodes.Num() - 1, false );
+	}
+	else
+	{
+		nodeNum = nodes.Num();
+		nodes.SetNum( nodeNum + 1, false );
+	}
+
+	electroNode_t &node = nodes[ nodeNum ];
+	node.entity = ent;
+	node.links.Clear();
+	node.source = source;
+	node.conducting = true;
+	node.shorted = false;
+	node.floodCount = 0;
+
+	ent->circuitNode = nodeNum;
+
+	// entities spawned after the map link right away
+	if ( built )
+	{
+		ent->LinkCircuit();
+		Update( nodeNum, true );
+	}
+}
+
+void admElectroCircuit::RemoveNode( admElectroBase *ent )
+{
+	int nodeNum = ent->circuitNode;
+	int i;
+
+	if ( nodeNum < 0 )
+	{
+		return;
+	}
+
+	electroNode_t &node = nodes[ nodeNum ];
+	idList<int> links = node.links;
+
+	for ( i = 0; i < links.Num(); i++ )
+	{
+		nodes[ links[ i ] ].links.Remove( nodeNum );
+	}
+
+	node.entity = NULL;
+	node.links.Clear();
+	freeNodes.Append( nodeNum );
+	ent->circuitNode = -1;
+
+	if ( built )
+	{
+		// the neighbours may have been split apart or lost their source
+		floodCount++;
+		for ( i = 0; i < links.Num(); i++ )
+		{
+			Evaluate( links[ i ], true );
+		}
+	}
+}
+
+void admElectroCircuit::Link( admElectroBase *a, admElectroBase *b )
+{
+	if ( a == b || a->circuitNode < 0 || b->circuitNode < 0 )
+	{
+		return;
+	}
+
+	nodes[ a->circuitNode ].links.AddUnique( b->circuitNode );
+	nodes[ b->circuitNode ].links.AddUnique( a->circuitNode );
+
+	if ( built )
+	{
+		Update( a->circuitNode, true );
+	}
+}
+
+void admElectroCircuit::Unlink( admElectroBase *a, admElectroBase *b )
+{
+	if ( a->circuitNode < 0 || b->circuitNode < 0 )
+	{
+		return;
+	}
+
+	nodes[ a->circuitNode ].links.Remove( b->circuitNode );
+	nodes[ b->circuitNode ].links.Remove( a->circuitNode );
+
+	if ( built )
+	{
+		floodCount++;
+		Evaluate( a->circuitNode, true );
+		Evaluate( b->circuitNode, true );
+	}
+}
+
+void admElectroCircuit::SetSource( admElectroBase *ent, bool source )
+{
+	if ( ent->circuitNode < 0 || nodes[ ent->circuitNode ].source == source )
+	{
+		return;
+	}
+
+	nodes[ ent->circuitNode ].source = source;
+
+	if ( built )
+	{
+		Update( ent->circuitNode, true );
+	}
+}
+
+void admElectroCircuit::SetConducting( admElectroBase *ent, bool conducting )
+{
+	if ( ent->circuitNode < 0 || nodes[ ent->circuitNode ].conducting == conducting )
+	{
+		return;
+	}
+
+	nodes[ ent->circuitNode ].conducting = conducting;
+
+	if ( built )
+	{
+		Update( ent->circuitNode, true );
+	}
+}
+
+void admElectroCircuit::SetShorted( admElectroBase *ent )
+{
+	if ( ent->circuitNode < 0 || nodes[ ent->circuitNode ].shorted )
+	{
+		return;
+	}
+
+	nodes[ ent->circuitNode ].shorted = true;
+
+	if ( built )
+	{
+		Update( ent->circuitNode, true );
+	}
+}
+
+bool admElectroCircuit::IsSource( const admElectroBase *ent ) const
+{
+	return ent->circuitNode >= 0 && nodes[ ent->circuitNode ].source;
+}
+
+bool admElectroCircuit::IsConducting( const admElectroBase *ent ) const
+{
+	return ent->circuitNode >= 0 && nodes[ ent->circuitNode ].conducting;
+}
+
+// re-evaluates the component of the node, and those of its neighbours in case the node splits them
+void admElectroCircuit::Update( int nodeNum, bool notify )
+{
+	const idList<int> links = nodes[ nodeNum ].links;
+
+	floodCount++;
+	Evaluate( nodeNum, notify );
+	for ( int i = 0; i < links.Num(); i++ )
+	{
+		Evaluate( links[ i ], notify );
+	}
+}
+
+// floods the component of the node and sets the state of all its entities
+void admElectroCircuit::Evaluate( int nodeNum, bool notify )
+{
+	bool	powered, shorted;
+	int		i, state;
+
+	if ( nodes[ nodeNum ].floodCount == floodCount )
+	{
+		return;
+	}
+
+	powered = false;
+	shorted = false;
+
+	stack.SetNum( 0, false );
+	component.SetNum( 0, false );
+
+	nodes[ nodeNum ].floodCount = floodCount;
+	stack.Append( nodeNum );
+
+	while ( stack.Num() )
+	{
+		int n = stack[ stack.Num() - 1 ];
+		stack.SetNum( stack.Num() - 1, false );
+		component.Append( n );
+
+		const electroNode_t &node = nodes[ n ];
+
+		// a cut entity is a component on its own
+		if ( !node.conducting )
+		{
+			continue;
+		}
+
+		powered |= node.source;
+		shorted |= node.shorted;
+
+		for ( i = 0; i < node.links.Num(); i++ )
+		{
+			electroNode_t &other = nodes[ node.links[ i ] ];
+			if ( other.floodCount == floodCount || !other.conducting )
+			{
+				continue;
+			}
+			other.floodCount = floodCount;
+			stack.Append( node.links[ i ] );
+		}
+	}
+
+	state = powered ? ( shorted ? EL_SHORTED : EL_ON ) : EL_OFF;
+
+	if ( !notify )
+	{
+		for ( i = 0; i < component.Num(); i++ )
+		{
+			const electroNode_t &node = nodes[ component[ i ] ];
+			node.entity->SetCircuitState( node.conducting ? state : EL_OFF, false );
+		}
+		return;
+	}
+
+	// the targets triggered by a state change can change the circuit again
+	idList< idEntityPtr<admElectroBase> > entities;
+	idList<int> states;
+
+	for ( i = 0; i < component.Num(); i++ )
+	{
+		const electroNode_t &node = nodes[ component[ i ] ];
+		entities.Append( idEntityPtr<admElectroBase>() );
+		entities[ i ] = node.entity;
+		states.Append( node.conducting ? state : EL_OFF );
+	}
+
+	for ( i = 0; i < entities.Num(); i++ )
+	{
+		if ( entities[ i ].GetEntity() )
+		{
+			entities[ i ].GetEntity()->SetCircuitState( states[ i ], true );
+		}
+	}
+}
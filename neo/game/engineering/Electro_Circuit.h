@@ -0,0 +1,61 @@
+#pragma once
+
+/*
+===============================================================================
+	Electrical circuit
+
+	Graph of all the electrical entities in the map. Entities that conduct
+	and are linked together form a component. A component is powered when
+	it contains a source, and shorted when it is powered and any of its
+	entities is shorted. A cut entity doesn't conduct and is always off.
+
+	The links are built once all the map entities have spawned. Cutters,
+	screwdrivers and plugs only re-evaluate the components they touch, so
+	the electrical entities don't have to think while nothing changes.
+===============================================================================
+*/
+
+class admElectroBase;
+
+class admElectroCircuit
+{
+public:
+							admElectroCircuit( void );
+
+	void					Clear( void );
+							// links all the entities, called after the map entities have spawned
+	void					Build( void );
+
+	void					AddNode( admElectroBase *ent, bool source );
+	void					RemoveNode( admElectroBase *ent );
+
+	void					Link( admElectroBase *a, admElectroBase *b );
+	void					Unlink( admElectroBase *a, admElectroBase *b );
+
+	void					SetSource( admElectroBase *ent, bool source );
+	void					SetConducting( admElectroBase *ent, bool conducting );
+	void					SetShorted( admElectroBase *ent );
+
+	bool					IsSource( const admElectroBase *ent ) const;
+	bool					IsConducting( const admElectroBase *ent ) const;
+
+private:
+	typedef struct electroNode_s {
+		admElectroBase *	entity;
+		idList<int>			links;
+		bool				source;				// feeds its component
+		bool				conducting;			// false when cut
+		bool				shorted;
+		int					floodCount;			// last evaluation that visited this node
+	} electroNode_t;
+
+	idList<electroNode_t>	nodes;
+	idList<int>				freeNodes;			// unused entries in nodes
+	idList<int>				stack;
+	idList<int>				component;
+	int						floodCount;
+	bool					built;
+
+	void					Update( int nodeNum, bool notify );
+	void					Evaluate( int nodeNum, bool notify );
+};
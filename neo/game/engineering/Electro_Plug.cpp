@@ -11,7 +11,7 @@ END_CLASS
 
 void admElectroPlug::SpawnCustom()
 {
-
+	circuitSource = spawnArgs.GetBool( "source", "0" );
 }
 
 void admElectroPlug::Think()
@@ -21,7 +21,9 @@ void admElectroPlug::Think()
 	if ( !GetBindMaster() &&  voltageSource.GetEntity() )
 	{
 		Bind( voltageSource.GetEntity(), true );
+		gameLocal.electroCircuit.Link( this, static_cast<admElectroBase*>( voltageSource.GetEntity() ) );
 		OnUnuse( user.GetEntity() );
+		BecomeInactive( TH_THINK );
 		return;
 	}
 	else if ( GetBindMaster() && !voltageSource.GetEntity() )
@@ -30,6 +32,13 @@ void admElectroPlug::Think()
 		return;
 	}
 
+	// dropped without plugging it in
+	if ( !user.GetEntity() )
+	{
+		BecomeInactive( TH_THINK );
+		return;
+	}
+
 	CheckForSockets();
 }
 
@@ -59,6 +68,7 @@ void admElectroPlug::OnUse( idPlayer *player )
 	player->isUsing = true;
 	player->isUsingDragEntity = true;
 	user = player;
+	BecomeActive( TH_THINK );
 }
 
 void admElectroPlug::OnUnuse( idPlayer *player )
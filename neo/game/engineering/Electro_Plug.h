@@ -3,7 +3,8 @@
 /*
 ===============================================================================
 	Electric plug entity
-	Plugs into sockets
+	Plugs into sockets, which links it into their circuit.
+	Only thinks while a player is dragging it.
 
 	On multimeter - nothing
 	On screwdriver - nothing
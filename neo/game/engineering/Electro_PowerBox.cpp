@@ -28,6 +28,8 @@ bool IsModelOkay( idStr const &model, bool crashIfNotFound = true )
 
 void admElectroPowerBox::SpawnCustom()
 {
+	powerBoxState = PowerBox_Normal;
+
 	modelUninsulated = spawnArgs.GetString( "model_stripped" );
 	IsModelOkay( modelUninsulated, false );
 
@@ -35,14 +37,27 @@ void admElectroPowerBox::SpawnCustom()
 	IsModelOkay( modelCut, false );
 }
 
-void admElectroPowerBox::SpawnThink()
+void admElectroPowerBox::LinkCircuit()
 {
+	admElectroBase::LinkCircuit();
+
 	FindCustomTargets( "target_socket", sockets );
-}
 
-void admElectroPowerBox::Think()
-{
-	// do nothing
+	for ( int i = 0; i < sockets.Num(); i++ )
+	{
+		idEntity *ent = sockets[ i ].GetEntity();
+		if ( !ent || !ent->IsType( admElectroSocket::Type ) )
+		{
+			continue;
+		}
+
+		// the sockets get their power from the box unless the mapper says otherwise
+		if ( !ent->spawnArgs.FindKey( "source" ) )
+		{
+			gameLocal.electroCircuit.SetSource( static_cast<admElectroSocket*>(ent), false );
+		}
+		gameLocal.electroCircuit.Link( this, static_cast<admElectroSocket*>(ent) );
+	}
 }
 
 void admElectroPowerBox::OnMultimeter( idWeapon *weap )
@@ -65,7 +80,7 @@ void admElectroPowerBox::OnScrewdriver( idWeapon *weap )
 	{
 		if ( powerBoxState == PowerBox_Stripped )
 		{
-			OnShorted();
+			gameLocal.electroCircuit.SetShorted( this );
 		}
 	}
 }
@@ -84,44 +99,7 @@ void admElectroPowerBox::OnCutter( idWeapon *weap )
 			powerBoxState = PowerBox_Cut;
 			SetModel( modelCut );
 
-			TurnOff();
+			gameLocal.electroCircuit.SetConducting( this, false );
 		}
 	}
 }
-
-void admElectroPowerBox::OnShorted()
-{
-	admElectroBase::OnShorted();
-
-	for ( int i = 0; i < sockets.Num(); i++ )
-	{
-		idEntity *ent = sockets[ i ].GetEntity();
-		static_cast<admElectroSocket*>(ent)->OnShorted();
-	}
-}
-
-void admElectroPowerBox::TurnOff()
-{
-	admElectroBase::TurnOff();
-
-	for ( int i = 0; i < sockets.Num(); i++ )
-	{
-		idEntity *ent = sockets[ i ].GetEntity();
-		static_cast<admElectroSocket*>(ent)->TurnOff();
-	}
-}
-
-void admElectroPowerBox::TurnOn()
-{
-	admElectroBase::TurnOn();
-
-	for ( int i = 0; i < sockets.Num(); i++ )
-	{
-		idEntity *ent = sockets[ i ].GetEntity();
-		static_cast<admElectroSocket*>(ent)->TurnOn();
-	}
-}
-
-
-
-
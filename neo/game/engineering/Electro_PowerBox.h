@@ -6,7 +6,8 @@
 	
 	Refers to a set of sockets, all set by the mapper.
 	If a short circuit occurs or wires are cut, then
-	sockets lose power.
+	sockets lose power. The sockets are linked into
+	the power box's circuit, which feeds them.
 
 	On multimeter - nothing
 	On screwdriver - if wires are cut, short circuit
@@ -27,16 +28,13 @@ public:
 	CLASS_PROTOTYPE( admElectroPowerBox );
 
 	void		SpawnCustom( void );
-	void		SpawnThink( void );
-	void		Think( void );
 
 	void		OnMultimeter(	idWeapon *weap );
 	void		OnScrewdriver(	idWeapon *weap );
 	void		OnCutter(		idWeapon *weap );
 
-	void		OnShorted( void );
-	void		TurnOff( void );
-	void		TurnOn( void );
+protected:
+	void		LinkCircuit( void );
 
 private:
 	int			powerBoxState;
@@ -12,12 +12,9 @@ admElectroSocket::admElectroSocket()
 {
 	pluggedIn = false;
 	voltageEffectiveOriginal = 0;
-	voltageEffective = 0;
-	voltageCurrent = 0;
 	voltageMaximum = 0;
 	voltageNoise = 0;
 
-	cycle = 0;
 	omega = 0;
 	frequency = 0;
 
@@ -27,12 +24,9 @@ admElectroSocket::~admElectroSocket()
 {
 	pluggedIn = false;
 	voltageEffectiveOriginal = 0;
-	voltageEffective = 0;
-	voltageCurrent = 0;
 	voltageMaximum = 0;
 	voltageNoise = 0;
 
-	cycle = 0;
 	omega = 0;
 	frequency = 0;
 
@@ -44,64 +38,56 @@ void admElectroSocket::SpawnCustom()
 	voltageEffectiveOriginal	= spawnArgs.GetFloat( "voltage", "220" );
 	voltageNoise				= spawnArgs.GetFloat( "voltageNoise", "2.5" );
 	currentType					= spawnArgs.GetFloat( "type", "1" );
-	voltageEffective			= voltageEffectiveOriginal;
 
 	if ( currentType == VT_DC )
-		voltageMaximum = voltageEffective;
+		voltageMaximum = voltageEffectiveOriginal;
 
 	else if ( currentType == VT_AC )
-		voltageMaximum = voltageEffective * idMath::SQRT_TWO;
+		voltageMaximum = voltageEffectiveOriginal * idMath::SQRT_TWO;
 
-	cycle		= 0;
 	frequency	= spawnArgs.GetFloat( "frequency", "50" );
 	omega		= idMath::TWO_PI * frequency;
 }
 
-void admElectroSocket::Think()
+float admElectroSocket::GetVoltageEffective() const
 {
-	idEntity::Think();
-
 	if ( electroState == EL_OFF || electroState == EL_SHORTED )
-	{
-		voltageEffective = 0;
-		voltageCurrent = 0;
-	}
+		return 0.0f;
 
-	else //if ( electroState == EL_ON )
-	{
-		if ( voltageEffective != voltageEffectiveOriginal )
-		{
-			voltageEffective = voltageEffectiveOriginal;
-		}
-
-		if ( currentType == VT_DC )
-		{
-			voltageCurrent = voltageCurrent * 0.5 + voltageEffective * 0.5;
-		}
+	return voltageEffectiveOriginal;
+}
 
-		else if ( currentType == VT_AC )
-		{
-			cycle += omega * MS2SEC( gameLocal.msec );
+float admElectroSocket::GetVoltage() const
+{
+	float voltageCurrent;
 
-			if ( cycle > idMath::TWO_PI )
-				cycle -= idMath::TWO_PI;
+	if ( electroState == EL_OFF || electroState == EL_SHORTED )
+		return 0.0f;
 
-			voltageCurrent = voltageMaximum * sin( cycle );
-		}
+	if ( currentType == VT_AC )
+	{
+		float cycle = omega * MS2SEC( gameLocal.time ); // current angle
+		voltageCurrent = voltageMaximum * sin( cycle );
+	}
+	else
+	{
+		voltageCurrent = voltageEffectiveOriginal;
+	}
 
-		if ( voltageNoise )
-		{
-			idRandom2 randomNoise;
-			randomNoise.SetSeed( 2459789 );
+	if ( voltageNoise )
+	{
+		idRandom2 randomNoise;
+		randomNoise.SetSeed( 2459789 );
 
-			voltageCurrent += voltageNoise * randomNoise.RandomFloat();
-		}
+		voltageCurrent += voltageNoise * randomNoise.RandomFloat();
 	}
+
+	return voltageCurrent;
 }
 
 void admElectroSocket::OnMultimeter( idWeapon *weap )
 {
-	weap->Measure( voltageEffective );
+	weap->Measure( GetVoltageEffective() );
 	common->Printf( va( "Measured voltage: %f\n", weap->MeasurementSize() ) );
 }
 
@@ -112,6 +98,7 @@ void admElectroSocket::OnScrewdriver( idWeapon *weap )
 
 void admElectroSocket::OnCutter( idWeapon *weap )
 {
+	float voltageEffective = GetVoltageEffective();
 	float damage = 0.028 * idMath::Pow( voltageEffective, 1.5f );
 
 	// TODO: implement insulation
@@ -120,7 +107,7 @@ void admElectroSocket::OnCutter( idWeapon *weap )
 	
 	// ^ Shalakin zakon: Nula + faza = dzenaza
 
-	OnShorted();
+	gameLocal.electroCircuit.SetShorted( this );
 
 	gameLocal.DPrintf( "admElectroSocket voltage %f damage dealt %f\n", voltageEffective, damage );
 }
@@ -4,6 +4,8 @@
 	On multimeter - give measurement voltage ( handled on the weapon side )
 	On screwdriver - nothing
 	On cutter - short circuit
+
+	Doesn't think, the voltage is worked out when something measures it.
 ===============================================================================
 */
 
@@ -18,7 +20,9 @@ public:
 						~admElectroSocket();
 
 	void				SpawnCustom( void );
-	void				Think( void );
+
+	float				GetVoltage( void ) const; // current, actual voltage
+	float				GetVoltageEffective( void ) const;
 
 	virtual void		OnMultimeter(	idWeapon *weap );
 	virtual void		OnScrewdriver(	idWeapon *weap );
@@ -26,14 +30,11 @@ public:
 
 private:
 	float				voltageEffectiveOriginal; // spawnArgs voltage
-	float				voltageEffective; // spawnArgs voltage
 	int					currentType; // 0 - DC, 1 - AC
 
-	float				voltageCurrent; // current, actual voltage
 	float				voltageMaximum; // AC voltage amplitude
 	float				voltageNoise;	// voltage noise, if any
 
-	float				cycle; // current angle; omega*time
 	float				omega; // angular velocity
 	float				frequency; // frequency of oscillating, if AC
 
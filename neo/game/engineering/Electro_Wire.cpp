@@ -32,14 +32,11 @@ void admElectroWire::SpawnCustom()
 
 	af.UpdateAnimation();
 	UpdateVisuals();
-}
-
-void admElectroWire::SpawnThink()
-{
 
+	circuitSource = spawnArgs.GetBool( "source", "0" );
 }
 
-void admElectroWire::Think()
+void admElectroWire::SpawnThink()
 {
 
 }
@@ -56,5 +53,5 @@ void admElectroWire::OnScrewdriver( idWeapon *weap )
 
 void admElectroWire::OnCutter( idWeapon *weap )
 {
-
+	gameLocal.electroCircuit.SetConducting( this, false );
 }
\ No newline at end of file
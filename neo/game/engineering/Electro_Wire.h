@@ -29,7 +29,6 @@ public:
 
 	void		SpawnCustom( void );
 	void		SpawnThink( void );
-	void		Think( void );
 
 	void		OnMultimeter( idWeapon *weap );
 	void		OnScrewdriver( idWeapon *weap );
@@ -54,6 +54,13 @@ extern idCVar   g_muzzleFlashLightLodBias;
 extern idCVar	g_disasm;
 extern idCVar	g_debugBounds;
 extern idCVar	g_debugAnim;
+extern idCVar	g_animMaxTranslationError;
+extern idCVar	g_animMaxRotationError;
+extern idCVar	g_animLod;
+extern idCVar	g_animLodDistance;
+extern idCVar	g_animLodHysteresis;
+extern idCVar	g_animLodStats;
+extern idCVar	g_parallelAnimation;
 extern idCVar	g_debugMove;
 extern idCVar	g_debugDamage;
 extern idCVar	g_debugWeapon;
@@ -74,6 +81,11 @@ extern idCVar	g_infiniSlide;
 extern idCVar	g_enableHudAid;
 
 extern idCVar	g_showPVS;
+extern idCVar	g_pvsCache;
+extern idCVar	g_parallelPVS;
+extern idCVar	net_parallelSnapshots;
+extern idCVar	net_snapshotCache;
+extern idCVar	net_snapshotPriority;
 extern idCVar	g_showTargets;
 extern idCVar	g_showTriggers;
 extern idCVar	g_showCollisionWorld;
@@ -122,6 +134,8 @@ extern idCVar	g_vehicleSuspensionDown;
 extern idCVar	g_vehicleSuspensionKCompress;
 extern idCVar	g_vehicleSuspensionDamping;
 extern idCVar	g_vehicleTireFriction;
+extern idCVar	g_vehicleStepMsec;
+extern idCVar	g_vehicleStats;
 
 extern idCVar	ik_enable;
 extern idCVar	ik_debug;
@@ -141,6 +155,7 @@ extern idCVar	af_jointFrictionScale;
 extern idCVar	af_contactFrictionScale;
 extern idCVar	af_highlightBody;
 extern idCVar	af_highlightConstraint;
+extern idCVar	af_parallelStage;
 extern idCVar	af_showTimings;
 extern idCVar	af_showConstraints;
 extern idCVar	af_showConstraintNames;
@@ -163,6 +178,9 @@ extern idCVar	rb_showMass;
 extern idCVar	rb_showInertia;
 extern idCVar	rb_showVelocity;
 extern idCVar	rb_showActive;
+extern idCVar	rb_sleepIslands;
+extern idCVar	rb_showIslands;
+extern idCVar	g_continuousCollision;
 
 extern idCVar	pm_jumpheight;
 extern idCVar	pm_stepsize;
@@ -293,6 +311,7 @@ extern idCVar	si_lives; //survival lives
 //stradex end
 
 extern idCVar	net_clientSelfSmoothing;
+extern idCVar	net_clientVehicleSmoothing;
 extern idCVar	net_clientLagOMeter;
 extern idCVar	net_clientCoopDebug; 
 
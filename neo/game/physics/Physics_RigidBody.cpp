@@ -173,7 +173,7 @@ bool idPhysics_RigidBody::CheckForCollisions( const float deltaTime, rigidBodyPS
 //#define TEST_COLLISION_DETECTION
 	idMat3 axis;
 	idRotation rotation;
-	bool collided = false;
+	bool hit, collided = false;
 
 #ifdef TEST_COLLISION_DETECTION
 	bool startsolid;
@@ -186,8 +186,14 @@ bool idPhysics_RigidBody::CheckForCollisions( const float deltaTime, rigidBodyPS
 	rotation = axis.ToRotation();
 	rotation.SetOrigin( current.i.position );
 
+	if ( continuousCollision && g_continuousCollision.GetBool() ) {
+		hit = gameLocal.clip.ContinuousMotion( collision, current.i.position, next.i.position, rotation, clipModel, current.i.orientation, clipMask, self );
+	} else {
+		hit = gameLocal.clip.Motion( collision, current.i.position, next.i.position, rotation, clipModel, current.i.orientation, clipMask, self );
+	}
+
 	// if there was a collision
-	if ( gameLocal.clip.Motion( collision, current.i.position, next.i.position, rotation, clipModel, current.i.orientation, clipMask, self ) )
+	if ( hit )
 	{
 		// set the next state to the state at the moment of impact
 		next.i.position = collision.endpos;
@@ -469,6 +475,8 @@ idPhysics_RigidBody::idPhysics_RigidBody( void ) {
 
 	hasMaster = false;
 	isOrientated = false;
+	sleepIsland = -1;
+	continuousCollision = false;
 
 #ifdef RB_TIMINGS
 	lastTimerReset = 0;
@@ -557,6 +565,8 @@ void idPhysics_RigidBody::Save( idSaveGame *savefile ) const {
 
 	savefile->WriteBool( hasMaster );
 	savefile->WriteBool( isOrientated );
+
+	savefile->WriteBool( continuousCollision );
 }
 
 /*
@@ -588,6 +598,8 @@ void idPhysics_RigidBody::Restore( idRestoreGame *savefile ) {
 
 	savefile->ReadBool( hasMaster );
 	savefile->ReadBool( isOrientated );
+
+	savefile->ReadBool( continuousCollision );
 }
 
 /*
@@ -727,6 +739,16 @@ void idPhysics_RigidBody::Rest( void ) {
 	self->BecomeInactive( TH_PHYSICS );
 }
 
+/*
+================
+idPhysics_RigidBody::Sleep
+================
+*/
+void idPhysics_RigidBody::Sleep( int island ) {
+	sleepIsland = island;
+	Rest();
+}
+
 /*
 ================
 idPhysics_RigidBody::DropToFloor
@@ -752,6 +774,11 @@ idPhysics_RigidBody::Activate
 ================
 */
 void idPhysics_RigidBody::Activate( void ) {
+	if ( sleepIsland >= 0 ) {
+		// wake up the bodies resting against this one as well
+		gameLocal.sleepIslands.Wake( sleepIsland );
+		sleepIsland = -1;
+	}
 	current.atRest = -1;
 	self->BecomeActive( TH_PHYSICS );
 }
@@ -939,7 +966,14 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 #endif
 
 		// check if the body has come to rest
-		if ( TestIfAtRest() ) {
+		if ( gameLocal.sleepIslands.IsEnabled() ) {
+			// the island decides when the body goes to sleep
+			bool quiet = TestIfAtRest();
+			if ( !quiet ) {
+				ContactFriction( timeStep );
+			}
+			gameLocal.sleepIslands.AddBody( self, quiet, contacts.Ptr(), contacts.Num() );
+		} else if ( TestIfAtRest() ) {
 			// put to rest
 			Rest();
 			cameToRest = true;
@@ -24,7 +24,7 @@
 ========================================================
 */
 
-CLASS_DECLARATION( idAFEntity_VehicleFourWheels, admVehicleEntity_Car )
+CLASS_DECLARATION( idAFEntity_Vehicle, admVehicleEntity_Car )
 END_CLASS
 
 admVehicleEntity_Car::admVehicleEntity_Car( void )
@@ -36,20 +36,345 @@ admVehicleEntity_Car::admVehicleEntity_Car( void )
 	steerAngle = 0.0f;
 	steerSpeed = 0.0f;
 	dustSmoke = NULL;
+
+	for ( int i = 0; i < 4; i++ )
+	{
+		wheelJoints[ i ] = INVALID_JOINT;
+	}
+	engineHorsepower = 0.0f;
+	isHeldHandbrake = false;
+	isHeldClutch = false;
+
+	snapshotChanged = false;
+	lastRenderTime = 0;
+	lastRenderOrigin.Zero();
+	lastRenderAxis.Identity();
+	predictionErrorOrigin.Zero();
+	predictionErrorAxis.Identity();
+}
+
+admVehicleEntity_Car::~admVehicleEntity_Car( void )
+{
+	gameLocal.vehicleSystem.RemoveVehicle( &physicsObj );
 }
 
-// TODO: IMPLEMENT -456
 void admVehicleEntity_Car::Spawn()
-{
+{
+	static const char *wheelJointKeys[] = {
+		"wheelJointFrontLeft",
+		"wheelJointFrontRight",
+		"wheelJointRearLeft",
+		"wheelJointRearRight"
+	};
+
+	int i;
+	idTraceModel trm;
+	idStr clipModelName, driveWheels;
+	idVec3 origin;
+	idMat3 axis;
+	float mass, suspensionLength, suspensionStiffness, restCompression;
+
+	// check if a clip model is set
+	spawnArgs.GetString( "clipmodel", "", clipModelName );
+	if ( !clipModelName[ 0 ] )
+	{
+		clipModelName = spawnArgs.GetString( "model" );		// use the visual model
+	}
+
+	if ( !collisionModelManager->TrmFromModel( clipModelName, trm ) )
+	{
+		gameLocal.Error( "admVehicleEntity_Car '%s': cannot load collision model %s", name.c_str(), clipModelName.c_str() );
+		return;
+	}
+
+	// setup the chassis
+	physicsObj.SetSelf( this );
+	physicsObj.SetClipModel( new idClipModel( trm ), 1.0f );
+	physicsObj.SetOrigin( spawnOrigin );
+	physicsObj.SetAxis( spawnAxis );
+	physicsObj.SetBouncyness( 0.0f );
+	physicsObj.SetFriction( 0.0f, 0.0f, 0.0f );
+	physicsObj.SetGravity( gameLocal.GetGravity() );
+	physicsObj.SetContents( CONTENTS_SOLID );
+	physicsObj.SetClipMask( MASK_SOLID | CONTENTS_BODY | CONTENTS_CORPSE | CONTENTS_MOVEABLECLIP );
+	physicsObj.SetContinuousCollision( spawnArgs.GetBool( "continuousCollision", "1" ) );
+	SetPhysics( &physicsObj );
+
+	spawnArgs.GetFloat( "mass", "1200", mass );
+	physicsObj.SetMass( mass );
+
+	spawnArgs.GetFloat( "horsepower", "150", engineHorsepower );
+	physicsObj.SetEngine( engineHorsepower, spawnArgs.GetFloat( "maxVelocity", "1000" ) );
+
+	spawnArgs.GetFloat( "suspensionLength", "16", suspensionLength );
+	spawnArgs.GetFloat( "suspensionStiffness", "150", suspensionStiffness );
+	physicsObj.SetSuspension( suspensionStiffness, spawnArgs.GetFloat( "suspensionDamping", "20" ) );
+	physicsObj.SetTireFriction( spawnArgs.GetFloat( "tireFriction", "1" ) );
+
+	spawnArgs.GetString( "driveWheels", "rear", driveWheels );
+
+	// the wheels sit where the model has them once the springs carry the weight
+	restCompression = Min( gameLocal.GetGravity().Length() / Max( suspensionStiffness, 1.0f ), suspensionLength );
+
+	for ( i = 0; i < 4; i++ )
+	{
+		const char *wheelJointName = spawnArgs.GetString( wheelJointKeys[ i ], "" );
+		if ( !wheelJointName[ 0 ] )
+		{
+			gameLocal.Error( "admVehicleEntity_Car '%s' no '%s' specified", name.c_str(), wheelJointKeys[ i ] );
+		}
+		wheelJoints[ i ] = animator.GetJointHandle( wheelJointName );
+		if ( wheelJoints[ i ] == INVALID_JOINT )
+		{
+			gameLocal.Error( "admVehicleEntity_Car '%s' can't find wheel joint '%s'", name.c_str(), wheelJointName );
+		}
+
+		GetAnimator()->GetJointTransform( wheelJoints[ i ], 0, origin, axis );
+		origin.z += suspensionLength - restCompression;
+
+		bool front = ( i < 2 );
+		bool driven = !driveWheels.Icmp( "all" ) || ( front ? !driveWheels.Icmp( "front" ) : !driveWheels.Icmp( "rear" ) );
+		physicsObj.AddWheel( origin, wheelRadius, suspensionLength, front, driven );
+	}
+
+	// settles on its wheels and goes to rest by itself
+	gameLocal.vehicleSystem.AddVehicle( &physicsObj );
+
+	fl.networkSync = true;
 
+	BecomeActive( TH_THINK );
+}
+
+void admVehicleEntity_Car::Save( idSaveGame *savefile ) const
+{
+	int i;
+
+	savefile->WriteStaticObject( physicsObj );
+	for ( i = 0; i < 4; i++ )
+	{
+		savefile->WriteJoint( wheelJoints[ i ] );
+	}
+	savefile->WriteFloat( engineHorsepower );
+	savefile->WriteBool( isHeldHandbrake );
+	savefile->WriteBool( isHeldClutch );
+}
+
+void admVehicleEntity_Car::Restore( idRestoreGame *savefile )
+{
+	int i;
+
+	savefile->ReadStaticObject( physicsObj );
+	RestorePhysics( &physicsObj );
+	for ( i = 0; i < 4; i++ )
+	{
+		savefile->ReadJoint( wheelJoints[ i ] );
+	}
+	savefile->ReadFloat( engineHorsepower );
+	savefile->ReadBool( isHeldHandbrake );
+	savefile->ReadBool( isHeldClutch );
+
+	gameLocal.vehicleSystem.AddVehicle( &physicsObj );
 }
 
 void admVehicleEntity_Car::Use( idPlayer *player )
-{
+{
+	idAFEntity_Vehicle::Use( player );
 
+	physicsObj.Activate();
 }
 
 void admVehicleEntity_Car::Think()
-{
+{
+	if ( thinkFlags & TH_THINK )
+	{
+		Drive();
+	}
+
+	UpdateAnimation();
+	if ( thinkFlags & TH_UPDATEVISUALS )
+	{
+		Present();
+		LinkCombat();
+	}
+}
+
+void admVehicleEntity_Car::ClientPredictionThink()
+{
+	// the driver's commands come with the snapshots, the local driver replays its own
+	Drive();
 
-}
\ No newline at end of file
+	UpdatePredictionError();
+
+	UpdateAnimation();
+	Present();
+}
+
+void admVehicleEntity_Car::Drive()
+{
+	float throttle = 0.0f, steer = 0.0f;
+	idVec3 origin;
+	idMat3 axis;
+	idRotation rotation;
+
+	// a parked car keeps still until something pushes it or a driver gets in
+	if ( !player && physicsObj.IsAtRest() )
+	{
+		isHeldHandbrake = true;
+		return;
+	}
+
+	if ( player )
+	{
+		// capture the input from a player
+		isHeldHandbrake = player->usercmd.upmove > 0;
+		isHeldClutch = player->usercmd.upmove < 0;
+		if ( !isHeldClutch )
+		{
+			throttle = player->usercmd.forwardmove * ( 1.0f / 127.0f );
+		}
+		steer = GetSteerAngle();
+	}
+	else
+	{
+		isHeldHandbrake = true;
+	}
+
+	physicsObj.SetControls( throttle, steer, isHeldHandbrake );
+
+	// update the steering wheel
+	if ( steeringWheelJoint != INVALID_JOINT )
+	{
+		animator.GetJointTransform( steeringWheelJoint, gameLocal.time, origin, axis );
+		rotation.SetVec( axis[ 2 ] );
+		rotation.SetAngle( -steer );
+		animator.SetJointAxis( steeringWheelJoint, JOINTMOD_WORLD, rotation.ToMat3() );
+	}
+
+	// run the physics
+	RunPhysics();
+
+	UpdateWheelJoints();
+
+	// the interpolated transform changes every frame while the car moves
+	UpdateVisuals();
+}
+
+void admVehicleEntity_Car::UpdateWheelJoints()
+{
+	int i;
+	float compression, angle;
+	idVec3 origin;
+	idRotation wheelRotation, steerRotation;
+
+	for ( i = 0; i < physicsObj.GetNumWheels(); i++ )
+	{
+		const vehicleWheel_t &wheel = physicsObj.GetWheel( i );
+
+		physicsObj.GetWheelRenderState( i, compression, angle );
+
+		// rotate about the wheel axis
+		wheelRotation.SetAngle( RAD2DEG( angle ) );
+		wheelRotation.SetVec( 0, -1, 0 );
+
+		if ( wheel.steered )
+		{
+			// rotate the wheel for steering
+			steerRotation.SetAngle( -steerAngle );
+			steerRotation.SetVec( 0, 0, 1 );
+			animator.SetJointAxis( wheelJoints[ i ], JOINTMOD_WORLD, wheelRotation.ToMat3() * steerRotation.ToMat3() );
+		}
+		else
+		{
+			animator.SetJointAxis( wheelJoints[ i ], JOINTMOD_WORLD, wheelRotation.ToMat3() );
+		}
+
+		// set wheel position for suspension, the model space is the body space of the chassis
+		origin = wheel.hardpoint;
+		origin.z -= wheel.suspensionLength - compression;
+		animator.SetJointPos( wheelJoints[ i ], JOINTMOD_WORLD_OVERRIDE, origin );
+	}
+}
+
+bool admVehicleEntity_Car::GetPhysicsToVisualTransform( idVec3 &origin, idMat3 &axis )
+{
+	idVec3 renderOrigin;
+	idMat3 renderAxis;
+
+	// render between the last two fixed steps
+	physicsObj.GetRenderTransform( renderOrigin, renderAxis );
+	if ( gameLocal.isClient )
+	{
+		renderOrigin += predictionErrorOrigin;
+		renderAxis = renderAxis * predictionErrorAxis;
+	}
+	axis = renderAxis * physicsObj.GetAxis().Transpose();
+	origin = ( renderOrigin - physicsObj.GetOrigin() ) * renderAxis.Transpose();
+	return true;
+}
+
+// A snapshot resets the car to the server state and the frames since
+// then are predicted again. When the replay reaches the last rendered
+// frame, the difference to what was rendered is kept as an error on top
+// of the render transform, which then fades out over the next frames.
+// This way a correction doesn't snap the car into place.
+void admVehicleEntity_Car::UpdatePredictionError()
+{
+	idVec3 origin;
+	idMat3 axis;
+	idQuat q;
+
+	physicsObj.GetRenderTransform( origin, axis );
+
+	if ( snapshotChanged && gameLocal.time == lastRenderTime )
+	{
+		predictionErrorOrigin += lastRenderOrigin - origin;
+		predictionErrorAxis = axis.Transpose() * lastRenderAxis * predictionErrorAxis;
+		snapshotChanged = false;
+	}
+
+	if ( !gameLocal.isNewFrame )
+	{
+		return;
+	}
+
+	snapshotChanged = false;
+	lastRenderTime = gameLocal.time;
+	lastRenderOrigin = origin;
+	lastRenderAxis = axis;
+
+	// teleported or too far off to smooth
+	if ( predictionErrorOrigin.LengthSqr() > Square( 100.0f ) )
+	{
+		predictionErrorOrigin.Zero();
+		predictionErrorAxis.Identity();
+		return;
+	}
+
+	predictionErrorOrigin *= net_clientVehicleSmoothing.GetFloat();
+	predictionErrorAxis = q.Slerp( idQuat( 0.0f, 0.0f, 0.0f, 1.0f ), predictionErrorAxis.ToQuat(), net_clientVehicleSmoothing.GetFloat() ).ToMat3();
+}
+
+void admVehicleEntity_Car::WriteToSnapshot( idBitMsgDelta &msg ) const
+{
+	physicsObj.WriteToSnapshot( msg );
+	msg.WriteBits( player ? gameLocal.GetSpawnId( player ) : -1, 32 );
+	msg.WriteChar( idMath::FtoiFast( steerAngle * 4.0f ) );
+}
+
+void admVehicleEntity_Car::ReadFromSnapshot( const idBitMsgDelta &msg )
+{
+	idEntityPtr<idPlayer> driver;
+	int spawnId;
+
+	physicsObj.ReadFromSnapshot( msg );
+
+	spawnId = msg.ReadBits( 32 );
+	player = ( spawnId != -1 && driver.SetSpawnId( spawnId ) ) ? driver.GetEntity() : NULL;
+	steerAngle = msg.ReadChar() * 0.25f;
+
+	if ( msg.HasChanged() )
+	{
+		snapshotChanged = true;
+		UpdateVisuals();
+	}
+}
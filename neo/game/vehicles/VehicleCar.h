@@ -5,27 +5,83 @@
 
 	admVehicleEntity_Car
 
+	Raycast car, simulated by admPhysics_Vehicle. It only
+	derives from idAFEntity_Vehicle for the driver handling,
+	it doesn't use an articulated figure.
+
+	Clients predict the car with the commands of the driver
+	from the last snapshot on, the same way the player
+	movement is predicted.
+
 ========================================================
 */
 
 #ifndef __GAME_VEHICLECAR_H__
 #define __GAME_VEHICLECAR_H__
 
-class admVehicleEntity_Car : public idAFEntity_VehicleFourWheels
-{
+class admVehicleEntity_Car : public idAFEntity_Vehicle
+{
 public:
 	CLASS_PROTOTYPE( admVehicleEntity_Car );
 
 	admVehicleEntity_Car();
+	~admVehicleEntity_Car();
+
+	void							Spawn( void );
+	void							Save( idSaveGame *savefile ) const;
+	void							Restore( idRestoreGame *savefile );
 
-	virtual void					Spawn( void ) override;
 	virtual void					Use( idPlayer *player );
 	virtual void					Think( void ) override;
+	virtual bool					GetPhysicsToVisualTransform( idVec3 &origin, idMat3 &axis ) override;
+
+	virtual void					ClientPredictionThink( void ) override;
+	virtual void					WriteToSnapshot( idBitMsgDelta &msg ) const override;
+	virtual void					ReadFromSnapshot( const idBitMsgDelta &msg ) override;
 
 protected:
+	admPhysics_Vehicle				physicsObj;
+	jointHandle_t					wheelJoints[ 4 ];
+
 	float							engineHorsepower;
 	bool							isHeldHandbrake;
 	bool							isHeldClutch;
+
+	// client side correction of the prediction, see UpdatePredictionError
+	bool							snapshotChanged;
+	int								lastRenderTime;
+	idVec3							lastRenderOrigin;
+	idMat3							lastRenderAxis;
+	idVec3							predictionErrorOrigin;
+	idMat3							predictionErrorAxis;
+
+	void							Drive( void );
+	void							UpdateWheelJoints( void );
+	void							UpdatePredictionError( void );
 };
 
-#endif /* !_GAME_VEHICLECAR_H */
\ No newline at end of file
+/*
+	.def keyvalues for this vehicle:
+	eyesJoint (default "eyes")
+	steeringWheelJoint (default "steeringwheel")
+
+	wheelJointFrontLeft
+	wheelJointFrontRight
+	wheelJointRearLeft
+	wheelJointRearRight
+
+	clipmodel (default the visual model)
+	mass (default 1200)
+	horsepower (default 150)
+	maxVelocity (default 1000)
+	driveWheels "front", "rear" or "all" (default "rear")
+
+	wheelRadius (default 20)
+	suspensionLength (default 16)
+	suspensionStiffness (default 150)
+	suspensionDamping (default 20)
+	tireFriction (default 1)
+	steerSpeed (default 5)
+*/
+
+#endif /* !_GAME_VEHICLECAR_H */
@@ -0,0 +1,629 @@
+/*
+=========================================================
+
+	Odljev Source Code
+	2019, Admer456
+
+	This code is licenced under GPLv3.
+
+=========================================================
+*/
+
+#include "../idlib/precompiled.h"
+#pragma hdrstop
+
+#include "Game_local.h"
+
+CLASS_DECLARATION( idPhysics_RigidBody, admPhysics_Vehicle )
+END_CLASS
+
+const int	MAX_VEHICLE_STEPS			= 8;				// steps per frame before the simulation drops time
+const int	VEHICLE_REST_TIME			= 500;				// msec without input and motion before the vehicle rests
+const float	VEHICLE_REST_VELOCITY		= 2.0f;
+const float	VEHICLE_REST_ANGULAR		= 0.05f;
+const float	MIN_DRIVE_VELOCITY			= 100.0f;			// limits the engine force when pulling away
+const float	HORSEPOWER_TO_GAME			= 745.7f * 39.37f * 39.37f;	// watts in units of mass * inches^2 / s^3
+const float	TIRE_LATERAL_STIFFNESS		= 0.5f;				// part of the side slip removed in one step
+const float	TIRE_ROLLING_RESISTANCE		= 0.2f;
+const float	HANDBRAKE_LATERAL_GRIP		= 0.3f;
+
+const float	VEHICLE_QUAT_SCALE			= 32767.0f;			// compressed quaternion components as shorts
+const float	VEHICLE_ANGULAR_MAX			= 64.0f;			// radians per second
+const int	VEHICLE_ANGULAR_TOTAL_BITS		= 16;
+const int	VEHICLE_ANGULAR_EXPONENT_BITS	= idMath::BitsForInteger( idMath::BitsForFloat( VEHICLE_ANGULAR_MAX ) ) + 1;
+const int	VEHICLE_ANGULAR_MANTISSA_BITS	= VEHICLE_ANGULAR_TOTAL_BITS - 1 - VEHICLE_ANGULAR_EXPONENT_BITS;
+const int	VEHICLE_STEP_TIME_BITS		= 5;
+
+/*
+================
+admPhysics_Vehicle::admPhysics_Vehicle
+================
+*/
+admPhysics_Vehicle::admPhysics_Vehicle( void )
+{
+	suspensionStiffness = 150.0f;
+	suspensionDamping = 20.0f;
+	tireFriction = 1.0f;
+	enginePower = 0.0f;
+	maxVelocity = 0.0f;
+
+	throttle = 0.0f;
+	steerAngle = 0.0f;
+	handbrake = false;
+
+	stepTime = 0;
+	quietTime = 0;
+	prevOrigin.Zero();
+	prevAxis.Identity();
+
+	// the wheels hold the chassis up, the rigid body only handles the collisions
+	NoContact();
+}
+
+/*
+================
+admPhysics_Vehicle::Save
+================
+*/
+void admPhysics_Vehicle::Save( idSaveGame *savefile ) const
+{
+	int i;
+
+	savefile->WriteInt( wheels.Num() );
+	for ( i = 0; i < wheels.Num(); i++ )
+	{
+		const vehicleWheel_t &wheel = wheels[ i ];
+		savefile->WriteVec3( wheel.hardpoint );
+		savefile->WriteFloat( wheel.radius );
+		savefile->WriteFloat( wheel.suspensionLength );
+		savefile->WriteBool( wheel.steered );
+		savefile->WriteBool( wheel.driven );
+		savefile->WriteBool( wheel.touching );
+		savefile->WriteVec3( wheel.contactPoint );
+		savefile->WriteVec3( wheel.contactNormal );
+		savefile->WriteFloat( wheel.compression );
+		savefile->WriteFloat( wheel.prevCompression );
+		savefile->WriteFloat( wheel.angle );
+		savefile->WriteFloat( wheel.prevAngle );
+		savefile->WriteBool( wheel.grounded );
+	}
+
+	savefile->WriteFloat( suspensionStiffness );
+	savefile->WriteFloat( suspensionDamping );
+	savefile->WriteFloat( tireFriction );
+	savefile->WriteFloat( enginePower );
+	savefile->WriteFloat( maxVelocity );
+
+	savefile->WriteFloat( throttle );
+	savefile->WriteFloat( steerAngle );
+	savefile->WriteBool( handbrake );
+
+	savefile->WriteInt( stepTime );
+	savefile->WriteInt( quietTime );
+	savefile->WriteVec3( prevOrigin );
+	savefile->WriteMat3( prevAxis );
+}
+
+/*
+================
+admPhysics_Vehicle::Restore
+================
+*/
+void admPhysics_Vehicle::Restore( idRestoreGame *savefile )
+{
+	int i, num;
+
+	savefile->ReadInt( num );
+	wheels.SetNum( num );
+	for ( i = 0; i < num; i++ )
+	{
+		vehicleWheel_t &wheel = wheels[ i ];
+		savefile->ReadVec3( wheel.hardpoint );
+		savefile->ReadFloat( wheel.radius );
+		savefile->ReadFloat( wheel.suspensionLength );
+		savefile->ReadBool( wheel.steered );
+		savefile->ReadBool( wheel.driven );
+		savefile->ReadBool( wheel.touching );
+		savefile->ReadVec3( wheel.contactPoint );
+		savefile->ReadVec3( wheel.contactNormal );
+		savefile->ReadFloat( wheel.compression );
+		savefile->ReadFloat( wheel.prevCompression );
+		savefile->ReadFloat( wheel.angle );
+		savefile->ReadFloat( wheel.prevAngle );
+		savefile->ReadBool( wheel.grounded );
+	}
+
+	savefile->ReadFloat( suspensionStiffness );
+	savefile->ReadFloat( suspensionDamping );
+	savefile->ReadFloat( tireFriction );
+	savefile->ReadFloat( enginePower );
+	savefile->ReadFloat( maxVelocity );
+
+	savefile->ReadFloat( throttle );
+	savefile->ReadFloat( steerAngle );
+	savefile->ReadBool( handbrake );
+
+	savefile->ReadInt( stepTime );
+	savefile->ReadInt( quietTime );
+	savefile->ReadVec3( prevOrigin );
+	savefile->ReadMat3( prevAxis );
+}
+
+/*
+================
+admPhysics_Vehicle::AddWheel
+================
+*/
+int admPhysics_Vehicle::AddWheel( const idVec3 &hardpoint, float radius, float suspensionLength, bool steered, bool driven )
+{
+	vehicleWheel_t wheel;
+
+	wheel.hardpoint = hardpoint;
+	wheel.radius = radius;
+	wheel.suspensionLength = suspensionLength;
+	wheel.steered = steered;
+	wheel.driven = driven;
+
+	wheel.touching = false;
+	wheel.contactPoint.Zero();
+	wheel.contactNormal.Zero();
+
+	wheel.compression = 0.0f;
+	wheel.prevCompression = 0.0f;
+	wheel.angle = 0.0f;
+	wheel.prevAngle = 0.0f;
+	wheel.grounded = false;
+
+	return wheels.Append( wheel );
+}
+
+/*
+================
+admPhysics_Vehicle::SetSuspension
+================
+*/
+void admPhysics_Vehicle::SetSuspension( float stiffness, float damping )
+{
+	suspensionStiffness = stiffness;
+	suspensionDamping = damping;
+}
+
+/*
+================
+admPhysics_Vehicle::SetTireFriction
+================
+*/
+void admPhysics_Vehicle::SetTireFriction( float friction )
+{
+	tireFriction = friction;
+}
+
+/*
+================
+admPhysics_Vehicle::SetEngine
+================
+*/
+void admPhysics_Vehicle::SetEngine( float horsepower, float maxVelocity )
+{
+	this->enginePower = horsepower * HORSEPOWER_TO_GAME;
+	this->maxVelocity = maxVelocity;
+}
+
+/*
+================
+admPhysics_Vehicle::SetControls
+================
+*/
+void admPhysics_Vehicle::SetControls( float throttle, float steerAngle, bool handbrake )
+{
+	this->throttle = idMath::ClampFloat( -1.0f, 1.0f, throttle );
+	this->steerAngle = steerAngle;
+	this->handbrake = handbrake;
+
+	if ( this->throttle != 0.0f || this->steerAngle != 0.0f )
+	{
+		Activate();
+	}
+}
+
+/*
+================
+admPhysics_Vehicle::GetWheelRay
+
+  From the top of the suspension down to the bottom of the fully extended tire.
+================
+*/
+void admPhysics_Vehicle::GetWheelRay( int i, idVec3 &start, idVec3 &end ) const
+{
+	const vehicleWheel_t &wheel = wheels[ i ];
+	const idMat3 &axis = GetAxis();
+
+	start = GetOrigin() + wheel.hardpoint * axis;
+	end = start - axis[ 2 ] * ( wheel.suspensionLength + wheel.radius );
+}
+
+/*
+================
+admPhysics_Vehicle::SetWheelContact
+================
+*/
+void admPhysics_Vehicle::SetWheelContact( int i, const trace_t &trace )
+{
+	vehicleWheel_t &wheel = wheels[ i ];
+
+	wheel.touching = ( trace.fraction < 1.0f );
+	if ( wheel.touching )
+	{
+		wheel.contactPoint = trace.c.point;
+		wheel.contactNormal = trace.c.normal;
+	}
+}
+
+/*
+================
+admPhysics_Vehicle::GetInterpolation
+
+  The chassis is simulated up to the last whole step, the time left over
+  places the render transforms between the last two steps.
+================
+*/
+float admPhysics_Vehicle::GetInterpolation( void ) const
+{
+	if ( IsAtRest() )
+	{
+		return 1.0f;
+	}
+	return (float)stepTime / idMath::ClampInt( 1, USERCMD_MSEC, g_vehicleStepMsec.GetInteger() );
+}
+
+/*
+================
+admPhysics_Vehicle::GetRenderTransform
+================
+*/
+void admPhysics_Vehicle::GetRenderTransform( idVec3 &origin, idMat3 &axis ) const
+{
+	idQuat q;
+	float f = GetInterpolation();
+
+	origin = prevOrigin + ( GetOrigin() - prevOrigin ) * f;
+	axis = q.Slerp( prevAxis.ToQuat(), GetAxis().ToQuat(), f ).ToMat3();
+}
+
+/*
+================
+admPhysics_Vehicle::GetWheelRenderState
+================
+*/
+void admPhysics_Vehicle::GetWheelRenderState( int i, float &compression, float &angle ) const
+{
+	const vehicleWheel_t &wheel = wheels[ i ];
+	float f = GetInterpolation();
+
+	compression = wheel.prevCompression + ( wheel.compression - wheel.prevCompression ) * f;
+	angle = wheel.prevAngle + ( wheel.angle - wheel.prevAngle ) * f;
+}
+
+/*
+================
+admPhysics_Vehicle::EvaluateWheels
+
+  Adds the suspension and tire forces for one step. The compression is
+  measured against the contact plane of the last wheel query, moved along
+  with the chassis.
+================
+*/
+void admPhysics_Vehicle::EvaluateWheels( float deltaTime )
+{
+	int i, numDriven;
+	float mass, share, driveForce, forwardSpeed, s, c;
+	idVec3 up, down, start, contact, forward, side;
+	impactInfo_t info;
+
+	const idVec3 origin = GetOrigin();
+	const idMat3 axis = GetAxis();
+
+	up = axis[ 2 ];
+	down = -up;
+	mass = GetMass();
+	share = mass / wheels.Num();
+
+	numDriven = 0;
+	for ( i = 0; i < wheels.Num(); i++ )
+	{
+		if ( wheels[ i ].driven )
+		{
+			numDriven++;
+		}
+	}
+
+	// the engine delivers constant power, limited when pulling away and at top speed
+	driveForce = 0.0f;
+	forwardSpeed = GetLinearVelocity() * axis[ 0 ];
+	if ( throttle != 0.0f && numDriven )
+	{
+		if ( maxVelocity <= 0.0f || forwardSpeed * throttle < maxVelocity )
+		{
+			driveForce = throttle * enginePower / Max( idMath::Fabs( forwardSpeed ), MIN_DRIVE_VELOCITY ) / numDriven;
+		}
+	}
+
+	idMath::SinCos( DEG2RAD( steerAngle ), s, c );
+
+	for ( i = 0; i < wheels.Num(); i++ )
+	{
+		vehicleWheel_t &wheel = wheels[ i ];
+
+		wheel.grounded = false;
+
+		if ( !wheel.touching )
+		{
+			wheel.compression = 0.0f;
+			continue;
+		}
+
+		// distance along the suspension to the contact plane
+		float denom = down * wheel.contactNormal;
+		if ( denom > -0.1f )
+		{
+			wheel.compression = 0.0f;
+			continue;
+		}
+
+		start = origin + wheel.hardpoint * axis;
+		float dist = ( ( wheel.contactPoint - start ) * wheel.contactNormal ) / denom;
+		float length = dist - wheel.radius;
+		if ( length >= wheel.suspensionLength )
+		{
+			wheel.compression = 0.0f;
+			continue;
+		}
+
+		wheel.compression = Min( wheel.suspensionLength - length, wheel.suspensionLength );
+		wheel.grounded = true;
+		contact = start + down * dist;
+
+		// spring and damper
+		float compressionSpeed = ( wheel.compression - wheel.prevCompression ) / deltaTime;
+		float load = share * ( suspensionStiffness * wheel.compression + suspensionDamping * compressionSpeed );
+		if ( load < 0.0f )
+		{
+			load = 0.0f;
+		}
+
+		// tire directions on the contact plane, steering to the right for a positive angle
+		forward = axis[ 0 ];
+		if ( wheel.steered )
+		{
+			forward = axis[ 0 ] * c - axis[ 1 ] * s;
+		}
+		forward -= wheel.contactNormal * ( forward * wheel.contactNormal );
+		forward.Normalize();
+		side = wheel.contactNormal.Cross( forward );
+
+		GetImpactInfo( 0, contact, &info );
+		float forwardVelocity = info.velocity * forward;
+		float sideVelocity = info.velocity * side;
+
+		float lateral = -sideVelocity * share * TIRE_LATERAL_STIFFNESS / deltaTime;
+		float longitudinal;
+
+		if ( handbrake && !wheel.steered )
+		{
+			// locked wheel
+			longitudinal = -forwardVelocity * share / deltaTime;
+			lateral *= HANDBRAKE_LATERAL_GRIP;
+		}
+		else
+		{
+			longitudinal = -forwardVelocity * share * TIRE_ROLLING_RESISTANCE;
+			if ( wheel.driven )
+			{
+				longitudinal += driveForce;
+			}
+			wheel.angle += forwardVelocity * deltaTime / wheel.radius;
+		}
+
+		// friction circle
+		float maxFriction = tireFriction * load;
+		float friction = idMath::Sqrt( lateral * lateral + longitudinal * longitudinal );
+		if ( friction > maxFriction )
+		{
+			float scale = maxFriction / friction;
+			lateral *= scale;
+			longitudinal *= scale;
+		}
+
+		AddForce( 0, contact, up * load + forward * longitudinal + side * lateral );
+	}
+}
+
+/*
+================
+admPhysics_Vehicle::Evaluate
+
+  Runs the whole steps that fit in the frame, the remainder carries over
+  to the next frame.
+================
+*/
+bool admPhysics_Vehicle::Evaluate( int timeStepMSec, int endTimeMSec )
+{
+	int i, j, numSteps, stepMsec;
+	bool moved;
+
+	if ( IsAtRest() || timeStepMSec <= 0 || !wheels.Num() )
+	{
+		stepTime = 0;
+		return idPhysics_RigidBody::Evaluate( timeStepMSec, endTimeMSec );
+	}
+
+	stepMsec = idMath::ClampInt( 1, USERCMD_MSEC, g_vehicleStepMsec.GetInteger() );
+
+	stepTime += timeStepMSec;
+	numSteps = stepTime / stepMsec;
+	if ( numSteps > MAX_VEHICLE_STEPS )
+	{
+		numSteps = MAX_VEHICLE_STEPS;
+		stepTime = numSteps * stepMsec;
+	}
+	stepTime -= numSteps * stepMsec;
+
+	moved = false;
+	for ( i = 0; i < numSteps; i++ )
+	{
+		prevOrigin = GetOrigin();
+		prevAxis = GetAxis();
+		for ( j = 0; j < wheels.Num(); j++ )
+		{
+			wheels[ j ].prevCompression = wheels[ j ].compression;
+			wheels[ j ].prevAngle = wheels[ j ].angle;
+		}
+
+		EvaluateWheels( MS2SEC( stepMsec ) );
+
+		if ( idPhysics_RigidBody::Evaluate( stepMsec, endTimeMSec - stepTime - ( numSteps - 1 - i ) * stepMsec ) )
+		{
+			moved = true;
+		}
+
+		if ( IsAtRest() )
+		{
+			break;
+		}
+	}
+
+	// rest once the vehicle sits still without input
+	if ( throttle == 0.0f && steerAngle == 0.0f &&
+			GetLinearVelocity().LengthSqr() < Square( VEHICLE_REST_VELOCITY ) &&
+			GetAngularVelocity().LengthSqr() < Square( VEHICLE_REST_ANGULAR ) )
+	{
+		quietTime += timeStepMSec;
+		if ( quietTime >= VEHICLE_REST_TIME )
+		{
+			PutToRest();
+		}
+	}
+	else
+	{
+		quietTime = 0;
+	}
+
+	return moved;
+}
+
+/*
+================
+admPhysics_Vehicle::Activate
+================
+*/
+void admPhysics_Vehicle::Activate( void )
+{
+	if ( IsAtRest() )
+	{
+		// start interpolating from where the vehicle rests
+		prevOrigin = GetOrigin();
+		prevAxis = GetAxis();
+		stepTime = 0;
+	}
+	idPhysics_RigidBody::Activate();
+}
+
+/*
+================
+admPhysics_Vehicle::WriteToSnapshot
+
+  The chassis origin goes out in full so the client steps from the same
+  place, the orientation as a compressed quaternion in shorts and the
+  velocities in 16 bits. The wheels only need their spring compression
+  and spin in a byte each, the contacts are queried again on the client.
+================
+*/
+void admPhysics_Vehicle::WriteToSnapshot( idBitMsgDelta &msg ) const
+{
+	int i;
+	idCQuat quat;
+	idVec3 linearVelocity, angularVelocity;
+
+	quat = GetAxis().ToCQuat();
+	linearVelocity = GetLinearVelocity();
+	angularVelocity = GetAngularVelocity();
+
+	msg.WriteBits( IsAtRest(), 1 );
+	msg.WriteFloat( GetOrigin()[0] );
+	msg.WriteFloat( GetOrigin()[1] );
+	msg.WriteFloat( GetOrigin()[2] );
+	msg.WriteShort( idMath::FtoiFast( quat.x * VEHICLE_QUAT_SCALE ) );
+	msg.WriteShort( idMath::FtoiFast( quat.y * VEHICLE_QUAT_SCALE ) );
+	msg.WriteShort( idMath::FtoiFast( quat.z * VEHICLE_QUAT_SCALE ) );
+	msg.WriteFloat( linearVelocity[0], RB_VELOCITY_EXPONENT_BITS, RB_VELOCITY_MANTISSA_BITS );
+	msg.WriteFloat( linearVelocity[1], RB_VELOCITY_EXPONENT_BITS, RB_VELOCITY_MANTISSA_BITS );
+	msg.WriteFloat( linearVelocity[2], RB_VELOCITY_EXPONENT_BITS, RB_VELOCITY_MANTISSA_BITS );
+	msg.WriteFloat( angularVelocity[0], VEHICLE_ANGULAR_EXPONENT_BITS, VEHICLE_ANGULAR_MANTISSA_BITS );
+	msg.WriteFloat( angularVelocity[1], VEHICLE_ANGULAR_EXPONENT_BITS, VEHICLE_ANGULAR_MANTISSA_BITS );
+	msg.WriteFloat( angularVelocity[2], VEHICLE_ANGULAR_EXPONENT_BITS, VEHICLE_ANGULAR_MANTISSA_BITS );
+	msg.WriteBits( stepTime, VEHICLE_STEP_TIME_BITS );
+	msg.WriteShort( quietTime );
+
+	for ( i = 0; i < wheels.Num(); i++ )
+	{
+		const vehicleWheel_t &wheel = wheels[ i ];
+		msg.WriteByte( idMath::ClampInt( 0, 255, idMath::FtoiFast( wheel.compression * 255.0f / wheel.suspensionLength ) ) );
+		msg.WriteAngle8( RAD2DEG( wheel.angle ) );
+	}
+}
+
+/*
+================
+admPhysics_Vehicle::ReadFromSnapshot
+
+  The client predicts on from here, the previous step starts out where
+  the snapshot puts the vehicle.
+================
+*/
+void admPhysics_Vehicle::ReadFromSnapshot( const idBitMsgDelta &msg )
+{
+	int i;
+	bool atRest;
+	idCQuat quat;
+	idVec3 origin, linearVelocity, angularVelocity;
+
+	atRest = msg.ReadBits( 1 ) != 0;
+	origin[0] = msg.ReadFloat();
+	origin[1] = msg.ReadFloat();
+	origin[2] = msg.ReadFloat();
+	quat.x = msg.ReadShort() / VEHICLE_QUAT_SCALE;
+	quat.y = msg.ReadShort() / VEHICLE_QUAT_SCALE;
+	quat.z = msg.ReadShort() / VEHICLE_QUAT_SCALE;
+	linearVelocity[0] = msg.ReadFloat( RB_VELOCITY_EXPONENT_BITS, RB_VELOCITY_MANTISSA_BITS );
+	linearVelocity[1] = msg.ReadFloat( RB_VELOCITY_EXPONENT_BITS, RB_VELOCITY_MANTISSA_BITS );
+	linearVelocity[2] = msg.ReadFloat( RB_VELOCITY_EXPONENT_BITS, RB_VELOCITY_MANTISSA_BITS );
+	angularVelocity[0] = msg.ReadFloat( VEHICLE_ANGULAR_EXPONENT_BITS, VEHICLE_ANGULAR_MANTISSA_BITS );
+	angularVelocity[1] = msg.ReadFloat( VEHICLE_ANGULAR_EXPONENT_BITS, VEHICLE_ANGULAR_MANTISSA_BITS );
+	angularVelocity[2] = msg.ReadFloat( VEHICLE_ANGULAR_EXPONENT_BITS, VEHICLE_ANGULAR_MANTISSA_BITS );
+
+	// setting the state wakes the vehicle up
+	SetOrigin( origin );
+	SetAxis( quat.ToMat3() );
+	SetLinearVelocity( linearVelocity );
+	SetAngularVelocity( angularVelocity );
+
+	stepTime = msg.ReadBits( VEHICLE_STEP_TIME_BITS );
+	quietTime = msg.ReadShort();
+	prevOrigin = GetOrigin();
+	prevAxis = GetAxis();
+
+	for ( i = 0; i < wheels.Num(); i++ )
+	{
+		vehicleWheel_t &wheel = wheels[ i ];
+		wheel.compression = msg.ReadByte() * wheel.suspensionLength / 255.0f;
+		wheel.prevCompression = wheel.compression;
+		wheel.angle = DEG2RAD( msg.ReadAngle8() );
+		wheel.prevAngle = wheel.angle;
+		wheel.grounded = wheel.compression > 0.0f;
+	}
+
+	if ( atRest )
+	{
+		PutToRest();
+	}
+}
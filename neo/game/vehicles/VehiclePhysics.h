@@ -0,0 +1,102 @@
+#pragma once
+
+/*
+===============================================================================
+
+	admPhysics_Vehicle
+
+	Rigid body chassis held up by raycast wheels. The wheel contacts come
+	from admVehicleSystem, which queries the wheels of all the vehicles in
+	one pass before the entities think. The suspension and the tires are
+	then integrated in fixed steps of g_vehicleStepMsec, independent of the
+	game frame rate, and the chassis is moved with the rigid body collision
+	for every step. The contact planes of the query are reused for all the
+	steps of a frame.
+
+	The render transforms are interpolated between the last two steps.
+
+	The snapshots carry a quantized chassis and the spring and spin of the
+	wheels, the clients query the wheel contacts and step the vehicle from
+	there like the server does.
+
+===============================================================================
+*/
+
+typedef struct vehicleWheel_s {
+	idVec3					hardpoint;				// top of the suspension in the body space
+	float					radius;
+	float					suspensionLength;		// spring rest length and maximum travel
+	bool					steered;
+	bool					driven;
+
+	// contact from the last wheel query
+	bool					touching;
+	idVec3					contactPoint;
+	idVec3					contactNormal;
+
+	float					compression;			// how far the spring is compressed
+	float					prevCompression;		// compression at the previous step
+	float					angle;					// spin about the axle in radians
+	float					prevAngle;
+	bool					grounded;				// the tire touched the ground in the last step
+} vehicleWheel_t;
+
+class admPhysics_Vehicle : public idPhysics_RigidBody
+{
+public:
+	CLASS_PROTOTYPE( admPhysics_Vehicle );
+
+							admPhysics_Vehicle( void );
+
+	void					Save( idSaveGame *savefile ) const;
+	void					Restore( idRestoreGame *savefile );
+
+							// initialisation
+	int						AddWheel( const idVec3 &hardpoint, float radius, float suspensionLength, bool steered, bool driven );
+	void					SetSuspension( float stiffness, float damping );
+	void					SetTireFriction( float friction );
+	void					SetEngine( float horsepower, float maxVelocity );
+
+							// throttle in the range [-1, 1], steer angle in degrees
+	void					SetControls( float throttle, float steerAngle, bool handbrake );
+
+	idEntity *				GetSelf( void ) const { return self; }
+	int						GetNumWheels( void ) const { return wheels.Num(); }
+	const vehicleWheel_t &	GetWheel( int i ) const { return wheels[i]; }
+
+							// wheel query, see admVehicleSystem
+	void					GetWheelRay( int i, idVec3 &start, idVec3 &end ) const;
+	void					SetWheelContact( int i, const trace_t &trace );
+
+							// interpolated between the last two steps for rendering
+	void					GetRenderTransform( idVec3 &origin, idMat3 &axis ) const;
+	void					GetWheelRenderState( int i, float &compression, float &angle ) const;
+
+public:	// common physics interface
+	bool					Evaluate( int timeStepMSec, int endTimeMSec );
+	void					Activate( void );
+
+	void					WriteToSnapshot( idBitMsgDelta &msg ) const;
+	void					ReadFromSnapshot( const idBitMsgDelta &msg );
+
+private:
+	idList<vehicleWheel_t>	wheels;
+
+	float					suspensionStiffness;	// spring force per unit of compression and unit of mass
+	float					suspensionDamping;
+	float					tireFriction;
+	float					enginePower;			// in game units
+	float					maxVelocity;
+
+	float					throttle;
+	float					steerAngle;
+	bool					handbrake;
+
+	int						stepTime;				// time not simulated yet, less than one step
+	int						quietTime;				// time spent without input and without moving
+	idVec3					prevOrigin;				// chassis at the previous step
+	idMat3					prevAxis;
+
+	void					EvaluateWheels( float deltaTime );
+	float					GetInterpolation( void ) const;
+};
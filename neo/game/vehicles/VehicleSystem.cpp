@@ -0,0 +1,175 @@
+/*
+=========================================================
+
+	Odljev Source Code
+	2019, Admer456
+
+	This code is licenced under GPLv3.
+
+=========================================================
+*/
+
+#include "../idlib/precompiled.h"
+#pragma hdrstop
+
+#include "Game_local.h"
+
+const int MAX_VEHICLE_CLIP_MODELS	= 64;
+
+/*
+================
+admVehicleSystem::admVehicleSystem
+================
+*/
+admVehicleSystem::admVehicleSystem( void )
+{
+	statsTime = 0;
+	statsFrames = 0;
+	statsQueried = 0;
+	statsMsec = 0.0;
+}
+
+/*
+================
+admVehicleSystem::Clear
+================
+*/
+void admVehicleSystem::Clear( void )
+{
+	vehicles.Clear();
+
+	statsTime = 0;
+	statsFrames = 0;
+	statsQueried = 0;
+	statsMsec = 0.0;
+}
+
+/*
+================
+admVehicleSystem::AddVehicle
+================
+*/
+void admVehicleSystem::AddVehicle( admPhysics_Vehicle *vehicle )
+{
+	vehicles.AddUnique( vehicle );
+}
+
+/*
+================
+admVehicleSystem::RemoveVehicle
+================
+*/
+void admVehicleSystem::RemoveVehicle( admPhysics_Vehicle *vehicle )
+{
+	vehicles.Remove( vehicle );
+}
+
+/*
+================
+admVehicleSystem::RunFrame
+================
+*/
+void admVehicleSystem::RunFrame( void )
+{
+	int i, numQueried;
+	idTimer timer;
+
+	timer.Start();
+
+	numQueried = 0;
+	for ( i = 0; i < vehicles.Num(); i++ )
+	{
+		if ( vehicles[ i ]->IsAtRest() )
+		{
+			continue;
+		}
+		QueryWheels( vehicles[ i ] );
+		numQueried++;
+	}
+
+	timer.Stop();
+
+	if ( !g_vehicleStats.GetBool() )
+	{
+		statsFrames = 0;
+		return;
+	}
+
+	// once a second, the time goes back while a client predicts
+	if ( !statsFrames || gameLocal.time < statsTime )
+	{
+		statsTime = gameLocal.time;
+		statsFrames = 0;
+		statsQueried = 0;
+		statsMsec = 0.0;
+	}
+
+	statsFrames++;
+	statsQueried += numQueried;
+	statsMsec += timer.Milliseconds();
+
+	if ( gameLocal.time - statsTime >= 1000 )
+	{
+		gameLocal.Printf( "vehicles: %.1f awake of %d, wheel query %.3f ms per frame\n",
+			(float)statsQueried / statsFrames, vehicles.Num(), statsMsec / statsFrames );
+		statsFrames = 0;
+	}
+}
+
+/*
+================
+admVehicleSystem::QueryWheels
+================
+*/
+void admVehicleSystem::QueryWheels( admPhysics_Vehicle *vehicle )
+{
+	int i, j, numClipModels;
+	idVec3 start, end;
+	idBounds bounds;
+	trace_t trace, result;
+	idClipModel *clipModels[ MAX_VEHICLE_CLIP_MODELS ];
+	idEntity *self = vehicle->GetSelf();
+
+	// one bounds around all the wheel rays
+	bounds.Clear();
+	for ( i = 0; i < vehicle->GetNumWheels(); i++ )
+	{
+		vehicle->GetWheelRay( i, start, end );
+		bounds.AddPoint( start );
+		bounds.AddPoint( end );
+	}
+
+	numClipModels = gameLocal.clip.ClipModelsTouchingBounds( bounds.Expand( CM_BOX_EPSILON ), MASK_SOLID, clipModels, MAX_VEHICLE_CLIP_MODELS );
+
+	// leave out the vehicle itself and whatever rides on it
+	for ( i = 0; i < numClipModels; i++ )
+	{
+		idEntity *ent = clipModels[ i ]->GetEntity();
+		if ( ent == self || ( ent && ent->GetBindMaster() == self ) || clipModels[ i ]->IsRenderModel() )
+		{
+			clipModels[ i ] = clipModels[ --numClipModels ];
+			i--;
+		}
+	}
+
+	for ( i = 0; i < vehicle->GetNumWheels(); i++ )
+	{
+		vehicle->GetWheelRay( i, start, end );
+
+		gameLocal.clip.TranslationModel( result, start, end, NULL, mat3_identity, MASK_SOLID, 0, vec3_origin, mat3_identity );
+		result.c.entityNum = result.fraction < 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+
+		for ( j = 0; j < numClipModels && result.fraction > 0.0f; j++ )
+		{
+			const idClipModel *touch = clipModels[ j ];
+			gameLocal.clip.TranslationModel( trace, start, end, NULL, mat3_identity, MASK_SOLID, touch->Handle(), touch->GetOrigin(), touch->GetAxis() );
+			if ( trace.fraction < result.fraction )
+			{
+				result = trace;
+				result.c.entityNum = touch->GetEntity()->entityNumber;
+			}
+		}
+
+		vehicle->SetWheelContact( i, result );
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+/*
+===============================================================================
+
+	admVehicleSystem
+
+	Queries the wheel contacts of all the awake vehicles in one pass before
+	the entities think. The clip models around a vehicle are gathered once
+	for all of its wheels, and every wheel ray is tested against that short
+	list instead of going through a full clip world trace per wheel.
+	Resting vehicles are skipped.
+
+===============================================================================
+*/
+
+class admPhysics_Vehicle;
+
+class admVehicleSystem
+{
+public:
+							admVehicleSystem( void );
+
+	void					Clear( void );
+
+	void					AddVehicle( admPhysics_Vehicle *vehicle );
+	void					RemoveVehicle( admPhysics_Vehicle *vehicle );
+
+							// called once per frame before the entities think
+	void					RunFrame( void );
+
+private:
+	idList<admPhysics_Vehicle *> vehicles;
+
+	// g_vehicleStats, summed up over a second
+	int						statsTime;
+	int						statsFrames;
+	int						statsQueried;
+	double					statsMsec;
+
+	void					QueryWheels( admPhysics_Vehicle *vehicle );
+};
@@ -640,6 +640,110 @@ idVec3 idBitMsg::BitsToDir( int bits, int numBits ) {
 
 const int MAX_DATA_BUFFER		= 1024;
 
+// recorded delta writes
+enum {
+	DELTA_OP_END,							// never written, the padding of the last byte reads as the end
+	DELTA_OP_BITS,
+	DELTA_OP_DELTA,
+	DELTA_OP_STRING,
+	DELTA_OP_DATA,
+	DELTA_OP_DICT,
+	DELTA_OP_BYTE_COUNTER,
+	DELTA_OP_SHORT_COUNTER,
+	DELTA_OP_LONG_COUNTER
+};
+
+const int DELTA_OP_NUM_BITS		= 4;
+const int DELTA_OP_SIZE_BITS	= -7;		// number of bits of a recorded value, -31 to 32
+
+/*
+================
+RecordValue
+
+  Values are stored without the overflow check, they are truncated when written anyway.
+================
+*/
+static void RecordValue( idBitMsg *record, int value, int numBits ) {
+	if ( numBits < 0 ) {
+		numBits = -numBits;
+	}
+	if ( numBits != 32 ) {
+		value &= ( 1 << numBits ) - 1;
+	}
+	record->WriteBits( value, numBits );
+}
+
+/*
+================
+idBitMsgDelta::Replay
+================
+*/
+void idBitMsgDelta::Replay( const idBitMsg &record ) {
+	idBitMsg	msg;
+	int			op, numBits, oldValue, newValue, length;
+	char		string[MAX_DATA_BUFFER];
+	byte		data[MAX_DATA_BUFFER];
+	idDict		dict;
+
+	assert( this->record == NULL );
+
+	// read from a copy so the same record can be replayed by several threads
+	msg.Init( record.GetData(), record.GetSize() );
+	msg.SetSize( record.GetSize() );
+	msg.BeginReading();
+
+	while ( msg.GetRemainingReadBits() >= DELTA_OP_NUM_BITS ) {
+		op = msg.ReadBits( DELTA_OP_NUM_BITS );
+		switch( op ) {
+			case DELTA_OP_END:
+				return;
+			case DELTA_OP_BITS:
+				numBits = msg.ReadBits( DELTA_OP_SIZE_BITS );
+				newValue = msg.ReadBits( numBits );
+				WriteBits( newValue, numBits );
+				break;
+			case DELTA_OP_DELTA:
+				numBits = msg.ReadBits( DELTA_OP_SIZE_BITS );
+				oldValue = msg.ReadBits( numBits );
+				newValue = msg.ReadBits( numBits );
+				WriteDelta( oldValue, newValue, numBits );
+				break;
+			case DELTA_OP_STRING:
+				length = msg.ReadLong();
+				msg.ReadString( string, sizeof( string ) );
+				WriteString( string, length );
+				break;
+			case DELTA_OP_DATA:
+				length = msg.ReadLong();
+				msg.ReadData( data, length );
+				WriteData( data, length );
+				break;
+			case DELTA_OP_DICT:
+				msg.ReadDeltaDict( dict, NULL );
+				WriteDict( dict );
+				break;
+			case DELTA_OP_BYTE_COUNTER:
+				oldValue = msg.ReadBits( 8 );
+				newValue = msg.ReadBits( 8 );
+				WriteDeltaByteCounter( oldValue, newValue );
+				break;
+			case DELTA_OP_SHORT_COUNTER:
+				oldValue = msg.ReadBits( 16 );
+				newValue = msg.ReadBits( 16 );
+				WriteDeltaShortCounter( oldValue, newValue );
+				break;
+			case DELTA_OP_LONG_COUNTER:
+				oldValue = msg.ReadBits( 32 );
+				newValue = msg.ReadBits( 32 );
+				WriteDeltaLongCounter( oldValue, newValue );
+				break;
+			default:
+				idLib::common->Error( "idBitMsgDelta::Replay: bad op %d", op );
+				break;
+		}
+	}
+}
+
 /*
 ================
 idBitMsgDelta::WriteBits
@@ -650,7 +754,12 @@ void idBitMsgDelta::WriteBits( int value, int numBits ) {
 		newBase->WriteBits( value, numBits );
 	}
 
-	if ( !base ) {
+	if ( record ) {
+		record->WriteBits( DELTA_OP_BITS, DELTA_OP_NUM_BITS );
+		record->WriteBits( numBits, DELTA_OP_SIZE_BITS );
+		RecordValue( record, value, numBits );
+		changed = true;
+	} else if ( !base ) {
 		writeDelta->WriteBits( value, numBits );
 		changed = true;
 	} else {
@@ -675,7 +784,13 @@ void idBitMsgDelta::WriteDelta( int oldValue, int newValue, int numBits ) {
 		newBase->WriteBits( newValue, numBits );
 	}
 
-	if ( !base ) {
+	if ( record ) {
+		record->WriteBits( DELTA_OP_DELTA, DELTA_OP_NUM_BITS );
+		record->WriteBits( numBits, DELTA_OP_SIZE_BITS );
+		RecordValue( record, oldValue, numBits );
+		RecordValue( record, newValue, numBits );
+		changed = true;
+	} else if ( !base ) {
 		if ( oldValue == newValue ) {
 			writeDelta->WriteBits( 0, 1 );
 		} else {
@@ -772,7 +887,12 @@ void idBitMsgDelta::WriteString( const char *s, int maxLength ) {
 		newBase->WriteString( s, maxLength );
 	}
 
-	if ( !base ) {
+	if ( record ) {
+		record->WriteBits( DELTA_OP_STRING, DELTA_OP_NUM_BITS );
+		record->WriteLong( maxLength );
+		record->WriteString( s, maxLength );
+		changed = true;
+	} else if ( !base ) {
 		writeDelta->WriteString( s, maxLength );
 		changed = true;
 	} else {
@@ -798,7 +918,12 @@ void idBitMsgDelta::WriteData( const void *data, int length ) {
 		newBase->WriteData( data, length );
 	}
 
-	if ( !base ) {
+	if ( record ) {
+		record->WriteBits( DELTA_OP_DATA, DELTA_OP_NUM_BITS );
+		record->WriteLong( length );
+		record->WriteData( data, length );
+		changed = true;
+	} else if ( !base ) {
 		writeDelta->WriteData( data, length );
 		changed = true;
 	} else {
@@ -825,7 +950,11 @@ void idBitMsgDelta::WriteDict( const idDict &dict ) {
 		newBase->WriteDeltaDict( dict, NULL );
 	}
 
-	if ( !base ) {
+	if ( record ) {
+		record->WriteBits( DELTA_OP_DICT, DELTA_OP_NUM_BITS );
+		record->WriteDeltaDict( dict, NULL );
+		changed = true;
+	} else if ( !base ) {
 		writeDelta->WriteDeltaDict( dict, NULL );
 		changed = true;
 	} else {
@@ -845,7 +974,12 @@ void idBitMsgDelta::WriteDeltaByteCounter( int oldValue, int newValue ) {
 		newBase->WriteBits( newValue, 8 );
 	}
 
-	if ( !base ) {
+	if ( record ) {
+		record->WriteBits( DELTA_OP_BYTE_COUNTER, DELTA_OP_NUM_BITS );
+		RecordValue( record, oldValue, 8 );
+		RecordValue( record, newValue, 8 );
+		changed = true;
+	} else if ( !base ) {
 		writeDelta->WriteDeltaByteCounter( oldValue, newValue );
 		changed = true;
 	} else {
@@ -870,7 +1004,12 @@ void idBitMsgDelta::WriteDeltaShortCounter( int oldValue, int newValue ) {
 		newBase->WriteBits( newValue, 16 );
 	}
 
-	if ( !base ) {
+	if ( record ) {
+		record->WriteBits( DELTA_OP_SHORT_COUNTER, DELTA_OP_NUM_BITS );
+		RecordValue( record, oldValue, 16 );
+		RecordValue( record, newValue, 16 );
+		changed = true;
+	} else if ( !base ) {
 		writeDelta->WriteDeltaShortCounter( oldValue, newValue );
 		changed = true;
 	} else {
@@ -895,7 +1034,12 @@ void idBitMsgDelta::WriteDeltaLongCounter( int oldValue, int newValue ) {
 		newBase->WriteBits( newValue, 32 );
 	}
 
-	if ( !base ) {
+	if ( record ) {
+		record->WriteBits( DELTA_OP_LONG_COUNTER, DELTA_OP_NUM_BITS );
+		RecordValue( record, oldValue, 32 );
+		RecordValue( record, newValue, 32 );
+		changed = true;
+	} else if ( !base ) {
 		writeDelta->WriteDeltaLongCounter( oldValue, newValue );
 		changed = true;
 	} else {
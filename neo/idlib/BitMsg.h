@@ -433,6 +433,10 @@ ID_INLINE float idBitMsg::ReadDeltaFloat( float oldValue, int exponentBits, int
 
   idBitMsgDelta
 
+  A delta can also record the writes instead of compressing them against a base.
+  The record is then replayed against any number of bases, which writes exactly
+  the same delta as writing the values directly.
+
 ===============================================================================
 */
 
@@ -443,8 +447,11 @@ public:
 
 	void			Init( const idBitMsg *base, idBitMsg *newBase, idBitMsg *delta );
 	void			Init( const idBitMsg *base, idBitMsg *newBase, const idBitMsg *delta );
+	void			InitRecord( idBitMsg *newBase, idBitMsg *record );	// record the writes instead of writing a delta
 	bool			HasChanged( void ) const;
 
+	void			Replay( const idBitMsg &record );		// write the recorded writes as a delta, the read state of the record is not used
+
 	void			WriteBits( int value, int numBits );
 	void			WriteChar( int c );
 	void			WriteByte( int c );
@@ -500,6 +507,7 @@ private:
 	idBitMsg *		newBase;		// new base
 	idBitMsg *		writeDelta;		// delta from base to new base for writing
 	const idBitMsg *readDelta;		// delta from base to new base for reading
+	idBitMsg *		record;			// recorded writes
 	mutable bool	changed;		// true if the new base is different from the base
 
 private:
@@ -512,6 +520,7 @@ ID_INLINE idBitMsgDelta::idBitMsgDelta() {
 	newBase = NULL;
 	writeDelta = NULL;
 	readDelta = NULL;
+	record = NULL;
 	changed = false;
 }
 
@@ -520,6 +529,7 @@ ID_INLINE void idBitMsgDelta::Init( const idBitMsg *base, idBitMsg *newBase, idB
 	this->newBase = newBase;
 	this->writeDelta = delta;
 	this->readDelta = delta;
+	this->record = NULL;
 	this->changed = false;
 }
 
@@ -528,6 +538,16 @@ ID_INLINE void idBitMsgDelta::Init( const idBitMsg *base, idBitMsg *newBase, con
 	this->newBase = newBase;
 	this->writeDelta = NULL;
 	this->readDelta = delta;
+	this->record = NULL;
+	this->changed = false;
+}
+
+ID_INLINE void idBitMsgDelta::InitRecord( idBitMsg *newBase, idBitMsg *record ) {
+	this->base = NULL;
+	this->newBase = newBase;
+	this->writeDelta = NULL;
+	this->readDelta = NULL;
+	this->record = record;
 	this->changed = false;
 }
 
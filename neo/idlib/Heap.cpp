@@ -29,6 +29,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "../idlib/precompiled.h"
 #pragma hdrstop
 
+#include <mutex>
+
 #ifndef USE_LIBC_MALLOC
 	#define USE_LIBC_MALLOC		0
 #endif
@@ -987,6 +989,7 @@ static idHeap *			mem_heap = NULL;
 static memoryStats_t	mem_total_allocs = { 0, 0x0fffffff, -1, 0 };
 static memoryStats_t	mem_frame_allocs;
 static memoryStats_t	mem_frame_frees;
+static std::mutex		mem_lock;				// parallel jobs allocate as well
 
 /*
 ==================
@@ -1074,6 +1077,7 @@ void *Mem_Alloc( const int size ) {
 #endif
 		return malloc( size );
 	}
+	std::lock_guard<std::mutex> lock( mem_lock );
 	void *mem = mem_heap->Allocate( size );
 	Mem_UpdateAllocStats( mem_heap->Msize( mem ) );
 	return mem;
@@ -1095,6 +1099,7 @@ void Mem_Free( void *ptr ) {
 		free( ptr );
 		return;
 	}
+	std::lock_guard<std::mutex> lock( mem_lock );
 	Mem_UpdateFreeStats( mem_heap->Msize( ptr ) );
  	mem_heap->Free( ptr );
 }
@@ -1114,6 +1119,7 @@ void *Mem_Alloc16( const int size ) {
 #endif
 		return malloc( size );
 	}
+	std::lock_guard<std::mutex> lock( mem_lock );
 	void *mem = mem_heap->Allocate16( size );
 	// make sure the memory is 16 byte aligned
 	assert( ( ((int)mem) & 15) == 0 );
@@ -1138,6 +1144,7 @@ void Mem_Free16( void *ptr ) {
 	}
 	// make sure the memory is 16 byte aligned
 	assert( ( ((int)ptr) & 15) == 0 );
+	std::lock_guard<std::mutex> lock( mem_lock );
  	mem_heap->Free16( ptr );
 }
 
@@ -1576,6 +1583,8 @@ void *Mem_AllocDebugMemory( const int size, const char *fileName, const int line
 		return malloc( size );
 	}
 
+	std::lock_guard<std::mutex> lock( mem_lock );
+
 	if ( align16 ) {
 		p = mem_heap->Allocate16( size + sizeof( debugMemory_t ) );
 	}
@@ -1622,6 +1631,8 @@ void Mem_FreeDebugMemory( void *p, const char *fileName, const int lineNumber, c
 		return;
 	}
 
+	std::lock_guard<std::mutex> lock( mem_lock );
+
 	m = (debugMemory_t *) ( ( (byte *) p ) - sizeof( debugMemory_t ) );
 
 	if ( m->size < 0 ) {
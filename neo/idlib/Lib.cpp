@@ -90,6 +90,9 @@ idLib::ShutDown
 */
 void idLib::ShutDown( void ) {
 
+	// stop the worker threads of the parallel job lists
+	idParallelJobManager::Shutdown();
+
 	// shut down the dictionary string pools
 	idDict::Shutdown();
 
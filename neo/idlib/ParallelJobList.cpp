@@ -0,0 +1,275 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code (?Doom 3 Source Code?).
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+static idCVar jobs_numThreads( "jobs_numThreads", "-1", CVAR_SYSTEM | CVAR_INTEGER | CVAR_ARCHIVE, "number of worker threads for parallel jobs, -1 = one less than the number of cores, 0 = run jobs on the submitting thread" );
+
+static const int MAX_JOB_THREADS = 16;
+
+struct jobListState_s {
+	std::atomic<int>		nextJob;
+	std::atomic<int>		doneJobs;
+	int						numWorkers;		// worker threads holding on to the list, protected by jobQueueMutex
+	std::condition_variable	doneCondition;
+};
+
+/*
+===============================================================================
+
+	Worker threads
+
+===============================================================================
+*/
+
+static std::thread *				jobThreads[MAX_JOB_THREADS];
+static int							numJobThreads = 0;
+static std::atomic<bool>			jobThreadsStarted( false );
+static std::mutex					jobThreadsInitMutex;		// the threads may be started by the first Submit on any thread
+static bool							jobThreadsExit = false;
+static std::mutex					jobQueueMutex;
+static std::condition_variable		jobQueueCondition;
+static idList<idParallelJobList *>	jobQueue;
+
+/*
+================
+idParallelJobManager::JobThread
+================
+*/
+void idParallelJobManager::JobThread( void ) {
+	while ( 1 ) {
+		idParallelJobList *jobList;
+		{
+			std::unique_lock<std::mutex> lock( jobQueueMutex );
+			jobQueueCondition.wait( lock, []{ return jobThreadsExit || jobQueue.Num() > 0; } );
+			if ( jobThreadsExit ) {
+				return;
+			}
+			jobList = jobQueue[0];
+			jobList->state->numWorkers++;
+		}
+
+		while ( jobList->RunNextJob() ) {
+		}
+
+		// the list is taken off the queue once it runs out of jobs to hand out
+		std::lock_guard<std::mutex> lock( jobQueueMutex );
+		jobQueue.Remove( jobList );
+		if ( --jobList->state->numWorkers == 0 ) {
+			jobList->state->doneCondition.notify_all();
+		}
+	}
+}
+
+/*
+================
+idParallelJobManager::Init
+================
+*/
+void idParallelJobManager::Init( int numThreads ) {
+	std::lock_guard<std::mutex> initLock( jobThreadsInitMutex );
+
+	if ( jobThreadsStarted ) {
+		return;
+	}
+
+	if ( numThreads < 0 ) {
+		numThreads = (int)std::thread::hardware_concurrency() - 1;
+	}
+	numJobThreads = idMath::ClampInt( 0, MAX_JOB_THREADS, numThreads );
+
+	jobThreadsExit = false;
+	for ( int i = 0; i < numJobThreads; i++ ) {
+		jobThreads[i] = new std::thread( JobThread );
+	}
+
+	// set last so GetNumThreads never sees a partially started pool
+	jobThreadsStarted = true;
+}
+
+/*
+================
+idParallelJobManager::Shutdown
+================
+*/
+void idParallelJobManager::Shutdown( void ) {
+	std::lock_guard<std::mutex> initLock( jobThreadsInitMutex );
+
+	if ( !jobThreadsStarted ) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( jobQueueMutex );
+		jobThreadsExit = true;
+	}
+	jobQueueCondition.notify_all();
+
+	for ( int i = 0; i < numJobThreads; i++ ) {
+		jobThreads[i]->join();
+		delete jobThreads[i];
+		jobThreads[i] = NULL;
+	}
+	numJobThreads = 0;
+	jobQueue.Clear();
+	jobThreadsStarted = false;
+}
+
+/*
+================
+idParallelJobManager::GetNumThreads
+================
+*/
+int idParallelJobManager::GetNumThreads( void ) {
+	if ( !jobThreadsStarted ) {
+		Init( jobs_numThreads.GetInteger() );
+	}
+	return numJobThreads;
+}
+
+/*
+===============================================================================
+
+	idParallelJobList
+
+===============================================================================
+*/
+
+/*
+================
+idParallelJobList::idParallelJobList
+================
+*/
+idParallelJobList::idParallelJobList( const char *name ) {
+	this->name = name;
+	submitted = false;
+	state = new jobListState_s;
+	state->nextJob = 0;
+	state->doneJobs = 0;
+	state->numWorkers = 0;
+}
+
+/*
+================
+idParallelJobList::~idParallelJobList
+================
+*/
+idParallelJobList::~idParallelJobList( void ) {
+	if ( submitted ) {
+		Wait();
+	}
+	delete state;
+}
+
+/*
+================
+idParallelJobList::AddJob
+================
+*/
+void idParallelJobList::AddJob( jobRun_t function, void *data ) {
+	assert( !submitted );
+	job_t &job = jobs.Alloc();
+	job.function = function;
+	job.data = data;
+}
+
+/*
+================
+idParallelJobList::Submit
+================
+*/
+void idParallelJobList::Submit( bool background ) {
+	assert( !submitted );
+	submitted = true;
+	state->nextJob = 0;
+	state->doneJobs = 0;
+
+	if ( jobs.Num() == 0 || ( jobs.Num() == 1 && !background ) || idParallelJobManager::GetNumThreads() == 0 ) {
+		// not worth waking up the workers, Wait runs everything
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( jobQueueMutex );
+		jobQueue.Append( this );
+	}
+	jobQueueCondition.notify_all();
+}
+
+/*
+================
+idParallelJobList::Wait
+================
+*/
+void idParallelJobList::Wait( void ) {
+	if ( !submitted ) {
+		return;
+	}
+
+	// help out instead of sitting idle
+	while ( RunNextJob() ) {
+	}
+
+	// wait for the jobs still running and for every worker to let go of the list
+	{
+		std::unique_lock<std::mutex> lock( jobQueueMutex );
+		jobQueue.Remove( this );
+		state->doneCondition.wait( lock, [this]{ return state->doneJobs.load() == jobs.Num() && state->numWorkers == 0; } );
+	}
+
+	jobs.SetNum( 0, false );
+	submitted = false;
+}
+
+/*
+================
+idParallelJobList::RunNextJob
+
+Returns false if all jobs have been started.
+================
+*/
+bool idParallelJobList::RunNextJob( void ) {
+	const int jobNum = state->nextJob++;
+	if ( jobNum >= jobs.Num() ) {
+		return false;
+	}
+
+	jobs[jobNum].function( jobs[jobNum].data );
+
+	if ( ++state->doneJobs == jobs.Num() ) {
+		std::lock_guard<std::mutex> lock( jobQueueMutex );
+		state->doneCondition.notify_all();
+	}
+	return true;
+}
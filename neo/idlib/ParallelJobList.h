@@ -0,0 +1,94 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code (?Doom 3 Source Code?).
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __PARALLELJOBLIST_H__
+#define __PARALLELJOBLIST_H__
+
+/*
+===============================================================================
+
+	Parallel job lists.
+
+	Jobs are added on the owning thread, Submit hands them to the worker
+	threads and Wait runs whatever is left on the calling thread and blocks
+	until all jobs are done. Jobs run concurrently with each other so they
+	must not print or touch any shared state that is not owned by the job.
+	The heap and the idVecX / idMatX temporaries may be used, but heap
+	allocations take a lock and are best kept out of the inner loops.
+
+	Each module (engine, game) has its own set of worker threads.
+
+===============================================================================
+*/
+
+typedef void ( *jobRun_t )( void * );
+
+struct jobListState_s;
+
+class idParallelJobList {
+public:
+					idParallelJobList( const char *name );
+					~idParallelJobList( void );
+
+	void			AddJob( jobRun_t function, void *data );
+					// a single job normally runs in Wait, background lists hand it to a worker as well
+	void			Submit( bool background = false );
+	void			Wait( void );
+
+	bool			IsSubmitted( void ) const { return submitted; }
+	int				NumJobs( void ) const { return jobs.Num(); }
+	const char *	GetName( void ) const { return name; }
+
+private:
+	friend class idParallelJobManager;
+
+	typedef struct {
+		jobRun_t	function;
+		void *		data;
+	} job_t;
+
+	const char *	name;
+	idList<job_t>	jobs;
+	bool			submitted;
+	jobListState_s *state;
+
+	bool			RunNextJob( void );
+};
+
+class idParallelJobManager {
+public:
+					// starts the worker threads, numThreads < 0 uses one thread less than the number of cores
+	static void		Init( int numThreads );
+	static void		Shutdown( void );
+	static int		GetNumThreads( void );
+
+private:
+	static void		JobThread( void );
+};
+
+#endif /* !__PARALLELJOBLIST_H__ */
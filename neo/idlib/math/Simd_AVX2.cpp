@@ -0,0 +1,1090 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code (?Doom 3 Source Code?).
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "../precompiled.h"
+#pragma hdrstop
+
+#include "Simd_Generic.h"
+#include "Simd_MMX.h"
+#include "Simd_SSE.h"
+#include "Simd_SSE2.h"
+#include "Simd_SSE3.h"
+#include "Simd_AVX2.h"
+
+
+//===============================================================
+//
+//	AVX2 & FMA implementation of idSIMDProcessor
+//
+//===============================================================
+
+#ifdef ID_SIMD_AVX2
+
+#include <immintrin.h>
+#include <float.h>
+
+// gcc and clang only allow the intrinsics in functions compiled for the instruction set,
+// the rest of the engine keeps being compiled for the baseline CPU
+#ifdef _MSC_VER
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET					__attribute__((target("avx,avx2,fma")))
+#endif
+
+#define DRAWVERT_FLOATS				( sizeof( idDrawVert ) / sizeof( float ) )
+#define DRAWVERT_XYZ_OFFSET			0
+#define DRAWVERT_ST_OFFSET			3
+
+/*
+============
+HorizontalSum
+============
+*/
+static ID_INLINE AVX2_TARGET float HorizontalSum( const __m256 v ) {
+	__m128 s = _mm_add_ps( _mm256_castps256_ps128( v ), _mm256_extractf128_ps( v, 1 ) );
+	s = _mm_add_ps( s, _mm_movehl_ps( s, s ) );
+	s = _mm_add_ss( s, _mm_shuffle_ps( s, s, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	return _mm_cvtss_f32( s );
+}
+
+/*
+============
+Combine
+============
+*/
+static ID_INLINE AVX2_TARGET __m256 Combine( const __m128 lo, const __m128 hi ) {
+	return _mm256_insertf128_ps( _mm256_castps128_ps256( lo ), hi, 1 );
+}
+
+/*
+============
+RSqrtNonZero
+
+  one Newton-Raphson step like idMath::RSqrt, zero length vectors get a zero scale
+============
+*/
+static ID_INLINE AVX2_TARGET __m256 RSqrtNonZero( const __m256 x ) {
+	const __m256 half = _mm256_set1_ps( 0.5f );
+	const __m256 threeHalves = _mm256_set1_ps( 1.5f );
+	__m256 r = _mm256_rsqrt_ps( x );
+	r = _mm256_mul_ps( r, _mm256_fnmadd_ps( _mm256_mul_ps( half, x ), _mm256_mul_ps( r, r ), threeHalves ) );
+	return _mm256_andnot_ps( _mm256_cmp_ps( x, _mm256_set1_ps( FLT_MIN ), _CMP_LT_OQ ), r );
+}
+
+/*
+============
+Transpose4x4
+
+  transposes the 4x4 matrices in both 128 bit lanes like _MM_TRANSPOSE4_PS
+============
+*/
+static ID_INLINE AVX2_TARGET void Transpose4x4( __m256 &r0, __m256 &r1, __m256 &r2, __m256 &r3 ) {
+	const __m256 t0 = _mm256_unpacklo_ps( r0, r1 );
+	const __m256 t1 = _mm256_unpacklo_ps( r2, r3 );
+	const __m256 t2 = _mm256_unpackhi_ps( r0, r1 );
+	const __m256 t3 = _mm256_unpackhi_ps( r2, r3 );
+	r0 = _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	r1 = _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	r2 = _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	r3 = _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+}
+
+/*
+============
+Load4x8
+
+  Loads four floats from eight addresses into one register per component.
+  The k-th address goes to lane k and the (k+4)-th address to lane k+4 after the
+  transpose, so the registers end up in address order. Unaligned loads and
+  shuffles are used instead of gathers which are slow on many CPUs.
+============
+*/
+static ID_INLINE AVX2_TARGET void Load4x8( const float * const p[8], __m256 r[4] ) {
+	for ( int k = 0; k < 4; k++ ) {
+		r[k] = Combine( _mm_loadu_ps( p[k] ), _mm_loadu_ps( p[k+4] ) );
+	}
+	Transpose4x4( r[0], r[1], r[2], r[3] );
+}
+
+/*
+============
+Store4x8
+
+  inverse of Load4x8, the registers are clobbered
+============
+*/
+static ID_INLINE AVX2_TARGET void Store4x8( float * const p[8], __m256 r[4] ) {
+	Transpose4x4( r[0], r[1], r[2], r[3] );
+	for ( int k = 0; k < 4; k++ ) {
+		_mm_storeu_ps( p[k], _mm256_castps256_ps128( r[k] ) );
+		_mm_storeu_ps( p[k+4], _mm256_extractf128_ps( r[k], 1 ) );
+	}
+}
+
+/*
+============
+LoadStrided4x8
+============
+*/
+static ID_INLINE AVX2_TARGET void LoadStrided4x8( const float *base, const int stride, __m256 r[4] ) {
+	const float *p[8];
+
+	for ( int k = 0; k < 8; k++ ) {
+		p[k] = base + k * stride;
+	}
+	Load4x8( p, r );
+}
+
+/*
+============
+LoadJointQuats
+
+  The translation is loaded together with q.w so all the loads stay inside the joint.
+============
+*/
+static ID_INLINE AVX2_TARGET void LoadJointQuats( const idJointQuat * const joints[8], __m256 q[4], __m256 t[3] ) {
+	const float *p[8];
+	__m256 r[4];
+
+	for ( int k = 0; k < 8; k++ ) {
+		p[k] = joints[k]->q.ToFloatPtr();
+	}
+	Load4x8( p, q );
+	for ( int k = 0; k < 8; k++ ) {
+		p[k] += 3;
+	}
+	Load4x8( p, r );
+	t[0] = r[1];
+	t[1] = r[2];
+	t[2] = r[3];
+}
+
+/*
+============
+StoreJointQuats
+============
+*/
+static ID_INLINE AVX2_TARGET void StoreJointQuats( idJointQuat * const joints[8], __m256 q[4], const __m256 t[3] ) {
+	float *p[8];
+	__m256 r[4];
+
+	r[0] = q[3];
+	r[1] = t[0];
+	r[2] = t[1];
+	r[3] = t[2];
+	for ( int k = 0; k < 8; k++ ) {
+		p[k] = joints[k]->q.ToFloatPtr() + 3;
+	}
+	Store4x8( p, r );
+	for ( int k = 0; k < 8; k++ ) {
+		p[k] -= 3;
+	}
+	Store4x8( p, q );
+}
+
+/*
+============
+idSIMD_AVX2::GetName
+============
+*/
+const char * idSIMD_AVX2::GetName( void ) const {
+	return "MMX & SSE & SSE2 & SSE3 & AVX2 & FMA";
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant * src[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Dot( float *dst, const idVec3 &constant, const idVec3 *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant.x );
+	const __m256 cy = _mm256_set1_ps( constant.y );
+	const __m256 cz = _mm256_set1_ps( constant.z );
+	__m256 v[4];
+	int i;
+
+	// each load reads one float of the next vector so the last vector is done separately
+	for ( i = 0; i + 8 < count; i += 8 ) {
+		LoadStrided4x8( src[i].ToFloatPtr(), 3, v );
+		_mm256_storeu_ps( dst + i, _mm256_fmadd_ps( cx, v[0], _mm256_fmadd_ps( cy, v[1], _mm256_mul_ps( cz, v[2] ) ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant * src[i].Normal() + src[i][3];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Dot( float *dst, const idVec3 &constant, const idPlane *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant.x );
+	const __m256 cy = _mm256_set1_ps( constant.y );
+	const __m256 cz = _mm256_set1_ps( constant.z );
+	__m256 v[4];
+	int i;
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		LoadStrided4x8( src[i].ToFloatPtr(), 4, v );
+		_mm256_storeu_ps( dst + i, _mm256_fmadd_ps( cx, v[0], _mm256_fmadd_ps( cy, v[1], _mm256_fmadd_ps( cz, v[2], v[3] ) ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i].Normal() + src[i][3];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant * src[i].xyz;
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Dot( float *dst, const idVec3 &constant, const idDrawVert *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant.x );
+	const __m256 cy = _mm256_set1_ps( constant.y );
+	const __m256 cz = _mm256_set1_ps( constant.z );
+	__m256 v[4];
+	int i;
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		LoadStrided4x8( src[i].xyz.ToFloatPtr(), DRAWVERT_FLOATS, v );
+		_mm256_storeu_ps( dst + i, _mm256_fmadd_ps( cx, v[0], _mm256_fmadd_ps( cy, v[1], _mm256_mul_ps( cz, v[2] ) ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i].xyz;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant.Normal() * src[i] + constant[3];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Dot( float *dst, const idPlane &constant, const idVec3 *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant[0] );
+	const __m256 cy = _mm256_set1_ps( constant[1] );
+	const __m256 cz = _mm256_set1_ps( constant[2] );
+	const __m256 cd = _mm256_set1_ps( constant[3] );
+	__m256 v[4];
+	int i;
+
+	// each load reads one float of the next vector so the last vector is done separately
+	for ( i = 0; i + 8 < count; i += 8 ) {
+		LoadStrided4x8( src[i].ToFloatPtr(), 3, v );
+		_mm256_storeu_ps( dst + i, _mm256_fmadd_ps( cx, v[0], _mm256_fmadd_ps( cy, v[1], _mm256_fmadd_ps( cz, v[2], cd ) ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i] + constant[3];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant.Normal() * src[i].Normal() + constant[3] * src[i][3];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Dot( float *dst, const idPlane &constant, const idPlane *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant[0] );
+	const __m256 cy = _mm256_set1_ps( constant[1] );
+	const __m256 cz = _mm256_set1_ps( constant[2] );
+	const __m256 cd = _mm256_set1_ps( constant[3] );
+	__m256 v[4];
+	int i;
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		LoadStrided4x8( src[i].ToFloatPtr(), 4, v );
+		_mm256_storeu_ps( dst + i, _mm256_fmadd_ps( cx, v[0], _mm256_fmadd_ps( cy, v[1], _mm256_fmadd_ps( cz, v[2], _mm256_mul_ps( cd, v[3] ) ) ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i].Normal() + constant[3] * src[i][3];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant.Normal() * src[i].xyz + constant[3];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Dot( float *dst, const idPlane &constant, const idDrawVert *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant[0] );
+	const __m256 cy = _mm256_set1_ps( constant[1] );
+	const __m256 cz = _mm256_set1_ps( constant[2] );
+	const __m256 cd = _mm256_set1_ps( constant[3] );
+	__m256 v[4];
+	int i;
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		LoadStrided4x8( src[i].xyz.ToFloatPtr(), DRAWVERT_FLOATS, v );
+		_mm256_storeu_ps( dst + i, _mm256_fmadd_ps( cx, v[0], _mm256_fmadd_ps( cy, v[1], _mm256_fmadd_ps( cz, v[2], cd ) ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i].xyz + constant[3];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = src0[i] * src1[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Dot( float *dst, const idVec3 *src0, const idVec3 *src1, const int count ) {
+	__m256 v0[4], v1[4];
+	int i;
+
+	// each load reads one float of the next vector so the last vector is done separately
+	for ( i = 0; i + 8 < count; i += 8 ) {
+		LoadStrided4x8( src0[i].ToFloatPtr(), 3, v0 );
+		LoadStrided4x8( src1[i].ToFloatPtr(), 3, v1 );
+		_mm256_storeu_ps( dst + i, _mm256_fmadd_ps( v0[0], v1[0], _mm256_fmadd_ps( v0[1], v1[1], _mm256_mul_ps( v0[2], v1[2] ) ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] * src1[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dot = src1[0] * src2[0] + src1[1] * src2[1] + src1[2] * src2[2] + ...
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Dot( float &dot, const float *src1, const float *src2, const int count ) {
+	__m256 sum0 = _mm256_setzero_ps();
+	__m256 sum1 = _mm256_setzero_ps();
+	int i;
+
+	for ( i = 0; i + 16 <= count; i += 16 ) {
+		sum0 = _mm256_fmadd_ps( _mm256_loadu_ps( src1 + i + 0 ), _mm256_loadu_ps( src2 + i + 0 ), sum0 );
+		sum1 = _mm256_fmadd_ps( _mm256_loadu_ps( src1 + i + 8 ), _mm256_loadu_ps( src2 + i + 8 ), sum1 );
+	}
+	if ( i + 8 <= count ) {
+		sum0 = _mm256_fmadd_ps( _mm256_loadu_ps( src1 + i ), _mm256_loadu_ps( src2 + i ), sum0 );
+		i += 8;
+	}
+	float s = HorizontalSum( _mm256_add_ps( sum0, sum1 ) );
+	for ( ; i < count; i++ ) {
+		s += src1[i] * src2[i];
+	}
+	dot = s;
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MinMax( float &min, float &max, const float *src, const int count ) {
+	__m256 vmin = _mm256_set1_ps( idMath::INFINITY );
+	__m256 vmax = _mm256_set1_ps( -idMath::INFINITY );
+	int i;
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		const __m256 v = _mm256_loadu_ps( src + i );
+		vmin = _mm256_min_ps( vmin, v );
+		vmax = _mm256_max_ps( vmax, v );
+	}
+
+	__m128 mn = _mm_min_ps( _mm256_castps256_ps128( vmin ), _mm256_extractf128_ps( vmin, 1 ) );
+	__m128 mx = _mm_max_ps( _mm256_castps256_ps128( vmax ), _mm256_extractf128_ps( vmax, 1 ) );
+	mn = _mm_min_ps( mn, _mm_movehl_ps( mn, mn ) );
+	mx = _mm_max_ps( mx, _mm_movehl_ps( mx, mx ) );
+	mn = _mm_min_ss( mn, _mm_shuffle_ps( mn, mn, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	mx = _mm_max_ss( mx, _mm_shuffle_ps( mx, mx, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	for ( ; i < count; i++ ) {
+		const __m128 v = _mm_load_ss( src + i );
+		mn = _mm_min_ss( mn, v );
+		mx = _mm_max_ss( mx, v );
+	}
+	min = _mm_cvtss_f32( mn );
+	max = _mm_cvtss_f32( mx );
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MinMax( idVec2 &min, idVec2 &max, const idVec2 *src, const int count ) {
+	__m256 vmin = _mm256_set1_ps( idMath::INFINITY );
+	__m256 vmax = _mm256_set1_ps( -idMath::INFINITY );
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		const __m256 v = _mm256_loadu_ps( src[i].ToFloatPtr() );
+		vmin = _mm256_min_ps( vmin, v );
+		vmax = _mm256_max_ps( vmax, v );
+	}
+
+	__m128 mn = _mm_min_ps( _mm256_castps256_ps128( vmin ), _mm256_extractf128_ps( vmin, 1 ) );
+	__m128 mx = _mm_max_ps( _mm256_castps256_ps128( vmax ), _mm256_extractf128_ps( vmax, 1 ) );
+	mn = _mm_min_ps( mn, _mm_movehl_ps( mn, mn ) );
+	mx = _mm_max_ps( mx, _mm_movehl_ps( mx, mx ) );
+	for ( ; i < count; i++ ) {
+		const __m128 v = _mm_setr_ps( src[i].x, src[i].y, src[i].y, src[i].y );
+		mn = _mm_min_ps( mn, v );
+		mx = _mm_max_ps( mx, v );
+	}
+	min.x = _mm_cvtss_f32( mn );
+	min.y = _mm_cvtss_f32( _mm_shuffle_ps( mn, mn, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	max.x = _mm_cvtss_f32( mx );
+	max.y = _mm_cvtss_f32( _mm_shuffle_ps( mx, mx, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+}
+
+/*
+============
+StoreMinMax3
+============
+*/
+static ID_INLINE AVX2_TARGET void StoreMinMax3( idVec3 &min, idVec3 &max, const __m128 mn, const __m128 mx ) {
+	ALIGN16( float t[4] );
+
+	_mm_store_ps( t, mn );
+	min.Set( t[0], t[1], t[2] );
+	_mm_store_ps( t, mx );
+	max.Set( t[0], t[1], t[2] );
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idVec3 *src, const int count ) {
+	__m128 mn = _mm_set1_ps( idMath::INFINITY );
+	__m128 mx = _mm_set1_ps( -idMath::INFINITY );
+
+	if ( count > 0 ) {
+		// the unaligned loads read one float past each vector so the last one is loaded separately
+		for ( int i = 0; i < count - 1; i++ ) {
+			const __m128 v = _mm_loadu_ps( src[i].ToFloatPtr() );
+			mn = _mm_min_ps( mn, v );
+			mx = _mm_max_ps( mx, v );
+		}
+		const idVec3 &last = src[count - 1];
+		const __m128 v = _mm_setr_ps( last.x, last.y, last.z, last.z );
+		mn = _mm_min_ps( mn, v );
+		mx = _mm_max_ps( mx, v );
+	}
+	StoreMinMax3( min, max, mn, mx );
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const int count ) {
+	__m128 mn0 = _mm_set1_ps( idMath::INFINITY );
+	__m128 mx0 = _mm_set1_ps( -idMath::INFINITY );
+	__m128 mn1 = mn0;
+	__m128 mx1 = mx0;
+	int i;
+
+	// the unaligned loads also pick up st[0] which is ignored
+	for ( i = 0; i + 2 <= count; i += 2 ) {
+		const __m128 v0 = _mm_loadu_ps( src[i+0].xyz.ToFloatPtr() );
+		const __m128 v1 = _mm_loadu_ps( src[i+1].xyz.ToFloatPtr() );
+		mn0 = _mm_min_ps( mn0, v0 );
+		mx0 = _mm_max_ps( mx0, v0 );
+		mn1 = _mm_min_ps( mn1, v1 );
+		mx1 = _mm_max_ps( mx1, v1 );
+	}
+	if ( i < count ) {
+		const __m128 v = _mm_loadu_ps( src[i].xyz.ToFloatPtr() );
+		mn0 = _mm_min_ps( mn0, v );
+		mx0 = _mm_max_ps( mx0, v );
+	}
+	StoreMinMax3( min, max, _mm_min_ps( mn0, mn1 ), _mm_max_ps( mx0, mx1 ) );
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const int *indexes, const int count ) {
+	__m128 mn0 = _mm_set1_ps( idMath::INFINITY );
+	__m128 mx0 = _mm_set1_ps( -idMath::INFINITY );
+	__m128 mn1 = mn0;
+	__m128 mx1 = mx0;
+	int i;
+
+	for ( i = 0; i + 2 <= count; i += 2 ) {
+		const __m128 v0 = _mm_loadu_ps( src[indexes[i+0]].xyz.ToFloatPtr() );
+		const __m128 v1 = _mm_loadu_ps( src[indexes[i+1]].xyz.ToFloatPtr() );
+		mn0 = _mm_min_ps( mn0, v0 );
+		mx0 = _mm_max_ps( mx0, v0 );
+		mn1 = _mm_min_ps( mn1, v1 );
+		mx1 = _mm_max_ps( mx1, v1 );
+	}
+	if ( i < count ) {
+		const __m128 v = _mm_loadu_ps( src[indexes[i]].xyz.ToFloatPtr() );
+		mn0 = _mm_min_ps( mn0, v );
+		mx0 = _mm_max_ps( mx0, v );
+	}
+	StoreMinMax3( min, max, _mm_min_ps( mn0, mn1 ), _mm_max_ps( mx0, mx1 ) );
+}
+
+/*
+============
+idSIMD_AVX2::Dequantize
+
+  dst[i] = bias[i] + scale[i] * src[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Dequantize( float *dst, const short *src, const float *scale, const float *bias, const int count ) {
+	int i;
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		const __m256i s = _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i *)( src + i ) ) );
+		const __m256 v = _mm256_fmadd_ps( _mm256_cvtepi32_ps( s ), _mm256_loadu_ps( scale + i ), _mm256_loadu_ps( bias + i ) );
+		_mm256_storeu_ps( dst + i, v );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = bias[i] + scale[i] * src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::BlendJoints
+
+  Slerps eight joints at a time with the same polynomial approximations idQuat::Slerp uses.
+  The rotation between the quaternions is at most 90 degrees after the sign flip so the
+  atan and sin approximations need no range reduction.
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::BlendJoints( idJointQuat *joints, const idJointQuat *blendJoints, const float lerp, const int *index, const int numJoints ) {
+	int i;
+
+	if ( lerp <= 0.0f ) {
+		return;
+	}
+	if ( lerp >= 1.0f ) {
+		for ( i = 0; i < numJoints; i++ ) {
+			joints[index[i]] = blendJoints[index[i]];
+		}
+		return;
+	}
+
+	const __m256 one = _mm256_set1_ps( 1.0f );
+	const __m256 signBit = _mm256_set1_ps( -0.0f );
+	const __m256 t = _mm256_set1_ps( lerp );
+	const __m256 invT = _mm256_set1_ps( 1.0f - lerp );
+	const __m256 halfPi = _mm256_set1_ps( idMath::HALF_PI );
+	__m256 from[4], to[4], fromT[3], toT[3], result[4];
+	idJointQuat *fromJoints[8];
+	const idJointQuat *toJoints[8];
+
+	for ( i = 0; i + 8 <= numJoints; i += 8 ) {
+		for ( int k = 0; k < 8; k++ ) {
+			fromJoints[k] = &joints[index[i+k]];
+			toJoints[k] = &blendJoints[index[i+k]];
+		}
+		LoadJointQuats( fromJoints, from, fromT );
+		LoadJointQuats( toJoints, to, toT );
+
+		__m256 equal = _mm256_cmp_ps( from[0], to[0], _CMP_EQ_OQ );
+		equal = _mm256_and_ps( equal, _mm256_cmp_ps( from[1], to[1], _CMP_EQ_OQ ) );
+		equal = _mm256_and_ps( equal, _mm256_cmp_ps( from[2], to[2], _CMP_EQ_OQ ) );
+		equal = _mm256_and_ps( equal, _mm256_cmp_ps( from[3], to[3], _CMP_EQ_OQ ) );
+
+		__m256 cosom = _mm256_mul_ps( from[3], to[3] );
+		cosom = _mm256_fmadd_ps( from[2], to[2], cosom );
+		cosom = _mm256_fmadd_ps( from[1], to[1], cosom );
+		cosom = _mm256_fmadd_ps( from[0], to[0], cosom );
+
+		// take the shortest path
+		const __m256 sign = _mm256_and_ps( cosom, signBit );
+		cosom = _mm256_xor_ps( cosom, sign );
+
+		__m256 scale0 = _mm256_fnmadd_ps( cosom, cosom, one );
+		const __m256 sinom = _mm256_div_ps( one, _mm256_sqrt_ps( scale0 ) );
+
+		// omega = idMath::ATan16( scale0 * sinom, cosom )
+		const __m256 y = _mm256_mul_ps( scale0, sinom );
+		const __m256 a = _mm256_div_ps( _mm256_min_ps( y, cosom ), _mm256_max_ps( y, cosom ) );
+		const __m256 s = _mm256_mul_ps( a, a );
+		__m256 p = _mm256_set1_ps( 0.0028662257f );
+		p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( -0.0161657367f ) );
+		p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( 0.0429096138f ) );
+		p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( -0.0752896400f ) );
+		p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( 0.1065626393f ) );
+		p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( -0.1420889944f ) );
+		p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( 0.1999355085f ) );
+		p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( -0.3333314528f ) );
+		p = _mm256_mul_ps( _mm256_fmadd_ps( p, s, one ), a );
+		const __m256 omega = _mm256_blendv_ps( p, _mm256_sub_ps( halfPi, p ), _mm256_cmp_ps( y, cosom, _CMP_GT_OQ ) );
+
+		// scale0 = idMath::Sin16( ( 1.0f - t ) * omega ) * sinom, scale1 = idMath::Sin16( t * omega ) * sinom
+		__m256 angle[2], sine[2];
+		angle[0] = _mm256_mul_ps( invT, omega );
+		angle[1] = _mm256_mul_ps( t, omega );
+		for ( int k = 0; k < 2; k++ ) {
+			const __m256 ss = _mm256_mul_ps( angle[k], angle[k] );
+			__m256 q = _mm256_set1_ps( -2.39e-08f );
+			q = _mm256_fmadd_ps( q, ss, _mm256_set1_ps( 2.7526e-06f ) );
+			q = _mm256_fmadd_ps( q, ss, _mm256_set1_ps( -1.98409e-04f ) );
+			q = _mm256_fmadd_ps( q, ss, _mm256_set1_ps( 8.3333315e-03f ) );
+			q = _mm256_fmadd_ps( q, ss, _mm256_set1_ps( -1.666666664e-01f ) );
+			q = _mm256_fmadd_ps( q, ss, one );
+			sine[k] = _mm256_mul_ps( _mm256_mul_ps( angle[k], q ), sinom );
+		}
+
+		// fall back to a linear blend when the quaternions are very close
+		const __m256 linear = _mm256_cmp_ps( _mm256_sub_ps( one, cosom ), _mm256_set1_ps( 1e-6f ), _CMP_LE_OQ );
+		scale0 = _mm256_blendv_ps( sine[0], invT, linear );
+		const __m256 scale1 = _mm256_xor_ps( _mm256_blendv_ps( sine[1], t, linear ), sign );
+
+		for ( int k = 0; k < 4; k++ ) {
+			const __m256 q = _mm256_fmadd_ps( scale0, from[k], _mm256_mul_ps( scale1, to[k] ) );
+			result[k] = _mm256_blendv_ps( q, to[k], equal );
+		}
+		for ( int k = 0; k < 3; k++ ) {
+			fromT[k] = _mm256_fmadd_ps( t, _mm256_sub_ps( toT[k], fromT[k] ), fromT[k] );
+		}
+
+		StoreJointQuats( fromJoints, result, fromT );
+	}
+
+	for ( ; i < numJoints; i++ ) {
+		int j = index[i];
+		joints[j].q.Slerp( joints[j].q, blendJoints[j].q, lerp );
+		joints[j].t.Lerp( joints[j].t, blendJoints[j].t, lerp );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::ConvertJointQuatsToJointMats
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::ConvertJointQuatsToJointMats( idJointMat *jointMats, const idJointQuat *jointQuats, const int numJoints ) {
+	const __m256 one = _mm256_set1_ps( 1.0f );
+	const idJointQuat *joints[8];
+	__m256 q[4], t[3], row[3][4];
+	int i;
+
+	for ( i = 0; i + 8 <= numJoints; i += 8 ) {
+		for ( int k = 0; k < 8; k++ ) {
+			joints[k] = &jointQuats[i+k];
+		}
+		LoadJointQuats( joints, q, t );
+
+		const __m256 x2 = _mm256_add_ps( q[0], q[0] );
+		const __m256 y2 = _mm256_add_ps( q[1], q[1] );
+		const __m256 z2 = _mm256_add_ps( q[2], q[2] );
+
+		const __m256 xx = _mm256_mul_ps( q[0], x2 );
+		const __m256 xy = _mm256_mul_ps( q[0], y2 );
+		const __m256 xz = _mm256_mul_ps( q[0], z2 );
+		const __m256 yy = _mm256_mul_ps( q[1], y2 );
+		const __m256 yz = _mm256_mul_ps( q[1], z2 );
+		const __m256 zz = _mm256_mul_ps( q[2], z2 );
+		const __m256 wx = _mm256_mul_ps( q[3], x2 );
+		const __m256 wy = _mm256_mul_ps( q[3], y2 );
+		const __m256 wz = _mm256_mul_ps( q[3], z2 );
+
+		// rows of the joint matrix are the columns of idQuat::ToMat3
+		row[0][0] = _mm256_sub_ps( one, _mm256_add_ps( yy, zz ) );
+		row[0][1] = _mm256_add_ps( xy, wz );
+		row[0][2] = _mm256_sub_ps( xz, wy );
+		row[0][3] = t[0];
+		row[1][0] = _mm256_sub_ps( xy, wz );
+		row[1][1] = _mm256_sub_ps( one, _mm256_add_ps( xx, zz ) );
+		row[1][2] = _mm256_add_ps( yz, wx );
+		row[1][3] = t[1];
+		row[2][0] = _mm256_add_ps( xz, wy );
+		row[2][1] = _mm256_sub_ps( yz, wx );
+		row[2][2] = _mm256_sub_ps( one, _mm256_add_ps( xx, yy ) );
+		row[2][3] = t[2];
+
+		for ( int r = 0; r < 3; r++ ) {
+			Transpose4x4( row[r][0], row[r][1], row[r][2], row[r][3] );
+			for ( int k = 0; k < 4; k++ ) {
+				_mm_storeu_ps( jointMats[i+k].ToFloatPtr() + r * 4, _mm256_castps256_ps128( row[r][k] ) );
+				_mm_storeu_ps( jointMats[i+k+4].ToFloatPtr() + r * 4, _mm256_extractf128_ps( row[r][k], 1 ) );
+			}
+		}
+	}
+
+	for ( ; i < numJoints; i++ ) {
+		jointMats[i].SetRotation( jointQuats[i].q.ToMat3() );
+		jointMats[i].SetTranslation( jointQuats[i].t );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TransformJoints
+
+  Every joint depends on its parent so the joints are transformed one at a time,
+  each row of the result is a linear combination of the rows of the child matrix.
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::TransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint ) {
+	const __m128 translationMask = _mm_castsi128_ps( _mm_setr_epi32( 0, 0, 0, -1 ) );
+	int i;
+
+	for( i = firstJoint; i <= lastJoint; i++ ) {
+		assert( parents[i] < i );
+		const float *a = jointMats[parents[i]].ToFloatPtr();
+		float *m = jointMats[i].ToFloatPtr();
+
+		const __m128 m0 = _mm_loadu_ps( m + 0 );
+		const __m128 m1 = _mm_loadu_ps( m + 4 );
+		const __m128 m2 = _mm_loadu_ps( m + 8 );
+
+		for ( int r = 0; r < 3; r++ ) {
+			const __m128 ar = _mm_loadu_ps( a + r * 4 );
+			__m128 d = _mm_and_ps( ar, translationMask );
+			d = _mm_fmadd_ps( _mm_shuffle_ps( ar, ar, _MM_SHUFFLE( 2, 2, 2, 2 ) ), m2, d );
+			d = _mm_fmadd_ps( _mm_shuffle_ps( ar, ar, _MM_SHUFFLE( 1, 1, 1, 1 ) ), m1, d );
+			d = _mm_fmadd_ps( _mm_shuffle_ps( ar, ar, _MM_SHUFFLE( 0, 0, 0, 0 ) ), m0, d );
+			_mm_storeu_ps( m + r * 4, d );
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TransformVerts
+
+  The first two rows of each joint matrix are weighted in one 256 bit register and the
+  dot products are only summed once all the weights of a vertex have been accumulated.
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::TransformVerts( idDrawVert *verts, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) {
+	const byte *jointsPtr = (const byte *)joints;
+	int i, j;
+
+	for( j = i = 0; i < numVerts; i++ ) {
+		__m256 acc01 = _mm256_setzero_ps();
+		__m128 acc2 = _mm_setzero_ps();
+
+		do {
+			const float *m = (const float *)( jointsPtr + index[j*2+0] );
+			const __m128 w = _mm_loadu_ps( weights[j].ToFloatPtr() );
+			acc01 = _mm256_fmadd_ps( _mm256_loadu_ps( m ), Combine( w, w ), acc01 );
+			acc2 = _mm_fmadd_ps( _mm_loadu_ps( m + 8 ), w, acc2 );
+		} while( index[j++*2+1] == 0 );
+
+		const __m128 h01 = _mm_hadd_ps( _mm256_castps256_ps128( acc01 ), _mm256_extractf128_ps( acc01, 1 ) );
+		const __m128 h2 = _mm_hadd_ps( acc2, acc2 );
+		const __m128 v = _mm_hadd_ps( h01, h2 );
+
+		float *xyz = verts[i].xyz.ToFloatPtr();
+		_mm_storel_pi( (__m64 *)xyz, v );
+		_mm_store_ss( xyz + 2, _mm_movehl_ps( v, v ) );
+	}
+}
+
+/*
+============
+MulUnfused
+
+  The compiler may contract a multiply followed by a subtract into a fused multiply-subtract,
+  which leaves rounding noise in cross products that are zero for degenerate triangles. The
+  empty asm statement hides the product from the optimizer to keep the generic results.
+============
+*/
+static ID_INLINE AVX2_TARGET __m256 MulUnfused( const __m256 a, const __m256 b ) {
+	__m256 r = _mm256_mul_ps( a, b );
+#ifndef _MSC_VER
+	__asm__( "" : "+x" ( r ) );
+#endif
+	return r;
+}
+
+/*
+============
+LoadTriangleCorners
+
+  xyz and st[0] come from the first load, st[1] is the first float of the second one
+============
+*/
+static ID_INLINE AVX2_TARGET void LoadTriangleCorners( const idDrawVert *verts, const int *indexes, __m256 v[5] ) {
+	const float *p[8];
+	__m256 r[4];
+
+	for ( int k = 0; k < 8; k++ ) {
+		p[k] = verts[indexes[k*3]].xyz.ToFloatPtr();
+	}
+	Load4x8( p, v );
+	for ( int k = 0; k < 8; k++ ) {
+		p[k] += 4;
+	}
+	Load4x8( p, r );
+	v[4] = r[0];
+}
+
+/*
+============
+DeriveTangentsBatch
+
+  Calculates the plane and the unnormalized vertex contributions of eight triangles.
+============
+*/
+static ID_INLINE AVX2_TARGET void DeriveTangentsBatch( const idDrawVert *verts, const int *indexes, __m256 out[10] ) {
+	const __m256 signBit = _mm256_set1_ps( -0.0f );
+	__m256 a[5], d0[5], d1[5];
+
+	LoadTriangleCorners( verts, indexes + 0, a );
+	LoadTriangleCorners( verts, indexes + 1, d0 );
+	LoadTriangleCorners( verts, indexes + 2, d1 );
+	for ( int k = 0; k < 5; k++ ) {
+		d0[k] = _mm256_sub_ps( d0[k], a[k] );
+		d1[k] = _mm256_sub_ps( d1[k], a[k] );
+	}
+
+	// normal
+	__m256 n0 = _mm256_sub_ps( MulUnfused( d1[1], d0[2] ), MulUnfused( d1[2], d0[1] ) );
+	__m256 n1 = _mm256_sub_ps( MulUnfused( d1[2], d0[0] ), MulUnfused( d1[0], d0[2] ) );
+	__m256 n2 = _mm256_sub_ps( MulUnfused( d1[0], d0[1] ), MulUnfused( d1[1], d0[0] ) );
+	__m256 f = RSqrtNonZero( _mm256_fmadd_ps( n0, n0, _mm256_fmadd_ps( n1, n1, _mm256_mul_ps( n2, n2 ) ) ) );
+	out[0] = _mm256_mul_ps( n0, f );
+	out[1] = _mm256_mul_ps( n1, f );
+	out[2] = _mm256_mul_ps( n2, f );
+	out[3] = _mm256_xor_ps( _mm256_fmadd_ps( out[0], a[0], _mm256_fmadd_ps( out[1], a[1], _mm256_mul_ps( out[2], a[2] ) ) ), signBit );
+
+	// area sign bit
+	const __m256 sign = _mm256_and_ps( _mm256_sub_ps( MulUnfused( d0[3], d1[4] ), MulUnfused( d0[4], d1[3] ) ), signBit );
+
+	// first tangent
+	n0 = _mm256_sub_ps( MulUnfused( d0[0], d1[4] ), MulUnfused( d0[4], d1[0] ) );
+	n1 = _mm256_sub_ps( MulUnfused( d0[1], d1[4] ), MulUnfused( d0[4], d1[1] ) );
+	n2 = _mm256_sub_ps( MulUnfused( d0[2], d1[4] ), MulUnfused( d0[4], d1[2] ) );
+	f = _mm256_xor_ps( RSqrtNonZero( _mm256_fmadd_ps( n0, n0, _mm256_fmadd_ps( n1, n1, _mm256_mul_ps( n2, n2 ) ) ) ), sign );
+	out[4] = _mm256_mul_ps( n0, f );
+	out[5] = _mm256_mul_ps( n1, f );
+	out[6] = _mm256_mul_ps( n2, f );
+
+	// second tangent
+	n0 = _mm256_sub_ps( MulUnfused( d0[3], d1[0] ), MulUnfused( d0[0], d1[3] ) );
+	n1 = _mm256_sub_ps( MulUnfused( d0[3], d1[1] ), MulUnfused( d0[1], d1[3] ) );
+	n2 = _mm256_sub_ps( MulUnfused( d0[3], d1[2] ), MulUnfused( d0[2], d1[3] ) );
+	f = _mm256_xor_ps( RSqrtNonZero( _mm256_fmadd_ps( n0, n0, _mm256_fmadd_ps( n1, n1, _mm256_mul_ps( n2, n2 ) ) ) ), sign );
+	out[7] = _mm256_mul_ps( n0, f );
+	out[8] = _mm256_mul_ps( n1, f );
+	out[9] = _mm256_mul_ps( n2, f );
+}
+
+/*
+============
+idSIMD_AVX2::DeriveTangents
+
+	The triangle planes and tangents are calculated eight triangles at a time,
+	the per vertex accumulation stays in triangle order like the generic code.
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	const int numTris = numIndexes / 3;
+	__m256 out[10];
+	int tailIndexes[8*3];
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	for ( int i = 0; i < numTris; i += 8 ) {
+		const int batch = Min( numTris - i, 8 );
+
+		if ( batch < 8 ) {
+			// repeat the last triangle so the loads stay inside the index list
+			for ( int k = 0; k < 8 * 3; k++ ) {
+				tailIndexes[k] = indexes[( i + Min( k / 3, batch - 1 ) ) * 3 + k % 3];
+			}
+			DeriveTangentsBatch( verts, tailIndexes, out );
+		} else {
+			DeriveTangentsBatch( verts, indexes + i * 3, out );
+		}
+
+		for ( int j = 0; j < batch; j++ ) {
+			const float *o[10];
+			for ( int k = 0; k < 10; k++ ) {
+				o[k] = (const float *)&out[k] + j;
+			}
+			const idVec3 n( *o[0], *o[1], *o[2] );
+			const idVec3 t0( *o[4], *o[5], *o[6] );
+			const idVec3 t1( *o[7], *o[8], *o[9] );
+
+			idPlane &plane = planes[i+j];
+			plane.SetNormal( n );
+			plane[3] = *o[3];
+
+			for ( int k = 0; k < 3; k++ ) {
+				const int v = indexes[( i + j ) * 3 + k];
+				idDrawVert &dv = verts[v];
+				if ( used[v] ) {
+					dv.normal += n;
+					dv.tangents[0] += t0;
+					dv.tangents[1] += t1;
+				} else {
+					dv.normal = n;
+					dv.tangents[0] = t0;
+					dv.tangents[1] = t1;
+					used[v] = true;
+				}
+			}
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CreateShadowCache
+============
+*/
+AVX2_TARGET int VPCALL idSIMD_AVX2::CreateShadowCache( idVec4 *vertexCache, int *vertRemap, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts ) {
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 light = _mm_setr_ps( lightOrigin.x, lightOrigin.y, lightOrigin.z, 0.0f );
+	int outVerts = 0;
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		if ( vertRemap[i] ) {
+			continue;
+		}
+		// the fourth float is st[0] and gets replaced
+		const __m128 v = _mm_loadu_ps( verts[i].xyz.ToFloatPtr() );
+		const __m128 v0 = _mm_blend_ps( v, one, 8 );
+		const __m128 v1 = _mm_blend_ps( _mm_sub_ps( v, light ), zero, 8 );
+		_mm256_storeu_ps( vertexCache[outVerts].ToFloatPtr(), Combine( v0, v1 ) );
+		vertRemap[i] = outVerts;
+		outVerts += 2;
+	}
+	return outVerts;
+}
+
+/*
+============
+idSIMD_AVX2::CreateVertexProgramShadowCache
+============
+*/
+AVX2_TARGET int VPCALL idSIMD_AVX2::CreateVertexProgramShadowCache( idVec4 *vertexCache, const idDrawVert *verts, const int numVerts ) {
+	const __m256 w = _mm256_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		const __m128 v = _mm_loadu_ps( verts[i].xyz.ToFloatPtr() );
+		_mm256_storeu_ps( vertexCache[i*2].ToFloatPtr(), _mm256_blend_ps( Combine( v, v ), w, 0x88 ) );
+	}
+	return numVerts * 2;
+}
+
+/*
+============
+MixSoundSixSpeaker
+
+  Mixes four samples per iteration, which is exactly three registers of the interleaved
+  six speaker mix buffer. The permutations spread the source samples over those registers.
+============
+*/
+static ID_INLINE AVX2_TARGET void MixSoundSixSpeaker( float *mixBuffer, const float *samples, const int stereo, const float lastV[6], const float currentV[6], const int permute[3][8] ) {
+	ALIGN16( float volume[24] );
+	ALIGN16( float increment[24] );
+	__m256 vol[3], inc[3];
+	__m256i perm[3];
+
+	for ( int i = 0; i < 24; i++ ) {
+		const float incV = ( currentV[i % 6] - lastV[i % 6] ) / MIXBUFFER_SAMPLES;
+		volume[i] = lastV[i % 6] + ( i / 6 ) * incV;
+		increment[i] = 4.0f * incV;
+	}
+	for ( int k = 0; k < 3; k++ ) {
+		vol[k] = _mm256_loadu_ps( volume + k * 8 );
+		inc[k] = _mm256_loadu_ps( increment + k * 8 );
+		perm[k] = _mm256_loadu_si256( (const __m256i *)permute[k] );
+	}
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 4 ) {
+		__m256 s;
+		if ( stereo ) {
+			s = _mm256_loadu_ps( samples + i * 2 );
+		} else {
+			s = _mm256_castps128_ps256( _mm_loadu_ps( samples + i ) );
+		}
+		float *mix = mixBuffer + i * 6;
+		for ( int k = 0; k < 3; k++ ) {
+			const __m256 m = _mm256_loadu_ps( mix + k * 8 );
+			_mm256_storeu_ps( mix + k * 8, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, perm[k] ), vol[k], m ) );
+			vol[k] = _mm256_add_ps( vol[k], inc[k] );
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundSixSpeakerMono
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MixSoundSixSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	static const int permute[3][8] = {
+		{ 0, 0, 0, 0, 0, 0, 1, 1 },
+		{ 1, 1, 1, 1, 2, 2, 2, 2 },
+		{ 2, 2, 3, 3, 3, 3, 3, 3 }
+	};
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	MixSoundSixSpeaker( mixBuffer, samples, 0, lastV, currentV, permute );
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundSixSpeakerStereo
+
+  The left channel goes to speakers 0, 2, 3 and 4, the right channel to speakers 1 and 5.
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MixSoundSixSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	static const int permute[3][8] = {
+		{ 0, 1, 0, 0, 0, 1, 2, 3 },
+		{ 2, 2, 2, 3, 4, 5, 4, 4 },
+		{ 4, 5, 6, 7, 6, 6, 6, 7 }
+	};
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	MixSoundSixSpeaker( mixBuffer, samples, 1, lastV, currentV, permute );
+}
+
+#endif /* ID_SIMD_AVX2 */
@@ -2238,6 +2238,21 @@ bool VPCALL idSIMD_Generic::MatX_LDLTFactor( idMatX &mat, idVecX &invDiag, const
 #endif
 }
 
+/*
+============
+idSIMD_Generic::Dequantize
+
+  dst[i] = bias[i] + scale[i] * src[i];
+============
+*/
+void VPCALL idSIMD_Generic::Dequantize( float *dst, const short *src, const float *scale, const float *bias, const int count ) {
+	int i;
+
+	for ( i = 0; i < count; i++ ) {
+		dst[i] = bias[i] + scale[i] * src[i];
+	}
+}
+
 /*
 ============
 idSIMD_Generic::BlendJoints
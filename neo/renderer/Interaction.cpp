@@ -316,6 +316,15 @@ static srfTriangles_t *R_CreateLightTris( const idRenderEntityLocal *ent,
 	newTri->numVerts = tri->numVerts;
 	R_ReferenceStaticTriSurfVerts( newTri, tri );
 
+	// gpu skinned surfaces without cpu side vertexes can't be culled per triangle,
+	// the whole surface is lit
+	if ( tri->gpuSkinnedMesh != NULL && !tri->gpuSkinnedVertsValid ) {
+		R_ReferenceStaticTriSurfIndexes( newTri, tri );
+		newTri->numIndexes = tri->numIndexes;
+		newTri->bounds = tri->bounds;
+		return newTri;
+	}
+
 	// calculate cull information
 	if ( !includeBackFaces ) {
 		R_CalcInteractionFacing( ent, tri, light, cullInfo );
@@ -892,6 +901,11 @@ void idInteraction::CreateInteraction( const idRenderModel *model ) {
 			continue;
 		}
 
+		// stencil shadow volumes are built from the cpu side vertexes
+		if ( lightDef->ShadowMode() == shadowMode_t::StencilShadow && HasShadows() && shader->SurfaceCastsShadow() ) {
+			R_SkinVertsOnCPU( tri );
+		}
+
 		// generate a lighted surface and add it
 		if ( shader->ReceivesLighting() ) {
 			if ( tri->ambientViewCount == tr.viewCount ) {
@@ -40,6 +40,7 @@ If you have questions concerning this license or the applicable additional terms
 #include <unordered_map>
 
 
+idCVar idRenderModelStatic::r_binaryModels( "r_binaryModels", "1", CVAR_BOOL|CVAR_RENDERER, "cache processed models in generated/rendermodels and load them instead of the source when up to date" );
 idCVar idRenderModelStatic::r_mergeModelSurfaces( "r_mergeModelSurfaces", "1", CVAR_BOOL|CVAR_RENDERER, "combine model surfaces with the same material" );
 idCVar idRenderModelStatic::r_slopVertex( "r_slopVertex", "0.01", CVAR_RENDERER, "merge xyz coordinates this far apart" );
 idCVar idRenderModelStatic::r_slopTexCoord( "r_slopTexCoord", "0.001", CVAR_RENDERER, "merge texture coordinates this far apart" );
@@ -354,6 +355,19 @@ void idRenderModelStatic::InitFromFile( const char *fileName ) {
 
 	name.ExtractFileExtension( extension );
 
+	// formats that go through the full cleanup can be restored from the binary cache
+	const bool cacheable = extension.Icmp( "ase" ) == 0 || extension.Icmp( "lwo" ) == 0 ||
+							extension.Icmp( "ma" ) == 0 || extension.Icmp( "obj" ) == 0;
+
+	ID_TIME_T sourceTimeStamp = FILE_NOT_FOUND_TIMESTAMP;
+	if ( cacheable ) {
+		fileSystem->ReadFile( name, NULL, &sourceTimeStamp );
+		if ( LoadBinaryModel( sourceTimeStamp ) ) {
+			reloadable = true;
+			return;
+		}
+	}
+
 	if ( extension.Icmp( "ase" ) == 0 ) {
 		loaded		= LoadASE( name );
 		reloadable	= true;
@@ -385,6 +399,10 @@ void idRenderModelStatic::InitFromFile( const char *fileName ) {
 
 	// create the bounds for culling and dynamic surface creation
 	FinishSurfaces();
+
+	if ( cacheable ) {
+		WriteBinaryModel( sourceTimeStamp );
+	}
 }
 
 /*
@@ -784,6 +802,217 @@ void idRenderModelStatic::FinishSurfaces() {
 	}
 }
 
+/*
+===============================================================================
+
+	Binary model cache
+
+===============================================================================
+*/
+
+static const char *	BINARY_MODEL_DIR		= "generated/rendermodels/";
+static const int	BINARY_MODEL_MAGIC		= ( 'B' << 24 ) | ( 'R' << 16 ) | ( 'M' << 8 ) | 'D';
+static const int	BINARY_MODEL_VERSION	= 2;
+
+/*
+================
+R_BinaryModelMaterialFlags
+
+The processing done in FinishSurfaces depends on these material properties,
+a cached model is only valid if they didn't change
+================
+*/
+static int R_BinaryModelMaterialFlags( const idMaterial *shader ) {
+	int flags = 0;
+	if ( shader->ShouldCreateBackSides() ) {
+		flags |= BIT( 0 );
+	}
+	if ( shader->UseUnsmoothedTangents() ) {
+		flags |= BIT( 1 );
+	}
+	if ( shader->Deform() != DFRM_NONE ) {
+		flags |= BIT( 2 );
+	}
+	return flags;
+}
+
+/*
+================
+idRenderModelStatic::BinaryModelFileName
+================
+*/
+void idRenderModelStatic::BinaryModelFileName( idStr &fileName ) const {
+	idStr extension;
+
+	name.ExtractFileExtension( extension );
+	fileName = BINARY_MODEL_DIR;
+	fileName += name;
+	fileName.SetFileExtension( va( "b%s", extension.c_str() ) );
+}
+
+/*
+================
+idRenderModelStatic::LoadBinaryModel
+
+Restores the processed surfaces written by a previous load of the same source file.
+Returns false if there is no valid cache, in which case the model is left empty.
+================
+*/
+bool idRenderModelStatic::LoadBinaryModel( ID_TIME_T sourceTimeStamp ) {
+	if ( !r_binaryModels.GetBool() || fastLoad || sourceTimeStamp == FILE_NOT_FOUND_TIMESTAMP ) {
+		return false;
+	}
+
+	idStr binaryName;
+	BinaryModelFileName( binaryName );
+
+	// the whole file is read at once, surfaces are copied straight out of the buffer
+	void *buffer = NULL;
+	int length = fileSystem->ReadFile( binaryName, &buffer );
+	if ( length <= 0 || buffer == NULL ) {
+		return false;
+	}
+
+	idFile_Memory file( binaryName, (const char *)buffer, length );
+
+	int magic = 0, version = 0, vertSize = 0, indexSize = 0;
+	unsigned int cachedTimeStamp = 0;
+	file.ReadInt( magic );
+	file.ReadInt( version );
+	file.ReadInt( vertSize );
+	file.ReadInt( indexSize );
+	file.ReadUnsignedInt( cachedTimeStamp );
+
+	bool valid = magic == BINARY_MODEL_MAGIC && version == BINARY_MODEL_VERSION &&
+				vertSize == sizeof( idDrawVert ) && indexSize == sizeof( glIndex_t ) &&
+				cachedTimeStamp == (unsigned int)sourceTimeStamp;
+
+	if ( valid ) {
+		valid = ReadBinaryModelFile( &file );
+		if ( !valid ) {
+			// ReadBinaryModelFile purged the partial data, the caller loads the source into the empty model
+			common->DPrintf( "discarding invalid binary model '%s'\n", binaryName.c_str() );
+			purged = false;
+		}
+	}
+
+	fileSystem->FreeFile( buffer );
+
+	if ( !valid ) {
+		return false;
+	}
+
+	timeStamp = sourceTimeStamp;
+	purged = false;
+	return true;
+}
+
+/*
+================
+idRenderModelStatic::WriteBinaryModel
+================
+*/
+void idRenderModelStatic::WriteBinaryModel( ID_TIME_T sourceTimeStamp ) const {
+	if ( !r_binaryModels.GetBool() || fastLoad || sourceTimeStamp == FILE_NOT_FOUND_TIMESTAMP ) {
+		return;
+	}
+
+	idStr binaryName;
+	BinaryModelFileName( binaryName );
+
+	idFile *file = fileSystem->OpenFileWrite( binaryName );
+	if ( !file ) {
+		return;
+	}
+
+	file->WriteInt( BINARY_MODEL_MAGIC );
+	file->WriteInt( BINARY_MODEL_VERSION );
+	file->WriteInt( sizeof( idDrawVert ) );
+	file->WriteInt( sizeof( glIndex_t ) );
+	file->WriteUnsignedInt( (unsigned int)sourceTimeStamp );
+
+	WriteBinaryModelFile( file );
+
+	fileSystem->CloseFile( file );
+}
+
+/*
+================
+idRenderModelStatic::ReadBinaryModelFile
+================
+*/
+bool idRenderModelStatic::ReadBinaryModelFile( idFile *file ) {
+	int numSurfaces = 0;
+
+	file->ReadVec3( bounds[0] );
+	file->ReadVec3( bounds[1] );
+	if ( file->ReadInt( numSurfaces ) != sizeof( numSurfaces ) || numSurfaces < 0 ) {
+		return false;
+	}
+
+	surfaces.SetNum( 0, false );
+	for ( int i = 0; i < numSurfaces; i++ ) {
+		modelSurface_t surf;
+		idStr materialName;
+		int flags = 0;
+		float area = 0.0f;
+
+		file->ReadInt( surf.id );
+		file->ReadString( materialName );
+		file->ReadInt( flags );
+		file->ReadFloat( area );
+
+		surf.shader = declManager->FindMaterial( materialName );
+		if ( R_BinaryModelMaterialFlags( surf.shader ) != flags ) {
+			PurgeModel();
+			return false;
+		}
+
+		surf.geometry = R_ReadStaticTriSurfBinary( file );
+		if ( !surf.geometry ) {
+			PurgeModel();
+			return false;
+		}
+
+		surfaces.Append( surf );
+
+		// development information normally gathered in FinishSurfaces
+		const_cast<idMaterial *>(surf.shader)->AddToSurfaceArea( area );
+	}
+
+	return true;
+}
+
+/*
+================
+idRenderModelStatic::WriteBinaryModelFile
+================
+*/
+void idRenderModelStatic::WriteBinaryModelFile( idFile *file ) const {
+	file->WriteVec3( bounds[0] );
+	file->WriteVec3( bounds[1] );
+	file->WriteInt( surfaces.Num() );
+
+	for ( int i = 0; i < surfaces.Num(); i++ ) {
+		const modelSurface_t *surf = &surfaces[i];
+		const srfTriangles_t *tri = surf->geometry;
+
+		// shadow models only have shadow vertexes
+		float area = 0.0f;
+		for ( int j = 0; tri->verts != NULL && j < tri->numIndexes; j += 3 ) {
+			area += idWinding::TriangleArea( tri->verts[tri->indexes[j]].xyz,
+				tri->verts[tri->indexes[j+1]].xyz, tri->verts[tri->indexes[j+2]].xyz );
+		}
+
+		file->WriteInt( surf->id );
+		file->WriteString( surf->shader->GetName() );
+		file->WriteInt( R_BinaryModelMaterialFlags( surf->shader ) );
+		file->WriteFloat( area );
+
+		R_WriteStaticTriSurfBinary( file, tri );
+	}
+}
+
 /*
 =================
 idRenderModelStatic::ConvertASEToModelSurfaces
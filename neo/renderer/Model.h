@@ -133,6 +133,13 @@ typedef struct srfTriangles_s {
 
 	struct srfTriangles_s *		nextDeferredFree;		// chain of tris to free next frame
 
+	// md5 surfaces skinned on the gpu only have valid vertexes in the ambientCache,
+	// R_SkinVertsOnCPU fills in verts for the few users that need them
+	const class idMD5Mesh *		gpuSkinnedMesh;
+	class idJointMat *			gpuSkinnedJoints;		// copy of the entity joints, kept allocated between frames
+	int							numGpuSkinnedJoints;
+	bool						gpuSkinnedVertsValid;
+
 	// data in vertex object space, not directly readable by the CPU
 	struct vertCache_s *		indexCache;				// int
 	struct vertCache_s *		ambientCache;			// idDrawVert
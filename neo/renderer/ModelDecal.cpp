@@ -315,6 +315,9 @@ void idRenderModelDecal::CreateDecal( const idRenderModel *model, const decalPro
 			continue;
 		}
 
+		// gpu skinned surfaces only have their vertexes in the vertex cache
+		R_SkinVertsOnCPU( stri );
+
 		// allocate memory for the cull bits
 		byte *cullBits = (byte *)_alloca16( stri->numVerts * sizeof( cullBits[0] ) );
 
@@ -138,6 +138,9 @@ void idRenderModelOverlay::CreateOverlay( const idRenderModel *model, const idPl
 
 		const srfTriangles_t *stri = surf->geometry;
 
+		// gpu skinned surfaces only have their vertexes in the vertex cache
+		R_SkinVertsOnCPU( stri );
+
 		// try to cull the whole surface along the first texture axis
 		d = stri->bounds.PlaneDistance( localTextureAxis[0] );
 		if ( d < 0.0f || d > 1.0f ) {
@@ -318,6 +321,8 @@ void idRenderModelOverlay::AddOverlaySurfacesToModel( idRenderModel *baseModel )
 				}
 			}
 
+			R_SkinVertsOnCPU( baseSurf->geometry );
+
 			// copy indexes;
 			for ( j = 0; j < surf->numIndexes; j++ ) {
 				newTri->indexes[numIndexes + j] = numVerts + surf->indexes[j];
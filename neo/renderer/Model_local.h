@@ -104,6 +104,15 @@ public:
 	void						DeleteSurfacesWithNegativeId( void );
 	bool						FindSurfaceWithId( int id, int &surfaceNum );
 
+	// processed geometry cache in generated/rendermodels, only valid as long as
+	// the source file has the same timestamp
+	bool						LoadBinaryModel( ID_TIME_T sourceTimeStamp );
+	void						WriteBinaryModel( ID_TIME_T sourceTimeStamp ) const;
+
+	// raw surface payload of the cache, also used for the world models in binary procs
+	virtual bool				ReadBinaryModelFile( idFile *file );
+	virtual void				WriteBinaryModelFile( idFile *file ) const;
+
 public:
 	idList<modelSurface_t>		surfaces;
 	idBounds					bounds;
@@ -123,6 +132,9 @@ protected:
 	bool						levelLoadReferenced;	// for determining if it needs to be freed
 	ID_TIME_T						timeStamp;
 
+	void						BinaryModelFileName( idStr &fileName ) const;
+
+	static idCVar				r_binaryModels;			// cache processed models in generated/rendermodels
 	static idCVar				r_mergeModelSurfaces;	// combine model surfaces with the same material
 	static idCVar				r_slopVertex;			// merge xyz coordinates this far apart
 	static idCVar				r_slopTexCoord;			// merge texture coordinates this far apart
@@ -146,12 +158,20 @@ public:
 
  	void						ParseMesh( idLexer &parser, int numJoints, const idJointMat *joints );
 	void						UpdateSurface( const struct renderEntity_t *ent, const idJointMat *joints, modelSurface_t *surf ) const;
+								// the part of UpdateSurface that can run as a parallel job
+	void						SkinSurface( srfTriangles_t *tri, const idJointMat *joints, float skinScale, bool deriveTangents, int *tangentIndexes = NULL ) const;
+								// only allocates the vertex cache, the back end skins the bind pose into it
+	bool						UpdateSurfaceGPU( const idJointMat *joints, int numJoints, const idJointMat *bindPose, int firstJoint, const idBounds &bounds, modelSurface_t *surf ) const;
+	void						FreeGPUSkinningCaches( void );
 	idBounds					CalcBounds( const idJointMat *joints ) const;
 	int							NearestJoint( int a, int b, int c ) const;
 	int							NumVerts( void ) const;
 	int							NumTris( void ) const;
 	int							NumWeights( void ) const;
 
+	void						WriteBinary( idFile *file ) const;
+	bool						ReadBinary( idFile *file, int numJoints );
+
 private:
 	idList<idVec2>				texCoords;			// texture coordinates
 	int							numWeights;			// number of weights
@@ -162,6 +182,11 @@ private:
 	struct deformInfo_s *		deformInfo;			// used to create srfTriangles_t from base frames and new vertexes
 	int							surfaceNum;			// number of the static surface created for this mesh
 
+	mutable struct vertCache_s *gpuBindVerts;		// bind pose idDrawVerts for gpu skinning
+	mutable struct vertCache_s *gpuWeights;			// gpuSkinningWeight_t per vertex
+
+	srfTriangles_t *			SetupSurface( modelSurface_t *surf ) const;
+	bool						CreateGPUSkinningCaches( const idJointMat *bindPose ) const;
 	void						TransformVerts( idDrawVert *verts, const idJointMat *joints ) const;
 	void						TransformScaledVerts( idDrawVert *verts, const idJointMat *joints, float scale ) const;
 };
@@ -189,6 +214,11 @@ public:
 	virtual const char *		GetJointName( jointHandle_t handle ) const;
 	virtual const idJointQuat *	GetDefaultPose( void ) const;
 	virtual int					NearestJoint( int surfaceNum, int a, int b, int c ) const;
+	virtual void				FreeVertexCache();
+
+protected:
+	virtual bool				ReadBinaryModelFile( idFile *file );
+	virtual void				WriteBinaryModelFile( idFile *file ) const;
 
 private:
 	idList<idMD5Joint>			joints;
@@ -199,11 +229,13 @@ private:
 	// jmarshall
 	idJointMat                  *poseMat3;
 	// jmarshall end
+	idList<idJointMat>			inverseBindPose;	// built on first use by gpu skinning
 
 	void						CalculateBounds( const idJointMat *joints );
 	void						GetFrameBounds( const renderEntity_t *ent, idBounds &bounds ) const;
 	void						DrawJoints( const renderEntity_t *ent, const struct viewDef_s *view ) const;
 	void						ParseJoint( idLexer &parser, idMD5Joint *joint, idJointQuat *defaultPose );
+	int							AddGPUSkinningPalette( const idJointMat *entJoints );
 };
 
 /*
@@ -64,6 +64,8 @@ idMD5Mesh::idMD5Mesh() {
 	numTris			= 0;
 	deformInfo		= NULL;
 	surfaceNum		= 0;
+	gpuBindVerts	= NULL;
+	gpuWeights		= NULL;
 }
 
 /*
@@ -78,6 +80,7 @@ idMD5Mesh::~idMD5Mesh() {
 		R_FreeDeformInfo( deformInfo );
 		deformInfo = NULL;
 	}
+	FreeGPUSkinningCaches();
 }
 
 /*
@@ -245,6 +248,89 @@ void idMD5Mesh::ParseMesh( idLexer &parser, int numJoints, const idJointMat *joi
 	deformInfo = R_BuildDeformInfo( texCoords.Num(), verts, tris.Num(), tris.Ptr(), shader->UseUnsmoothedTangents() );
 }
 
+/*
+====================
+idMD5Mesh::WriteBinary
+====================
+*/
+void idMD5Mesh::WriteBinary( idFile *file ) const {
+	file->WriteString( shader->GetName() );
+	file->WriteBool( shader->UseUnsmoothedTangents() );
+	file->WriteInt( numTris );
+
+	file->WriteInt( texCoords.Num() );
+	file->Write( texCoords.Ptr(), texCoords.Num() * sizeof( texCoords[0] ) );
+
+	file->WriteInt( numWeights );
+	file->Write( scaledWeights, numWeights * sizeof( scaledWeights[0] ) );
+	file->Write( weightIndex, numWeights * 2 * sizeof( weightIndex[0] ) );
+
+	R_WriteDeformInfoBinary( file, deformInfo );
+}
+
+/*
+====================
+idMD5Mesh::ReadBinary
+
+Returns false if the data doesn't match the current material or joints.
+====================
+*/
+bool idMD5Mesh::ReadBinary( idFile *file, int numJoints ) {
+	idStr	shaderName;
+	bool	unsmoothedTangents = false;
+	int		numVerts = 0;
+	int		i;
+
+	file->ReadString( shaderName );
+	file->ReadBool( unsmoothedTangents );
+	file->ReadInt( numTris );
+
+	shader = declManager->FindMaterial( shaderName );
+	if ( shader->UseUnsmoothedTangents() != unsmoothedTangents ) {
+		return false;
+	}
+
+	if ( file->ReadInt( numVerts ) != sizeof( numVerts ) || numVerts < 0 || numVerts * (int)sizeof( texCoords[0] ) > file->Length() - file->Tell() ) {
+		return false;
+	}
+	texCoords.SetNum( numVerts );
+	file->Read( texCoords.Ptr(), numVerts * sizeof( texCoords[0] ) );
+
+	if ( file->ReadInt( numWeights ) != sizeof( numWeights ) || numWeights < numVerts || numWeights * (int)sizeof( scaledWeights[0] ) > file->Length() - file->Tell() ) {
+		numWeights = 0;
+		return false;
+	}
+	scaledWeights = (idVec4 *) Mem_Alloc16( numWeights * sizeof( scaledWeights[0] ) );
+	weightIndex = (int *) Mem_Alloc16( numWeights * 2 * sizeof( weightIndex[0] ) );
+	file->Read( scaledWeights, numWeights * sizeof( scaledWeights[0] ) );
+	if ( file->Read( weightIndex, numWeights * 2 * sizeof( weightIndex[0] ) ) != numWeights * 2 * (int)sizeof( weightIndex[0] ) ) {
+		return false;
+	}
+
+	// the weight index holds byte offsets into the joint array
+	for ( i = 0; i < numWeights; i++ ) {
+		int offset = weightIndex[i * 2 + 0];
+		if ( offset < 0 || offset >= numJoints * (int)sizeof( idJointMat ) || ( offset % sizeof( idJointMat ) ) != 0 ) {
+			return false;
+		}
+	}
+
+	deformInfo = R_ReadDeformInfoBinary( file );
+	if ( !deformInfo || deformInfo->numSourceVerts != numVerts ) {
+		return false;
+	}
+
+	// update counters
+	c_numVerts += texCoords.Num();
+	c_numWeights += numWeights;
+	c_numWeightJoints++;
+	for ( i = 0; i < numWeights; i++ ) {
+		c_numWeightJoints += weightIndex[i*2+1];
+	}
+
+	return true;
+}
+
 /*
 ====================
 idMD5Mesh::TransformVerts
@@ -269,17 +355,15 @@ void idMD5Mesh::TransformScaledVerts( idDrawVert *verts, const idJointMat *entJo
 
 /*
 ====================
-idMD5Mesh::UpdateSurface
+idMD5Mesh::SetupSurface
+
+Sets up the triangle surface for a new frame, the vertexes are left for the skinning.
 ====================
 */
-void idMD5Mesh::UpdateSurface( const struct renderEntity_t *ent, const idJointMat *entJoints, modelSurface_t *surf ) const {
-	int i, base;
+srfTriangles_t *idMD5Mesh::SetupSurface( modelSurface_t *surf ) const {
+	int i;
 	srfTriangles_t *tri;
 
-	tr.pc.c_deformedSurfaces++;
-	tr.pc.c_deformedVerts += deformInfo->numOutputVerts;
-	tr.pc.c_deformedIndexes += deformInfo->numIndexes;
-
 	surf->shader = shader;
 
 	if ( surf->geometry ) {
@@ -314,6 +398,10 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_t *ent, const idJointMa
 	tri->dominantTris = deformInfo->dominantTris;
 	tri->numVerts = deformInfo->numOutputVerts;
 
+	// the joint copy stays allocated for the next gpu skinned frame
+	tri->gpuSkinnedMesh = NULL;
+	tri->gpuSkinnedVertsValid = false;
+
 	if ( tri->verts == NULL ) {
 		R_AllocStaticTriSurfVerts( tri, tri->numVerts );
 		for ( i = 0; i < deformInfo->numSourceVerts; i++ ) {
@@ -322,23 +410,60 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_t *ent, const idJointMa
 		}
 	}
 
-	/*if ( ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] != 0.0f ) {
-		TransformScaledVerts( tri->verts, entJoints, ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] );
-	} else {
-		TransformVerts( tri->verts, entJoints );
-	}*/
+	return tri;
+}
 
-	// jmarshall - No renderEntity support
-	if ( ent != nullptr && ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] != 0.0f )
-	{
-		TransformScaledVerts( tri->verts, entJoints, ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] );
-	}
-	else
-	{
-		TransformVerts( tri->verts, entJoints );
-	}
+/*
+====================
+idMD5Mesh::UpdateSurface
+====================
+*/
+void idMD5Mesh::UpdateSurface( const struct renderEntity_t *ent, const idJointMat *entJoints, modelSurface_t *surf ) const {
+	tr.pc.c_deformedSurfaces++;
+	tr.pc.c_deformedVerts += deformInfo->numOutputVerts;
+	tr.pc.c_deformedIndexes += deformInfo->numIndexes;
+
+	srfTriangles_t *tri = SetupSurface( surf );
+
+	// jmarshall - No renderEntity support
+	const float skinScale = ( ent != nullptr ) ? ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] : 0.0f;
 	// jmarshall end
 
+	// If a surface is going to be have a lighting interaction generated, it will also have to call
+	// R_DeriveTangents() to get normals, tangents, and face planes.  If it only
+	// needs shadows generated, it will only have to generate face planes.  If it only
+	// has ambient drawing, or is culled, no additional work will be necessary
+	const bool deriveTangents = !r_useDeferredTangents.GetBool();
+
+	// everything that allocates is done here so the skinning can run as a job
+	if ( deriveTangents && tri->dominantTris == NULL && tri->facePlanes == NULL ) {
+		R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
+	}
+
+	if ( R_ParallelSkinningActive() ) {
+		R_AddSkinningJob( this, tri, entJoints, skinScale, deriveTangents );
+		return;
+	}
+
+	SkinSurface( tri, entJoints, skinScale, deriveTangents );
+}
+
+/*
+====================
+idMD5Mesh::SkinSurface
+
+Transforms the vertexes of a surface set up by UpdateSurface.
+====================
+*/
+void idMD5Mesh::SkinSurface( srfTriangles_t *tri, const idJointMat *entJoints, float skinScale, bool deriveTangents, int *tangentIndexes ) const {
+	int i, base;
+
+	if ( skinScale != 0.0f ) {
+		TransformScaledVerts( tri->verts, entJoints, skinScale );
+	} else {
+		TransformVerts( tri->verts, entJoints );
+	}
+
 	// replicate the mirror seam vertexes
 	base = deformInfo->numOutputVerts - deformInfo->numMirroredVerts;
 	for ( i = 0; i < deformInfo->numMirroredVerts; i++ ) {
@@ -347,16 +472,173 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_t *ent, const idJointMa
 
 	R_BoundTriSurf( tri );
 
-	// If a surface is going to be have a lighting interaction generated, it will also have to call
-	// R_DeriveTangents() to get normals, tangents, and face planes.  If it only
-	// needs shadows generated, it will only have to generate face planes.  If it only
-	// has ambient drawing, or is culled, no additional work will be necessary
-	if ( !r_useDeferredTangents.GetBool() ) {
+	if ( deriveTangents ) {
 		// set face planes, vertex normals, tangents
-		R_DeriveTangents( tri );
+		R_DeriveTangents( tri, false, tangentIndexes );
 	}
 }
 
+/*
+====================
+idMD5Mesh::CreateGPUSkinningCaches
+
+Uploads the bind pose vertexes and the four most important joint weights of
+every vertex, these stay in the vertex cache for all instances of the mesh.
+====================
+*/
+bool idMD5Mesh::CreateGPUSkinningCaches( const idJointMat *bindPose ) const {
+	int i, w;
+
+	if ( gpuBindVerts != NULL && gpuWeights != NULL ) {
+		return true;
+	}
+
+	// skin the bind pose on a temporary surface to get the normals and tangents
+	srfTriangles_t *tri = R_AllocStaticTriSurf();
+	tri->deformedSurface = true;
+	tri->numIndexes = deformInfo->numIndexes;
+	tri->indexes = deformInfo->indexes;
+	tri->numMirroredVerts = deformInfo->numMirroredVerts;
+	tri->mirroredVerts = deformInfo->mirroredVerts;
+	tri->numDupVerts = deformInfo->numDupVerts;
+	tri->dupVerts = deformInfo->dupVerts;
+	tri->dominantTris = deformInfo->dominantTris;
+	tri->numVerts = deformInfo->numOutputVerts;
+	R_AllocStaticTriSurfVerts( tri, tri->numVerts );
+	for ( i = 0; i < deformInfo->numSourceVerts; i++ ) {
+		tri->verts[i].Clear();
+		tri->verts[i].st = texCoords[i];
+	}
+	SkinSurface( tri, bindPose, 0.0f, true );
+
+	gpuSkinningWeight_t *weights = (gpuSkinningWeight_t *)R_StaticAlloc( tri->numVerts * sizeof( weights[0] ) );
+
+	for ( w = i = 0; i < deformInfo->numSourceVerts; i++ ) {
+		int		joint[4] = { 0, 0, 0, 0 };
+		float	weight[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+		// keep the four largest weights, sorted
+		while ( 1 ) {
+			const float f = scaledWeights[w].w;
+			if ( f > weight[3] ) {
+				int k;
+				for ( k = 3; k > 0 && f > weight[k - 1]; k-- ) {
+					weight[k] = weight[k - 1];
+					joint[k] = joint[k - 1];
+				}
+				weight[k] = f;
+				joint[k] = weightIndex[w * 2 + 0] / sizeof( idJointMat );
+			}
+			if ( weightIndex[w++ * 2 + 1] ) {
+				break;
+			}
+		}
+
+		// renormalize the dropped weights away, the rounding error goes to the largest weight
+		const float scale = 255.0f / ( weight[0] + weight[1] + weight[2] + weight[3] );
+		int sum = 0;
+		for ( int k = 1; k < 4; k++ ) {
+			const int b = idMath::FtoiFast( weight[k] * scale + 0.5f );
+			weights[i].joints[k] = joint[k];
+			weights[i].weights[k] = b;
+			sum += b;
+		}
+		weights[i].joints[0] = joint[0];
+		weights[i].weights[0] = 255 - sum;
+	}
+
+	const int base = deformInfo->numOutputVerts - deformInfo->numMirroredVerts;
+	for ( i = 0; i < deformInfo->numMirroredVerts; i++ ) {
+		weights[base + i] = weights[deformInfo->mirroredVerts[i]];
+	}
+
+	gpuBindVerts = vertexCache.Alloc( tri->verts, tri->numVerts * sizeof( tri->verts[0] ), false );
+	gpuWeights = vertexCache.Alloc( weights, tri->numVerts * sizeof( weights[0] ), false );
+
+	R_StaticFree( weights );
+	R_ReallyFreeStaticTriSurf( tri );
+
+	return ( gpuBindVerts != NULL && gpuWeights != NULL );
+}
+
+/*
+====================
+idMD5Mesh::FreeGPUSkinningCaches
+====================
+*/
+void idMD5Mesh::FreeGPUSkinningCaches( void ) {
+	vertexCache.Free( gpuBindVerts );
+	gpuBindVerts = NULL;
+	vertexCache.Free( gpuWeights );
+	gpuWeights = NULL;
+}
+
+/*
+====================
+idMD5Mesh::UpdateSurfaceGPU
+
+Only sets up the vertex cache of the surface, RB_SkinGPUSurfaces writes the
+skinned vertexes into it. The cpu side vertexes are skinned on demand by
+R_SkinVertsOnCPU, until then the surface uses the bounds of the entity.
+====================
+*/
+bool idMD5Mesh::UpdateSurfaceGPU( const idJointMat *entJoints, int numJoints, const idJointMat *bindPose, int firstJoint, const idBounds &bounds, modelSurface_t *surf ) const {
+	vertCache_t *ambientCache;
+
+	if ( !CreateGPUSkinningCaches( bindPose ) ) {
+		return false;
+	}
+
+	// the skinning pass overwrites the whole vertex cache, so the one of the last frame is reused
+	ambientCache = NULL;
+	if ( surf->geometry != NULL && surf->geometry->gpuSkinnedMesh == this ) {
+		ambientCache = surf->geometry->ambientCache;
+		surf->geometry->ambientCache = NULL;
+	}
+
+	srfTriangles_t *tri = SetupSurface( surf );
+
+	const int cacheSize = tri->numVerts * sizeof( idDrawVert );
+	if ( ambientCache != NULL && ambientCache->size != cacheSize ) {
+		vertexCache.Free( ambientCache );
+		ambientCache = NULL;
+	}
+	if ( ambientCache == NULL ) {
+		ambientCache = vertexCache.Alloc( NULL, cacheSize, false );
+		if ( !ambientCache ) {
+			return false;
+		}
+	}
+	tri->ambientCache = ambientCache;
+
+	tri->bounds = bounds;
+	// the vertex program rotates the bind pose normals and tangents
+	tri->tangentsCalculated = true;
+
+	// the game owns the entity joints, R_SkinVertsOnCPU may run after they changed
+	if ( tri->numGpuSkinnedJoints != numJoints ) {
+		Mem_Free16( tri->gpuSkinnedJoints );
+		tri->gpuSkinnedJoints = (idJointMat *)Mem_Alloc16( numJoints * sizeof( tri->gpuSkinnedJoints[0] ) );
+		tri->numGpuSkinnedJoints = numJoints;
+	}
+	SIMDProcessor->Memcpy( tri->gpuSkinnedJoints, entJoints, numJoints * sizeof( tri->gpuSkinnedJoints[0] ) );
+
+	tri->gpuSkinnedMesh = this;
+	tri->gpuSkinnedVertsValid = false;
+
+	gpuSkinnedSurface_t &skin = tr.gpuSkinnedSurfaces.Alloc();
+	skin.output = tri->ambientCache;
+	skin.bindVerts = gpuBindVerts;
+	skin.weights = gpuWeights;
+	skin.numVerts = tri->numVerts;
+	skin.firstJoint = firstJoint;
+
+	tr.pc.c_gpuSkinnedSurfaces++;
+	tr.pc.c_gpuSkinnedVerts += tri->numVerts;
+
+	return true;
+}
+
 /*
 ====================
 idMD5Mesh::CalcBounds
@@ -539,6 +821,13 @@ void idRenderModelMD5::LoadModel() {
 	}
 	purged = false;
 
+	// set the timestamp for reloadmodels
+	fileSystem->ReadFile( name, NULL, &timeStamp );
+
+	if ( LoadBinaryModel( timeStamp ) ) {
+		return;
+	}
+
 	if ( !parser.LoadFile( name ) ) {
 		MakeDefaultModel();
 		return;
@@ -565,6 +854,7 @@ void idRenderModelMD5::LoadModel() {
 	defaultPose.SetGranularity( 1 );
 	defaultPose.SetNum( num );
 	// jmarshall
+	Mem_Free16( poseMat3 );
 	poseMat3 = ( idJointMat * )Mem_Alloc16( num * sizeof( *poseMat3 ) );
 	// jmarshall end
 
@@ -606,8 +896,87 @@ void idRenderModelMD5::LoadModel() {
 	//
 	CalculateBounds( poseMat3 );
 
-	// set the timestamp for reloadmodels
-	fileSystem->ReadFile( name, NULL, &timeStamp );
+	WriteBinaryModel( timeStamp );
+}
+
+/*
+====================
+idRenderModelMD5::ReadBinaryModelFile
+====================
+*/
+bool idRenderModelMD5::ReadBinaryModelFile( idFile *file ) {
+	int numJoints = 0;
+	int numMeshes = 0;
+	int i;
+
+	if ( file->ReadInt( numJoints ) != sizeof( numJoints ) || numJoints < 0 || numJoints * (int)sizeof( idJointMat ) > file->Length() ) {
+		return false;
+	}
+
+	joints.SetGranularity( 1 );
+	joints.SetNum( numJoints );
+	defaultPose.SetGranularity( 1 );
+	defaultPose.SetNum( numJoints );
+
+	for ( i = 0; i < numJoints; i++ ) {
+		int parentNum = -1;
+		file->ReadString( joints[i].name );
+		file->ReadInt( parentNum );
+		if ( parentNum >= numJoints ) {
+			PurgeModel();
+			return false;
+		}
+		joints[i].parent = ( parentNum < 0 ) ? NULL : &joints[parentNum];
+	}
+	file->Read( defaultPose.Ptr(), numJoints * sizeof( defaultPose[0] ) );
+
+	Mem_Free16( poseMat3 );
+	poseMat3 = ( idJointMat * )Mem_Alloc16( numJoints * sizeof( *poseMat3 ) );
+	file->Read( poseMat3, numJoints * sizeof( *poseMat3 ) );
+
+	if ( file->ReadInt( numMeshes ) != sizeof( numMeshes ) || numMeshes < 0 || numMeshes > file->Length() ) {
+		PurgeModel();
+		return false;
+	}
+
+	meshes.SetGranularity( 1 );
+	meshes.SetNum( numMeshes );
+	for ( i = 0; i < numMeshes; i++ ) {
+		if ( !meshes[i].ReadBinary( file, numJoints ) ) {
+			PurgeModel();
+			return false;
+		}
+	}
+
+	file->ReadVec3( bounds[0] );
+	file->ReadVec3( bounds[1] );
+
+	return true;
+}
+
+/*
+====================
+idRenderModelMD5::WriteBinaryModelFile
+====================
+*/
+void idRenderModelMD5::WriteBinaryModelFile( idFile *file ) const {
+	int i;
+
+	file->WriteInt( joints.Num() );
+	for ( i = 0; i < joints.Num(); i++ ) {
+		file->WriteString( joints[i].name );
+		file->WriteInt( joints[i].parent ? joints[i].parent - joints.Ptr() : -1 );
+	}
+	file->Write( defaultPose.Ptr(), defaultPose.Num() * sizeof( defaultPose[0] ) );
+	file->Write( poseMat3, joints.Num() * sizeof( *poseMat3 ) );
+
+	file->WriteInt( meshes.Num() );
+	for ( i = 0; i < meshes.Num(); i++ ) {
+		meshes[i].WriteBinary( file );
+	}
+
+	file->WriteVec3( bounds[0] );
+	file->WriteVec3( bounds[1] );
 }
 
 /*
@@ -751,6 +1120,198 @@ void idRenderModelMD5::DrawJoints( const renderEntity_t *ent, const struct viewD
 	}
 }
 
+/***********************************************************************
+
+	Parallel skinning
+
+***********************************************************************/
+
+typedef struct {
+	const idMD5Mesh *		mesh;
+	srfTriangles_t *		tri;
+	const idJointMat *		joints;
+	float					skinScale;
+	bool					deriveTangents;
+	int						tangentIndexes;		// added to tr.pc by R_EndParallelSkinning
+} skinningJob_t;
+
+static idParallelJobList				skinningJobList( "skinning" );
+static idList<skinningJob_t>			skinningJobs;
+static idList<idRenderModelStatic *>	skinnedModels;
+static bool								skinningActive = false;
+
+/*
+====================
+R_SkinningJob
+====================
+*/
+static void R_SkinningJob( void *data ) {
+	skinningJob_t *job = static_cast<skinningJob_t *>( data );
+	job->mesh->SkinSurface( job->tri, job->joints, job->skinScale, job->deriveTangents, &job->tangentIndexes );
+}
+
+/*
+====================
+R_BeginParallelSkinning
+
+While active, idMD5Mesh::UpdateSurface only sets up the surfaces and queues the
+vertex transforms, which are run by R_EndParallelSkinning.
+====================
+*/
+void R_BeginParallelSkinning( void ) {
+	assert( !skinningActive );
+	skinningJobs.SetNum( 0, false );
+	skinnedModels.SetNum( 0, false );
+	skinningActive = true;
+}
+
+/*
+====================
+R_ParallelSkinningActive
+====================
+*/
+bool R_ParallelSkinningActive( void ) {
+	return skinningActive;
+}
+
+/*
+====================
+R_AddSkinningJob
+====================
+*/
+void R_AddSkinningJob( const idMD5Mesh *mesh, srfTriangles_t *tri, const idJointMat *joints, float skinScale, bool deriveTangents ) {
+	assert( skinningActive );
+	skinningJob_t &job = skinningJobs.Alloc();
+	job.mesh = mesh;
+	job.tri = tri;
+	job.joints = joints;
+	job.skinScale = skinScale;
+	job.deriveTangents = deriveTangents;
+	job.tangentIndexes = 0;
+}
+
+/*
+====================
+R_AddSkinnedModel
+
+The bounds of the model are calculated when the skinning has finished.
+====================
+*/
+void R_AddSkinnedModel( idRenderModelStatic *model ) {
+	assert( skinningActive );
+	skinnedModels.Append( model );
+}
+
+/*
+====================
+R_EndParallelSkinning
+====================
+*/
+void R_EndParallelSkinning( void ) {
+	int i, j;
+
+	assert( skinningActive );
+	skinningActive = false;
+
+	// the job list is filled after all jobs are queued so the pointers stay valid
+	for ( i = 0; i < skinningJobs.Num(); i++ ) {
+		skinningJobList.AddJob( R_SkinningJob, &skinningJobs[i] );
+		tr.pc.c_skinningJobVerts += skinningJobs[i].tri->numVerts;
+	}
+	tr.pc.c_skinningJobs += skinningJobs.Num();
+
+	skinningJobList.Submit();
+	skinningJobList.Wait();
+
+	for ( i = 0; i < skinningJobs.Num(); i++ ) {
+		tr.pc.c_tangentIndexes += skinningJobs[i].tangentIndexes;
+	}
+
+	for ( i = 0; i < skinnedModels.Num(); i++ ) {
+		idRenderModelStatic *model = skinnedModels[i];
+		model->bounds.Clear();
+		for ( j = 0; j < model->surfaces.Num(); j++ ) {
+			const modelSurface_t *surf = &model->surfaces[j];
+			if ( surf->id < 0 || surf->geometry == NULL ) {
+				continue;
+			}
+			model->bounds.AddPoint( surf->geometry->bounds[0] );
+			model->bounds.AddPoint( surf->geometry->bounds[1] );
+		}
+	}
+
+	skinningJobs.SetNum( 0, false );
+	skinnedModels.SetNum( 0, false );
+}
+
+/***********************************************************************
+
+	GPU skinning
+
+***********************************************************************/
+
+/*
+====================
+R_UseGPUSkinning
+====================
+*/
+bool R_UseGPUSkinning( void ) {
+	return r_useGPUSkinning.GetBool() && skinningProgram != NULL && skinningProgram->IsLoaded();
+}
+
+/*
+====================
+R_SkinVertsOnCPU
+
+Fills in the cpu side vertexes of a gpu skinned surface for stencil shadows,
+traces, overlays and decals. The normals and tangents are left alone, the ambientCache has them.
+====================
+*/
+void R_SkinVertsOnCPU( const srfTriangles_t *tri ) {
+	if ( tri == NULL || tri->gpuSkinnedMesh == NULL || tri->gpuSkinnedVertsValid ) {
+		return;
+	}
+
+	srfTriangles_t *skinTri = const_cast<srfTriangles_t *>( tri );
+	tri->gpuSkinnedMesh->SkinSurface( skinTri, tri->gpuSkinnedJoints, 0.0f, false );
+	skinTri->gpuSkinnedVertsValid = true;
+	// the face planes are derived from the new vertexes when needed
+	skinTri->facePlanesCalculated = false;
+}
+
+/*
+====================
+idRenderModelMD5::AddGPUSkinningPalette
+
+Appends the skinning matrices of the entity to tr.gpuSkinningJoints, which
+transform from the bind pose instead of the joint space of the weights.
+====================
+*/
+int idRenderModelMD5::AddGPUSkinningPalette( const idJointMat *entJoints ) {
+	int i;
+
+	if ( inverseBindPose.Num() != joints.Num() ) {
+		inverseBindPose.SetNum( joints.Num() );
+		for ( i = 0; i < joints.Num(); i++ ) {
+			inverseBindPose[i].SetRotation( mat3_identity );
+			inverseBindPose[i].SetTranslation( vec3_origin );
+			inverseBindPose[i] /= poseMat3[i];
+		}
+	}
+
+	// align the palette so it can be bound as a uniform buffer range
+	const int firstJoint = ( tr.gpuSkinningJoints.Num() + GPU_SKINNING_PALETTE_ALIGN - 1 ) & ~( GPU_SKINNING_PALETTE_ALIGN - 1 );
+	tr.gpuSkinningJoints.AssureSize( firstJoint + joints.Num() );
+
+	idJointMat *palette = &tr.gpuSkinningJoints[firstJoint];
+	for ( i = 0; i < joints.Num(); i++ ) {
+		palette[i] = inverseBindPose[i];
+		palette[i] *= entJoints[i];
+	}
+
+	return firstJoint;
+}
+
 /*
 ====================
 idRenderModelMD5::InstantiateDynamicModel
@@ -837,6 +1398,12 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 	}
 	// jmarshall end
 
+	// without an entity there are no bounds to use for the gpu skinned surfaces,
+	// and the fat / skinny scaling is only done on the cpu
+	const bool gpuSkinning = ent != nullptr && R_UseGPUSkinning() && joints.Num() <= MAX_GPU_SKINNING_JOINTS
+								&& ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] == 0.0f;
+	int gpuFirstJoint = -1;
+
 	// create all the surfaces
 	for( mesh = meshes.Ptr(), i = 0; i < meshes.Num(); i++, mesh++ ) {
 		// avoid deforming the surface if it will be a nodraw due to a skin remapping
@@ -873,6 +1440,20 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 			surf->id = i;
 		}
 
+		// deforms and guis need the vertexes on the cpu
+		if ( gpuSkinning && shader->Deform() == DFRM_NONE && !shader->HasGui() ) {
+			const idJointMat *entJoints = ent->HasValidJoints() ? ent->joints : &poseMat3[ 0 ];
+			if ( gpuFirstJoint < 0 ) {
+				// the palette is shared by all meshes of the entity
+				gpuFirstJoint = AddGPUSkinningPalette( entJoints );
+			}
+			if ( mesh->UpdateSurfaceGPU( entJoints, joints.Num(), &poseMat3[ 0 ], gpuFirstJoint, Bounds( ent ), surf ) ) {
+				staticModel->bounds.AddPoint( surf->geometry->bounds[0] );
+				staticModel->bounds.AddPoint( surf->geometry->bounds[1] );
+				continue;
+			}
+		}
+
 		//mesh->UpdateSurface( ent, ent->joints, surf );
 
 		// jmarshall - md5mesh without animation
@@ -893,10 +1474,19 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 		}
 		// jmarshall end
 
+		if ( R_ParallelSkinningActive() ) {
+			// the surface bounds aren't known until the skinning job has run
+			continue;
+		}
+
 		staticModel->bounds.AddPoint( surf->geometry->bounds[0] );
 		staticModel->bounds.AddPoint( surf->geometry->bounds[1] );
 	}
 
+	if ( R_ParallelSkinningActive() ) {
+		R_AddSkinnedModel( staticModel );
+	}
+
 	return staticModel;
 }
 
@@ -1020,6 +1610,21 @@ void idRenderModelMD5::PurgeModel() {
 	joints.Clear();
 	defaultPose.Clear();
 	meshes.Clear();
+	inverseBindPose.Clear();
+}
+
+/*
+===================
+idRenderModelMD5::FreeVertexCache
+
+the gpu skinning caches of the meshes are recreated on the next use
+===================
+*/
+void idRenderModelMD5::FreeVertexCache() {
+	for ( int i = 0; i < meshes.Num(); i++ ) {
+		meshes[i].FreeGPUSkinningCaches();
+	}
+	idRenderModelStatic::FreeVertexCache();
 }
 
 /*
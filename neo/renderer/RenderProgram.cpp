@@ -69,6 +69,17 @@ const fhRenderProgram* bloomProgram = nullptr;
 const fhRenderProgram* blurProgram = nullptr;
 const fhRenderProgram* brightnessGammaProgram = nullptr;
 const fhRenderProgram* rtcmProgram = nullptr;
+const fhRenderProgram* skinningProgram = nullptr;
+
+// output of skinning.vp, must match the member order of idDrawVert
+static const char* const skinningFeedbackVaryings[] = {
+	"skinned_xyz",
+	"skinned_st",
+	"skinned_normal",
+	"skinned_tangent0",
+	"skinned_tangent1",
+	"skinned_color"
+};
 
 class fhParseException {
 public:
@@ -304,7 +315,7 @@ namespace {
 R_FindGlslProgram
 =================
 */
-const fhRenderProgram* R_FindGlslProgram( const char* vertexShaderName, const char* fragmentShaderName ) {
+const fhRenderProgram* R_FindGlslProgram( const char* vertexShaderName, const char* fragmentShaderName, const char* const* feedbackVaryings = nullptr, int numFeedbackVaryings = 0 ) {
 	assert( vertexShaderName && vertexShaderName[0] );
 	assert( fragmentShaderName && fragmentShaderName[0] );
 
@@ -336,14 +347,16 @@ const fhRenderProgram* R_FindGlslProgram( const char* vertexShaderName, const ch
 		return nullptr;
 	}
 
-	glslPrograms[i].Load(vertexShaderName, fragmentShaderName);
+	glslPrograms[i].Load(vertexShaderName, fragmentShaderName, feedbackVaryings, numFeedbackVaryings);
 
 	return &glslPrograms[i];
 }
 
 
 fhRenderProgram::fhRenderProgram()
-: ident(0) {
+: ident(0)
+, feedbackVaryings(nullptr)
+, numFeedbackVaryings(0) {
 	vertexShaderName[0] = '\0';
 	fragmentShaderName[0] = '\0';
 }
@@ -351,13 +364,15 @@ fhRenderProgram::fhRenderProgram()
 fhRenderProgram::~fhRenderProgram() {
 }
 
-void fhRenderProgram::Load( const char* vs, const char* fs ) {
+void fhRenderProgram::Load( const char* vs, const char* fs, const char* const* varyings, int numVaryings ) {
 	const int vsLen = Min( strlen( vs ), sizeof(vertexShaderName)-1 );
 	const int fsLen = Min( strlen( fs ), sizeof(fragmentShaderName)-1 );
 	strncpy( vertexShaderName, vs, vsLen );
 	strncpy( fragmentShaderName, fs, fsLen );
 	vertexShaderName[vsLen] = '\0';
 	fragmentShaderName[fsLen] = '\0';
+	feedbackVaryings = varyings;
+	numFeedbackVaryings = numVaryings;
 	Load();
 }
 
@@ -386,6 +401,11 @@ void fhRenderProgram::Load() {
 
 	vertexShader.attachToProgram( program );
 	fragmentShader.attachToProgram( program );
+
+	if (feedbackVaryings && numFeedbackVaryings > 0) {
+		glTransformFeedbackVaryings( program, numFeedbackVaryings, feedbackVaryings, GL_INTERLEAVED_ATTRIBS );
+	}
+
 	glLinkProgram( program );
 
 	GLint isLinked = 0;
@@ -455,6 +475,11 @@ void fhRenderProgram::Load() {
 		uniformLocations[fhUniform::ShadowMapSize] = glGetUniformLocation( program, "rpShadowMapSize" );
 		uniformLocations[fhUniform::InverseLightRotation] = glGetUniformLocation( program, "rpInverseLightRotation" );
 		uniformLocations[fhUniform::NormalMapEncoding] = glGetUniformLocation( program, "rpNormalMapEncoding" );
+
+		const GLuint jointBlock = glGetUniformBlockIndex( program, "rpJointBlock" );
+		if (jointBlock != GL_INVALID_INDEX) {
+			glUniformBlockBinding( program, jointBlock, uniform_block_joints );
+		}
 	} else {
 		for(int i=0; i<fhUniform::NUM; ++i) {
 			uniformLocations[i] = -1;
@@ -552,4 +577,5 @@ void fhRenderProgram::Init() {
 	brightnessGammaProgram = R_FindGlslProgram("postprocess.vp", "brightnessGamma.fp");
 
 	rtcmProgram = R_FindGlslProgram( "rtcm.vp", "rtcm.fp" );
+	skinningProgram = R_FindGlslProgram( "skinning.vp", "skinning.fp", skinningFeedbackVaryings, sizeof( skinningFeedbackVaryings ) / sizeof( skinningFeedbackVaryings[0] ) );
 }
\ No newline at end of file
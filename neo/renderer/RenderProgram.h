@@ -103,6 +103,11 @@ public:
 	static const int vertex_attrib_binormal = 4;
 	static const int vertex_attrib_tangent = 5;
 	static const int vertex_attrib_position_shadow = 6;
+	static const int vertex_attrib_jointIndexes = 7;
+	static const int vertex_attrib_jointWeights = 8;
+	static const int num_vertex_attribs = 9;
+
+	static const int uniform_block_joints = 0;
 
 	static const int normal_map_encoding_rgb = 0;
 	static const int normal_map_encoding_dxrg = 1;
@@ -113,7 +118,7 @@ public:
 	fhRenderProgram();
 	~fhRenderProgram();
 
-	void Load(const char* vertexShader, const char* fragmentShader);
+	void Load(const char* vertexShader, const char* fragmentShader, const char* const* feedbackVaryings = nullptr, int numFeedbackVaryings = 0);
 	void Reload();
 	void Purge();
 	bool IsLoaded() const { return ident != 0; }
@@ -196,6 +201,9 @@ private:
 	char   fragmentShaderName[64];
 	GLuint ident;
 	GLint  uniformLocations[fhUniform::NUM];
+
+	const char* const* feedbackVaryings;	// captured with GL_INTERLEAVED_ATTRIBS if not null
+	int    numFeedbackVaryings;
 };
 
 extern const fhRenderProgram* shadowProgram;
@@ -218,6 +226,7 @@ extern const fhRenderProgram* blurProgram;
 extern const fhRenderProgram* brightnessGammaProgram;
 
 extern const fhRenderProgram* rtcmProgram;
+extern const fhRenderProgram* skinningProgram;
 
 
 ID_INLINE void fhRenderProgram::SetModelMatrix( const float* m ) {
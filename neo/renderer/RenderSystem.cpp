@@ -72,13 +72,17 @@ static void R_PerformanceCounters( void ) {
 	}
 
 	if ( r_showDynamic.GetBool() ) {
-		common->Printf( "callback:%i md5:%i dfrmVerts:%i dfrmTris:%i tangTris:%i guis:%i\n",
+		common->Printf( "callback:%i md5:%i dfrmVerts:%i dfrmTris:%i tangTris:%i guis:%i skinJobs:%i skinVerts:%i gpuSkin:%i gpuSkinVerts:%i\n",
 			tr.pc.c_entityDefCallbacks,
 			tr.pc.c_generateMd5,
 			tr.pc.c_deformedVerts,
 			tr.pc.c_deformedIndexes/3,
 			tr.pc.c_tangentIndexes/3,
-			tr.pc.c_guiSurfs
+			tr.pc.c_guiSurfs,
+			tr.pc.c_skinningJobs,
+			tr.pc.c_skinningJobVerts,
+			tr.pc.c_gpuSkinnedSurfaces,
+			tr.pc.c_gpuSkinnedVerts
 			);
 	}
 
@@ -685,6 +689,11 @@ frameInfo_t idRenderSystemLocal::LocalEndFrame() {
 	// may still be rendering into the current buffers
 	R_ToggleSmpFrame();
 
+	// the back end has consumed the gpu skinning requests, anything left
+	// refers to vertex caches that are released now
+	tr.gpuSkinnedSurfaces.SetNum( 0, false );
+	tr.gpuSkinningJoints.SetNum( 0, false );
+
 	// we can now release the vertexes used this frame
 	vertexCache.EndFrame();
 
@@ -71,6 +71,9 @@ idCVar r_useTurboShadow( "r_useTurboShadow", "1", CVAR_RENDERER | CVAR_BOOL, "us
 idCVar r_useTwoSidedStencil( "r_useTwoSidedStencil", "1", CVAR_RENDERER | CVAR_BOOL, "do stencil shadows in one pass with different ops on each side" );
 idCVar r_useDeferredTangents( "r_useDeferredTangents", "1", CVAR_RENDERER | CVAR_BOOL, "defer tangents calculations after deform" );
 idCVar r_useCachedDynamicModels( "r_useCachedDynamicModels", "1", CVAR_RENDERER | CVAR_BOOL, "cache snapshots of dynamic models" );
+idCVar r_parallelSkinning( "r_parallelSkinning", "1", CVAR_RENDERER | CVAR_BOOL, "skin visible md5 meshes with parallel jobs" );
+idCVar r_useGPUSkinning( "r_useGPUSkinning", "1", CVAR_RENDERER | CVAR_BOOL, "skin md5 meshes in a vertex program, the cpu only skins them for stencil shadows, traces and decals" );
+idCVar r_binaryProc( "r_binaryProc", "1", CVAR_RENDERER | CVAR_BOOL, "load the binary .bproc written by dmap instead of parsing the .proc" );
 
 idCVar r_useIndexBuffers( "r_useIndexBuffers", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "use ARB_vertex_buffer_object for indexes", 0, 1, idCmdSystem::ArgCompletion_Integer<0,1>  );
 
@@ -1968,6 +1971,7 @@ void R_VidRestart_f( const idCmdArgs &args ) {
 		globalImages->PurgeAllImages();
 		fhSampler::PurgeAll();
 		fhRenderProgram::PurgeAll();
+		RB_PurgeGPUSkinning();
 		// free the context and close the window
 		GLimp_Shutdown();
 		glConfig.isInitialized = false;
@@ -2198,6 +2202,7 @@ void idRenderSystemLocal::Shutdown( void ) {
 
 	if ( glConfig.isInitialized ) {
 		fhRenderProgram::PurgeAll();
+		RB_PurgeGPUSkinning();
 		fhFramebuffer::PurgeAll();
 		fhSampler::PurgeAll();
 		globalImages->PurgeAllImages();
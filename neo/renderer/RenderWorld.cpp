@@ -138,6 +138,7 @@ idRenderWorldLocal::idRenderWorldLocal() {
 
 	doublePortals = NULL;
 	numInterAreaPortals = 0;
+	portalStateGeneration = 0;
 
 	interactionTable = 0;
 	interactionTableWidth = 0;
@@ -43,6 +43,9 @@ If you have questions concerning this license or the applicable additional terms
 #define OCL_FILE_EXT				"ocl"
 #define	OCL_FILE_ID					"mapOclFile002"
 
+// binary version of the .proc, written by dmap with the "binary" option
+#define BPROC_FILE_EXT				"bproc"
+
 // shader parms
 const int MAX_GLOBAL_SHADER_PARMS	= 12;
 
@@ -366,6 +369,10 @@ public:
 	virtual	void			SetPortalState( qhandle_t portal, int blockingBits ) = 0;
 	virtual int				GetPortalState( qhandle_t portal ) = 0;
 
+	// incremented whenever any portal state changes or the portals are reset on
+	// map load, so systems that cache portal floods know when to rebuild them
+	virtual int				GetPortalStateGeneration( void ) const = 0;
+
 	// returns true only if a chain of portals without the given connection bits set
 	// exists between the two areas (a door doesn't separate them, etc)
 	virtual	bool			AreasAreConnected( int areaNum1, int areaNum2, portalConnection_t connection ) = 0;
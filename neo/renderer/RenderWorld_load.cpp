@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #pragma hdrstop
 
 #include "tr_local.h"
+#include "Model_local.h"
 
 
 /*
@@ -367,7 +368,6 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src ) {
 	for ( i = 0 ; i < numInterAreaPortals ; i++ ) {
 		int		numPoints, a1, a2;
 		idWinding	*w;
-		portal_t	*p;
 
 		numPoints = src->ParseInt();
 		a1 = src->ParseInt();
@@ -382,32 +382,45 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src ) {
 			(*w)[j][4] = 0;
 		}
 
-		// add the portal to a1
-		p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
-		p->intoArea = a2;
-		p->doublePortal = &doublePortals[i];
-		p->w = w;
-		p->w->GetPlane( p->plane );
+		AddInterAreaPortal( i, a1, a2, w );
+	}
 
-		p->next = portalAreas[a1].portals;
-		portalAreas[a1].portals = p;
+	src->ExpectTokenString( "}" );
+}
 
-		doublePortals[i].portals[0] = p;
+/*
+================
+idRenderWorldLocal::AddInterAreaPortal
 
-		// reverse it for a2
-		p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
-		p->intoArea = a1;
-		p->doublePortal = &doublePortals[i];
-		p->w = w->Reverse();
-		p->w->GetPlane( p->plane );
+Links the winding into both areas, the world takes ownership of it
+================
+*/
+void idRenderWorldLocal::AddInterAreaPortal( int portalNum, int a1, int a2, idWinding *w ) {
+	portal_t	*p;
 
-		p->next = portalAreas[a2].portals;
-		portalAreas[a2].portals = p;
+	// add the portal to a1
+	p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
+	p->intoArea = a2;
+	p->doublePortal = &doublePortals[portalNum];
+	p->w = w;
+	p->w->GetPlane( p->plane );
 
-		doublePortals[i].portals[1] = p;
-	}
+	p->next = portalAreas[a1].portals;
+	portalAreas[a1].portals = p;
 
-	src->ExpectTokenString( "}" );
+	doublePortals[portalNum].portals[0] = p;
+
+	// reverse it for a2
+	p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
+	p->intoArea = a1;
+	p->doublePortal = &doublePortals[portalNum];
+	p->w = w->Reverse();
+	p->w->GetPlane( p->plane );
+
+	p->next = portalAreas[a2].portals;
+	portalAreas[a2].portals = p;
+
+	doublePortals[portalNum].portals[1] = p;
 }
 
 /*
@@ -576,7 +589,7 @@ bool idRenderWorldLocal::LoadProc(const char* name) {
 	// if we are reloading the same map, check the timestamp
 	// and try to skip all the work
 	ID_TIME_T currentTimeStamp;
-	fileSystem->ReadFile( filename, NULL, &currentTimeStamp );
+	int procLength = fileSystem->ReadFile( filename, NULL, &currentTimeStamp );
 
 	if (name == mapName) {
 		if (currentTimeStamp != FILE_NOT_FOUND_TIMESTAMP && currentTimeStamp == mapTimeStamp) {
@@ -592,8 +605,13 @@ bool idRenderWorldLocal::LoadProc(const char* name) {
 
 	FreeWorld();
 
-	idLexer src( filename, LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
-	if (!src.IsLoaded()) {
+	// a binary proc written by dmap for this exact .proc skips all the parsing
+	idStr binaryName = filename;
+	binaryName.SetFileExtension( BPROC_FILE_EXT );
+	const bool binaryLoaded = LoadBinaryProc( binaryName, procLength, currentTimeStamp );
+
+	idLexer src( LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
+	if (!binaryLoaded && !src.LoadFile( filename )) {
 		common->Printf( "idRenderWorldLocal::LoadProc: %s not found\n", filename.c_str() );
 		ClearWorld();
 		return false;
@@ -608,13 +626,13 @@ bool idRenderWorldLocal::LoadProc(const char* name) {
 	}
 
 	idToken token;
-	if (!src.ReadToken( &token ) || token.Icmp( PROC_FILE_ID )) {
+	if (!binaryLoaded && (!src.ReadToken( &token ) || token.Icmp( PROC_FILE_ID ))) {
 		common->Printf( "idRenderWorldLocal::LoadProc: bad id '%s' instead of '%s'\n", token.c_str(), PROC_FILE_ID );
 		return false;
 	}
 
 	// parse the file
-	while (1) {
+	while (!binaryLoaded) {
 		if (!src.ReadToken( &token )) {
 			break;
 		}
@@ -669,6 +687,205 @@ bool idRenderWorldLocal::LoadProc(const char* name) {
 	return true;
 }
 
+/*
+===============================================================================
+
+	Binary proc files
+
+	Same content as the .proc after parsing and FinishSurfaces, so loading is
+	one file read plus the area/portal linking. Only used while the .proc
+	it was written from is unchanged.
+
+===============================================================================
+*/
+
+static const int	BPROC_FILE_MAGIC	= ( 'B' << 24 ) | ( 'P' << 16 ) | ( 'R' << 8 ) | 'C';
+static const int	BPROC_FILE_VERSION	= 1;
+
+/*
+=====================
+idRenderWorldLocal::LoadBinaryProc
+
+Returns false if there is no binary proc for this .proc, in which case
+the world is left empty for the text parser.
+=====================
+*/
+bool idRenderWorldLocal::LoadBinaryProc( const char *fileName, int procLength, ID_TIME_T procTimeStamp ) {
+	if ( !r_binaryProc.GetBool() || procTimeStamp == FILE_NOT_FOUND_TIMESTAMP ) {
+		return false;
+	}
+
+	void *buffer = NULL;
+	int length = fileSystem->ReadFile( fileName, &buffer );
+	if ( length <= 0 || buffer == NULL ) {
+		return false;
+	}
+
+	idFile_Memory file( fileName, (const char *)buffer, length );
+
+	int magic = 0, version = 0, vertSize = 0, indexSize = 0, cachedLength = 0;
+	unsigned int cachedTimeStamp = 0;
+	file.ReadInt( magic );
+	file.ReadInt( version );
+	file.ReadInt( vertSize );
+	file.ReadInt( indexSize );
+	file.ReadInt( cachedLength );
+	file.ReadUnsignedInt( cachedTimeStamp );
+
+	bool valid = magic == BPROC_FILE_MAGIC && version == BPROC_FILE_VERSION &&
+				vertSize == sizeof( idDrawVert ) && indexSize == sizeof( glIndex_t ) &&
+				cachedLength == procLength && cachedTimeStamp == (unsigned int)procTimeStamp;
+
+	// area and shadow models
+	int numModels = 0;
+	valid = valid && file.ReadInt( numModels ) == sizeof( numModels ) && numModels >= 0;
+	for ( int i = 0; valid && i < numModels; i++ ) {
+		idStr modelName;
+		file.ReadString( modelName );
+
+		idRenderModelStatic *model = static_cast<idRenderModelStatic *>( renderModelManager->AllocModel() );
+		model->InitEmpty( modelName );
+		if ( !model->ReadBinaryModelFile( &file ) ) {
+			delete model;
+			valid = false;
+			break;
+		}
+
+		// the text parser references the materials of the area surfaces
+		for ( int j = 0; j < model->NumSurfaces(); j++ ) {
+			const modelSurface_t *surf = model->Surface( j );
+			if ( surf->geometry->verts != NULL ) {
+				const_cast<idMaterial *>( surf->shader )->AddReference();
+			}
+		}
+
+		renderModelManager->AddModel( model );
+		localModels.Append( model );
+	}
+
+	// inter area portals
+	int numAreas = 0, numPortals = 0;
+	valid = valid && file.ReadInt( numAreas ) == sizeof( numAreas ) && numAreas >= 0;
+	valid = valid && file.ReadInt( numPortals ) == sizeof( numPortals ) && numPortals >= 0;
+	if ( valid && numAreas > 0 ) {
+		numPortalAreas = numAreas;
+		portalAreas = (portalArea_t *)R_ClearedStaticAlloc( numPortalAreas * sizeof( portalAreas[0] ) );
+		areaScreenRect = (idScreenRect *) R_ClearedStaticAlloc( numPortalAreas * sizeof( idScreenRect ) );
+		SetupAreaRefs();
+
+		numInterAreaPortals = numPortals;
+		doublePortals = (doublePortal_t *)R_ClearedStaticAlloc( numInterAreaPortals * sizeof( doublePortals[0] ) );
+	}
+	for ( int i = 0; valid && i < numPortals; i++ ) {
+		int numPoints = 0, a1 = 0, a2 = 0;
+		file.ReadInt( numPoints );
+		file.ReadInt( a1 );
+		file.ReadInt( a2 );
+		if ( numPoints < 3 || a1 < 0 || a1 >= numAreas || a2 < 0 || a2 >= numAreas ) {
+			valid = false;
+			break;
+		}
+
+		idWinding *w = new idWinding( numPoints );
+		w->SetNumPoints( numPoints );
+		for ( int j = 0; j < numPoints; j++ ) {
+			idVec3 point;
+			file.ReadVec3( point );
+			(*w)[j] = idVec5( point, idVec2( 0.0f, 0.0f ) );
+		}
+		AddInterAreaPortal( i, a1, a2, w );
+	}
+
+	// area nodes
+	int numNodes = 0;
+	valid = valid && file.ReadInt( numNodes ) == sizeof( numNodes ) && numNodes >= 0;
+	if ( valid && numNodes > 0 ) {
+		numAreaNodes = numNodes;
+		areaNodes = (areaNode_t *)R_ClearedStaticAlloc( numAreaNodes * sizeof( areaNodes[0] ) );
+	}
+	for ( int i = 0; valid && i < numNodes; i++ ) {
+		areaNode_t *node = &areaNodes[i];
+
+		file.ReadVec4( *reinterpret_cast<idVec4 *>( node->plane.ToFloatPtr() ) );
+		file.ReadInt( node->children[0] );
+		file.ReadInt( node->children[1] );
+
+		for ( int j = 0; j < 2; j++ ) {
+			const int child = node->children[j];
+			if ( child > 0 ? child >= numNodes : -1 - child >= numAreas ) {
+				valid = false;
+			}
+		}
+	}
+
+	valid = valid && file.Tell() == file.Length();
+
+	fileSystem->FreeFile( buffer );
+
+	if ( !valid ) {
+		common->DPrintf( "discarding invalid binary proc '%s'\n", fileName );
+		FreeWorld();
+		return false;
+	}
+
+	common->Printf( "idRenderWorldLocal::LoadProc: loaded binary %s\n", fileName );
+	return true;
+}
+
+/*
+=====================
+idRenderWorldLocal::WriteBinaryProc
+
+Must be called right after the .proc was loaded, before LoadOcl adds the occluders.
+=====================
+*/
+bool idRenderWorldLocal::WriteBinaryProc( const char *fileName, int procLength, ID_TIME_T procTimeStamp ) const {
+	idFile *file = fileSystem->OpenFileWrite( fileName, "fs_devpath" );
+	if ( !file ) {
+		common->Warning( "Error opening %s", fileName );
+		return false;
+	}
+
+	file->WriteInt( BPROC_FILE_MAGIC );
+	file->WriteInt( BPROC_FILE_VERSION );
+	file->WriteInt( sizeof( idDrawVert ) );
+	file->WriteInt( sizeof( glIndex_t ) );
+	file->WriteInt( procLength );
+	file->WriteUnsignedInt( (unsigned int)procTimeStamp );
+
+	file->WriteInt( localModels.Num() );
+	for ( int i = 0; i < localModels.Num(); i++ ) {
+		const idRenderModelStatic *model = static_cast<const idRenderModelStatic *>( localModels[i] );
+		file->WriteString( model->Name() );
+		model->WriteBinaryModelFile( file );
+	}
+
+	file->WriteInt( numPortalAreas );
+	file->WriteInt( numInterAreaPortals );
+	for ( int i = 0; i < numInterAreaPortals; i++ ) {
+		const portal_t *p = doublePortals[i].portals[0];
+		const idWinding *w = p->w;
+
+		file->WriteInt( w->GetNumPoints() );
+		file->WriteInt( doublePortals[i].portals[1]->intoArea );
+		file->WriteInt( p->intoArea );
+		for ( int j = 0; j < w->GetNumPoints(); j++ ) {
+			file->WriteVec3( (*w)[j].ToVec3() );
+		}
+	}
+
+	file->WriteInt( numAreaNodes );
+	for ( int i = 0; i < numAreaNodes; i++ ) {
+		const areaNode_t *node = &areaNodes[i];
+		file->WriteVec4( *reinterpret_cast<const idVec4 *>( node->plane.ToFloatPtr() ) );
+		file->WriteInt( node->children[0] );
+		file->WriteInt( node->children[1] );
+	}
+
+	fileSystem->CloseFile( file );
+	return true;
+}
+
 /*
 =====================
 idRenderWorldLocal::LoadOcl
@@ -742,6 +959,7 @@ void idRenderWorldLocal::ClearPortalStates() {
 	for ( i = 0 ; i < numInterAreaPortals ; i++ ) {
 		doublePortals[i].blockingBits = PS_BLOCK_NONE;
 	}
+	portalStateGeneration++;
 
 	// flood fill all area connections
 	for ( i = 0 ; i < numPortalAreas ; i++ ) {
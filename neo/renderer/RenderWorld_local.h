@@ -143,6 +143,7 @@ public:
 	portalArea_t *			portalAreas;
 	int						numPortalAreas;
 	int						connectedAreaNum;		// incremented every time a door portal state changes
+	int						portalStateGeneration;	// incremented every time any portal state changes
 
 	idScreenRect *			areaScreenRect;
 
@@ -174,6 +175,7 @@ public:
 	// RenderWorld_load.cpp
 	void					SetupAreaRefs();
 	void					ParseInterAreaPortals( idLexer *src );
+	void					AddInterAreaPortal( int portalNum, int a1, int a2, idWinding *w );
 	void					ParseNodes( idLexer *src );
 	int						CommonChildrenArea_r( areaNode_t *node );
 	void					FreeWorld();
@@ -185,6 +187,8 @@ public:
 	virtual	bool			InitFromMap( const char *mapName );
 	bool                    LoadProc( const char* mapName );
 	bool                    LoadOcl( const char* mapName );
+	bool					LoadBinaryProc( const char *fileName, int procLength, ID_TIME_T procTimeStamp );
+	bool					WriteBinaryProc( const char *fileName, int procLength, ID_TIME_T procTimeStamp ) const;
 
 	//--------------------------
 	// RenderWorld_portals.cpp
@@ -210,6 +214,7 @@ public:
 	qhandle_t				FindPortal( const idBounds &b ) const;
 	void					SetPortalState( qhandle_t portal, int blockingBits );
 	int						GetPortalState( qhandle_t portal );
+	int						GetPortalStateGeneration( void ) const { return portalStateGeneration; }
 	bool					AreasAreConnected( int areaNum1, int areaNum2, portalConnection_t connection );
 	void					FloodConnectedAreas( portalArea_t *area, int portalAttributeIndex );
 	idScreenRect &			GetAreaScreenRect( int areaNum ) const { return areaScreenRect[areaNum]; }
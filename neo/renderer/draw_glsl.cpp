@@ -585,6 +585,76 @@ void RB_GLSL_FillDepthBuffer(drawSurf_t **drawSurfs, int numDrawSurfs) {
 	depthRenderList.Submit();
 }
 
+static GLuint gpuSkinningJointBuffer = 0;
+
+/*
+=====================
+RB_SkinGPUSurfaces
+
+Skins the md5 surfaces queued by idMD5Mesh::UpdateSurfaceGPU into their
+ambientCache with a transform feedback pass, nothing is rasterized.
+=====================
+*/
+void RB_SkinGPUSurfaces( void ) {
+	const int numSurfaces = tr.gpuSkinnedSurfaces.Num();
+	if ( !numSurfaces || !skinningProgram || !skinningProgram->IsLoaded() ) {
+		return;
+	}
+
+	if ( !gpuSkinningJointBuffer ) {
+		glGenBuffers( 1, &gpuSkinningJointBuffer );
+	}
+
+	// the buffer is padded, so every palette can be bound with the full size of the uniform block
+	const int jointBytes = tr.gpuSkinningJoints.Num() * sizeof( idJointMat );
+	const int blockBytes = MAX_GPU_SKINNING_JOINTS * sizeof( idJointMat );
+	glBindBuffer( GL_UNIFORM_BUFFER, gpuSkinningJointBuffer );
+	glBufferData( GL_UNIFORM_BUFFER, jointBytes + blockBytes, NULL, GL_STREAM_DRAW );
+	glBufferSubData( GL_UNIFORM_BUFFER, 0, jointBytes, tr.gpuSkinningJoints.Ptr() );
+
+	GL_UseProgram( skinningProgram );
+	glEnable( GL_RASTERIZER_DISCARD );
+
+	for ( int i = 0; i < numSurfaces; i++ ) {
+		const gpuSkinnedSurface_t &skin = tr.gpuSkinnedSurfaces[i];
+
+		glBindBufferRange( GL_UNIFORM_BUFFER, fhRenderProgram::uniform_block_joints, gpuSkinningJointBuffer,
+			skin.firstJoint * sizeof( idJointMat ), blockBytes );
+		glBindBufferRange( GL_TRANSFORM_FEEDBACK_BUFFER, 0, skin.output->vbo,
+			skin.output->offset, skin.numVerts * sizeof( idDrawVert ) );
+
+		const int weightOffset = vertexCache.Bind( skin.weights );
+		glVertexAttribIPointer( fhRenderProgram::vertex_attrib_jointIndexes, 4, GL_UNSIGNED_BYTE, sizeof( gpuSkinningWeight_t ),
+			reinterpret_cast<const void*>( weightOffset + offsetof( gpuSkinningWeight_t, joints ) ) );
+		glVertexAttribPointer( fhRenderProgram::vertex_attrib_jointWeights, 4, GL_UNSIGNED_BYTE, true, sizeof( gpuSkinningWeight_t ),
+			reinterpret_cast<const void*>( weightOffset + offsetof( gpuSkinningWeight_t, weights ) ) );
+
+		const int offset = vertexCache.Bind( skin.bindVerts );
+		GL_SetupVertexAttributes( fhVertexLayout::Skinning, offset );
+
+		glBeginTransformFeedback( GL_POINTS );
+		glDrawArrays( GL_POINTS, 0, skin.numVerts );
+		glEndTransformFeedback();
+	}
+
+	glDisable( GL_RASTERIZER_DISCARD );
+	glBindBufferBase( GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0 );
+	glBindBufferBase( GL_UNIFORM_BUFFER, fhRenderProgram::uniform_block_joints, 0 );
+	glBindBuffer( GL_UNIFORM_BUFFER, 0 );
+}
+
+/*
+=====================
+RB_PurgeGPUSkinning
+=====================
+*/
+void RB_PurgeGPUSkinning( void ) {
+	if ( gpuSkinningJointBuffer ) {
+		glDeleteBuffers( 1, &gpuSkinningJointBuffer );
+		gpuSkinningJointBuffer = 0;
+	}
+}
+
 /*
 =================
 R_ReloadGlslPrograms_f
@@ -74,7 +74,16 @@ static const unsigned vertexLayoutAttributes[] = {
 	//DrawPosColorTexOnly
 	(1 << fhRenderProgram::vertex_attrib_position)
 	| (1 << fhRenderProgram::vertex_attrib_texcoord)
+	| (1 << fhRenderProgram::vertex_attrib_color),
+	//Skinning
+	(1 << fhRenderProgram::vertex_attrib_position)
+	| (1 << fhRenderProgram::vertex_attrib_texcoord)
+	| (1 << fhRenderProgram::vertex_attrib_normal)
 	| (1 << fhRenderProgram::vertex_attrib_color)
+	| (1 << fhRenderProgram::vertex_attrib_binormal)
+	| (1 << fhRenderProgram::vertex_attrib_tangent)
+	| (1 << fhRenderProgram::vertex_attrib_jointIndexes)
+	| (1 << fhRenderProgram::vertex_attrib_jointWeights)
 };
 static_assert(sizeof( vertexLayoutAttributes ) / sizeof( vertexLayoutAttributes[0] ) == (size_t)fhVertexLayout::COUNT, "");
 
@@ -349,7 +358,7 @@ void GL_SetVertexLayout( fhVertexLayout layout ) {
 	const unsigned current = vertexLayoutAttributes[(int)currentVertexLayout];
 	const unsigned target = vertexLayoutAttributes[(int)layout];
 
-	for (unsigned i = 0; i < 7 ; ++i) {
+	for (unsigned i = 0; i < fhRenderProgram::num_vertex_attribs ; ++i) {
 		const unsigned bit = (1 << i);
 		const bool isEnabled = (current & bit) != 0;
 		const bool shouldBeEnabled = (target & bit) != 0;
@@ -418,6 +427,16 @@ void GL_SetupVertexAttributes( fhVertexLayout layout, int offset ) {
 		glVertexAttribPointer( fhRenderProgram::vertex_attrib_binormal, 3, GL_FLOAT, false, sizeof(idDrawVert), attributeOffset( offset, idDrawVert::binormalOffset ) );
 		glVertexAttribPointer( fhRenderProgram::vertex_attrib_tangent, 3, GL_FLOAT, false, sizeof(idDrawVert), attributeOffset( offset, idDrawVert::tangentOffset ) );
 		break;
+	case fhVertexLayout::Skinning:
+		// the weights are in a second buffer, set up by RB_SkinGPUSurfaces.
+		// the color is passed through the transform feedback unchanged, so it stays packed
+		glVertexAttribPointer( fhRenderProgram::vertex_attrib_position, 3, GL_FLOAT, false, sizeof(idDrawVert), attributeOffset( offset, idDrawVert::xyzOffset ) );
+		glVertexAttribPointer( fhRenderProgram::vertex_attrib_texcoord, 2, GL_FLOAT, false, sizeof(idDrawVert), attributeOffset( offset, idDrawVert::texcoordOffset ) );
+		glVertexAttribPointer( fhRenderProgram::vertex_attrib_normal, 3, GL_FLOAT, false, sizeof(idDrawVert), attributeOffset( offset, idDrawVert::normalOffset ) );
+		glVertexAttribIPointer( fhRenderProgram::vertex_attrib_color, 1, GL_UNSIGNED_INT, sizeof(idDrawVert), attributeOffset( offset, idDrawVert::colorOffset ) );
+		glVertexAttribPointer( fhRenderProgram::vertex_attrib_binormal, 3, GL_FLOAT, false, sizeof(idDrawVert), attributeOffset( offset, idDrawVert::binormalOffset ) );
+		glVertexAttribPointer( fhRenderProgram::vertex_attrib_tangent, 3, GL_FLOAT, false, sizeof(idDrawVert), attributeOffset( offset, idDrawVert::tangentOffset ) );
+		break;
 	case fhVertexLayout::COUNT:
 	default:
 		assert( false && "invalid vertex layout" );
@@ -1029,6 +1048,9 @@ fhFramebuffer* RB_ExecuteBackEndCommands( const emptyCommand_t *cmds ) {
 	// needed for editor rendering
 	RB_SetDefaultGLState();
 
+	// fill the vertex caches of the gpu skinned surfaces before any view uses them
+	RB_SkinGPUSurfaces();
+
 	// upload any image loads that have completed
 	globalImages->CompleteBackgroundImageLoads();
 
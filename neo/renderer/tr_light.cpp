@@ -1101,6 +1101,38 @@ bool R_IssueEntityDefCallback( idRenderEntityLocal *def ) {
 	return update;
 }
 
+/*
+===================
+R_FinishEntityDefDynamicModel
+
+Adds the overlays to a newly instantiated dynamic model snapshot.
+===================
+*/
+static void R_FinishEntityDefDynamicModel( idRenderEntityLocal *def ) {
+	if ( !def->cachedDynamicModel ) {
+		return;
+	}
+
+	// add any overlays to the snapshot of the dynamic model
+	if ( def->overlay && !r_skipOverlays.GetBool() ) {
+		def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
+	} else {
+		idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
+	}
+
+	if ( r_checkBounds.GetBool() ) {
+		idBounds b = def->cachedDynamicModel->Bounds();
+		if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
+				b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
+				b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
+				b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
+				b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
+				b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
+			common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
+		}
+	}
+}
+
 /*
 ===================
 R_EntityDefDynamicModel
@@ -1144,26 +1176,10 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 		// instantiate the snapshot of the dynamic model, possibly reusing memory from the cached snapshot
 		def->cachedDynamicModel = model->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
 
-		if ( def->cachedDynamicModel ) {
-
-			// add any overlays to the snapshot of the dynamic model
-			if ( def->overlay && !r_skipOverlays.GetBool() ) {
-				def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
-			} else {
-				idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
-			}
-
-			if ( r_checkBounds.GetBool() ) {
-				idBounds b = def->cachedDynamicModel->Bounds();
-				if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
-						b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
-						b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
-						b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
-						b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
-						b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
-					common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
-				}
-			}
+		// with parallel skinning the vertexes aren't there yet, the overlays
+		// and bounds checks are done after R_EndParallelSkinning
+		if ( !R_ParallelSkinningActive() ) {
+			R_FinishEntityDefDynamicModel( def );
 		}
 
 		def->dynamicModel = def->cachedDynamicModel;
@@ -1456,6 +1472,66 @@ idScreenRect R_CalcEntityScissorRectangle( viewEntity_t *vEntity ) {
 	return R_ScreenRectFromViewFrustumBounds( bounds );
 }
 
+/*
+===================
+R_InstantiateDynamicModels
+
+Instantiates the cached dynamic models of the visible entities up front, so
+the md5 meshes among them can be skinned as parallel jobs.  Entities in a
+time group still go through the serial path in R_AddModelSurfaces.
+===================
+*/
+static void R_InstantiateDynamicModels( void ) {
+	static idList<idRenderEntityLocal *> instantiated;
+
+	if ( !r_parallelSkinning.GetBool() || idParallelJobManager::GetNumThreads() == 0 ) {
+		return;
+	}
+
+	instantiated.SetNum( 0, false );
+
+	game->SelectTimeGroup( 0 );
+
+	R_BeginParallelSkinning();
+
+	for ( viewEntity_t* vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		idRenderEntityLocal *def = vEntity->entityDef;
+
+		if ( def->parms.timeGroup || def->dynamicModel ) {
+			continue;
+		}
+		if ( tr.viewDef->isXraySubview && def->parms.xrayIndex == 1 ) {
+			continue;
+		} else if ( !tr.viewDef->isXraySubview && def->parms.xrayIndex == 2 ) {
+			continue;
+		}
+		if ( def->parms.hModel == NULL || def->parms.hModel->IsDynamicModel() != DM_CACHED ) {
+			continue;
+		}
+
+		// only the entities that will get ambient surfaces
+		idScreenRect scissorRect = vEntity->scissorRect;
+		if ( r_useEntityScissors.GetBool() ) {
+			scissorRect.Intersect( R_CalcEntityScissorRectangle( vEntity ) );
+		}
+		if ( scissorRect.IsEmpty() ) {
+			continue;
+		}
+
+		R_EntityDefDynamicModel( def );
+
+		if ( def->dynamicModel ) {
+			instantiated.Append( def );
+		}
+	}
+
+	R_EndParallelSkinning();
+
+	for ( int i = 0; i < instantiated.Num(); i++ ) {
+		R_FinishEntityDefDynamicModel( instantiated[i] );
+	}
+}
+
 /*
 ===================
 R_AddModelSurfaces
@@ -1472,6 +1548,8 @@ void R_AddModelSurfaces( void ) {
 	tr.viewDef->numDrawSurfs = 0;
 	tr.viewDef->maxDrawSurfs = 0;	// will be set to INITIAL_DRAWSURFS on R_AddDrawSurf
 
+	R_InstantiateDynamicModels();
+
 	// go through each entity that is either visible to the view, or to
 	// any light that intersects the view (for shadows)
 	for ( viewEntity_t* vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
@@ -599,6 +599,8 @@ static const int vertex_attrib_color = 3;
 static const int vertex_attrib_binormal = 4;
 static const int vertex_attrib_tangent = 5;
 static const int vertex_attrib_position_shadow = 6;
+static const int vertex_attrib_jointIndexes = 7;
+static const int vertex_attrib_jointWeights = 8;
 
 #ifdef None
 #undef None
@@ -614,6 +616,7 @@ enum class fhVertexLayout {
 	DrawPosTexOnly,
 	DrawPosColorOnly,
 	DrawPosColorTexOnly,
+	Skinning,
 	COUNT
 };
 
@@ -676,6 +679,40 @@ bool R_GlobalShaderOverride( const idMaterial **shader );
 // this does various checks before calling the idDeclSkin
 const idMaterial *R_RemapShaderBySkin( const idMaterial *shader, const idDeclSkin *customSkin, const idMaterial *customShader );
 
+// while active, the vertex transforms of instantiated md5 meshes are queued
+// and run as parallel jobs by R_EndParallelSkinning
+class idMD5Mesh;
+class idRenderModelStatic;
+void R_BeginParallelSkinning( void );
+bool R_ParallelSkinningActive( void );
+void R_AddSkinningJob( const idMD5Mesh *mesh, srfTriangles_t *tri, const idJointMat *joints, float skinScale, bool deriveTangents );
+void R_AddSkinnedModel( idRenderModelStatic *model );
+void R_EndParallelSkinning( void );
+
+// md5 meshes skinned on the gpu only get their ambientCache allocated by the
+// front end, RB_SkinGPUSurfaces fills it with a transform feedback pass before
+// the first view of the frame is drawn
+static const int MAX_GPU_SKINNING_JOINTS = 256;		// must match skinning.vp
+static const int GPU_SKINNING_PALETTE_ALIGN = 16;	// 16 joints are 768 bytes, a multiple of any uniform buffer offset alignment
+
+typedef struct {
+	byte					joints[4];
+	byte					weights[4];			// normalized, sum up to 255
+} gpuSkinningWeight_t;
+
+typedef struct {
+	struct vertCache_s *	output;				// ambientCache of the deformed surface
+	struct vertCache_s *	bindVerts;
+	struct vertCache_s *	weights;
+	int						numVerts;
+	int						firstJoint;			// into tr.gpuSkinningJoints
+} gpuSkinnedSurface_t;
+
+bool R_UseGPUSkinning( void );
+void R_SkinVertsOnCPU( const srfTriangles_t *tri );
+void RB_SkinGPUSurfaces( void );
+void RB_PurgeGPUSkinning( void );
+
 
 //====================================================
 
@@ -700,6 +737,10 @@ typedef struct {
 	int		c_deformedVerts;	// idMD5Mesh::GenerateSurface
 	int		c_deformedIndexes;	// idMD5Mesh::GenerateSurface
 	int		c_tangentIndexes;	// R_DeriveTangents()
+	int		c_skinningJobs;		// R_EndParallelSkinning
+	int		c_skinningJobVerts;	// R_EndParallelSkinning
+	int		c_gpuSkinnedSurfaces;	// idMD5Mesh::UpdateSurfaceGPU
+	int		c_gpuSkinnedVerts;		// idMD5Mesh::UpdateSurfaceGPU
 	int		c_entityUpdates, c_lightUpdates, c_entityReferences, c_lightReferences;
 	int		c_guiSurfs;
 	int		frontEndMsec;		// sum of time in all RE_RenderScene's in a frame
@@ -924,6 +965,10 @@ public:
 	int						guiRecursionLevel;		// to prevent infinite overruns
 	class idGuiModel *		guiModel;
 	class idGuiModel *		demoGuiModel;
+
+	// filled by the front end, consumed by RB_SkinGPUSurfaces and cleared at the end of the frame
+	idList<idJointMat>			gpuSkinningJoints;
+	idList<gpuSkinnedSurface_t>	gpuSkinnedSurfaces;
 };
 
 extern backEndState_t		backEnd;
@@ -985,6 +1030,9 @@ extern idCVar r_useOptimizedShadows;	// 1 = use the dmap generated static shadow
 extern idCVar r_useShadowProjectedCull;	// 1 = discard triangles outside light volume before shadowing
 extern idCVar r_useDeferredTangents;	// 1 = don't always calc tangents after deform
 extern idCVar r_useCachedDynamicModels;	// 1 = cache snapshots of dynamic models
+extern idCVar r_parallelSkinning;		// 1 = skin visible md5 meshes with parallel jobs
+extern idCVar r_useGPUSkinning;			// 1 = skin md5 meshes in a vertex program
+extern idCVar r_binaryProc;				// load the binary .bproc written by dmap instead of parsing the .proc
 extern idCVar r_useTwoSidedStencil;		// 1 = do stencil shadows in one pass with different ops on each side
 extern idCVar r_useInfiniteFarZ;		// 1 = use the no-far-clip-plane trick
 extern idCVar r_useScissor;				// 1 = scissor clip as portals and lights are processed
@@ -1439,7 +1487,7 @@ DRAW_*
 */
 
 void	RB_GLSL_DrawInteractions( void );
-const	fhRenderProgram*  R_FindGlslProgram( const char* vertexShaderName, const char* fragmentShaderName );
+const	fhRenderProgram*  R_FindGlslProgram( const char* vertexShaderName, const char* fragmentShaderName, const char* const* feedbackVaryings = nullptr, int numFeedbackVaryings = 0 );
 void	R_ReloadGlslPrograms_f( const idCmdArgs &args );
 void	RB_GLSL_FillDepthBuffer( drawSurf_t **drawSurfs, int numDrawSurfs );
 void	RB_GLSL_FogPass(const viewLight_t& vlight);
@@ -1564,7 +1612,8 @@ srfTriangles_t *	R_MergeTriangles( const srfTriangles_t *tri1, const srfTriangle
 
 // if the deformed verts have significant enough texture coordinate changes to reverse the texture
 // polarity of a triangle, the tangents will be incorrect
-void				R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes = true );
+// jobs pass their own counter, otherwise the indexes are counted in tr.pc
+void				R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes = true, int *tangentIndexes = NULL );
 
 // deformable meshes precalculate as much as possible from a base frame, then generate
 // complete srfTriangles_t from just a new set of vertexes
@@ -1598,6 +1647,12 @@ deformInfo_t *		R_BuildDeformInfo( int numVerts, const idDrawVert *verts, int nu
 void				R_FreeDeformInfo( deformInfo_t *deformInfo );
 int					R_DeformInfoMemoryUsed( deformInfo_t *deformInfo );
 
+// binary model cache, the read functions return NULL if the data is truncated or invalid
+void				R_WriteStaticTriSurfBinary( idFile *file, const srfTriangles_t *tri );
+srfTriangles_t *	R_ReadStaticTriSurfBinary( idFile *file );
+void				R_WriteDeformInfoBinary( idFile *file, const deformInfo_t *deformInfo );
+deformInfo_t *		R_ReadDeformInfoBinary( idFile *file );
+
 /*
 ============================================================
 
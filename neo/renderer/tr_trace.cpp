@@ -71,6 +71,9 @@ localTrace_t R_LocalTrace( const idVec3 &start, const idVec3 &end, const float r
 	planes[3] = -startDir;
 	planes[3][3] = - end * planes[3].Normal();
 
+	// gpu skinned surfaces only have their vertexes in the vertex cache
+	R_SkinVertsOnCPU( tri );
+
 	// catagorize each point against the four planes
 	cullBits = (byte *) _alloca16( tri->numVerts );
 	SIMDProcessor->TracePointCull( cullBits, totalOr, radius, planes, tri->verts, tri->numVerts );
@@ -329,6 +329,9 @@ int R_TriSurfMemory( const srfTriangles_t *tri ) {
 	if ( tri->dupVerts != NULL ) {
 		total += tri->numDupVerts * sizeof( tri->dupVerts[0] );
 	}
+	if ( tri->gpuSkinnedJoints != NULL ) {
+		total += tri->numGpuSkinnedJoints * sizeof( tri->gpuSkinnedJoints[0] );
+	}
 
 	total += sizeof( *tri );
 
@@ -412,6 +415,10 @@ void R_ReallyFreeStaticTriSurf( srfTriangles_t *tri ) {
 		triShadowVertexAllocator.Free( tri->shadowVertexes );
 	}
 
+	if ( tri->gpuSkinnedJoints != NULL ) {
+		Mem_Free16( tri->gpuSkinnedJoints );
+	}
+
 #ifdef _DEBUG
 	memset( tri, 0, sizeof( srfTriangles_t ) );
 #endif
@@ -1639,7 +1646,7 @@ This is called once for static surfaces, and every frame for deforming surfaces
 Builds tangents, normals, and face planes
 ==================
 */
-void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes ) {
+void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes, int *tangentIndexes ) {
 	int				i;
 	idPlane			*planes;
 
@@ -1652,7 +1659,11 @@ void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes ) {
 		return;
 	}
 
-	tr.pc.c_tangentIndexes += tri->numIndexes;
+	if ( tangentIndexes != NULL ) {
+		*tangentIndexes += tri->numIndexes;
+	} else {
+		tr.pc.c_tangentIndexes += tri->numIndexes;
+	}
 
 	if ( !tri->facePlanes && allocFacePlanes ) {
 		R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
@@ -2267,3 +2278,200 @@ int R_DeformInfoMemoryUsed( deformInfo_t *deformInfo ) {
 	return total;
 }
 
+
+/*
+===================================================================================
+
+BINARY MODEL CACHE
+
+Processed surfaces are written with all the derived data R_CleanupTriangles and
+R_BuildDeformInfo generate, so later loads can skip those steps completely.
+Arrays are written in native layout, the cache is not meant to be portable.
+
+===================================================================================
+*/
+
+/*
+=================
+R_WriteBinaryArray
+=================
+*/
+template<typename T>
+static void R_WriteBinaryArray( idFile *file, const T *data, int num ) {
+	if ( data == NULL ) {
+		num = 0;
+	}
+	file->WriteInt( num );
+	if ( num > 0 ) {
+		file->Write( data, num * sizeof( data[0] ) );
+	}
+}
+
+/*
+=================
+R_ReadBinaryArray
+
+Allocates from the given allocator, data is NULL if the array was empty.
+Returns false if the file is truncated or the size is invalid.
+=================
+*/
+template<typename T, typename A>
+static bool R_ReadBinaryArray( idFile *file, A &allocator, T *&data, int &num ) {
+	data = NULL;
+	num = 0;
+	if ( file->ReadInt( num ) != sizeof( num ) || num < 0 ) {
+		num = 0;
+		return false;
+	}
+	if ( num == 0 ) {
+		return true;
+	}
+	if ( num * (int)sizeof( data[0] ) > file->Length() - file->Tell() ) {
+		num = 0;
+		return false;
+	}
+	data = allocator.Alloc( num );
+	file->Read( data, num * sizeof( data[0] ) );
+	return true;
+}
+
+/*
+=================
+R_WriteStaticTriSurfBinary
+=================
+*/
+void R_WriteStaticTriSurfBinary( idFile *file, const srfTriangles_t *tri ) {
+	file->WriteVec3( tri->bounds[0] );
+	file->WriteVec3( tri->bounds[1] );
+	file->WriteBool( tri->generateNormals );
+	file->WriteBool( tri->tangentsCalculated );
+	file->WriteBool( tri->facePlanesCalculated );
+	file->WriteBool( tri->perfectHull );
+	file->WriteInt( tri->numShadowIndexesNoFrontCaps );
+	file->WriteInt( tri->numShadowIndexesNoCaps );
+	file->WriteInt( tri->shadowCapPlaneBits );
+
+	R_WriteBinaryArray( file, tri->verts, tri->numVerts );
+	R_WriteBinaryArray( file, tri->indexes, tri->numIndexes );
+	R_WriteBinaryArray( file, tri->silIndexes, tri->numIndexes );
+	R_WriteBinaryArray( file, tri->mirroredVerts, tri->numMirroredVerts );
+	R_WriteBinaryArray( file, tri->dupVerts, tri->numDupVerts * 2 );
+	R_WriteBinaryArray( file, tri->silEdges, tri->numSilEdges );
+	R_WriteBinaryArray( file, tri->dominantTris, tri->numVerts );
+	R_WriteBinaryArray( file, tri->facePlanes, tri->numIndexes / 3 );
+	R_WriteBinaryArray( file, tri->shadowVertexes, tri->numVerts );
+}
+
+/*
+=================
+R_ReadStaticTriSurfBinary
+
+Returns NULL if the data is truncated or inconsistent.
+=================
+*/
+srfTriangles_t *R_ReadStaticTriSurfBinary( idFile *file ) {
+	srfTriangles_t *tri = R_AllocStaticTriSurf();
+	int numSilIndexes = 0, numDupVerts = 0, numDominantTris = 0, numFacePlanes = 0, numShadowVerts = 0;
+	bool ok = true;
+
+	file->ReadVec3( tri->bounds[0] );
+	file->ReadVec3( tri->bounds[1] );
+	file->ReadBool( tri->generateNormals );
+	file->ReadBool( tri->tangentsCalculated );
+	file->ReadBool( tri->facePlanesCalculated );
+	file->ReadBool( tri->perfectHull );
+	file->ReadInt( tri->numShadowIndexesNoFrontCaps );
+	file->ReadInt( tri->numShadowIndexesNoCaps );
+	file->ReadInt( tri->shadowCapPlaneBits );
+
+	ok = ok && R_ReadBinaryArray( file, triVertexAllocator, tri->verts, tri->numVerts );
+	ok = ok && R_ReadBinaryArray( file, triIndexAllocator, tri->indexes, tri->numIndexes );
+	ok = ok && R_ReadBinaryArray( file, triSilIndexAllocator, tri->silIndexes, numSilIndexes );
+	ok = ok && R_ReadBinaryArray( file, triMirroredVertAllocator, tri->mirroredVerts, tri->numMirroredVerts );
+	ok = ok && R_ReadBinaryArray( file, triDupVertAllocator, tri->dupVerts, numDupVerts );
+	ok = ok && R_ReadBinaryArray( file, triSilEdgeAllocator, tri->silEdges, tri->numSilEdges );
+	ok = ok && R_ReadBinaryArray( file, triDominantTrisAllocator, tri->dominantTris, numDominantTris );
+	ok = ok && R_ReadBinaryArray( file, triPlaneAllocator, tri->facePlanes, numFacePlanes );
+	ok = ok && R_ReadBinaryArray( file, triShadowVertexAllocator, tri->shadowVertexes, numShadowVerts );
+
+	// shadow models from the .proc only have shadow vertexes
+	if ( ok && tri->verts == NULL ) {
+		tri->numVerts = numShadowVerts;
+	}
+	if ( ok ) {
+		ok = ( tri->silIndexes == NULL || numSilIndexes == tri->numIndexes ) &&
+			( tri->shadowVertexes == NULL || numShadowVerts == tri->numVerts ) &&
+			( tri->dominantTris == NULL || numDominantTris == tri->numVerts ) &&
+			( tri->facePlanes == NULL || numFacePlanes == tri->numIndexes / 3 ) &&
+			( numDupVerts & 1 ) == 0;
+	}
+	for ( int i = 0; ok && i < tri->numIndexes; i++ ) {
+		ok = tri->indexes[i] >= 0 && tri->indexes[i] < tri->numVerts;
+	}
+	tri->numDupVerts = numDupVerts / 2;
+
+	if ( !ok ) {
+		R_ReallyFreeStaticTriSurf( tri );
+		return NULL;
+	}
+
+	return tri;
+}
+
+/*
+=================
+R_WriteDeformInfoBinary
+=================
+*/
+void R_WriteDeformInfoBinary( idFile *file, const deformInfo_t *deformInfo ) {
+	file->WriteInt( deformInfo->numSourceVerts );
+	file->WriteInt( deformInfo->numOutputVerts );
+
+	R_WriteBinaryArray( file, deformInfo->indexes, deformInfo->numIndexes );
+	R_WriteBinaryArray( file, deformInfo->silIndexes, deformInfo->numIndexes );
+	R_WriteBinaryArray( file, deformInfo->mirroredVerts, deformInfo->numMirroredVerts );
+	R_WriteBinaryArray( file, deformInfo->dupVerts, deformInfo->numDupVerts * 2 );
+	R_WriteBinaryArray( file, deformInfo->silEdges, deformInfo->numSilEdges );
+	R_WriteBinaryArray( file, deformInfo->dominantTris, deformInfo->numOutputVerts );
+}
+
+/*
+=================
+R_ReadDeformInfoBinary
+
+Returns NULL if the data is truncated or inconsistent.
+=================
+*/
+deformInfo_t *R_ReadDeformInfoBinary( idFile *file ) {
+	deformInfo_t *deform = (deformInfo_t *)R_ClearedStaticAlloc( sizeof( *deform ) );
+	int numSilIndexes = 0, numDupVerts = 0, numDominantTris = 0;
+	bool ok = true;
+
+	file->ReadInt( deform->numSourceVerts );
+	file->ReadInt( deform->numOutputVerts );
+
+	ok = ok && R_ReadBinaryArray( file, triIndexAllocator, deform->indexes, deform->numIndexes );
+	ok = ok && R_ReadBinaryArray( file, triSilIndexAllocator, deform->silIndexes, numSilIndexes );
+	ok = ok && R_ReadBinaryArray( file, triMirroredVertAllocator, deform->mirroredVerts, deform->numMirroredVerts );
+	ok = ok && R_ReadBinaryArray( file, triDupVertAllocator, deform->dupVerts, numDupVerts );
+	ok = ok && R_ReadBinaryArray( file, triSilEdgeAllocator, deform->silEdges, deform->numSilEdges );
+	ok = ok && R_ReadBinaryArray( file, triDominantTrisAllocator, deform->dominantTris, numDominantTris );
+
+	if ( ok ) {
+		ok = numSilIndexes == deform->numIndexes &&
+			( deform->dominantTris == NULL || numDominantTris == deform->numOutputVerts ) &&
+			deform->numOutputVerts >= deform->numSourceVerts &&
+			( numDupVerts & 1 ) == 0;
+	}
+	for ( int i = 0; ok && i < deform->numIndexes; i++ ) {
+		ok = deform->indexes[i] >= 0 && deform->indexes[i] < deform->numOutputVerts;
+	}
+	deform->numDupVerts = numDupVerts / 2;
+
+	if ( !ok ) {
+		R_FreeDeformInfo( deform );
+		return NULL;
+	}
+
+	return deform;
+}
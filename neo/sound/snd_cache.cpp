@@ -50,6 +50,10 @@ idSoundCache::idSoundCache() {
 	listCache.AssureSize( 1024, NULL );
 	listCache.SetGranularity( 256 );
 	insideLevelLoad = false;
+	lastUpdateWorld = NULL;
+	inUseStamp = 0;
+	checkBudget = false;
+	ClearStats();
 }
 
 /*
@@ -99,6 +103,7 @@ idSoundSample *idSoundCache::FindSound( const idStr& filename, bool loadOnDemand
 			def->levelLoadReferenced = true;
 			if ( def->purged && !loadOnDemandOnly ) {
 				def->Load();
+				checkBudget = true;
 			}
 			return def;
 		}
@@ -122,6 +127,7 @@ idSoundSample *idSoundCache::FindSound( const idStr& filename, bool loadOnDemand
 	if ( !loadOnDemandOnly ) {
 		// this may make it a default sound if it can't be loaded
 		def->Load();
+		checkBudget = true;
 	}
 
 	return def;
@@ -209,6 +215,10 @@ void idSoundCache::EndLevelLoad() {
 
 	soundCacheAllocator.FreeEmptyBaseBlocks();
 
+	// the level may need more than s_cacheBudget, the least recently
+	// played samples are evicted on the next update
+	checkBudget = true;
+
 	common->Printf( "%5ik referenced\n", useCount / 1024 );
 	common->Printf( "%5ik purged\n", purgeCount / 1024 );
 	common->Printf( "----------------------------------------\n" );
@@ -272,6 +282,263 @@ void idSoundCache::PrintMemInfo( MemInfo_t *mi ) {
 	fileSystem->CloseFile( f );
 }
 
+/*
+===================
+idSoundCache::PrintStats
+===================
+*/
+void idSoundCache::PrintStats( void ) const {
+	int residentSamples[SOUND_MAX_CLASSES];
+	int residentMemory[SOUND_MAX_CLASSES];
+	int totalHits = 0, totalMisses = 0, totalSamples = 0, totalMemory = 0;
+
+	memset( residentSamples, 0, sizeof( residentSamples ) );
+	memset( residentMemory, 0, sizeof( residentMemory ) );
+
+	for ( int i = 0; i < listCache.Num(); i++ ) {
+		const idSoundSample *sample = listCache[i];
+		if ( !sample || sample->purged ) {
+			continue;
+		}
+		residentSamples[sample->soundClass]++;
+		residentMemory[sample->soundClass] += sample->objectMemSize;
+	}
+
+	common->Printf( "class     hits   misses  samples   resident\n" );
+	for ( int i = 0; i < SOUND_MAX_CLASSES; i++ ) {
+		if ( !hits[i] && !misses[i] && !residentSamples[i] ) {
+			continue;
+		}
+		common->Printf( "%5d %8d %8d %8d %8dkB\n", i, hits[i], misses[i], residentSamples[i], residentMemory[i] >> 10 );
+		totalHits += hits[i];
+		totalMisses += misses[i];
+		totalSamples += residentSamples[i];
+		totalMemory += residentMemory[i];
+	}
+	common->Printf( "total %8d %8d %8d %8dkB\n", totalHits, totalMisses, totalSamples, totalMemory >> 10 );
+
+	if ( idSoundSystemLocal::s_cacheBudget.GetInteger() > 0 ) {
+		common->Printf( "%d kB budget\n", idSoundSystemLocal::s_cacheBudget.GetInteger() << 10 );
+	} else {
+		common->Printf( "no budget\n" );
+	}
+	common->Printf( "%d reloads, %d evictions, %d pending loads\n", numReloads, numEvictions, pendingLoads.Num() );
+}
+
+/*
+===================
+idSoundCache::ClearStats
+===================
+*/
+void idSoundCache::ClearStats( void ) {
+	memset( hits, 0, sizeof( hits ) );
+	memset( misses, 0, sizeof( misses ) );
+	numReloads = 0;
+	numEvictions = 0;
+}
+
+/*
+===================
+idSoundCache::Touch
+
+this is called by the main thread
+===================
+*/
+void idSoundCache::Touch( idSoundSample *sample, int soundClass ) {
+	soundClass = idMath::ClampInt( 0, SOUND_MAX_CLASSES - 1, soundClass );
+
+	if ( sample->purged ) {
+		misses[soundClass]++;
+	} else {
+		hits[soundClass]++;
+	}
+
+	sample->lastUsed = Sys_Milliseconds();
+	sample->soundClass = soundClass;
+}
+
+/*
+===================
+idSoundCache::LoadOnDemand
+
+Samples evicted by the budget still know their length, so the caller can
+go on with them while Update reloads the data; the mixer keeps their
+channels silent until then.  Anything else is loaded right away.
+this is called by the main thread
+===================
+*/
+bool idSoundCache::LoadOnDemand( idSoundSample *sample ) {
+	if ( !sample->purged ) {
+		return true;
+	}
+
+	if ( sample->evicted && idSoundSystemLocal::s_cacheLoadTime.GetInteger() > 0 ) {
+		if ( !sample->loadPending ) {
+			sample->loadPending = true;
+			pendingLoads.Append( sample );
+		}
+		return false;
+	}
+
+	int start = Sys_Milliseconds();
+	sample->Load();
+	session->TimeHitch( Sys_Milliseconds() - start );
+
+	numReloads++;
+	checkBudget = true;
+	return true;
+}
+
+/*
+===================
+idSoundCache::MarkSamplesInUse
+
+Stamps every sample a channel of the world holds, so they are not evicted.
+Evicted samples found on the way are queued for a reload, this happens when
+a world with stopped samples becomes the playing one again.
+===================
+*/
+void idSoundCache::MarkSamplesInUse( idSoundWorldLocal *sw ) {
+	inUseStamp++;
+
+	if ( !sw ) {
+		return;
+	}
+
+	for ( int i = 0; i < sw->emitters.Num(); i++ ) {
+		idSoundEmitterLocal *sound = sw->emitters[i];
+		if ( !sound ) {
+			continue;
+		}
+
+		for ( int j = 0; j < SOUND_MAX_CHANNELS; j++ ) {
+			const idSoundChannel *chan = &sound->channels[j];
+			if ( !chan->triggerState ) {
+				continue;
+			}
+
+			idSoundSample *samples[2] = { chan->leadinSample, chan->LoopingSample() };
+			for ( int k = 0; k < 2; k++ ) {
+				if ( !samples[k] ) {
+					continue;
+				}
+				samples[k]->inUseStamp = inUseStamp;
+				if ( samples[k]->purged && samples[k]->evicted ) {
+					LoadOnDemand( samples[k] );
+				}
+			}
+		}
+	}
+}
+
+/*
+===================
+SampleLRUCompare
+
+Sorts the least recently played samples first
+===================
+*/
+static int SampleLRUCompare( idSoundSample * const *a, idSoundSample * const *b ) {
+	return (*a)->lastUsed - (*b)->lastUsed;
+}
+
+/*
+===================
+idSoundCache::EnforceBudget
+
+Evicts the least recently played samples no channel holds until the resident
+samples fit in s_cacheBudget.
+===================
+*/
+void idSoundCache::EnforceBudget( void ) {
+	const int budget = idSoundSystemLocal::s_cacheBudget.GetInteger() << 20;
+	if ( budget <= 0 ) {
+		return;
+	}
+
+	int resident = 0;
+	for ( int i = 0; i < listCache.Num(); i++ ) {
+		const idSoundSample *sample = listCache[i];
+		if ( sample && !sample->purged ) {
+			resident += sample->objectMemSize;
+		}
+	}
+	if ( resident <= budget ) {
+		return;
+	}
+
+	MarkSamplesInUse( lastUpdateWorld );
+
+	idList<idSoundSample *> candidates;
+	candidates.SetGranularity( 256 );
+	for ( int i = 0; i < listCache.Num(); i++ ) {
+		idSoundSample *sample = listCache[i];
+		if ( !sample || sample->purged || sample->defaultSound || sample->inUseStamp == inUseStamp ) {
+			continue;
+		}
+		candidates.Append( sample );
+	}
+	candidates.Sort( SampleLRUCompare );
+
+	int i;
+	for ( i = 0; i < candidates.Num() && resident > budget; i++ ) {
+		idSoundSample *sample = candidates[i];
+		resident -= sample->objectMemSize;
+		sample->PurgeSoundSample();
+		sample->evicted = true;
+		numEvictions++;
+	}
+
+	if ( i > 0 ) {
+		soundCacheAllocator.FreeEmptyBaseBlocks();
+	}
+}
+
+/*
+===================
+idSoundCache::Update
+
+this is called by the main thread, inside the sound critical section
+===================
+*/
+void idSoundCache::Update( idSoundWorldLocal *sw ) {
+	if ( insideLevelLoad ) {
+		return;
+	}
+
+	// channels of a world that was not playing may hold evicted samples
+	if ( sw != lastUpdateWorld ) {
+		lastUpdateWorld = sw;
+		MarkSamplesInUse( sw );
+	}
+
+	// reload the evicted samples started since the last frame, at least
+	// one per frame so the queue always drains
+	if ( pendingLoads.Num() ) {
+		int start = Sys_Milliseconds();
+		while ( pendingLoads.Num() ) {
+			idSoundSample *sample = pendingLoads[0];
+			pendingLoads.RemoveIndex( 0 );
+
+			sample->loadPending = false;
+			if ( sample->purged ) {
+				sample->Load();
+				numReloads++;
+				checkBudget = true;
+			}
+
+			if ( Sys_Milliseconds() - start >= idSoundSystemLocal::s_cacheLoadTime.GetInteger() ) {
+				break;
+			}
+		}
+	}
+
+	if ( checkBudget ) {
+		checkBudget = false;
+		EnforceBudget();
+	}
+}
+
 
 /*
 ==========================================================================
@@ -298,6 +565,11 @@ idSoundSample::idSoundSample() {
 	onDemand = false;
 	purged = false;
 	levelLoadReferenced = false;
+	evicted = false;
+	loadPending = false;
+	lastUsed = 0;
+	inUseStamp = 0;
+	soundClass = 0;
 }
 
 /*
@@ -432,6 +704,7 @@ Loads based on name, possibly doing a MakeDefault if necessary
 void idSoundSample::Load( void ) {
 	defaultSound = false;
 	purged = false;
+	evicted = false;
 	hardwareBuffer = false;
 
 	timestamp = GetNewTimeStamp();
@@ -525,11 +798,13 @@ void idSoundSample::Load( void ) {
 	}
 
 	// OGG decompressed at load time (when smaller than s_decompressionLimit seconds, 6 seconds by default)
+	// short sounds are the ones that get triggered over and over, so they are decoded once here instead
+	// of every time they start
 	if ( objectInfo.wFormatTag == WAVE_FORMAT_TAG_OGG ) {
 #if defined(MACOS_X)
 		if ( ( objectSize < ( ( int ) objectInfo.nSamplesPerSec * idSoundSystemLocal::s_decompressionLimit.GetInteger() ) ) ) {
 #else
-		if ( ( alIsExtensionPresent( "EAX-RAM" ) == AL_TRUE ) && ( objectSize < ( ( int ) objectInfo.nSamplesPerSec * idSoundSystemLocal::s_decompressionLimit.GetInteger() ) ) ) {
+		if ( ( idSoundSystemLocal::s_preDecodeOgg.GetBool() || alIsExtensionPresent( "EAX-RAM" ) == AL_TRUE ) && ( objectSize < ( ( int ) objectInfo.nSamplesPerSec * idSoundSystemLocal::s_decompressionLimit.GetInteger() ) ) ) {
 #endif
 			alGetError();
 			alGenBuffers( 1, &openalBuffer );
@@ -623,6 +898,9 @@ idSoundSample::PurgeSoundSample
 ===================
 */
 void idSoundSample::PurgeSoundSample() {
+	// the stream decoder jobs may still be reading the sample
+	soundSystemLocal.streamDecoder.Sync();
+
 	purged = true;
 
 	if ( hardwareBuffer ) {
@@ -39,7 +39,9 @@ If you have questions concerning this license or the applicable additional terms
 
   Thread safe decoder memory allocator.
 
-  Each OggVorbis decoder consumes about 150kB of memory.
+  Each OggVorbis decoder consumes about 150kB of memory.  Private decoders
+  decode on the job threads without CRITICAL_SECTION_ONE, so the allocator
+  has a lock of its own.
 
 ===================================================================================
 */
@@ -48,6 +50,8 @@ idDynamicBlockAlloc<byte, 1<<20, 128>		decoderMemoryAllocator;
 
 const int MIN_OGGVORBIS_MEMORY				= 768 * 1024;
 
+const int CRITICAL_SECTION_DECODER_MEMORY	= CRITICAL_SECTION_TWO;
+
 extern "C" {
 	void *_decoder_malloc( size_t size );
 	void *_decoder_calloc( size_t num, size_t size );
@@ -56,26 +60,34 @@ extern "C" {
 }
 
 void *_decoder_malloc( size_t size ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_DECODER_MEMORY );
 	void *ptr = decoderMemoryAllocator.Alloc( size );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_DECODER_MEMORY );
 	assert( size == 0 || ptr != NULL );
 	return ptr;
 }
 
 void *_decoder_calloc( size_t num, size_t size ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_DECODER_MEMORY );
 	void *ptr = decoderMemoryAllocator.Alloc( num * size );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_DECODER_MEMORY );
 	assert( ( num * size ) == 0 || ptr != NULL );
 	memset( ptr, 0, num * size );
 	return ptr;
 }
 
 void *_decoder_realloc( void *memblock, size_t size ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_DECODER_MEMORY );
 	void *ptr = decoderMemoryAllocator.Resize( (byte *)memblock, size );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_DECODER_MEMORY );
 	assert( size == 0 || ptr != NULL );
 	return ptr;
 }
 
 void _decoder_free( void *memblock ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_DECODER_MEMORY );
 	decoderMemoryAllocator.Free( (byte *)memblock );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_DECODER_MEMORY );
 }
 
 
@@ -287,11 +299,13 @@ public:
 	virtual int				GetLastDecodeTime( void ) const;
 
 	void					Clear( void );
+	void					SetThreadPrivate( bool threadPrivate ) { this->threadPrivate = threadPrivate; }
 	int						DecodePCM( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest );
 	int						DecodeOGG( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest );
 
 private:
 	bool					failed;				// set if decoding failed
+	bool					threadPrivate;		// only used by one thread, decodes without CRITICAL_SECTION_ONE
 	int						lastFormat;			// last format being decoded
 	idSoundSample *			lastSample;			// last sample being decoded
 	int						lastSampleOffset;	// last offset into the decoded sample
@@ -329,9 +343,10 @@ void idSampleDecoder::Shutdown( void ) {
 idSampleDecoder::Alloc
 ====================
 */
-idSampleDecoder *idSampleDecoder::Alloc( void ) {
+idSampleDecoder *idSampleDecoder::Alloc( bool threadPrivate ) {
 	idSampleDecoderLocal *decoder = sampleDecoderAllocator.Alloc();
 	decoder->Clear();
+	decoder->SetThreadPrivate( threadPrivate );
 	return decoder;
 }
 
@@ -439,7 +454,9 @@ void idSampleDecoderLocal::Decode( idSoundSample *sample, int sampleOffset44k, i
 	}
 
 	// samples can be decoded both from the sound thread and the main thread for shakes
-	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
+	if ( !threadPrivate ) {
+		Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
+	}
 
 	switch( sample->objectInfo.wFormatTag ) {
 		case WAVE_FORMAT_TAG_PCM: {
@@ -456,7 +473,9 @@ void idSampleDecoderLocal::Decode( idSoundSample *sample, int sampleOffset44k, i
 		}
 	}
 
-	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+	if ( !threadPrivate ) {
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+	}
 
 	if ( readSamples44k < sampleCount44k ) {
 		memset( dest + readSamples44k, 0, ( sampleCount44k - readSamples44k ) * sizeof( dest[0] ) );
@@ -517,7 +536,10 @@ int idSampleDecoderLocal::DecodeOGG( idSoundSample *sample, int sampleOffset44k,
 	// open OGG file if not yet opened
 	if ( lastSample == NULL ) {
 		// make sure there is enough space for another decoder
-		if ( decoderMemoryAllocator.GetFreeBlockMemory() < MIN_OGGVORBIS_MEMORY ) {
+		Sys_EnterCriticalSection( CRITICAL_SECTION_DECODER_MEMORY );
+		int freeMemory = decoderMemoryAllocator.GetFreeBlockMemory();
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_DECODER_MEMORY );
+		if ( freeMemory < MIN_OGGVORBIS_MEMORY ) {
 			return 0;
 		}
 		if ( sample->nonCacheData == NULL ) {
@@ -570,3 +592,215 @@ int idSampleDecoderLocal::DecodeOGG( idSoundSample *sample, int sampleOffset44k,
 
 	return ( readSamples << shift );
 }
+
+
+/*
+===================================================================================
+
+  idSoundStreamDecoder
+
+===================================================================================
+*/
+
+/*
+====================
+idSoundStreamDecoder::idSoundStreamDecoder
+====================
+*/
+idSoundStreamDecoder::idSoundStreamDecoder( void ) {
+	memset( rings, 0, sizeof( rings ) );
+	jobs = NULL;
+}
+
+/*
+====================
+idSoundStreamDecoder::Init
+====================
+*/
+void idSoundStreamDecoder::Init( void ) {
+	if ( jobs == NULL ) {
+		jobs = new idParallelJobList( "soundStreamDecode" );
+	}
+}
+
+/*
+====================
+idSoundStreamDecoder::Shutdown
+====================
+*/
+void idSoundStreamDecoder::Shutdown( void ) {
+	Sync();
+
+	for ( int i = 0; i < MAX_STREAM_RINGS; i++ ) {
+		if ( rings[i].decoder != NULL ) {
+			idSampleDecoder::Free( rings[i].decoder );
+		}
+	}
+	memset( rings, 0, sizeof( rings ) );
+
+	delete jobs;
+	jobs = NULL;
+}
+
+/*
+====================
+idSoundStreamDecoder::Sync
+
+The sound thread calls this at the start of every mix, the main thread before
+it purges a sample, so the critical section keeps them from waiting at once.
+====================
+*/
+void idSoundStreamDecoder::Sync( void ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+
+	if ( jobs != NULL && jobs->IsSubmitted() ) {
+		jobs->Wait();
+
+		for ( int i = 0; i < MAX_STREAM_RINGS; i++ ) {
+			rings[i].numBlocks += rings[i].pendingBlocks;
+			rings[i].pendingBlocks = 0;
+		}
+	}
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+}
+
+/*
+====================
+idSoundStreamDecoder::Submit
+====================
+*/
+void idSoundStreamDecoder::Submit( void ) {
+	if ( jobs == NULL ) {
+		return;
+	}
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+
+	for ( int i = 0; i < MAX_STREAM_RINGS; i++ ) {
+		streamRing_t &ring = rings[i];
+
+		// the channel stopped streaming or lost its voice
+		if ( ring.chan != NULL && !ring.queued ) {
+			idSampleDecoder::Free( ring.decoder );
+			ring.decoder = NULL;
+			ring.chan = NULL;
+		}
+		ring.queued = false;
+	}
+
+	if ( jobs->NumJobs() > 0 ) {
+		jobs->Submit( true );
+	}
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+}
+
+/*
+====================
+idSoundStreamDecoder::FindRing
+====================
+*/
+idSoundStreamDecoder::streamRing_t *idSoundStreamDecoder::FindRing( const idSoundChannel *chan ) {
+	for ( int i = 0; i < MAX_STREAM_RINGS; i++ ) {
+		if ( rings[i].chan == chan ) {
+			return &rings[i];
+		}
+	}
+	return NULL;
+}
+
+/*
+====================
+idSoundStreamDecoder::Read
+====================
+*/
+bool idSoundStreamDecoder::Read( const idSoundChannel *chan, int streamOffset, float *dest ) {
+	streamRing_t *ring = FindRing( chan );
+
+	if ( ring == NULL || ring->numBlocks == 0 || ring->start != streamOffset ) {
+		return false;
+	}
+	if ( ring->triggerTime != chan->trigger44kHzTime || ring->leadin != chan->leadinSample ) {
+		return false;
+	}
+
+	memcpy( dest, ring->samples[ring->first], MIXBUFFER_SAMPLES * ring->numChannels * sizeof( dest[0] ) );
+
+	ring->first = ( ring->first + 1 ) % STREAM_RING_BLOCKS;
+	ring->start += MIXBUFFER_SAMPLES;
+	ring->numBlocks--;
+
+	return true;
+}
+
+/*
+====================
+idSoundStreamDecoder::Queue
+====================
+*/
+void idSoundStreamDecoder::Queue( const idSoundChannel *chan, int streamOffset ) {
+	if ( jobs == NULL || !idSoundSystemLocal::s_backgroundDecoding.GetBool() ) {
+		return;
+	}
+
+	idSoundSample *leadin = chan->leadinSample;
+	idSoundSample *loop = chan->LoopingSample();
+
+	// only compressed samples are worth decoding ahead
+	if ( leadin->objectInfo.wFormatTag != WAVE_FORMAT_TAG_OGG && ( loop == NULL || loop->objectInfo.wFormatTag != WAVE_FORMAT_TAG_OGG ) ) {
+		return;
+	}
+
+	streamRing_t *ring = FindRing( chan );
+	if ( ring == NULL ) {
+		ring = FindRing( NULL );
+		if ( ring == NULL ) {
+			// all rings are busy, the mixer decodes this one itself
+			return;
+		}
+		ring->chan = chan;
+		ring->decoder = idSampleDecoder::Alloc( true );
+		ring->leadin = NULL;
+	}
+
+	// (re)started channels and seeks throw away what was decoded
+	if ( ring->leadin != leadin || ring->loop != loop || ring->triggerTime != chan->trigger44kHzTime || ring->start != streamOffset ) {
+		ring->leadin = leadin;
+		ring->loop = loop;
+		ring->triggerTime = chan->trigger44kHzTime;
+		ring->numChannels = leadin->objectInfo.nChannels;
+		ring->start = streamOffset;
+		ring->first = 0;
+		ring->numBlocks = 0;
+	}
+
+	if ( ring->queued ) {
+		return;
+	}
+	ring->queued = true;
+
+	if ( ring->numBlocks < STREAM_RING_BLOCKS ) {
+		ring->pendingBlocks = STREAM_RING_BLOCKS - ring->numBlocks;
+		jobs->AddJob( DecodeRing, ring );
+	}
+}
+
+/*
+====================
+idSoundStreamDecoder::DecodeRing
+
+Runs on a job thread, fills the free blocks of the ring behind the decoded ones.
+====================
+*/
+void idSoundStreamDecoder::DecodeRing( void *data ) {
+	streamRing_t *ring = static_cast<streamRing_t *>( data );
+
+	for ( int i = 0; i < ring->pendingBlocks; i++ ) {
+		int block = ring->numBlocks + i;
+		int offset = ring->start + block * MIXBUFFER_SAMPLES;
+		float *dest = ring->samples[( ring->first + block ) % STREAM_RING_BLOCKS];
+
+		idSoundChannel::GatherSamples( ring->decoder, ring->leadin, ring->loop, offset * ring->numChannels, MIXBUFFER_SAMPLES * ring->numChannels, dest );
+	}
+}
@@ -185,6 +185,7 @@ void idSoundChannel::Clear( void ) {
 	memset( &parms, 0, sizeof(parms) );
 
 	triggered = false;
+	virtualVoice = false;
 	openalSource = 0;
 	openalStreamingOffset = 0;
 	openalStreamingBuffer[0] = openalStreamingBuffer[1] = openalStreamingBuffer[2] = 0;
@@ -255,6 +256,27 @@ samples and leadins
 ===================
 */
 void idSoundChannel::GatherChannelSamples( int sampleOffset44k, int sampleCount44k, float *dest ) const {
+	GatherSamples( decoder, leadinSample, LoopingSample(), sampleOffset44k, sampleCount44k, dest );
+}
+
+/*
+===================
+idSoundChannel::LoopingSample
+===================
+*/
+idSoundSample *idSoundChannel::LoopingSample( void ) const {
+	if ( !soundShader || !( parms.soundShaderFlags & SSF_LOOPING ) ) {
+		return NULL;
+	}
+	return soundShader->entries[0];
+}
+
+/*
+===================
+idSoundChannel::GatherSamples
+===================
+*/
+void idSoundChannel::GatherSamples( idSampleDecoder *decoder, idSoundSample *leadin, idSoundSample *loop, int sampleOffset44k, int sampleCount44k, float *dest ) {
 	float	*dest_p = dest;
 	int		len;
 
@@ -273,7 +295,6 @@ void idSoundChannel::GatherChannelSamples( int sampleOffset44k, int sampleCount4
 	}
 
 	// grab part of the leadin sample
-	idSoundSample *leadin = leadinSample;
 	if ( !leadin || sampleOffset44k < 0 || sampleCount44k <= 0 ) {
 		memset( dest_p, 0, sampleCount44k * sizeof( dest_p[0] ) );
 		return;
@@ -294,14 +315,6 @@ void idSoundChannel::GatherChannelSamples( int sampleOffset44k, int sampleCount4
 	}
 
 	// if not looping, zero fill any remaining spots
-	if ( !soundShader || !( parms.soundShaderFlags & SSF_LOOPING ) ) {
-		memset( dest_p, 0, sampleCount44k * sizeof( dest_p[0] ) );
-		return;
-	}
-
-	// fill the remainder with looped samples
-	idSoundSample *loop = soundShader->entries[0];
-
 	if ( !loop ) {
 		memset( dest_p, 0, sampleCount44k * sizeof( dest_p[0] ) );
 		return;
@@ -368,6 +381,8 @@ void idSoundEmitterLocal::Clear( void ) {
 	distance = 0.0f;
 
 	lastValidPortalArea = -1;
+	portalPath.listenerArea = -1;
+	portalPath.numPortals = 0;
 
 	playing = false;
 	hasShakes = false;
@@ -565,7 +580,7 @@ void idSoundEmitterLocal::Spatialize( idVec3 listenerPos, int listenerArea, idRe
 			return;
 		}
 
-		soundWorld->ResolveOrigin( 0, NULL, soundInArea, 0.0f, origin, this );
+		soundWorld->ResolveOriginCached( soundInArea, this );
 		distance /= METERS_TO_DOOM;
 	} else {
 		// no portals available
@@ -800,17 +815,19 @@ int idSoundEmitterLocal::StartSound( const idSoundShader *shader, const s_channe
 		chan->leadinSample = shader->entries[ choice ];
 	}
 
-	// if the sample is onDemand (voice mails, etc), load it now
-	if ( chan->leadinSample->purged ) {
-		int		start = Sys_Milliseconds();
-		chan->leadinSample->Load();
-		int		end = Sys_Milliseconds();
-		session->TimeHitch( end - start );
+	soundSystemLocal.soundCache->Touch( chan->leadinSample, chanParms.soundClass );
+
+	// if the sample is onDemand (voice mails, etc), load it now, samples evicted
+	// by the cache budget are reloaded after this frame instead
+	if ( chan->leadinSample->purged && soundSystemLocal.soundCache->LoadOnDemand( chan->leadinSample ) ) {
 		// recalculate start44kHz, because loading may have taken a fair amount of time
 		if ( !soundWorld->fpa[0] ) {
 			start44kHz = soundSystemLocal.GetCurrent44kHzTime() + MIXBUFFER_SAMPLES;
 		}
 	}
+	if ( ( chanParms.soundShaderFlags & SSF_LOOPING ) && shader->entries[0]->evicted ) {
+		soundSystemLocal.soundCache->LoadOnDemand( shader->entries[0] );
+	}
 
 	if ( idSoundSystemLocal::s_showStartSound.GetInteger() ) {
 		common->Printf( "'%s'\n", chan->leadinSample->name.c_str() );
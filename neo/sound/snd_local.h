@@ -488,6 +488,10 @@ public:
 	void				GatherChannelSamples( int sampleOffset44k, int sampleCount44k, float *dest ) const;
 	void				ALStop( void );			// free OpenAL resources if any
 
+	idSoundSample *		LoopingSample( void ) const;	// NULL if the channel doesn't loop
+	// GatherChannelSamples without a channel, loop is NULL if the sound doesn't loop
+	static void			GatherSamples( idSampleDecoder *decoder, idSoundSample *leadin, idSoundSample *loop, int sampleOffset44k, int sampleCount44k, float *dest );
+
 	bool				triggerState;
 	int					trigger44kHzTime;		// hardware time sample the channel started
 	int					triggerGame44kHzTime;	// game time sample time the channel started
@@ -505,11 +509,34 @@ public:
 	ALuint				openalStreamingOffset;
 	ALuint				openalStreamingBuffer[3];
 	ALuint				lastopenalStreamingBuffer[3];
+	bool				virtualVoice;			// has no OpenAL source because louder channels took them, time still advances
 
 	bool				disallowSlow;
 
 };
 
+// don't spend too much time doing portal calculations in big maps
+const int MAX_PORTAL_TRACE_DEPTH = 10;
+
+// the best chain of portals found from an emitter to the listener, so the
+// portal graph is only searched again when an area or a portal state changes
+typedef struct soundPortalPath_s {
+	int					listenerArea;				// -1 when nothing is cached
+	int					soundArea;
+	int					portalStateGeneration;		// idRenderWorld::GetPortalStateGeneration() of the search
+	float				maxDistance;				// in quake units, limits how far the search looked
+	float				doorDistance;				// s_doorDistanceAdd at the time of the search
+	idVec3				searchOrigin;				// emitter and listener positions of the last full search
+	idVec3				searchListener;
+	idVec3				origin;						// emitter and listener positions the results belong to
+	idVec3				listener;
+	float				distance;					// in quake units
+	idVec3				spatializedOrigin;
+	int					numPortals;					// 0 if there is no path shorter than maxDistance
+	int					areas[MAX_PORTAL_TRACE_DEPTH];
+	int					portals[MAX_PORTAL_TRACE_DEPTH];	// index for idRenderWorld::GetPortal( areas[i], ... )
+} soundPortalPath_t;
+
 class idSoundEmitterLocal : public idSoundEmitter {
 public:
 
@@ -573,6 +600,7 @@ public:
 	float				distance;					// in meters, this may be the straight-line distance, or
 													// it may go through a chain of portals.  If there
 													// is not an open-portal path, distance will be > maxDistance
+	soundPortalPath_t	portalPath;					// cached result of idSoundWorldLocal::ResolveOrigin
 
 	// a single soundEmitter can have many channels playing from the same point
 	idSoundChannel		channels[SOUND_MAX_CHANNELS];
@@ -609,6 +637,7 @@ public:
 		missedWindow = 0;
 		missedUpdateWindow = 0;
 		activeSounds = 0;
+		virtualSounds = 0;
 	}
 	int		rinuse;
 	int		runs;
@@ -616,10 +645,25 @@ public:
 	int		missedWindow;
 	int		missedUpdateWindow;
 	int		activeSounds;
+	int		virtualSounds;
 };
 
+// a triggered channel ranked for the OpenAL source budget in MixLoop
+typedef struct soundVoice_s {
+	idSoundEmitterLocal *	sound;
+	idSoundChannel *		chan;
+	float					volume;			// with distance, fades and occlusion applied
+	float					spatialize;
+	idVec3					spatializedOriginInMeters;
+	float					minDistance;
+	float					maxDistance;
+	bool					global;
+	bool					omni;
+} soundVoice_t;
+
 typedef struct soundPortalTrace_s {
 	int		portalArea;
+	int		exitPortal;			// portal of portalArea the trace continued through
 	const struct soundPortalTrace_s	*prevStack;
 } soundPortalTrace_t;
 
@@ -697,11 +741,13 @@ public:
 
 	idSoundEmitterLocal *	AllocLocalSoundEmitter();
 	void					CalcEars( int numSpeakers, idVec3 realOrigin, idVec3 listenerPos, idMat3 listenerAxis, float ears[6], float spatialize );
-	void					AddChannelContribution( idSoundEmitterLocal *sound, idSoundChannel *chan,
-												int current44kHz, int numSpeakers, float *finalMixBuffer );
+	bool					SetupVoice( soundVoice_t &voice, int current44kHz );
+	void					AddChannelContribution( const soundVoice_t &voice, int current44kHz, int numSpeakers, float *finalMixBuffer );
 	void					MixLoop( int current44kHz, int numSpeakers, float *finalMixBuffer );
 	void					AVIUpdate( void );
 	void					ResolveOrigin( const int stackDepth, const soundPortalTrace_t *prevStack, const int soundArea, const float dist, const idVec3& soundOrigin, idSoundEmitterLocal *def );
+	void					ResolveOriginCached( const int soundArea, idSoundEmitterLocal *def );
+	float					TracePortalPath( const soundPortalPath_t &path, const idVec3 &soundOrigin, idVec3 &spatializedOrigin );
 	void					FindEffects( const int stackDepth, const soundPortalTrace_t *prevStack, const int soundArea );
 	float					FindAmplitude( idSoundEmitterLocal *sound, const int localTime, const idVec3 *listenerPosition, const s_channelType channel, bool shakesOnly );
 
@@ -741,6 +787,7 @@ public:
 	int						lastAVI44kHz;		// determine when we need to mix and write another block
 
 	idList<idSoundEmitterLocal *>emitters;
+	idList<soundVoice_t>	voices;				// triggered channels of the current mix, loudest first
 
 	idSoundFade				soundClassFade[SOUND_MAX_CLASSES];	// for global sound fading
 
@@ -767,6 +814,63 @@ private:
 /*
 ===================================================================================
 
+idSoundStreamDecoder
+
+Streaming OGG channels get their samples decoded ahead of playback by parallel
+jobs that run while the sound thread waits for the next mix.  Every streaming
+channel that is mixed queues itself again, rings of channels that were not
+queued during a mix are released.
+
+===================================================================================
+*/
+
+const int STREAM_RING_BLOCKS	= 8;		// mix blocks decoded ahead, about 90 msec
+const int MAX_STREAM_RINGS		= 16;
+
+class idSoundStreamDecoder {
+public:
+							idSoundStreamDecoder( void );
+
+	void					Init( void );
+	void					Shutdown( void );
+
+	// waits for the decoding started by the last Submit, must be called before
+	// the mixer reads from the rings and before a sample is purged
+	void					Sync( void );
+	// releases unused rings and starts decoding everything queued since the last Sync
+	void					Submit( void );
+
+	// copies the mix block at streamOffset if it has been decoded ahead
+	bool					Read( const idSoundChannel *chan, int streamOffset, float *dest );
+	// keeps the ring of the channel filled STREAM_RING_BLOCKS ahead of streamOffset
+	void					Queue( const idSoundChannel *chan, int streamOffset );
+
+private:
+	typedef struct streamRing_s {
+		const idSoundChannel *	chan;			// NULL if the ring is free
+		idSoundSample *			leadin;			// what the channel was playing when the ring was set up
+		idSoundSample *			loop;			// NULL if not looping
+		int						triggerTime;	// trigger44kHzTime of the channel, to notice restarts
+		int						numChannels;
+		idSampleDecoder *		decoder;		// private to the ring, so jobs never share it
+		int						start;			// stream offset in 44kHz samples of the oldest decoded block
+		int						first;			// ring index of the block at start
+		int						numBlocks;		// decoded blocks from start on
+		int						pendingBlocks;	// blocks being decoded after them by the submitted job
+		bool					queued;			// queued since the last Submit
+		float					samples[STREAM_RING_BLOCKS][MIXBUFFER_SAMPLES*2];
+	} streamRing_t;
+
+	streamRing_t			rings[MAX_STREAM_RINGS];
+	idParallelJobList *		jobs;
+
+	streamRing_t *			FindRing( const idSoundChannel *chan );
+	static void				DecodeRing( void *data );
+};
+
+/*
+===================================================================================
+
 idSoundSystemLocal
 
 ===================================================================================
@@ -844,6 +948,7 @@ public:
 
 	idAudioHardware *		snd_audio_hw;
 	idSoundCache *			soundCache;
+	idSoundStreamDecoder	streamDecoder;
 
 	idSoundWorldLocal *		currentSoundWorld;	// the one to mix each async tic
 
@@ -900,7 +1005,9 @@ public:
 	static idCVar			s_subFraction;
 	static idCVar			s_globalFraction;
 	static idCVar			s_doorDistanceAdd;
+	static idCVar			s_portalPathRefresh;
 	static idCVar			s_singleEmitter;
+	static idCVar			s_maxVoices;
 	static idCVar			s_numberOfSpeakers;
 	static idCVar			s_force22kHz;
 	static idCVar			s_clipVolumes;
@@ -909,6 +1016,10 @@ public:
 	static idCVar			s_useEAXReverb;
 	static idCVar			s_efxFadeOutDistance;
 	static idCVar			s_decompressionLimit;
+	static idCVar			s_preDecodeOgg;
+	static idCVar			s_backgroundDecoding;
+	static idCVar			s_cacheBudget;
+	static idCVar			s_cacheLoadTime;
 
 	static idCVar			s_slowAttenuate;
 
@@ -956,6 +1067,11 @@ public:
 	bool					onDemand;
 	bool					purged;
 	bool					levelLoadReferenced;		// so we can tell which samples aren't needed any more
+	bool					evicted;					// purged by the cache budget, the header is still valid
+	bool					loadPending;				// queued for a deferred reload
+	int						lastUsed;					// Sys_Milliseconds() of the last StartSound, for LRU eviction
+	int						inUseStamp;					// idSoundCache::inUseStamp when a channel last held it
+	int						soundClass;					// of the last shader that played it, for the cache report
 
 	int						LengthIn44kHzSamples() const;
 	ID_TIME_T		 			GetNewTimeStamp( void ) const;
@@ -980,7 +1096,7 @@ class idSampleDecoder {
 public:
 	static void				Init( void );
 	static void				Shutdown( void );
-	static idSampleDecoder *Alloc( void );
+	static idSampleDecoder *Alloc( bool threadPrivate = false );	// private decoders are never shared between threads
 	static void				Free( idSampleDecoder *decoder );
 	static int				GetNumUsedBlocks( void );
 	static int				GetUsedBlockMemory( void );
@@ -1017,10 +1133,32 @@ public:
 	void					EndLevelLoad();
 
 	void					PrintMemInfo( MemInfo_t *mi );
+	void					PrintStats( void ) const;
+	void					ClearStats( void );
+
+							// records a StartSound of the sample for the LRU order and the hit / miss counts
+	void					Touch( idSoundSample *sample, int soundClass );
+							// loads a purged sample right away, or queues it for Update if it was evicted
+							// by the budget, returns false if the sample is not playable yet
+	bool					LoadOnDemand( idSoundSample *sample );
+							// runs the deferred reloads and keeps the resident samples under s_cacheBudget
+	void					Update( idSoundWorldLocal *sw );
 
 private:
 	bool					insideLevelLoad;
 	idList<idSoundSample*>	listCache;
+
+	idList<idSoundSample*>	pendingLoads;
+	idSoundWorldLocal *		lastUpdateWorld;
+	int						inUseStamp;
+	bool					checkBudget;
+	int						hits[SOUND_MAX_CLASSES];
+	int						misses[SOUND_MAX_CLASSES];
+	int						numReloads;
+	int						numEvictions;
+
+	void					MarkSamplesInUse( idSoundWorldLocal *sw );
+	void					EnforceBudget( void );
 };
 
 #endif /* !__SND_LOCAL_H__ */
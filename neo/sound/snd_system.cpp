@@ -56,7 +56,9 @@ idCVar idSoundSystemLocal::s_playDefaultSound( "s_playDefaultSound", "1", CVAR_S
 idCVar idSoundSystemLocal::s_subFraction( "s_subFraction", "0.75", CVAR_SOUND | CVAR_ARCHIVE | CVAR_FLOAT, "volume to subwoofer in 5.1" );
 idCVar idSoundSystemLocal::s_globalFraction( "s_globalFraction", "0.8", CVAR_SOUND | CVAR_ARCHIVE | CVAR_FLOAT, "volume to all speakers when not spatialized" );
 idCVar idSoundSystemLocal::s_doorDistanceAdd( "s_doorDistanceAdd", "150", CVAR_SOUND | CVAR_ARCHIVE | CVAR_FLOAT, "reduce sound volume with this distance when going through a door" );
+idCVar idSoundSystemLocal::s_portalPathRefresh( "s_portalPathRefresh", "64", CVAR_SOUND | CVAR_FLOAT, "search the portals again after an emitter or the listener moved this far, 0 disables the portal path cache" );
 idCVar idSoundSystemLocal::s_singleEmitter( "s_singleEmitter", "0", CVAR_SOUND | CVAR_INTEGER, "mute all sounds but this emitter" );
+idCVar idSoundSystemLocal::s_maxVoices( "s_maxVoices", "0", CVAR_SOUND | CVAR_INTEGER, "number of the most audible channels that get OpenAL sources, the rest keep playing silently, 0 uses every available source" );
 idCVar idSoundSystemLocal::s_numberOfSpeakers( "s_numberOfSpeakers", "2", CVAR_SOUND | CVAR_ARCHIVE, "number of speakers" );
 idCVar idSoundSystemLocal::s_force22kHz( "s_force22kHz", "0", CVAR_SOUND | CVAR_BOOL, ""  );
 idCVar idSoundSystemLocal::s_clipVolumes( "s_clipVolumes", "1", CVAR_SOUND | CVAR_BOOL, ""  );
@@ -75,6 +77,10 @@ idCVar idSoundSystemLocal::s_libOpenAL( "s_libOpenAL", "openal32.dll", CVAR_SOUN
 idCVar idSoundSystemLocal::s_useEAXReverb( "s_useEAXReverb", "1", CVAR_SOUND | CVAR_BOOL | CVAR_ARCHIVE, "use EAX reverb" );
 idCVar idSoundSystemLocal::s_efxFadeOutDistance( "s_efxFadeOutDistance", "100", CVAR_SOUND | CVAR_FLOAT | CVAR_ARCHIVE, "" );
 idCVar idSoundSystemLocal::s_decompressionLimit( "s_decompressionLimit", "6", CVAR_SOUND | CVAR_INTEGER | CVAR_ARCHIVE, "specifies maximum uncompressed sample length in seconds" );
+idCVar idSoundSystemLocal::s_preDecodeOgg( "s_preDecodeOgg", "1", CVAR_SOUND | CVAR_BOOL | CVAR_ARCHIVE, "decode OGG samples shorter than s_decompressionLimit into hardware buffers at load time instead of streaming them" );
+idCVar idSoundSystemLocal::s_backgroundDecoding( "s_backgroundDecoding", "1", CVAR_SOUND | CVAR_BOOL, "decode streaming OGG sounds ahead of playback with parallel jobs" );
+idCVar idSoundSystemLocal::s_cacheBudget( "s_cacheBudget", "0", CVAR_SOUND | CVAR_INTEGER | CVAR_ARCHIVE, "megabytes of sound samples kept resident, the least recently played samples are evicted above it, 0 is unlimited" );
+idCVar idSoundSystemLocal::s_cacheLoadTime( "s_cacheLoadTime", "4", CVAR_SOUND | CVAR_INTEGER, "milliseconds per frame spent reloading evicted samples, 0 reloads them immediately in StartSound" );
 
 bool idSoundSystemLocal::EAXAvailable = false;
 
@@ -304,6 +310,24 @@ static void ListSoundDecoders_f( const idCmdArgs &args ) {
 	common->Printf( "%d kB decoder memory in %d blocks\n", idSampleDecoder::GetUsedBlockMemory() >> 10, idSampleDecoder::GetNumUsedBlocks() );
 }
 
+/*
+===============
+ListSoundCache_f
+===============
+*/
+static void ListSoundCache_f( const idCmdArgs &args ) {
+	if ( !soundSystemLocal.soundCache ) {
+		common->Printf( "No sound.\n" );
+		return;
+	}
+
+	soundSystemLocal.soundCache->PrintStats();
+
+	if ( !idStr::Icmp( args.Argv( 1 ), "clear" ) ) {
+		soundSystemLocal.soundCache->ClearStats();
+	}
+}
+
 /*
 ===============
 TestSound_f
@@ -429,11 +453,13 @@ void idSoundSystemLocal::Init() {
 
 	if (!s_noSound.GetBool()) {
 		idSampleDecoder::Init();
+		streamDecoder.Init();
 		soundCache = new idSoundCache();
 	}
 
 	cmdSystem->AddCommand( "listSounds", ListSounds_f, CMD_FL_SOUND, "lists all sounds" );
 	cmdSystem->AddCommand( "listSoundDecoders", ListSoundDecoders_f, CMD_FL_SOUND, "list active sound decoders" );
+	cmdSystem->AddCommand( "listSoundCache", ListSoundCache_f, CMD_FL_SOUND, "lists sound cache hits, misses and resident memory per sound class, 'clear' resets the counters" );
 	cmdSystem->AddCommand( "reloadSounds", SoundReloadSounds_f, CMD_FL_SOUND|CMD_FL_CHEAT, "reloads all sounds" );
 	cmdSystem->AddCommand( "reloadSoundEffects", SoundReloadSoundEffects_f, CMD_FL_SOUND | CMD_FL_CHEAT, "reloads efx files" );
 	cmdSystem->AddCommand( "testSound", TestSound_f, CMD_FL_SOUND | CMD_FL_CHEAT, "tests a sound", idCmdSystem::ArgCompletion_SoundName );
@@ -470,6 +496,9 @@ void idSoundSystemLocal::Shutdown() {
 		openalSources[i].looping = false;
 	}
 
+	// finish decoding ahead before the samples go away
+	streamDecoder.Shutdown();
+
 	// destroy all the sounds (hardware buffers as well)
 	delete soundCache;
 	soundCache = NULL;
@@ -636,6 +665,7 @@ int idSoundSystemLocal::AsyncUpdate( int inTime ) {
 
 	soundStats.runs++;
 	soundStats.activeSounds = 0;
+	soundStats.virtualSounds = 0;
 
 	int	numSpeakers = snd_audio_hw->GetNumberOfSpeakers();
 
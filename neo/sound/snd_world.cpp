@@ -438,6 +438,48 @@ float idSoundWorldLocal::CurrentShakeAmplitudeForPosition( const int time, const
 	return amp;
 }
 
+/*
+===================
+VoiceCompare
+
+Sorts the most audible voices first, global sounds win over positional ones
+===================
+*/
+static int VoiceCompare( const soundVoice_t *a, const soundVoice_t *b ) {
+	if ( a->global != b->global ) {
+		return a->global ? -1 : 1;
+	}
+	if ( a->volume > b->volume ) {
+		return -1;
+	}
+	if ( a->volume < b->volume ) {
+		return 1;
+	}
+	return 0;
+}
+
+/*
+===================
+VirtualizeChannel
+
+Takes the OpenAL source away from a channel that lost its voice.  Nothing is
+decoded while it is virtual, the next real mix restarts the source at the
+current offset from trigger44kHzTime.
+===================
+*/
+static void VirtualizeChannel( idSoundChannel *chan ) {
+	if ( !chan->virtualVoice ) {
+		chan->ALStop();
+		chan->triggered = true;
+		chan->virtualVoice = true;
+		chan->lastVolume = 0.0f;
+		for ( int i = 0; i < 6; i++ ) {
+			chan->lastV[i] = 0.0f;
+		}
+	}
+	soundSystemLocal.soundStats.virtualSounds++;
+}
+
 /*
 ===================
 idSoundWorldLocal::MixLoop
@@ -454,6 +496,9 @@ void idSoundWorldLocal::MixLoop( int current44kHz, int numSpeakers, float *final
 	int i, j;
 	idSoundEmitterLocal *sound;
 
+	// collect what was decoded ahead since the last mix
+	soundSystemLocal.streamDecoder.Sync();
+
 	// if noclip flying outside the world, leave silence
 	if ( listenerArea == -1 ) {
 		alListenerf( AL_GAIN, 0.0f );
@@ -493,27 +538,16 @@ void idSoundWorldLocal::MixLoop( int current44kHz, int numSpeakers, float *final
 	recreateModifiedEffects = false;
 
 	// debugging option to mute all but a single soundEmitter
+	int firstEmitter = 1;
+	int lastEmitter = emitters.Num();
 	if ( idSoundSystemLocal::s_singleEmitter.GetInteger() > 0 && idSoundSystemLocal::s_singleEmitter.GetInteger() < emitters.Num() ) {
-		sound = emitters[idSoundSystemLocal::s_singleEmitter.GetInteger()];
-
-		if ( sound && sound->playing ) {
-			// run through all the channels
-			for ( j = 0; j < SOUND_MAX_CHANNELS ; j++ ) {
-				idSoundChannel	*chan = &sound->channels[j];
-
-				// see if we have a sound triggered on this channel
-				if ( !chan->triggerState ) {
-					chan->ALStop();
-					continue;
-				}
-
-				AddChannelContribution( sound, chan, current44kHz, numSpeakers, finalMixBuffer );
-			}
-		}
-		return;
+		firstEmitter = idSoundSystemLocal::s_singleEmitter.GetInteger();
+		lastEmitter = firstEmitter + 1;
 	}
 
-	for ( i = 1; i < emitters.Num(); i++ ) {
+	// gather every triggered channel with its current volume
+	voices.SetNum( 0, false );
+	for ( i = firstEmitter; i < lastEmitter; i++ ) {
 		sound = emitters[i];
 
 		if ( !sound ) {
@@ -533,9 +567,44 @@ void idSoundWorldLocal::MixLoop( int current44kHz, int numSpeakers, float *final
 				continue;
 			}
 
-			AddChannelContribution( sound, chan, current44kHz, numSpeakers, finalMixBuffer );
+			soundVoice_t &voice = voices.Alloc();
+			voice.sound = sound;
+			voice.chan = chan;
+			if ( !SetupVoice( voice, current44kHz ) ) {
+				voices.RemoveIndex( voices.Num() - 1 );
+			}
 		}
 	}
+
+	// only the most audible channels get real voices, the others are
+	// virtualized: they give up their OpenAL source and skip decoding, but
+	// keep their trigger time, so they resume at the right spot once they
+	// become audible again
+	int maxVoices = soundSystemLocal.openalSourceCount;
+	if ( idSoundSystemLocal::s_maxVoices.GetInteger() > 0 && ( maxVoices <= 0 || idSoundSystemLocal::s_maxVoices.GetInteger() < maxVoices ) ) {
+		maxVoices = idSoundSystemLocal::s_maxVoices.GetInteger();
+	}
+	if ( maxVoices <= 0 ) {
+		// no hardware voices, only the software mix for avidemos
+		maxVoices = voices.Num();
+	}
+	if ( voices.Num() > maxVoices ) {
+		voices.Sort( VoiceCompare );
+	}
+
+	for ( i = 0; i < voices.Num(); i++ ) {
+		const soundVoice_t &voice = voices[i];
+
+		if ( i >= maxVoices || ( voice.volume < SND_EPSILON && voice.chan->lastVolume < SND_EPSILON ) ) {
+			VirtualizeChannel( voice.chan );
+			continue;
+		}
+
+		AddChannelContribution( voice, current44kHz, numSpeakers, finalMixBuffer );
+	}
+
+	// decode the streaming channels ahead while the sound thread sleeps
+	soundSystemLocal.streamDecoder.Submit();
 }
 
 //==============================================================================
@@ -717,6 +786,51 @@ void idSoundWorldLocal::AVIClose( void ) {
 //==============================================================================
 
 
+/*
+===================
+PortalSoundOrigin
+
+Pick a point on the portal to serve as the virtual sound origin for a sound
+at soundOrigin heard from listener
+===================
+*/
+static idVec3 PortalSoundOrigin( const exitPortal_t &re, const idVec3 &soundOrigin, const idVec3 &listener ) {
+	idVec3	source;
+
+	idPlane	pl;
+	re.w->GetPlane( pl );
+
+	float	scale;
+	idVec3	dir = listener - soundOrigin;
+	if ( !pl.RayIntersection( soundOrigin, dir, scale ) ) {
+		source = re.w->GetCenter();
+	} else {
+		source = soundOrigin + scale * dir;
+
+		// if this point isn't inside the portal edges, slide it in
+		for ( int i = 0 ; i < re.w->GetNumPoints() ; i++ ) {
+			int j = ( i + 1 ) % re.w->GetNumPoints();
+			idVec3	edgeDir = (*(re.w))[j].ToVec3() - (*(re.w))[i].ToVec3();
+			idVec3	edgeNormal;
+
+			edgeNormal.Cross( pl.Normal(), edgeDir );
+
+			idVec3	fromVert = source - (*(re.w))[j].ToVec3();
+
+			float	d = edgeNormal * fromVert;
+			if ( d > 0 ) {
+				// move it in
+				float div = edgeNormal.Normalize();
+				d /= div;
+
+				source -= d * edgeNormal;
+			}
+		}
+	}
+
+	return source;
+}
+
 /*
 ===================
 idSoundWorldLocal::ResolveOrigin
@@ -732,8 +846,6 @@ If there is no path through open portals from the sound to the listener, def->di
 set at maxDistance
 ===================
 */
-static const int MAX_PORTAL_TRACE_DEPTH = 10;
-
 void idSoundWorldLocal::ResolveOrigin( const int stackDepth, const soundPortalTrace_t *prevStack, const int soundArea, const float dist, const idVec3& soundOrigin, idSoundEmitterLocal *def ) {
 
 	if ( dist >= def->distance ) {
@@ -746,6 +858,15 @@ void idSoundWorldLocal::ResolveOrigin( const int stackDepth, const soundPortalTr
 		if ( fullDist < def->distance ) {
 			def->distance = fullDist;
 			def->spatializedOrigin = soundOrigin;
+
+			// remember the portal chain so it can be followed again without searching
+			soundPortalPath_t &path = def->portalPath;
+			path.numPortals = stackDepth;
+			int i = stackDepth - 1;
+			for ( const soundPortalTrace_t *prev = prevStack; prev; prev = prev->prevStack, i-- ) {
+				path.areas[i] = prev->portalArea;
+				path.portals[i] = prev->exitPortal;
+			}
 		}
 		return;
 	}
@@ -757,6 +878,7 @@ void idSoundWorldLocal::ResolveOrigin( const int stackDepth, const soundPortalTr
 
 	soundPortalTrace_t newStack;
 	newStack.portalArea = soundArea;
+	newStack.exitPortal = -1;
 	newStack.prevStack = prevStack;
 
 	int numPortals = rw->NumPortalsInArea( soundArea );
@@ -790,100 +912,107 @@ void idSoundWorldLocal::ResolveOrigin( const int stackDepth, const soundPortalTr
 		}
 
 		// pick a point on the portal to serve as our virtual sound origin
-#if 1
-		idVec3	source;
+		idVec3	source = PortalSoundOrigin( re, soundOrigin, listenerQU );
 
-		idPlane	pl;
-		re.w->GetPlane( pl );
+		idVec3 tlen = source - soundOrigin;
+		float tlenLength = tlen.LengthFast();
 
-		float	scale;
-		idVec3	dir = listenerQU - soundOrigin;
-		if ( !pl.RayIntersection( soundOrigin, dir, scale ) ) {
-			source = re.w->GetCenter();
-		} else {
-			source = soundOrigin + scale * dir;
+		newStack.exitPortal = p;
+		ResolveOrigin( stackDepth+1, &newStack, otherArea, dist+tlenLength+occlusionDistance, source, def );
+	}
+}
 
-			// if this point isn't inside the portal edges, slide it in
-			for ( int i = 0 ; i < re.w->GetNumPoints() ; i++ ) {
-				int j = ( i + 1 ) % re.w->GetNumPoints();
-				idVec3	edgeDir = (*(re.w))[j].ToVec3() - (*(re.w))[i].ToVec3();
-				idVec3	edgeNormal;
 
-				edgeNormal.Cross( pl.Normal(), edgeDir );
+/*
+===================
+idSoundWorldLocal::TracePortalPath
 
-				idVec3	fromVert = source - (*(re.w))[j].ToVec3();
+Follows a portal chain found by ResolveOrigin from soundOrigin to the listener
+and returns the full distance.
+===================
+*/
+float idSoundWorldLocal::TracePortalPath( const soundPortalPath_t &path, const idVec3 &soundOrigin, idVec3 &spatializedOrigin ) {
+	idVec3	origin = soundOrigin;
+	float	dist = 0.0f;
 
-				float	d = edgeNormal * fromVert;
-				if ( d > 0 ) {
-					// move it in
-					float div = edgeNormal.Normalize();
-					d /= div;
+	for ( int i = 0; i < path.numPortals; i++ ) {
+		exitPortal_t re = rw->GetPortal( path.areas[i], path.portals[i] );
 
-					source -= d * edgeNormal;
-				}
-			}
+		if ( (re.blockingBits & ( PS_BLOCK_VIEW | PS_BLOCK_AIR ) ) ) {
+			dist += idSoundSystemLocal::s_doorDistanceAdd.GetFloat();
 		}
-#else
-		// clip the ray from the listener to the center of the portal by
-		// all the portal edge planes, then project that point (or the original if not clipped)
-		// onto the portal plane to get the spatialized origin
-
-		idVec3	start = listenerQU;
-		idVec3	mid = re.w->GetCenter();
-		bool	wasClipped = false;
-
-		for ( int i = 0 ; i < re.w->GetNumPoints() ; i++ ) {
-			int j = ( i + 1 ) % re.w->GetNumPoints();
-			idVec3	v1 = (*(re.w))[j].ToVec3() - soundOrigin;
-			idVec3	v2 = (*(re.w))[i].ToVec3() - soundOrigin;
 
-			v1.Normalize();
-			v2.Normalize();
-
-			idVec3	edgeNormal;
-
-			edgeNormal.Cross( v1, v2 );
+		idVec3	source = PortalSoundOrigin( re, origin, listenerQU );
+		dist += ( source - origin ).LengthFast();
+		origin = source;
+	}
 
-			idVec3	fromVert = start - soundOrigin;
-			float	d1 = edgeNormal * fromVert;
+	spatializedOrigin = origin;
+	return dist + ( origin - listenerQU ).LengthFast();
+}
 
-			if ( d1 > 0.0f ) {
-				fromVert = mid - (*(re.w))[j].ToVec3();
-				float d2 = edgeNormal * fromVert;
+/*
+===================
+idSoundWorldLocal::ResolveOriginCached
 
-				// move it in
-				float	f = d1 / ( d1 - d2 );
+ResolveOrigin for the emitter in soundArea, reusing the portal chain of the
+previous search as long as the listener area, the emitter area and the portal
+states are unchanged.  While neither end moved, the previous result is
+returned as is.  After small moves the cached chain is followed again so the
+virtual origin keeps sliding along the portals, and after moving further than
+s_portalPathRefresh the whole graph is searched again, because a different
+chain may have become shorter.
 
-				idVec3	clipped = start * ( 1.0f - f ) + mid * f;
-				start = clipped;
-				wasClipped = true;
+def->distance must be set to the maximum distance in quake units.
+===================
+*/
+void idSoundWorldLocal::ResolveOriginCached( const int soundArea, idSoundEmitterLocal *def ) {
+	soundPortalPath_t &path = def->portalPath;
+	const float refresh = idSoundSystemLocal::s_portalPathRefresh.GetFloat();
+	const float doorDistance = idSoundSystemLocal::s_doorDistanceAdd.GetFloat();
+	const int generation = rw->GetPortalStateGeneration();
+
+	if ( refresh > 0.0f && path.listenerArea == listenerArea && path.soundArea == soundArea
+			&& path.portalStateGeneration == generation && path.maxDistance == def->distance
+			&& path.doorDistance == doorDistance ) {
+		if ( path.origin == def->origin && path.listener == listenerQU ) {
+			def->distance = path.distance;
+			def->spatializedOrigin = path.spatializedOrigin;
+			return;
+		}
+		if ( ( def->origin - path.searchOrigin ).LengthSqr() < Square( refresh )
+				&& ( listenerQU - path.searchListener ).LengthSqr() < Square( refresh ) ) {
+			if ( path.numPortals > 0 ) {
+				idVec3	spatialized;
+				float	fullDist = TracePortalPath( path, def->origin, spatialized );
+				if ( fullDist < def->distance ) {
+					def->distance = fullDist;
+					def->spatializedOrigin = spatialized;
+				}
 			}
+			path.origin = def->origin;
+			path.listener = listenerQU;
+			path.distance = def->distance;
+			path.spatializedOrigin = def->spatializedOrigin;
+			return;
 		}
+	}
 
-		idVec3	source;
-		if ( wasClipped ) {
-			// now project it onto the portal plane
-			idPlane	pl;
-			re.w->GetPlane( pl );
-
-			float	f1 = pl.Distance( start );
-			float	f2 = pl.Distance( soundOrigin );
+	path.listenerArea = listenerArea;
+	path.soundArea = soundArea;
+	path.portalStateGeneration = generation;
+	path.maxDistance = def->distance;
+	path.doorDistance = doorDistance;
+	path.searchOrigin = path.origin = def->origin;
+	path.searchListener = path.listener = listenerQU;
+	path.numPortals = 0;
 
-			float	f = f1 / ( f1 - f2 );
-			source = start * ( 1.0f - f ) + soundOrigin * f;
-		} else {
-			source = soundOrigin;
-		}
-#endif
+	ResolveOrigin( 0, NULL, soundArea, 0.0f, def->origin, def );
 
-		idVec3 tlen = source - soundOrigin;
-		float tlenLength = tlen.LengthFast();
-
-		ResolveOrigin( stackDepth+1, &newStack, otherArea, dist+tlenLength+occlusionDistance, source, def );
-	}
+	path.distance = def->distance;
+	path.spatializedOrigin = def->spatializedOrigin;
 }
 
-
 void idSoundWorldLocal::FindEffects( const int stackDepth, const soundPortalTrace_t *prevStack, const int soundArea ) {
 	if ( stackDepth == MAX_PORTAL_TRACE_DEPTH ) {
 		// don't spend too much time doing these calculations in big maps
@@ -1100,6 +1229,11 @@ void idSoundWorldLocal::ForegroundUpdate( int current44kHzTime ) {
 		}
 	}
 
+	// reload the evicted samples and keep the sound cache in its budget
+	if ( soundSystemLocal.currentSoundWorld == this ) {
+		soundSystemLocal.soundCache->Update( this );
+	}
+
 	Sys_LeaveCriticalSection();
 
 	//
@@ -1619,18 +1753,17 @@ void idSoundWorldLocal::CalcEars( int numSpeakers, idVec3 spatializedOrigin, idV
 
 /*
 ===============
-idSoundWorldLocal::AddChannelContribution
+idSoundWorldLocal::SetupVoice
 
-Adds the contribution of a single sound channel to finalMixBuffer
+Works out the volume and spatialization of voice.chan at current44kHz, so
+MixLoop can rank the channels before any of them is mixed.
+Returns false if the channel has nothing to play.
 this is called from the async thread
-
-Mixes MIXBUFFER_SAMPLES samples starting at current44kHz sample time into
-finalMixBuffer
 ===============
 */
-void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal *sound, idSoundChannel *chan,
-				   int current44kHz, int numSpeakers, float *finalMixBuffer ) {
-	int j;
+bool idSoundWorldLocal::SetupVoice( soundVoice_t &voice, int current44kHz ) {
+	idSoundEmitterLocal *sound = voice.sound;
+	idSoundChannel *chan = voice.chan;
 	float volume;
 
 	//
@@ -1644,12 +1777,17 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal *sound, idSo
 	// fetch the actual wave file and see if it's valid
 	idSoundSample *sample = chan->leadinSample;
 	if ( sample == NULL ) {
-		return;
+		return false;
 	}
 
 	// if you don't want to hear all the beeps from missing sounds
 	if ( sample->defaultSound && !idSoundSystemLocal::s_playDefaultSound.GetBool() ) {
-		return;
+		return false;
+	}
+
+	// samples evicted by the cache budget are silent until they are reloaded
+	if ( sample->purged || ( chan->LoopingSample() && chan->LoopingSample()->purged ) ) {
+		return false;
 	}
 
 	// get the actual shader
@@ -1657,15 +1795,13 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal *sound, idSo
 
 	// this might happen if the foreground thread just deleted the sound emitter
 	if ( !shader ) {
-		return;
+		return false;
 	}
 
 	float maxd = parms->maxDistance;
 	float mind = parms->minDistance;
 
-	int  mask = shader->speakerMask;
 	bool omni = ( parms->soundShaderFlags & SSF_OMNIDIRECTIONAL) != 0;
-	bool looping = ( parms->soundShaderFlags & SSF_LOOPING ) != 0;
 	bool global = ( parms->soundShaderFlags & SSF_GLOBAL ) != 0;
 	bool noOcclusion = ( parms->soundShaderFlags & SSF_NO_OCCLUSION ) || !idSoundSystemLocal::s_useOcclusion.GetBool();
 
@@ -1761,12 +1897,48 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal *sound, idSo
 		}
 	}
 
-	//
-	// do we have anything to add?
-	//
-	if ( volume < SND_EPSILON && chan->lastVolume < SND_EPSILON ) {
-		return;
-	}
+	voice.volume = volume;
+	voice.spatialize = spatialize;
+	voice.spatializedOriginInMeters = spatializedOriginInMeters;
+	voice.minDistance = mind;
+	voice.maxDistance = maxd;
+	voice.global = global;
+	voice.omni = omni;
+
+	return true;
+}
+
+/*
+===============
+idSoundWorldLocal::AddChannelContribution
+
+Adds the contribution of a single sound channel to finalMixBuffer
+this is called from the async thread
+
+Mixes MIXBUFFER_SAMPLES samples starting at current44kHz sample time into
+finalMixBuffer
+===============
+*/
+void idSoundWorldLocal::AddChannelContribution( const soundVoice_t &voice, int current44kHz, int numSpeakers, float *finalMixBuffer ) {
+	int j;
+
+	idSoundEmitterLocal *sound = voice.sound;
+	idSoundChannel *chan = voice.chan;
+	soundShaderParms_t *parms = &chan->parms;
+	idSoundSample *sample = chan->leadinSample;
+	const idSoundShader *shader = chan->soundShader;
+
+	float volume = voice.volume;
+	float spatialize = voice.spatialize;
+	const idVec3 &spatializedOriginInMeters = voice.spatializedOriginInMeters;
+	float maxd = voice.maxDistance;
+	float mind = voice.minDistance;
+
+	int  mask = shader->speakerMask;
+	bool omni = voice.omni;
+	bool looping = ( parms->soundShaderFlags & SSF_LOOPING ) != 0;
+	bool global = voice.global;
+
 	chan->lastVolume = volume;
 
 	//
@@ -1780,6 +1952,11 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal *sound, idSo
 	// allocate and initialize hardware source
 	//
 	if ( sound->removeStatus < REMOVE_STATUS_SAMPLEFINISHED ) {
+		// a virtual one shot that ran out while it had no voice is done
+		if ( chan->virtualVoice && !looping && offset >= sample->LengthIn44kHzSamples() ) {
+			return;
+		}
+
 		if ( !alIsSource( chan->openalSource ) ) {
 			chan->openalSource = soundSystemLocal.AllocOpenALSource( chan, !chan->leadinSample->hardwareBuffer || !chan->soundShader->entries[0]->hardwareBuffer || looping, chan->leadinSample->objectInfo.nChannels == 2 );
 		}
@@ -1825,7 +2002,14 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal *sound, idSo
 			if ( ( !looping && chan->leadinSample->hardwareBuffer ) || ( looping && chan->soundShader->entries[0]->hardwareBuffer ) ) {
 				// handle uncompressed (non streaming) single shot and looping sounds
 				if ( chan->triggered ) {
-					alSourcei( chan->openalSource, AL_BUFFER, looping ? chan->soundShader->entries[0]->openalBuffer : chan->leadinSample->openalBuffer );
+					idSoundSample *buffer = looping ? chan->soundShader->entries[0] : chan->leadinSample;
+					alSourcei( chan->openalSource, AL_BUFFER, buffer->openalBuffer );
+
+					// resume where the channel would be if it had kept its voice
+					if ( chan->virtualVoice && offset > 0 ) {
+						int resume = looping ? offset % buffer->LengthIn44kHzSamples() : offset;
+						alSourcei( chan->openalSource, AL_SAMPLE_OFFSET, (ALint)( resume * ( buffer->objectInfo.nSamplesPerSec / 44100.0f ) ) );
+					}
 				}
 			} else {
 				ALint finishedbuffers;
@@ -1833,6 +2017,9 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal *sound, idSo
 
 				// handle streaming sounds (decode on the fly) both single shot AND looping
 				if ( chan->triggered ) {
+					if ( chan->virtualVoice ) {
+						chan->openalStreamingOffset = offset;
+					}
 					alSourcei( chan->openalSource, AL_BUFFER, 0 );
 					alDeleteBuffers( 3, &chan->lastopenalStreamingBuffer[0] );
 					chan->lastopenalStreamingBuffer[0] = chan->openalStreamingBuffer[0];
@@ -1852,7 +2039,9 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal *sound, idSo
 				}
 
 				for ( j = 0; j < finishedbuffers; j++ ) {
-					chan->GatherChannelSamples( chan->openalStreamingOffset * sample->objectInfo.nChannels, MIXBUFFER_SAMPLES * sample->objectInfo.nChannels, alignedInputSamples );
+					if ( !soundSystemLocal.streamDecoder.Read( chan, chan->openalStreamingOffset, alignedInputSamples ) ) {
+						chan->GatherChannelSamples( chan->openalStreamingOffset * sample->objectInfo.nChannels, MIXBUFFER_SAMPLES * sample->objectInfo.nChannels, alignedInputSamples );
+					}
 					for ( int i = 0; i < ( MIXBUFFER_SAMPLES * sample->objectInfo.nChannels ); i++ ) {
 						if ( alignedInputSamples[i] < -32768.0f )
 							((short *)alignedInputSamples)[i] = -32768;
@@ -1868,6 +2057,8 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal *sound, idSo
 				if ( finishedbuffers ) {
 					alSourceQueueBuffers( chan->openalSource, finishedbuffers, &buffers[0] );
 				}
+
+				soundSystemLocal.streamDecoder.Queue( chan, chan->openalStreamingOffset );
 			}
 
 			// (re)start if needed..
@@ -1875,8 +2066,14 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal *sound, idSo
 				alSourcePlay( chan->openalSource );
 				chan->triggered = false;
 			}
+			chan->virtualVoice = false;
+		} else {
+			// every source is taken, keep the time running until one frees up
+			VirtualizeChannel( chan );
+			return;
 		}
 	} else {
+		chan->virtualVoice = false;
 
 		if ( slowmoActive && !chan->disallowSlow ) {
 			idSlowChannel slow = sound->GetSlowChannel( chan );
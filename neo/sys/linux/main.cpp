@@ -37,6 +37,10 @@ If you have questions concerning this license or the applicable additional terms
 #include <sys/types.h>
 #include <fcntl.h>
 
+#if defined( __i386__ ) || defined( __x86_64__ )
+#include <cpuid.h>
+#endif
+
 #ifdef ID_MCHECK
 #include <mcheck.h>
 #endif
@@ -170,7 +174,66 @@ Sys_GetProcessorId
 ===============
 */
 cpuid_t Sys_GetProcessorId( void ) {
+#if defined( __i386__ ) || defined( __x86_64__ )
+	static int flags = -1;
+	unsigned int eax, ebx, ecx, edx;
+
+	if ( flags != -1 ) {
+		return (cpuid_t)flags;
+	}
+
+	if ( !__get_cpuid( 0, &eax, &ebx, &ecx, &edx ) ) {
+		flags = CPUID_GENERIC;
+		return (cpuid_t)flags;
+	}
+
+	// "AuthenticAMD" has "Auth" in ebx, everything else is treated like Intel as on win32
+	flags = ( ebx == 0x68747541 ) ? CPUID_AMD : CPUID_INTEL;
+	const unsigned int maxLeaf = eax;
+
+	__get_cpuid( 1, &eax, &ebx, &ecx, &edx );
+	if ( edx & ( 1 << 23 ) ) {
+		flags |= CPUID_MMX;
+	}
+	if ( edx & ( 1 << 25 ) ) {
+		flags |= CPUID_SSE;
+	}
+	if ( edx & ( 1 << 26 ) ) {
+		flags |= CPUID_SSE2;
+	}
+	if ( ecx & ( 1 << 0 ) ) {
+		flags |= CPUID_SSE3;
+	}
+	if ( edx & ( 1 << 15 ) ) {
+		flags |= CPUID_CMOV;
+	}
+	if ( edx & ( 1 << 28 ) ) {
+		flags |= CPUID_HTT;
+	}
+
+	// AVX needs the OS to save the YMM registers, which it reports through XCR0
+	if ( ( ecx & ( 1 << 28 ) ) && ( ecx & ( 1 << 27 ) ) ) {
+		unsigned int xcr0Lo, xcr0Hi;
+		__asm__ __volatile__( "xgetbv" : "=a" ( xcr0Lo ), "=d" ( xcr0Hi ) : "c" ( 0 ) );
+		if ( ( xcr0Lo & 6 ) == 6 ) {
+			flags |= CPUID_AVX;
+			if ( ecx & ( 1 << 12 ) ) {
+				flags |= CPUID_FMA3;
+			}
+			if ( maxLeaf >= 7 ) {
+				__cpuid_count( 7, 0, eax, ebx, ecx, edx );
+				if ( ebx & ( 1 << 5 ) ) {
+					flags |= CPUID_AVX2;
+				}
+			}
+		}
+	}
+
+	// FTZ and DAZ are left out, Sys_FPU_SetFTZ / Sys_FPU_SetDAZ are not implemented here
+	return (cpuid_t)flags;
+#else
 	return CPUID_GENERIC;
+#endif
 }
 
 /*
@@ -179,7 +242,49 @@ Sys_GetProcessorString
 ===============
 */
 const char *Sys_GetProcessorString( void ) {
-	return "generic";
+	static idStr string;
+	cpuid_t cpuid = Sys_GetProcessorId();
+
+	if ( string.Length() ) {
+		return string.c_str();
+	}
+
+	if ( cpuid & CPUID_AMD ) {
+		string = "AMD CPU";
+	} else if ( cpuid & CPUID_INTEL ) {
+		string = "Intel CPU";
+	} else {
+		return "generic";
+	}
+
+	string += " with ";
+	if ( cpuid & CPUID_MMX ) {
+		string += "MMX & ";
+	}
+	if ( cpuid & CPUID_SSE ) {
+		string += "SSE & ";
+	}
+	if ( cpuid & CPUID_SSE2 ) {
+		string += "SSE2 & ";
+	}
+	if ( cpuid & CPUID_SSE3 ) {
+		string += "SSE3 & ";
+	}
+	if ( cpuid & CPUID_AVX ) {
+		string += "AVX & ";
+	}
+	if ( cpuid & CPUID_AVX2 ) {
+		string += "AVX2 & ";
+	}
+	if ( cpuid & CPUID_FMA3 ) {
+		string += "FMA3 & ";
+	}
+	if ( cpuid & CPUID_HTT ) {
+		string += "HTT & ";
+	}
+	string.StripTrailing( " & " );
+	string.StripTrailing( " with " );
+	return string.c_str();
 }
 
 /*
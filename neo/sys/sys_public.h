@@ -155,7 +155,10 @@ typedef enum {
 	CPUID_HTT							= 0x01000,	// Hyper-Threading Technology
 	CPUID_CMOV							= 0x02000,	// Conditional Move (CMOV) and fast floating point comparison (FCOMI) instructions
 	CPUID_FTZ							= 0x04000,	// Flush-To-Zero mode (denormal results are flushed to zero)
-	CPUID_DAZ							= 0x08000	// Denormals-Are-Zero mode (denormal source operands are set to zero)
+	CPUID_DAZ							= 0x08000,	// Denormals-Are-Zero mode (denormal source operands are set to zero)
+	CPUID_AVX							= 0x10000,	// Advanced Vector Extensions (CPU and OS support for 256 bit registers)
+	CPUID_AVX2							= 0x20000,	// Advanced Vector Extensions 2
+	CPUID_FMA3							= 0x40000	// Fused Multiply-Add
 } cpuid_t;
 
 typedef enum {
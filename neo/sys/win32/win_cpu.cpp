@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #pragma hdrstop
 
 #include "win_local.h"
+#include <intrin.h>
 
 
 /*
@@ -337,6 +338,68 @@ static bool HasSSE3( void ) {
 	return false;
 }
 
+/*
+================
+HasAVX
+================
+*/
+static bool HasAVX( void ) {
+	unsigned regs[4];
+
+	// get CPU feature bits
+	CPUID( 1, regs );
+
+	// bit 28 of ECX denotes AVX existence and bit 27 denotes the OS uses XSAVE/XRSTOR
+	if ( ( regs[_REG_ECX] & ( 1 << 28 ) ) == 0 || ( regs[_REG_ECX] & ( 1 << 27 ) ) == 0 ) {
+		return false;
+	}
+
+	// the OS must also save the XMM and YMM registers on context switches
+	return ( _xgetbv( 0 ) & 6 ) == 6;
+}
+
+/*
+================
+HasAVX2
+================
+*/
+static bool HasAVX2( void ) {
+	int regs[4];
+
+	if ( !HasAVX() ) {
+		return false;
+	}
+
+	// bit 5 of EBX of the extended features leaf denotes AVX2 existence
+	__cpuidex( regs, 7, 0 );
+	if ( regs[_REG_EBX] & ( 1 << 5 ) ) {
+		return true;
+	}
+	return false;
+}
+
+/*
+================
+HasFMA3
+================
+*/
+static bool HasFMA3( void ) {
+	unsigned regs[4];
+
+	if ( !HasAVX() ) {
+		return false;
+	}
+
+	// get CPU feature bits
+	CPUID( 1, regs );
+
+	// bit 12 of ECX denotes FMA3 existence
+	if ( regs[_REG_ECX] & ( 1 << 12 ) ) {
+		return true;
+	}
+	return false;
+}
+
 /*
 ================
 LogicalProcPerPhysicalProc
@@ -573,6 +636,21 @@ cpuid_t Sys_GetCPUId( void ) {
 		flags |= CPUID_SSE3;
 	}
 
+	// check for Advanced Vector Extensions
+	if ( HasAVX() ) {
+		flags |= CPUID_AVX;
+	}
+
+	// check for Advanced Vector Extensions 2
+	if ( HasAVX2() ) {
+		flags |= CPUID_AVX2;
+	}
+
+	// check for Fused Multiply-Add
+	if ( HasFMA3() ) {
+		flags |= CPUID_FMA3;
+	}
+
 	// check for Hyper-Threading Technology
 	if ( HasHTT() ) {
 		flags |= CPUID_HTT;
@@ -173,6 +173,7 @@ void DmapHelp( void ) {
 	"noCurves          = don't process curves\n"
 	"noCM              = don't create collision map\n"
 	"noAAS             = don't create AAS files\n"
+	"binary            = also write binary .bproc and .bcm files\n"
 
 	);
 }
@@ -207,6 +208,7 @@ void ResetDmapGlobals( void ) {
 	dmapGlobals.drawflag = false;
 	dmapGlobals.totalShadowTriangles = 0;
 	dmapGlobals.totalShadowVerts = 0;
+	dmapGlobals.binaryOutput = false;
 }
 
 /*
@@ -303,6 +305,9 @@ void Dmap( const idCmdArgs &args ) {
 		} else if (!idStr::Icmp( s, "exportObj" )) {
 			dmapGlobals.exportObj = true;
 			common->Printf( "exportObj = true\n" );
+		} else if ( !idStr::Icmp( s, "binary" ) ) {
+			dmapGlobals.binaryOutput = true;
+			common->Printf( "binary = true\n" );
 		} else if (!idStr::Icmp( s, "editorOutput" )) {
 #ifdef _WIN32
 			com_outputMsg = true;
@@ -355,6 +360,9 @@ void Dmap( const idCmdArgs &args ) {
 	if ( ProcessModels() ) {
 		WriteProcFile();
 		WriteOclFile();
+		if ( dmapGlobals.binaryOutput ) {
+			WriteBinaryProcFile();
+		}
 	} else {
 		leaked = true;
 	}
@@ -379,6 +387,9 @@ void Dmap( const idCmdArgs &args ) {
 			start = Sys_Milliseconds();
 
 			collisionModelManager->LoadMap( dmapGlobals.dmapFile );
+			if ( dmapGlobals.binaryOutput ) {
+				collisionModelManager->WriteBinaryCollisionModelFile( dmapGlobals.dmapFile );
+			}
 			collisionModelManager->FreeMap();
 
 			end = Sys_Milliseconds();
@@ -331,6 +331,7 @@ typedef struct {
 	bool	noShadow;			// don't create optimized shadow volumes
 
 	bool    exportObj;
+	bool	binaryOutput;		// also write .bproc and .bcm files
 
 	idBounds	drawBounds;
 	bool	drawflag;
@@ -545,6 +546,7 @@ void		ClipTriList( const mapTri_t *list, const idPlane &plane, float epsilon, ma
 srfTriangles_t	*ShareMapTriVerts( const mapTri_t *tris );
 void WriteProcFile( void );
 void WriteOclFile( void );
+void WriteBinaryProcFile( void );
 
 //=============================================================================
 
@@ -810,3 +810,33 @@ void WriteOclFile( void ) {
 
 	common->Printf( "occluder stats: %d lights, %d surfaces, %d vertices\n", lights, surfaces, vertices );
 }
+
+/*
+====================
+WriteBinaryProcFile
+
+Loads the .proc that was just written and stores the processed
+world in the binary format the renderer loads in its place.
+====================
+*/
+void WriteBinaryProcFile( void ) {
+	idStr			procName, binaryName;
+	ID_TIME_T		procTimeStamp;
+
+	common->Printf( "----- WriteBinaryProcFile -----\n" );
+
+	sprintf( procName, "%s." PROC_FILE_EXT, dmapGlobals.mapFileBase );
+	sprintf( binaryName, "%s." BPROC_FILE_EXT, dmapGlobals.mapFileBase );
+
+	// never load the binary file of a previous dmap
+	fileSystem->RemoveFile( binaryName );
+
+	int procLength = fileSystem->ReadFile( procName, NULL, &procTimeStamp );
+
+	idRenderWorldLocal *world = static_cast<idRenderWorldLocal *>( renderSystem->AllocRenderWorld() );
+	if ( world->LoadProc( dmapGlobals.mapFileBase ) ) {
+		common->Printf( "writing %s\n", binaryName.c_str() );
+		world->WriteBinaryProc( binaryName, procLength, procTimeStamp );
+	}
+	renderSystem->FreeRenderWorld( world );
+}